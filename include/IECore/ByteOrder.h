@@ -39,6 +39,7 @@
 
 #include "boost/static_assert.hpp"
 
+#include <cstring>
 #include <stdint.h>
 
 namespace IECore
@@ -163,6 +164,81 @@ inline double reverseBytes<double>( const double &x )
 	return xx.d;
 }
 
+namespace Detail
+{
+
+// Reverses the bytes of n contiguous values of type U in place. The
+// values are copied through a temporary rather than accessed through a
+// cast pointer, to avoid any aliasing problems with the caller's type.
+// Compilers recognise both the memcpy and the shifts in reverseBytes(),
+// so this loop is turned into vectorised byte shuffles.
+template<typename U>
+inline void reverseBytesInPlace( char *data, size_t n )
+{
+	for( size_t i = 0; i < n; ++i, data += sizeof( U ) )
+	{
+		U x;
+		memcpy( &x, data, sizeof( U ) );
+		x = reverseBytes<U>( x );
+		memcpy( data, &x, sizeof( U ) );
+	}
+}
+
+template<size_t Size>
+struct BulkReverseBytes
+{
+	// needs specialising for each size
+	BOOST_STATIC_ASSERT( Size==0 );
+};
+
+template<>
+struct BulkReverseBytes<1>
+{
+	static void apply( char *data, size_t n )
+	{
+	}
+};
+
+template<>
+struct BulkReverseBytes<2>
+{
+	static void apply( char *data, size_t n )
+	{
+		reverseBytesInPlace<uint16_t>( data, n );
+	}
+};
+
+template<>
+struct BulkReverseBytes<4>
+{
+	static void apply( char *data, size_t n )
+	{
+		reverseBytesInPlace<uint32_t>( data, n );
+	}
+};
+
+template<>
+struct BulkReverseBytes<8>
+{
+	static void apply( char *data, size_t n )
+	{
+		reverseBytesInPlace<Imf::Int64>( data, n );
+	}
+};
+
+} // namespace Detail
+
+/// Reverses the byte order of the n values starting at data, in place.
+/// This is much faster than calling reverseBytes( x ) per value, and
+/// should be preferred when converting arrays read from files. T must be
+/// a scalar type - compound types such as Imath::V3d should be passed as
+/// an array of their base type.
+template<typename T>
+inline void reverseBytes( T *data, size_t n )
+{
+	Detail::BulkReverseBytes<sizeof( T )>::apply( reinterpret_cast<char *>( data ), n );
+}
+
 /// If running on a big endian platform,
 /// returns a copy of x with reversed bytes,
 /// otherwise returns x unchanged.
@@ -195,6 +271,28 @@ inline T asBigEndian( const T &x )
 	}
 }
 
+/// If running on a big endian platform, reverses the
+/// bytes of the n values starting at data, in place.
+template<typename T>
+inline void asLittleEndian( T *data, size_t n )
+{
+	if( bigEndian() )
+	{
+		reverseBytes( data, n );
+	}
+}
+
+/// If running on a little endian platform, reverses the
+/// bytes of the n values starting at data, in place.
+template<typename T>
+inline void asBigEndian( T *data, size_t n )
+{
+	if( littleEndian() )
+	{
+		reverseBytes( data, n );
+	}
+}
+
 }
 
 #endif // IE_CORE_BYTEORDER_H
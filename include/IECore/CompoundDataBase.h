@@ -35,15 +35,14 @@
 #ifndef IECORE_COMPOUNDDATABASE_H
 #define IECORE_COMPOUNDDATABASE_H
 
+#include "IECore/CompoundMap.h"
 #include "IECore/TypedData.h"
 
-#include <map>
-
 namespace IECore
 {
 
 /// The type of Data held by the CompoundData typedef.
-typedef std::map< InternedString, DataPtr > CompoundDataMap;
+typedef CompoundMap< InternedString, DataPtr > CompoundDataMap;
 /// A subclass of Data which stores a map of other named Data
 /// objects - a CompoundDataMap. This is accessible as usual
 /// via the readable() and writable() member functions. Generally you
@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_COMPOUNDMAP_H
+#define IECORE_COMPOUNDMAP_H
+
+#ifdef IECORE_FLAT_MAPS
+#include "boost/container/flat_map.hpp"
+#endif
+
+#include <map>
+
+namespace IECore
+{
+
+/// The associative container used to store the members of CompoundObject
+/// and CompoundData, and the variables of a Primitive. By default this is
+/// a std::map, but if Cortex is built with IECORE_FLAT_MAPS defined, it is
+/// a boost::container::flat_map instead. This stores its elements in a
+/// single sorted vector, which is considerably more cache friendly and
+/// requires far fewer allocations to copy and load, at the expense of
+/// slower insertion into large maps. Because InternedString::operator <
+/// compares addresses, lookups by InternedString are then a binary search
+/// over contiguous pointers.
+///
+/// The interface of the two is the same, with one important exception :
+/// inserting into or erasing from a flat map invalidates all iterators and
+/// references to its elements. Code that must work with either container
+/// should not hold such references across modifications of the map.
+///
+/// \note IECORE_FLAT_MAPS changes the ABI of Cortex, so it must be defined
+/// consistently for Cortex and everything that uses it.
+#ifdef IECORE_FLAT_MAPS
+template<typename Key, typename T>
+using CompoundMap = boost::container::flat_map<Key, T>;
+#else
+template<typename Key, typename T>
+using CompoundMap = std::map<Key, T>;
+#endif
+
+} // namespace IECore
+
+#endif // IECORE_COMPOUNDMAP_H
@@ -35,6 +35,7 @@
 #ifndef IE_CORE_COMPOUNDOBJECT_H
 #define IE_CORE_COMPOUNDOBJECT_H
 
+#include "IECore/CompoundMap.h"
 #include "IECore/Export.h"
 #include "IECore/Object.h"
 
@@ -52,7 +53,7 @@ class IECORE_API CompoundObject : public Object
 
 		IE_CORE_DECLAREOBJECT( CompoundObject, Object );
 
-		typedef std::map<InternedString, ObjectPtr> ObjectMap;
+		typedef CompoundMap<InternedString, ObjectPtr> ObjectMap;
 
 		/// Gives const access to the member object map.
 		const ObjectMap &members() const;
@@ -59,6 +59,14 @@ class IECORE_API FileIndexedIO : public StreamIndexedIO
 		/// 	"compressor" : String [ 'blosclz' | 'lz4' | 'lz4hc' | 'snappy' | 'zlib']
 		///		"compressionLevel" : Int [ 0 = no compression, 9 = max compression ]
 		///		"maxCompressedBlockSize" : UInt [ size of compression block ]
+		///		"minCompressedBlockSize" : UInt [ entries smaller than this are not compressed, defaults to 1024 ]
+		///		"shuffle" : String [ 'none' | 'byte' | 'bit' ]
+		///		"compressionHints" : CompoundData [ maps a directory name to a CompoundData holding any of
+		///			"compressor", "compressionLevel", "shuffle", "typeSize" and "minCompressedBlockSize",
+		///			applied to everything written below directories of that name ]
+		///		"autoTune" : Bool [ chooses the compressor by trialling each of them on the first entries written ]
+		///		"blockStore" : String [ path to an IndexedIOBlockStore shared with other files, used to hold data blocks ]
+		///		"blockStoreMinSize" : UInt [ blocks smaller than this are held in the file rather than the block store, defaults to 4096 ]
 		FileIndexedIO(const std::string &path, const IndexedIO::EntryIDList &root, IndexedIO::OpenMode mode, const CompoundData *options = nullptr);
 
 		~FileIndexedIO() override;
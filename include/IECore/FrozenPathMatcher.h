@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_FROZENPATHMATCHER_H
+#define IECORE_FROZENPATHMATCHER_H
+
+#include "IECore/PathMatcher.h"
+
+namespace IECore
+{
+
+/// An immutable equivalent of PathMatcher, optimised for repeated
+/// calls to match(). Rather than a tree of individually allocated
+/// nodes, all locations are stored in contiguous arrays, with the
+/// children of each location occupying a single sorted span. Plain
+/// children are found by binary search on their InternedString
+/// addresses, and wildcarded children are partitioned at the end of
+/// the span so that they can be skipped entirely when not present.
+///
+/// FrozenPathMatchers are created with PathMatcher::freeze(), and
+/// can be converted back for editing with thaw(). Copies are cheap,
+/// since the underlying storage is shared.
+class IECORE_API FrozenPathMatcher
+{
+
+	public :
+
+		/// Constructs an empty matcher.
+		FrozenPathMatcher();
+		explicit FrozenPathMatcher( const PathMatcher &matcher );
+		FrozenPathMatcher( const FrozenPathMatcher &other );
+		~FrozenPathMatcher();
+
+		FrozenPathMatcher &operator = ( const FrozenPathMatcher &other );
+
+		/// Returns an editable copy of this matcher.
+		PathMatcher thaw() const;
+
+		bool isEmpty() const;
+		/// Returns the number of paths that would yield an
+		/// exact match. Complexity : constant.
+		size_t size() const;
+
+		/// Fills the paths container with all the paths
+		/// held within this matcher.
+		void paths( std::vector<std::string> &paths ) const;
+
+		/// Result is a bitwise or of the relevant values from
+		/// PathMatcher::Result, exactly as for PathMatcher::match().
+		unsigned match( const std::string &path ) const;
+		unsigned match( const std::vector<IECore::InternedString> &path ) const;
+
+		/// Returns an identifier for the location at the specified
+		/// path, or `npos` if it does not exist. As with PathMatcher::find(),
+		/// names are compared literally rather than as wildcards.
+		size_t find( const std::vector<IECore::InternedString> &path ) const;
+		/// Returns true if the location returned by `find()` was
+		/// explicitly added to the matcher, and false if it exists only
+		/// as the ancestor of other paths.
+		bool exactMatch( size_t location ) const;
+		static const size_t npos;
+
+		/// Set operations. These return new matchers, and are equivalent to
+		/// calling PathMatcher::addPaths(), PathMatcher::removePaths() and
+		/// PathMatcher::intersection() respectively. Independent branches
+		/// of the trees are combined in parallel.
+		FrozenPathMatcher unionWith( const FrozenPathMatcher &paths ) const;
+		FrozenPathMatcher difference( const FrozenPathMatcher &paths ) const;
+		FrozenPathMatcher intersection( const FrozenPathMatcher &paths ) const;
+
+		bool operator == ( const FrozenPathMatcher &other ) const;
+		bool operator != ( const FrozenPathMatcher &other ) const;
+
+	private :
+
+		// Defined in the .cpp file, along with all
+		// the algorithms operating on it.
+		class Tree;
+		typedef boost::intrusive_ptr<const Tree> ConstTreePtr;
+
+		FrozenPathMatcher( const ConstTreePtr &tree );
+
+		ConstTreePtr m_tree;
+
+};
+
+} // namespace IECore
+
+#endif // IECORE_FROZENPATHMATCHER_H
@@ -43,8 +43,17 @@ IECORE_PUSH_DEFAULT_VISIBILITY
 IECORE_POP_DEFAULT_VISIBILITY
 
 #include <fstream>
+#include <memory>
 #include <vector>
 
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+} // namespace interprocess
+} // namespace boost
+
 namespace IECore
 {
 
@@ -52,6 +61,8 @@ IE_CORE_FORWARDDECLARE( IFFFile );
 
 /// The IFFFile class defines a low level class for reading IFF files.
 /// For specific IFF file types use a more specific implementation (i.e. NParticleReader, IFFHairReader, IFFImageReader).
+/// The file is memory mapped, and Chunk data is copied directly from the mapping into the
+/// destination buffers, so only the Chunks which are actually read are paged in.
 class IECORE_API IFFFile : public RefCounted
 {
 	public :
@@ -135,6 +146,17 @@ class IECORE_API IFFFile : public RefCounted
 				template<typename T>
 				size_t read( std::vector<Imath::Vec3<T> > &data );
 
+				/// read only the elements specified by indices from Chunk data holding a vector
+				/// of values. This allows filtered subsets of large Chunks to be read without
+				/// decoding the whole Chunk.
+				template<typename T>
+				size_t read( std::vector<T> &data, const std::vector<size_t> &indices );
+
+				/// read only the elements specified by indices from Chunk data holding a vector
+				/// of Imath::Vec3 values.
+				template<typename T>
+				size_t read( std::vector<Imath::Vec3<T> > &data, const std::vector<size_t> &indices );
+
 			private :
 
 				Chunk( );
@@ -156,10 +178,15 @@ class IECORE_API IFFFile : public RefCounted
 				// reads most member variables from m_file, starting at pos
 				void readHeader( std::streampos *pos );
 
-				// reads the data from m_file, storing it in dataBuffer
+				// copies the data from m_file directly into dataBuffer, accounting for byte order
 				template<typename T>
 				void readData( T *dataBuffer, unsigned long n );
 
+				// copies the elements specified by indices from m_file into dataBuffer, where
+				// each element consists of elementSize values of type T
+				template<typename T>
+				void readData( T *dataBuffer, const std::vector<size_t> &indices, size_t elementSize );
+
 				// returns the proper byte alignment value for m_type
 				int alignmentQuota();
 
@@ -170,7 +197,9 @@ class IECORE_API IFFFile : public RefCounted
 	private :
 
 		bool open();
-		std::ifstream *m_iStream;
+		std::unique_ptr<boost::interprocess::mapped_region> m_region;
+		const char *m_data;
+		size_t m_size;
 		std::string m_streamFileName;
 
 		Chunk *m_root;
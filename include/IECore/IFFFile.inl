@@ -38,7 +38,9 @@
 #include "IECore/ByteOrder.h"
 #include "IECore/MessageHandler.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <vector>
 
 namespace IECore
@@ -68,13 +70,7 @@ size_t IFFFile::Chunk::read( std::vector<T> &data )
 		msg( Msg::Error, "IFFFile::Chunk::read()", boost::format( "Attempting to read '%d' pieces of data of size '%d' for a Chunk '%s' with dataSize '%d'." ) % length % sizeof(T) % m_type.name() % m_dataSize );
 	}
 
-	std::vector<T> dataBuffer( length );
-	readData( dataBuffer.data(), length );
-
-	for ( size_t i = 0; i < length; i++ )
-	{
-		data[i] = dataBuffer[i];
-	}
+	readData( data.data(), length );
 
 	return data.size();
 }
@@ -89,41 +85,67 @@ size_t IFFFile::Chunk::read( std::vector<Imath::Vec3<T> > &data )
 		msg( Msg::Error, "IFFFile::Chunk::read()", boost::format( "Attempting to read %d pieces of IMath::Vec3 data of size %d for a Chunk '%s' with dataSize %d." ) % length % sizeof(T) % m_type.name() % m_dataSize );
 	}
 
-	std::vector<T> dataBuffer( length * 3 );
-	readData( dataBuffer.data(), length * 3 );
+	// Imath::Vec3 is laid out as three contiguous values, so we can read straight into it
+	readData( reinterpret_cast<T *>( data.data() ), length * 3 );
 
-	for ( size_t i = 0; i < length ; i++ )
-	{
-		data[ i ][0] = dataBuffer[ 3*i ];
-		data[ i ][1] = dataBuffer[ 3*i + 1 ];
-		data[ i ][2] = dataBuffer[ 3*i + 2 ];
-	}
+	return data.size();
+}
 
+template<typename T>
+size_t IFFFile::Chunk::read( std::vector<T> &data, const std::vector<size_t> &indices )
+{
+	data.resize( indices.size() );
+	readData( data.data(), indices, 1 );
 	return data.size();
 }
 
 template<typename T>
-void IFFFile::Chunk::readData( T *dataBuffer, unsigned long n )
+size_t IFFFile::Chunk::read( std::vector<Imath::Vec3<T> > &data, const std::vector<size_t> &indices )
 {
-	m_file->m_iStream->seekg( m_filePosition, std::ios_base::beg );
+	data.resize( indices.size() );
+	readData( reinterpret_cast<T *>( data.data() ), indices, 3 );
+	return data.size();
+}
 
-	std::vector<char> buffer( m_dataSize );
-	m_file->m_iStream->read( buffer.data(), m_dataSize );
+template<typename T>
+void IFFFile::Chunk::readData( T *dataBuffer, unsigned long n )
+{
+	const size_t position = (std::streamoff)m_filePosition;
+	size_t size = std::min<size_t>( n * sizeof( T ), m_dataSize );
+	size = std::min( size, m_file->m_size - std::min( position, m_file->m_size ) );
 
-	IFFFile::readData( buffer.data(), dataBuffer, n );
+	memcpy( dataBuffer, m_file->m_data + position, size );
+	asBigEndian( dataBuffer, n );
 }
 
 template<typename T>
-void IFFFile::readData( const char *dataBuffer, T *attrBuffer, unsigned long n )
+void IFFFile::Chunk::readData( T *dataBuffer, const std::vector<size_t> &indices, size_t elementSize )
 {
-	for( unsigned long i=0; i < n; i++ )
-	{
-		T *data = (T*)dataBuffer;
-		dataBuffer += sizeof( T );
+	const size_t position = (std::streamoff)m_filePosition;
+	const size_t size = std::min<size_t>( m_dataSize, m_file->m_size - std::min( position, m_file->m_size ) );
+	const size_t elementBytes = elementSize * sizeof( T );
+	const char *source = m_file->m_data + position;
 
-		*attrBuffer = asBigEndian( *data );
-		attrBuffer++;
+	T *out = dataBuffer;
+	for( std::vector<size_t>::const_iterator it = indices.begin(); it != indices.end(); ++it, out += elementSize )
+	{
+		if( ( *it + 1 ) * elementBytes > size )
+		{
+			msg( Msg::Error, "IFFFile::Chunk::read()", boost::format( "Attempting to read element %d from Chunk '%s' with dataSize '%d'." ) % *it % m_type.name() % m_dataSize );
+			std::fill( out, out + elementSize, T( 0 ) );
+			continue;
+		}
+		memcpy( out, source + *it * elementBytes, elementBytes );
 	}
+
+	asBigEndian( dataBuffer, indices.size() * elementSize );
+}
+
+template<typename T>
+void IFFFile::readData( const char *dataBuffer, T *attrBuffer, unsigned long n )
+{
+	memcpy( attrBuffer, dataBuffer, n * sizeof( T ) );
+	asBigEndian( attrBuffer, n );
 }
 
 } // namespace IECore
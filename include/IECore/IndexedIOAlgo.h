@@ -127,7 +127,11 @@ struct FileStats
 	}
 };
 
-/// Recursively copy from 'src' to 'dst'
+/// Recursively copy from 'src' to 'dst'. Files are read and decompressed in
+/// parallel, but are written by a single writer in the order of a serial depth
+/// first traversal, so the layout of the destination is deterministic. To
+/// recompress a file, open 'dst' with the required "compressor" and
+/// "compressionLevel" options.
 IECORE_API void copy(const IndexedIO *src, IndexedIO *dst );
 
 /// Completely read an IndexedIO in parallel gathering statistics as we read.
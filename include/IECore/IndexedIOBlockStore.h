@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORE_INDEXEDIOBLOCKSTORE_H
+#define IECORE_INDEXEDIOBLOCKSTORE_H
+
+#include "IECore/Export.h"
+#include "IECore/MurmurHash.h"
+#include "IECore/RefCounted.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace IECore
+{
+
+IE_CORE_FORWARDDECLARE( IndexedIOBlockStore );
+
+/// A content addressed store for the data blocks of FileIndexedIO files,
+/// which may be shared by any number of files on the same machine. Blocks
+/// are keyed by the MurmurHash of their contents, so identical blocks written
+/// by different files (for instance the topology of successive versions of
+/// an asset) are stored, and page cached, only once. Files use a store by
+/// passing the "blockStore" option to FileIndexedIO.
+///
+/// Each file using the store records the blocks it references in a manifest
+/// held within the store. The reference count for a block is the number of
+/// manifests listing it, and compact() deletes any block whose count has
+/// dropped to zero. Blocks and manifests are written to temporary files and
+/// renamed into place, so concurrent writers are safe, but compact() must not
+/// be run while files using the store are being written.
+/// \ingroup ioGroup
+class IECORE_API IndexedIOBlockStore : public RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( IndexedIOBlockStore );
+
+		/// Opens the store rooted at the given directory. The directory
+		/// is created on demand when the first block is written.
+		IndexedIOBlockStore( const std::string &path );
+		~IndexedIOBlockStore() override;
+
+		/// Returns the absolute path to the store. This is what files using
+		/// the store record, so they may be read from any working directory.
+		const std::string &path() const;
+
+		/// Returns true if the block is present in the store.
+		bool contains( const MurmurHash &hash ) const;
+		/// Stores 'size' bytes from 'data' under 'hash', unless the block is
+		/// already present.
+		void write( const MurmurHash &hash, const char *data, size_t size );
+		/// Reads 'size' bytes from the block into 'buffer', throwing an IOException
+		/// if the block is missing or too short. Threadsafe.
+		void read( const MurmurHash &hash, char *buffer, size_t size ) const;
+
+		/// Replaces the manifest for 'fileName' with the given blocks.
+		void setReferences( const std::string &fileName, const std::vector<MurmurHash> &hashes );
+		/// Fills 'hashes' from the manifest for 'fileName', returning false
+		/// if there is no manifest.
+		bool getReferences( const std::string &fileName, std::vector<MurmurHash> &hashes ) const;
+		/// Removes the manifest for 'fileName', releasing its references. This
+		/// should be called when deleting a file which uses the store, although
+		/// compact() also releases the references of files which no longer exist.
+		void removeReferences( const std::string &fileName );
+
+		typedef std::map<MurmurHash, size_t> ReferenceCounts;
+		/// Fills 'counts' with the number of references to each block in the
+		/// store, including unreferenced blocks with a count of 0.
+		void referenceCounts( ReferenceCounts &counts ) const;
+
+		/// Removes the manifests of files which no longer exist, then deletes
+		/// the blocks that are no longer referenced. Returns the number of bytes
+		/// freed.
+		size_t compact();
+
+	private :
+
+		std::string blockFileName( const MurmurHash &hash ) const;
+		std::string manifestFileName( const std::string &fileName ) const;
+
+		std::string m_path;
+
+};
+
+} // namespace IECore
+
+#endif // IECORE_INDEXEDIOBLOCKSTORE_H
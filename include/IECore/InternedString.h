@@ -38,6 +38,7 @@
 #include "IECore/Export.h"
 
 #include <string>
+#include <utility>
 
 /// May be used to detect the existence of the
 /// InternedString( const char *, size_t length )
@@ -86,6 +87,18 @@ class IECORE_API InternedString
 
 		static size_t numUniqueStrings();
 
+		/// A string specified as a pointer to its first character
+		/// and its length, without the need for null termination.
+		typedef std::pair<const char *, size_t> StringRange;
+
+		/// Interns all the strings in the range [begin, end), storing
+		/// the results in `result`, which must have room for `end - begin`
+		/// elements. This is significantly faster than constructing
+		/// InternedStrings one by one, as each internal lock is
+		/// acquired only once for the whole batch.
+		static void internStrings( const StringRange *begin, const StringRange *end, InternedString *result );
+		static void internStrings( const std::string *begin, const std::string *end, InternedString *result );
+
 	private :
 
 		static const std::string *internedString( const char *value );
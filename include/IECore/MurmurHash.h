@@ -71,6 +71,9 @@ class IECORE_API MurmurHash
 
 		MurmurHash();
 		MurmurHash( const MurmurHash &other );
+		/// Constructs from the two halves of a previously computed hash,
+		/// as returned by h1() and h2().
+		MurmurHash( uint64_t h1, uint64_t h2 );
 
 		inline MurmurHash &append( char data );
 		inline MurmurHash &append( unsigned char data );
@@ -155,6 +158,10 @@ class IECORE_API MurmurHash
 
 		std::string toString() const;
 
+		/// The two halves of the hash, for use in serialisation.
+		inline uint64_t h1() const;
+		inline uint64_t h2() const;
+
 	private :
 
 		inline void append( const void *data, size_t bytes, int elementSize );
@@ -49,6 +49,8 @@
 namespace IECore
 {
 
+class FrozenPathMatcher;
+
 /// The PathMatcher class provides an acceleration structure for matching
 /// paths against a sequence of reference paths. It provides the internal
 /// implementation for the PathFilter.
@@ -77,6 +79,14 @@ class IECORE_API PathMatcher
 		template<typename PathIterator>
 		void init( PathIterator pathsBegin, PathIterator pathsEnd );
 
+		/// Replaces the contents with the tree described by a depth-first
+		/// traversal of the form produced by RawIterator. There is one entry in
+		/// `depths` and `exactMatches` per location, and one entry in `names`
+		/// for every location other than the root. The tree is built directly
+		/// in a single linear pass, which is much faster than calling addPath()
+		/// for each path, and is used to load PathMatcherData.
+		void initDepthFirst( const IECore::InternedString *names, size_t numNames, const unsigned int *depths, const unsigned char *exactMatches, size_t numLocations );
+
 		/// Returns true if the path was added, false if
 		/// it was already there.
 		bool addPath( const std::string &path );
@@ -141,8 +151,14 @@ class IECORE_API PathMatcher
 		/// or end() if it does not exist.
 		RawIterator find( const std::vector<IECore::InternedString> &path ) const;
 
+		/// Returns an immutable copy optimised for fast matching.
+		/// See FrozenPathMatcher for details.
+		FrozenPathMatcher freeze() const;
+
 	private :
 
+		friend class FrozenPathMatcher;
+
 		IE_CORE_FORWARDDECLARE( Node )
 
 		PathMatcher( const NodePtr &root );
@@ -153,6 +153,65 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 		void read(const IndexedIO::EntryID &name, short &x) const override;
 		void read(const IndexedIO::EntryID &name, unsigned short &x) const override;
 
+		/// Compression settings for the data entries written through a
+		/// particular handle. Members left at their default values fall
+		/// back to the file wide settings given by the options the file
+		/// was opened with (see FileIndexedIO).
+		struct IECORE_API CompressionHint
+		{
+			enum Shuffle
+			{
+				DefaultShuffle = -1,
+				NoShuffle = 0,
+				ByteShuffle = 1,
+				BitShuffle = 2
+			};
+
+			CompressionHint();
+
+			/// One of 'blosclz', 'lz4', 'lz4hc', 'snappy' or 'zlib'. Empty uses the file compressor.
+			std::string compressor;
+			/// In the range 0-9, where 0 stores the data uncompressed. -1 uses the file level.
+			int compressionLevel;
+			Shuffle shuffle;
+			/// The element size the shuffle filter operates on. 0 uses the size of the
+			/// type being written (4 for float arrays, 8 for double arrays and so on).
+			int typeSize;
+			/// Entries smaller than this are stored uncompressed. -1 uses the file setting.
+			int minCompressedBlockSize;
+
+			bool operator == ( const CompressionHint &other ) const;
+			bool operator != ( const CompressionHint &other ) const;
+		};
+
+		/// Sets the compression hint used for subsequent writes through this
+		/// handle. Handles returned by subdirectory() and createSubdirectory()
+		/// inherit the hint, unless one has been registered for the child's
+		/// name using the "compressionHints" option.
+		void setCompressionHint( const CompressionHint &hint );
+		const CompressionHint &getCompressionHint() const;
+
+		/// Statistics for the data read by a single thread, accumulated
+		/// over the lifetime of the process. Intended for profiling, by
+		/// taking the difference between values captured before and after
+		/// an operation.
+		struct IECORE_API ReadStatistics
+		{
+			ReadStatistics();
+
+			/// Bytes read from the file or block store, before decompression.
+			size_t bytesRead;
+			/// Bytes produced by decompression.
+			size_t bytesDecompressed;
+			/// Wall clock time spent decompressing, in seconds.
+			double decompressionTime;
+
+			ReadStatistics operator - ( const ReadStatistics &other ) const;
+		};
+
+		/// Returns the statistics for the reads made by the calling thread.
+		static ReadStatistics threadReadStatistics();
+
 		class PlatformReader;
 
 	protected:
@@ -187,6 +246,10 @@ class IECORE_API StreamIndexedIO : public IndexedIO
 
 				IndexedIO::OpenMode openMode() const;
 
+				/// Returns the name of the file being accessed, or an empty
+				/// string for streams which don't correspond to a file.
+				virtual std::string fileName() const;
+
 				// returns a read lock, when thread-safety is required.
 				typedef tbb::recursive_mutex Mutex;
 				typedef Mutex::scoped_lock MutexLock;
@@ -49,6 +49,9 @@ namespace IECoreImage
 /// This client class works synchronously.
 /// It forwards all parameters to the server and also includes one called "clientPID" to help grouping AOVs from the same render.
 /// You must set the parameter 'remoteDisplayType' with a registered display driver to be instantiated in the server side.
+/// When the server runs on the same host, pixel data is passed through a shared memory segment negotiated
+/// with the server, and the socket carries only control messages. The optional IntData parameter
+/// 'sharedMemorySize' specifies the size of the segment in bytes, and a value of 0 disables its use.
 /// \ingroup renderingGroup
 class IECOREIMAGE_API ClientDisplayDriver : public DisplayDriver
 {
@@ -68,6 +71,10 @@ class IECOREIMAGE_API ClientDisplayDriver : public DisplayDriver
 		// Get the port number or service name
 		std::string port() const;
 
+		// Returns true if pixel data is being passed to the server via
+		// shared memory rather than over the socket.
+		bool usingSharedMemory() const;
+
 		bool scanLineOrderOnly() const override;
 
 		bool acceptsRepeatedData() const override;
@@ -81,7 +88,7 @@ class IECOREIMAGE_API ClientDisplayDriver : public DisplayDriver
 		static const DisplayDriverDescription<ClientDisplayDriver> g_description;
 
 		void sendHeader( int msg, size_t dataSize );
-		size_t receiveHeader( int msg );
+		size_t receiveHeader( int msg, unsigned char *protocolVersion = nullptr );
 
 		class PrivateData;
 		IE_CORE_DECLAREPTR( PrivateData );
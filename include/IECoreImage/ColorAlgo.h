@@ -51,6 +51,9 @@ namespace ColorAlgo
 /// using color management provided via OpenImageIO.
 IECOREIMAGE_API void transformChannel( IECore::Data *channel, const std::string &inputSpace, const std::string &outputSpace );
 
+/// As above, but operating in place on a caller provided buffer of `size` values.
+IECOREIMAGE_API void transformChannel( float *channel, size_t size, const std::string &inputSpace, const std::string &outputSpace );
+
 /// Apply a simple color space transformation to the specified channels
 /// of the input image, using color management provided via OpenImageIO.
 /// Note that "A" and "Z" are special cases that will not be transformed.
@@ -52,7 +52,9 @@ namespace IECoreImage
 /// Server class that receives images from ClientDisplayDriver connections and forwards the data to local display drivers.
 /// The type of the local display drivers is defined by the 'remoteDisplayType' parameter.
 ///
-/// The server object creates a thread to control the socket connection. The thread dies when the object is destroyed.
+/// The server object creates a pool of threads to control the socket connections. The threads die when the object is destroyed.
+/// Each connection is serviced by only one thread at a time, so display drivers need not be thread-safe themselves, but
+/// separate connections are serviced concurrently when more than one thread is used.
 /// \ingroup renderingGroup
 class IECOREIMAGE_API DisplayDriverServer : public IECore::RunTimeTyped
 {
@@ -62,11 +64,22 @@ class IECOREIMAGE_API DisplayDriverServer : public IECore::RunTimeTyped
 
 		/// A port number of 0 causes a free port to be chosen
 		/// automatically. Call `portNumber()` after construction
-		/// to retrieve the actual number.
-		DisplayDriverServer( int portNumber = 0 );
+		/// to retrieve the actual number. A `numThreads` value of 0
+		/// uses one thread per hardware core. When `coalesceBuckets`
+		/// is true, adjacent buckets that arrive in quick succession are
+		/// merged into a single `imageData()` call on the display driver.
+		DisplayDriverServer( int portNumber = 0, int numThreads = 1, bool coalesceBuckets = false );
 		~DisplayDriverServer() override;
 
 		int portNumber();
+		int numThreads() const;
+		bool coalesceBuckets() const;
+
+		/// Returns the number of buckets received from clients, and the
+		/// number of `imageData()` calls made on display drivers. The two
+		/// differ only when buckets have been coalesced.
+		size_t numBucketsReceived() const;
+		size_t numBucketsForwarded() const;
 
 	private:
 
@@ -43,11 +43,15 @@
 #include "IECoreImage/ImagePrimitive.h"
 #include "IECoreImage/TypeIds.h"
 
+#include <atomic>
+#include <memory>
+
 namespace IECoreImage
 {
 
 /// Display driver that creates an ImagePrimitive object held
-/// in memory.
+/// in memory. The channels of the image are allocated up front,
+/// and incoming buckets are deinterleaved directly into them.
 /// \ingroup renderingGroup
 class IECOREIMAGE_API ImageDisplayDriver : public DisplayDriver
 {
@@ -69,6 +73,25 @@ class IECOREIMAGE_API ImageDisplayDriver : public DisplayDriver
 		/// before imageClose() has been called.
 		ConstImagePrimitivePtr image() const;
 
+		//! @name Progress
+		/// The data window is divided into a grid of tiles, each with an
+		/// update count which is incremented once imageData() has finished
+		/// writing a bucket which overlaps it. These counts may be polled from
+		/// any thread while the image is being rendered, without taking any
+		/// locks, to find the parts of image() which have changed since a
+		/// previous poll.
+		///////////////////////////////////////////////////////////////////////
+		//@{
+		/// The width and height of the tiles.
+		static int tileSize();
+		/// The number of tiles in x and y.
+		Imath::V2i numTiles() const;
+		/// The region of the data window covered by a tile.
+		Imath::Box2i tileBound( const Imath::V2i &tileIndex ) const;
+		/// The number of times the tile has been updated.
+		unsigned tileUpdateCount( const Imath::V2i &tileIndex ) const;
+		//@}
+
 		//! @name Image pool
 		/// It can be useful to store the images created by ImageDisplayDrivers for
 		/// later retrieval. Images can be stored by passing a StringData
@@ -90,6 +113,12 @@ class IECOREIMAGE_API ImageDisplayDriver : public DisplayDriver
 		static const DisplayDriverDescription<ImageDisplayDriver> g_description;
 
 		ImagePrimitivePtr m_image;
+		// Resolved once on construction, so that imageData()
+		// needn't look up the channels for every bucket.
+		std::vector<IECore::FloatVectorData *> m_channels;
+
+		Imath::V2i m_numTiles;
+		std::unique_ptr<std::atomic<unsigned>[]> m_tileUpdateCounts;
 
 };
 
@@ -43,6 +43,8 @@
 #include "IECore/SimpleTypedParameter.h"
 #include "IECore/VectorTypedParameter.h"
 
+#include "boost/iterator/iterator_facade.hpp"
+
 namespace IECoreImage
 {
 
@@ -105,6 +107,35 @@ class IECOREIMAGE_API ImageReader : public IECore::Reader
 		/// each element corresponds to a pixel. If that does not correspond
 		/// to the native file format, then it should return a FloatVectorData.
 		IECore::DataPtr readChannel( const std::string &name, bool raw = false );
+		/// As above, but reads only the specified region of the channel. Pixels
+		/// outside the data window are returned as zero.
+		IECore::DataPtr readChannel( const std::string &name, const Imath::Box2i &region, bool raw = false );
+		//@}
+
+		//! @name Streaming functions
+		/// These allow images to be processed piece by piece, without ever
+		/// holding all the pixels in memory at once. Pixels are fetched via
+		/// an internal cache of limited size, which loads only the tiles or
+		/// scanlines that overlap the requested region.
+		///////////////////////////////////////////////////////////////
+		//@{
+		/// Returns the size of the tiles stored in the file, or V2i( 0 )
+		/// if the file is stored as scanlines.
+		Imath::V2i tileSize();
+		/// Reads the specified region of the specified channels into
+		/// the buffer provided by the caller. The buffer must have room
+		/// for `channelNames.size() * region area` floats, and is filled
+		/// one channel after another, each channel in scanline order.
+		/// Pixels outside the data window are filled with zero. Unless raw
+		/// is true, colour channels are linearised as for readChannel().
+		void readRegion( const Imath::Box2i &region, const std::vector<std::string> &channelNames, float *buffer, bool raw = false );
+
+		class TileIterator;
+		/// Returns an iterator over blocks covering the specified region,
+		/// aligned to the tiles (or to bands of scanlines) stored in the
+		/// file. Each block is suitable for passing to readRegion().
+		TileIterator tilesBegin( const Imath::Box2i &region );
+		TileIterator tilesEnd();
 		//@}
 
 	protected :
@@ -129,6 +160,37 @@ class IECOREIMAGE_API ImageReader : public IECore::Reader
 
 };
 
+/// Iterates over a region in blocks aligned to a grid of tiles. Dereferencing
+/// yields the current block, clipped to the region being iterated.
+class IECOREIMAGE_API ImageReader::TileIterator : public boost::iterator_facade<ImageReader::TileIterator, const Imath::Box2i, boost::forward_traversal_tag>
+{
+
+	public :
+
+		/// Constructs an end iterator.
+		TileIterator();
+		/// Iterates over `region` in tiles of size `tileSize`, where
+		/// `origin` is the corner of any one tile in the grid.
+		TileIterator( const Imath::Box2i &region, const Imath::V2i &tileSize, const Imath::V2i &origin );
+
+	private :
+
+		friend class boost::iterator_core_access;
+
+		void increment();
+		bool equal( const TileIterator &other ) const;
+		const Imath::Box2i &dereference() const;
+
+		void updateTile();
+
+		Imath::Box2i m_region;
+		Imath::V2i m_tileSize;
+		Imath::V2i m_firstTileMin;
+		Imath::V2i m_tileMin;
+		Imath::Box2i m_tile;
+
+};
+
 IE_CORE_DECLAREPTR(ImageReader);
 
 } // namespace IECoreImage
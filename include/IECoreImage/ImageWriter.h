@@ -42,6 +42,7 @@
 #include "IECore/VectorTypedParameter.h"
 #include "IECore/Writer.h"
 
+#include <future>
 #include <string>
 #include <vector>
 
@@ -92,6 +93,13 @@ class IECOREIMAGE_API ImageWriter : public IECore::Writer
 		/// the parameter values.
 		void channelsToWrite( std::vector<std::string> &channels, const IECore::CompoundObject *operands = nullptr ) const;
 
+		/// Performs the write on a separate thread, returning a future which
+		/// can be used to wait for completion and to retrieve any exception
+		/// thrown. The parameter values are captured at the time of the call,
+		/// so the writer may be reused immediately, but the image is not
+		/// copied and must not be modified until the write has completed.
+		std::future<void> writeAsync();
+
 	protected :
 
 		void doWrite( const IECore::CompoundObject *operands ) override;
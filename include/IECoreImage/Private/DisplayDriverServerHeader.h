@@ -43,22 +43,32 @@ namespace IECoreImage
 /* Header block used by back and forth messages with the server.
 * 7 bytes long:
 * [0] - magic number ( 0x82 )
-* [1] - protocol version ( 1 )
-* [2] - message type ( imageOpen, imageData, imageClose )
+* [1] - protocol version ( 2 or 3 )
+* [2] - message type ( imageOpen, imageData, imageClose, exception, imageDataShared )
 * [3-6] - length of following data block.
 */
 class DisplayDriverServerHeader
 {
 	public:
 
-		enum MessageType { imageOpen = 1, imageData = 2, imageClose = 3, exception = 4 };
+		// imageDataShared is only sent once a shared memory segment has been
+		// negotiated during imageOpen, and its data block holds the position
+		// and size of a payload within that segment instead of the payload itself.
+		enum MessageType { imageOpen = 1, imageData = 2, imageClose = 3, exception = 4, imageDataShared = 5 };
 
 		static const unsigned char headerLength = 7;
 		static const unsigned char magicNumber = 0x82;
-		static const unsigned char currentProtocolVersion = 2;
+		// Messages are stamped with the oldest protocol version that understands
+		// them, so that new clients and servers remain compatible with old ones.
+		// Version 3 adds the shared memory transport : a server stamps its imageOpen
+		// replies with it to advertise that it will also reply to a shared memory
+		// offer, and it is used for imageDataShared messages.
+		static const unsigned char baseProtocolVersion = 2;
+		static const unsigned char sharedMemoryProtocolVersion = 3;
+		static const unsigned char currentProtocolVersion = sharedMemoryProtocolVersion;
 
 		DisplayDriverServerHeader();
-		DisplayDriverServerHeader( MessageType msg, size_t dataSize );
+		DisplayDriverServerHeader( MessageType msg, size_t dataSize, unsigned char protocolVersion = baseProtocolVersion );
 
 		// returns internal buffer ( length = headerLength constant )
 		unsigned char *buffer();
@@ -75,6 +85,9 @@ class DisplayDriverServerHeader
 		// returns the message type defined in the header.
 		MessageType messageType();
 
+		// returns the protocol version the message was stamped with.
+		unsigned char protocolVersion();
+
 	private:
 
 		unsigned char m_header[ headerLength ];
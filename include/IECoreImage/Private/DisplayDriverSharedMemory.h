@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECOREIMAGE_DISPLAYDRIVERSHAREDMEMORY
+#define IECOREIMAGE_DISPLAYDRIVERSHAREDMEMORY
+
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/interprocess/shared_memory_object.hpp"
+#include "boost/noncopyable.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace IECoreImage
+{
+
+/* Ring buffer living in a named shared memory segment, used to pass imageData
+* payloads from a ClientDisplayDriver to a DisplayDriverServer running on the
+* same host. The socket connection still carries every control message : the
+* client copies a payload into the ring and sends an imageDataShared message
+* holding its position, and the server releases the space once the payload
+* has been given to the display driver. Because the server processes messages
+* in order, a single read position stored in the segment is enough to tell the
+* client how much space is free.
+*/
+class DisplayDriverSharedMemory : public boost::noncopyable
+{
+
+	public :
+
+		// Creates a new uniquely named segment able to hold `capacity` bytes
+		// of payload. The segment name is removed again on destruction.
+		// Throws if the segment can't be created.
+		DisplayDriverSharedMemory( size_t capacity );
+		// Opens a segment created by another process. Throws if the segment
+		// doesn't exist or isn't a valid ring buffer.
+		DisplayDriverSharedMemory( const std::string &name );
+
+		~DisplayDriverSharedMemory();
+
+		const std::string &name() const;
+		size_t capacity() const;
+
+		// Client side. Reserves a contiguous block of `size` bytes, returning
+		// nullptr if the server hasn't yet released enough space. On success,
+		// `position` receives the value to send to the server.
+		char *reserve( size_t size, uint64_t &position );
+
+		// Server side. Returns the payload reserved by the client at `position`,
+		// throwing if it doesn't lie within the segment.
+		const char *payload( uint64_t position, size_t size ) const;
+		// Server side. Makes the space used by the payload at `position`
+		// available to the client again.
+		void release( uint64_t position, size_t size );
+
+	private :
+
+		struct Control;
+
+		void map();
+
+		std::string m_name;
+		bool m_owner;
+		boost::interprocess::shared_memory_object m_object;
+		boost::interprocess::mapped_region m_region;
+		Control *m_control;
+		char *m_data;
+		// Only used on the client side.
+		uint64_t m_writePosition;
+
+};
+
+} // namespace IECoreImage
+
+#endif // IECOREIMAGE_DISPLAYDRIVERSHAREDMEMORY
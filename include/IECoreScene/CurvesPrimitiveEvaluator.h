@@ -39,6 +39,7 @@
 #include "IECoreScene/PrimitiveEvaluator.h"
 
 #include "IECore/BoundedKDTree.h"
+#include "IECore/CompoundData.h"
 
 #include "tbb/mutex.h"
 
@@ -149,6 +150,28 @@ class IECORESCENE_API CurvesPrimitiveEvaluator : public PrimitiveEvaluator
 		float curveLength( unsigned curveIndex, float vStart=0.0f, float vEnd=1.0f ) const;
 		//@}
 
+		//! @name Batch queries
+		/// These functions perform many queries in a single call, evaluating them in
+		/// parallel and writing the results into arrays with one element per query.
+		/// They avoid the Result allocation and virtual dispatch that the single
+		/// queries above incur per sample, and should be preferred when evaluating
+		/// large numbers of points. Queries must use the same indexing as pointAtV(),
+		/// and an InvalidArgumentException is thrown if any of them are out of range.
+		////////////////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Fills points with the position at each ( curveIndices[i], v[i] ) pair, and
+		/// vTangents with the corresponding tangents if it is non-null.
+		void pointsAtV( const std::vector<int> &curveIndices, const std::vector<float> &v, std::vector<Imath::V3f> &points, std::vector<Imath::V3f> *vTangents = nullptr ) const;
+		/// Fills curveIndices and v with the location of the closest point on the curves
+		/// to each of the query points.
+		void closestPoints( const std::vector<Imath::V3f> &points, std::vector<int> &curveIndices, std::vector<float> &v ) const;
+		/// Evaluates the named primitive variables at each ( curveIndices[i], v[i] ) pair,
+		/// returning a CompoundData containing one VectorData per variable. Indexed
+		/// variables are expanded, and string variables are supported only for Constant
+		/// and Uniform interpolation.
+		IECore::CompoundDataPtr primitiveVariablesAtV( const std::vector<int> &curveIndices, const std::vector<float> &v, const std::vector<std::string> &names ) const;
+		//@}
+
 		//! @name Topology access
 		/// These functions make it easier to index curve data manually in cases where the
 		/// queries above are not sufficient.
@@ -193,6 +216,9 @@ class IECORESCENE_API CurvesPrimitiveEvaluator : public PrimitiveEvaluator
 		struct Line;
 		std::vector<Line> m_treeLines;
 
+		struct BatchVariable;
+		void validateQueries( const std::vector<int> &curveIndices, const std::vector<float> &v ) const;
+
 		void closestPointWalk( IECore::Box3fTree::NodeIndex nodeIndex, const Imath::V3f &p, unsigned &curveIndex, float &v, float &closestDistSquared ) const;
 
 };
@@ -98,6 +98,13 @@ class IECORESCENE_API LinkedScene : public  SampledSceneInterface
 		/// \param time Specifies the time that should be used to query the given scene
 		static IECore::CompoundDataPtr linkAttributeData( const SceneInterface *scene, double time );
 
+		/// Finds all the link targets below this location and opens them concurrently, rather than
+		/// one at a time as the links are reached during traversal. The opened scenes are held
+		/// for the lifetime of this LinkedScene and its locations, regardless of the limit set by
+		/// SharedSceneInterfaces::setMaxScenes(). Targets which are themselves LinkedScenes have
+		/// their own links prefetched too. Returns the number of files opened.
+		size_t prefetchLinks() const;
+
 		/*
 		 * virtual functions defined in SceneInterface.
 		 */
@@ -149,6 +156,7 @@ class IECORESCENE_API LinkedScene : public  SampledSceneInterface
 		IECore::ConstObjectPtr readObject( double time ) const override;
 		PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<IECore::InternedString> &primVarNames, double time ) const override;
 		void writeObject( const IECore::Object *object, double time ) override;
+		IECore::MurmurHash objectKey( double time ) const override;
 
 		bool hasChild( const Name &name ) const override;
 		void childNames( NameList &childNames ) const override;
@@ -162,7 +170,19 @@ class IECORESCENE_API LinkedScene : public  SampledSceneInterface
 
 	private :
 
-		LinkedScene( SceneInterface *mainScene, const SceneInterface *linkedScene, IECore::PathMatcherDataPtr linkLocationsData, int rootLinkDepth, bool readOnly, bool atLink, bool timeRemapped );
+		// Remapped times for each sample of the time link attribute, read once
+		// at the link location and shared with all the locations below it.
+		class TimeRemapping;
+		typedef boost::intrusive_ptr<const TimeRemapping> ConstTimeRemappingPtr;
+
+		// Link targets opened by prefetchLinks(), shared by all the locations of the scene.
+		class LinkTargets;
+		typedef boost::intrusive_ptr<LinkTargets> LinkTargetsPtr;
+
+		LinkedScene(
+			SceneInterface *mainScene, const SceneInterface *linkedScene, IECore::PathMatcherDataPtr linkLocationsData, LinkTargetsPtr linkTargets,
+			int rootLinkDepth, bool readOnly, bool atLink, bool timeRemapped, ConstTimeRemappingPtr timeRemapping = nullptr
+		);
 
 		ConstSceneInterfacePtr expandLink( const IECore::StringData *fileName, const IECore::InternedStringVectorData *root, int &linkDepth );
 
@@ -175,6 +195,9 @@ class IECORESCENE_API LinkedScene : public  SampledSceneInterface
 		IECore::PathMatcher linkLocations() const;
 		void recurseLinkLocations( IECore::PathMatcher &pathMatcher ) const;
 
+		// Adds the link targets at and below the main scene location to targets.
+		static void collectLinkTargets( const SceneInterface *mainScene, const SceneInterface::Path &path, const IECore::PathMatcher &linkLocations, LinkTargets &targets );
+
 		SceneInterfacePtr m_mainScene;
 		ConstSceneInterfacePtr m_linkedScene;
 		unsigned int m_rootLinkDepth;
@@ -182,6 +205,8 @@ class IECORESCENE_API LinkedScene : public  SampledSceneInterface
 		bool m_atLink;
 		bool m_sampled;
 		bool m_timeRemapped;
+		ConstTimeRemappingPtr m_timeRemapping;
+		LinkTargetsPtr m_linkTargets;
 		// \todo: std::map< Path, LinkedScenes > for quick scene calls... built by scene... dies with the instance (usually only root uses it).
 
 		/// locations of all links in the scene.
@@ -113,8 +113,10 @@ class IECORESCENE_API NParticleReader : public ParticleReader
 		IECore::IntVectorDataPtr m_frames;
 		std::map<int, IECore::IFFFile::Chunk::ChunkIterator> frameToRootChildren;
 
+		// reads numParticles elements of type F from chunk, decoding only the
+		// particles selected by percentage filtering and converting to T.
 		template<typename T, typename F>
-		typename T::Ptr filterAttr( const F * attr, float percentage );
+		typename T::Ptr readArray( IECore::IFFFile::Chunk &chunk, int numParticles );
 };
 
 IE_CORE_DECLAREPTR( NParticleReader );
@@ -41,12 +41,6 @@
 #include "IECore/Export.h"
 #include "IECore/Reader.h"
 
-IECORE_PUSH_DEFAULT_VISIBILITY
-#include "OpenEXR/ImathVec.h"
-IECORE_POP_DEFAULT_VISIBILITY
-
-#include <vector>
-
 namespace IECoreScene
 {
 
@@ -54,6 +48,10 @@ IE_CORE_FORWARDDECLARE(MeshPrimitive);
 
 /// The OBJReader class defines a class for reading OBJ mesh data.
 /// This is a subset of the full setup of objects encodable in OBJ.
+///
+/// The file is memory mapped and split into chunks of whole lines,
+/// which are parsed in parallel and then merged into a single
+/// MeshPrimitive.
 /// \ingroup ioGroup
 class IECORESCENE_API OBJReader : public IECore::Reader
 {
@@ -73,27 +71,6 @@ class IECORESCENE_API OBJReader : public IECore::Reader
 
 		static const ReaderDescription<OBJReader> m_readerDescription;
 
-		// top-level parse method
-		void parseOBJ();
-
-		// statement-level parse methods
-		void parseVertex(const char *, const char *);
-		void parseTextureCoordinate(const char *, const char *);
-		void parseNormal(const char *, const char *);
-
-		// elements
-		void parseFace(const char *, const char *);
-
-		// grouping
-		void parseGroup(const char *, const char *);
-
-		// pointers to mesh data
-		std::vector<int> *m_vpf, *m_vids;
-		std::vector<Imath::V3f> *m_vertices, *m_normals;
-		std::vector<float> *m_sTextureCoordinates, *m_tTextureCoordinates;
-
-		// local data for assembling mesh
-		std::vector<Imath::V3f> m_introducedNormals, m_introducedTextureCoordinates;
 };
 
 IE_CORE_DECLAREPTR(OBJReader);
@@ -40,6 +40,16 @@
 
 #include "IECore/VectorTypedData.h"
 
+#include <memory>
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+} // namespace interprocess
+} // namespace boost
+
 namespace IECoreScene
 {
 
@@ -47,6 +57,11 @@ namespace IECoreScene
 /// interface for Maya .pdc format particle caches. Percentage filtering
 /// of loaded particles is seeded using the particleId attribute, so
 /// is not only repeatable but also consistent from frame to frame.
+///
+/// Files are memory mapped, and only the attributes which are requested
+/// are decoded. When percentage filtering is in effect, only the selected
+/// particles are copied out of the file, so reading a small percentage of
+/// a large cache is correspondingly cheap.
 /// \ingroup ioGroup
 class IECORESCENE_API PDCParticleReader : public ParticleReader
 {
@@ -87,13 +102,15 @@ class IECORESCENE_API PDCParticleReader : public ParticleReader
 		struct Record
 		{
 			int type;
-			std::streampos position;
+			size_t position;
 		};
 
-		// makes sure that m_iStream is open and that m_header is full.
+		// makes sure that the file is mapped and that m_header is full.
 		// returns true on success and false on failure.
 		bool open();
-		std::ifstream *m_iStream;
+		std::unique_ptr<boost::interprocess::mapped_region> m_region;
+		const char *m_data;
+		size_t m_size;
 		std::string m_streamFileName;
 		struct
 		{
@@ -105,7 +122,25 @@ class IECORESCENE_API PDCParticleReader : public ParticleReader
 		} m_header;
 
 		template<typename T>
-		void readElements( T *buffer, std::streampos pos, unsigned long n ) const;
+		void readElements( T *buffer, size_t position, unsigned long n ) const;
+
+		// reads an array attribute stored in the file as elements of type F,
+		// decoding only the particles selected by percentage filtering.
+		template<typename T, typename F>
+		typename T::Ptr readArray( size_t position );
+
+		// returns the indices of the particles selected by percentage filtering,
+		// or 0 if all particles are to be loaded. the selection is cached so it
+		// is only computed once for all the attributes in the file.
+		const std::vector<size_t> *selectedParticles();
+		struct
+		{
+			bool valid;
+			float percentage;
+			int seed;
+			bool filtered;
+			std::vector<size_t> indices;
+		} m_filter;
 
 		// loads particleId in a completely unfiltered state
 		const IECore::Data * idAttribute();
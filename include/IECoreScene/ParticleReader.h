@@ -136,6 +136,13 @@ class IECORESCENE_API ParticleReader : public IECore::Reader
 		template<typename T, typename F>
 		typename T::Ptr filterAttr( const F * attr, float percentage, const IECore::Data *idAttr ) const;
 
+		/// Computes the indices of the particles which pass percentage filtering,
+		/// using exactly the same criteria as filterAttr(). This allows readers
+		/// to decode only the selected elements while streaming them from the file,
+		/// rather than reading everything and filtering afterwards. Returns false
+		/// if no filtering is required, in which case indices is left empty.
+		bool filteredIndices( size_t numParticles, float percentage, const IECore::Data *idAttr, std::vector<size_t> &indices ) const;
+
 		/// Returns the name of the original position primVar should we need to convert it to "P"
 		virtual std::string positionPrimVarName() = 0;
 
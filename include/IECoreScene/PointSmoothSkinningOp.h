@@ -39,11 +39,13 @@
 #define IECORESCENE_POINTSMOOTHSKINNINGOP_H
 
 #include "IECoreScene/Export.h"
+#include "IECoreScene/SmoothSkinningData.h"
 #include "IECoreScene/TypeIds.h"
 #include "IECoreScene/TypedObjectParameter.h"
 #include "IECoreScene/TypedPrimitiveParameter.h"
 
 #include "IECore/ModifyOp.h"
+#include "IECore/MurmurHash.h"
 #include "IECore/NumericParameter.h"
 #include "IECore/SimpleTypedParameter.h"
 #include "IECore/VectorTypedParameter.h"
@@ -73,10 +75,62 @@ class IECORESCENE_API PointSmoothSkinningOp : public IECore::ModifyOp
 		typedef enum
 		{
 			Linear = 0,
-			// todo: DualQuaternion = 1
+			/// Blends the rigid part of each influence transform as a dual
+			/// quaternion, avoiding the volume loss of Linear blending around
+			/// twisting joints. Scale and shear in the transforms are ignored.
+			DualQuaternion = 1,
 			// todo: LinearDualQuaternionMix = 2
 		} Blend;
 
+		/// SmoothSkinningData converted into a form suitable for fast repeated
+		/// deformation. The influences for each point are stored in fixed width
+		/// blocks of indices and weights, padded with zero weights, so that the
+		/// inner loops have a fixed trip count and can be vectorised by the compiler.
+		/// Construction validates the SmoothSkinningData, so callers deforming the
+		/// same skin many times (for instance once per frame, or once per crowd
+		/// agent) should construct a PreparedSkin once and reuse it.
+		/// \threading The deform methods may be called concurrently.
+		class IECORESCENE_API PreparedSkin : public IECore::RefCounted
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( PreparedSkin );
+
+				/// Throws if the SmoothSkinningData is invalid. The SmoothSkinningData
+				/// must not be modified while the PreparedSkin is in use.
+				PreparedSkin( ConstSmoothSkinningDataPtr smoothSkinningData );
+				~PreparedSkin() override;
+
+				const SmoothSkinningData *smoothSkinningData() const;
+
+				/// Deforms the points in place. The deformation pose must match the
+				/// influencePose of the SmoothSkinningData. If referenceIndices is
+				/// non-empty it maps each point to a point in the SmoothSkinningData,
+				/// otherwise the points must match the SmoothSkinningData one to one.
+				void deformPoints( std::vector<Imath::V3f> &points, const std::vector<Imath::M44f> &deformationPose, Blend blend = Linear, const std::vector<int> &referenceIndices = std::vector<int>() ) const;
+				/// As above, but for normals. If vertexIndices is non-empty, it maps
+				/// each normal to a point, as required for FaceVarying normals on meshes.
+				void deformNormals( std::vector<Imath::V3f> &normals, const std::vector<Imath::M44f> &deformationPose, Blend blend = Linear, const std::vector<int> &referenceIndices = std::vector<int>(), const std::vector<int> &vertexIndices = std::vector<int>() ) const;
+
+			private :
+
+				struct Block;
+				struct Transforms;
+
+				void skinningTransforms( const std::vector<Imath::M44f> &deformationPose, Blend blend, Transforms &transforms ) const;
+				void deform( std::vector<Imath::V3f> &data, bool normals, const std::vector<Imath::M44f> &deformationPose, Blend blend, const std::vector<int> &referenceIndices, const std::vector<int> &vertexIndices ) const;
+
+				ConstSmoothSkinningDataPtr m_smoothSkinningData;
+				// Index of the first block for each point, with a final
+				// element holding the total number of blocks.
+				std::vector<int> m_blockOffsets;
+				std::vector<Block> m_blocks;
+
+		};
+
+		IE_CORE_DECLAREPTR( PreparedSkin );
+
 		PointSmoothSkinningOp();
 		~PointSmoothSkinningOp() override;
 
@@ -125,10 +179,10 @@ class IECORESCENE_API PointSmoothSkinningOp : public IECore::ModifyOp
 		IECore::M44fVectorParameterPtr m_deformationPoseParameter;
 		IECore::IntVectorParameterPtr m_refIndicesParameter;
 
-		ConstSmoothSkinningDataPtr m_prevSmoothSkinningData;
-
-		struct DeformPositions;
-		struct DeformNormals;
+		PreparedSkinPtr m_preparedSkin;
+		// Hash of the SmoothSkinningData when m_preparedSkin was made, so
+		// that we notice if it is edited in place.
+		IECore::MurmurHash m_preparedSkinHash;
 };
 
 IE_CORE_DECLAREPTR( PointSmoothSkinningOp );
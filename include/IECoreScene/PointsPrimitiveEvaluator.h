@@ -38,6 +38,7 @@
 #include "IECoreScene/Export.h"
 #include "IECoreScene/PrimitiveEvaluator.h"
 
+#include "IECore/CompoundData.h"
 #include "IECore/KDTree.h"
 
 #include "tbb/mutex.h"
@@ -128,6 +129,25 @@ class IECORESCENE_API PointsPrimitiveEvaluator : public PrimitiveEvaluator
 			std::vector<PrimitiveEvaluator::ResultPtr> &results, float maxDistance = Imath::limits<float>::max() ) const override;
 		//@}
 
+		//! @name Batch queries
+		/// These functions perform many queries in a single call, evaluating them in
+		/// parallel and writing the results into arrays with one element per query.
+		/// They avoid the Result allocation and virtual dispatch that the single
+		/// queries above incur per sample, and should be preferred when evaluating
+		/// large numbers of points.
+		////////////////////////////////////////////////////////////////////////////////////////
+		//@{
+		/// Fills pointIndices with the index of the closest point to each of the
+		/// query points. Throws if there are no points to query.
+		void closestPoints( const std::vector<Imath::V3f> &points, std::vector<int> &pointIndices ) const;
+		/// Returns a CompoundData containing one VectorData per named primitive
+		/// variable, holding the value of the variable at each of the specified points.
+		/// Indexed variables are expanded, and Constant variables are returned as-is
+		/// since they have the same value at every point. Throws if any index is out
+		/// of range.
+		IECore::CompoundDataPtr primitiveVariables( const std::vector<int> &pointIndices, const std::vector<std::string> &names ) const;
+		//@}
+
 	protected :
 
 		/// \todo It would be much better if PrimitiveEvaluator::Description didn't require these create()
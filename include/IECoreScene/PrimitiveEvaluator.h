@@ -127,7 +127,24 @@ class IECORESCENE_API PrimitiveEvaluator : public IECore::RunTimeTyped
 		/// \threading Query implementations should ensure that they may be called from multiple
 		/// concurrent threads provided that a unique Result instance is used per thread. This
 		/// implies that all query data must be stored in the Result and not in the
-		/// PrimitiveEvaluator itself.
+		/// PrimitiveEvaluator itself. Any acceleration structures which are built lazily on
+		/// the first query must be built under a lock, so that a single evaluator can be
+		/// shared by all threads. The intended usage for parallel processing is therefore
+		/// to create one evaluator up front, and then create a Result per task :
+		///
+		/// ```
+		/// tbb::parallel_for( range, [&]( const tbb::blocked_range<size_t> &r ) {
+		/// 	PrimitiveEvaluator::ResultPtr result = evaluator->createResult();
+		/// 	for( size_t i = r.begin(); i != r.end(); ++i )
+		/// 	{
+		/// 		evaluator->closestPoint( points[i], result.get() );
+		/// 		...
+		/// 	}
+		/// } );
+		/// ```
+		///
+		/// Results themselves must not be written to concurrently, but may be read
+		/// concurrently once a query has completed.
 		////////////////////////////////////////////////////////////////////////////////////////
 		//@{
 
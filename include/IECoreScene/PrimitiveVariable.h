@@ -37,6 +37,7 @@
 
 #include "IECoreScene/Export.h"
 
+#include "IECore/CompoundMap.h"
 #include "IECore/VectorTypedData.h"
 
 namespace IECoreScene
@@ -173,7 +174,7 @@ class PrimitiveVariable::IndexedView
 };
 
 /// A simple type to hold named PrimitiveVariables.
-typedef std::map<std::string, PrimitiveVariable> PrimitiveVariableMap;
+typedef IECore::CompoundMap<std::string, PrimitiveVariable> PrimitiveVariableMap;
 
 } // namespace IECoreScene
 
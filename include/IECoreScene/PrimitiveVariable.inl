@@ -179,7 +179,7 @@ typename PrimitiveVariable::IndexedView<T>::Iterator PrimitiveVariable::IndexedV
 }
 
 /// A simple type to hold named PrimitiveVariables.
-typedef std::map<std::string, PrimitiveVariable> PrimitiveVariableMap;
+typedef IECore::CompoundMap<std::string, PrimitiveVariable> PrimitiveVariableMap;
 
 } // namespace IECoreScene
 
@@ -37,10 +37,21 @@
 
 #include "IECoreScene/Export.h"
 
+#include "IECoreScene/SceneBVH.h"
 #include "IECoreScene/SceneInterface.h"
 
+#include "IECore/Canceller.h"
+#include "IECore/MurmurHash.h"
+#include "IECore/PathMatcher.h"
+#include "IECore/RefCounted.h"
+
+#include "tbb/concurrent_vector.h"
+
+#include <chrono>
+#include <iosfwd>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace IECoreScene
 {
@@ -62,11 +73,103 @@ enum ProcessFlags
 
 typedef std::map<std::string, size_t> SceneStats;
 
-IECORESCENE_API SceneStats parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, float frameRate, unsigned int flags );
+/// Records how long each location took to read in parallelReadAll(),
+/// broken down by phase.
+class IECORESCENE_API ReadProfile : public IECore::RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( ReadProfile );
+
+		/// The statistics for reading a single phase of a location,
+		/// or the whole location when `phase` is `None`.
+		struct Event
+		{
+			SceneInterface::Path path;
+			/// The time in the scene that was read.
+			double time;
+			ProcessFlags phase;
+			/// Identifies the thread that did the reading.
+			size_t thread;
+			/// Wall clock start time and duration in seconds. Start times are
+			/// relative to the construction of the profile.
+			double start;
+			double duration;
+			/// See StreamIndexedIO::ReadStatistics. These are zero for scenes
+			/// not stored with StreamIndexedIO. Any work stolen by the thread
+			/// while waiting for parallel reads is included.
+			size_t bytesRead;
+			size_t bytesDecompressed;
+			double decompressionTime;
+			/// See SceneCache::CacheStatistics.
+			size_t cacheHits;
+			size_t cacheMisses;
+		};
+
+		ReadProfile();
+		~ReadProfile() override;
+
+		/// Returns the events recorded so far, sorted by start time. Events
+		/// are recorded as each location is read, so a profile is still
+		/// useful when parallelReadAll() is cancelled.
+		std::vector<Event> events() const;
+
+		/// Writes the events in the Chrome trace event format, which can be
+		/// viewed as a flame chart in Perfetto, speedscope or chrome://tracing.
+		/// Phases are nested inside their locations.
+		void writeTrace( std::ostream &stream ) const;
+		void writeTrace( const std::string &fileName ) const;
+
+		/// Used by parallelReadAll() to record events.
+		double elapsed() const;
+		void addEvent( const Event &event );
+
+	private :
 
-/// copy from one scene to another.
+		std::chrono::steady_clock::time_point m_startTime;
+		tbb::concurrent_vector<Event> m_events;
+
+};
+
+IE_CORE_DECLAREPTR( ReadProfile );
+
+/// Reads everything specified by flags from all locations, returning counts
+/// of what was read. When a profile is provided, an event is recorded for every
+/// location and phase. Throws IECore::Cancelled if the canceller is cancelled.
+IECORESCENE_API SceneStats parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, float frameRate, unsigned int flags, ReadProfile *profile = nullptr, const IECore::Canceller *canceller = nullptr );
+
+/// Copy from one scene to another. Locations are read in parallel, but are
+/// written by a single writer in the order of a serial depth first traversal,
+/// so the layout of the destination is deterministic.
 IECORESCENE_API void copy( const SceneInterface *src, SceneInterface *dst, int startFrame, int endFrame, float frameRate, unsigned int flags );
 
+/// An object shared by one or more locations, along with the paths
+/// of those locations relative to the root of the traversal.
+struct InstancedObject
+{
+	IECore::ConstObjectPtr object;
+	IECore::PathMatcher paths;
+};
+
+typedef std::map<IECore::MurmurHash, InstancedObject> InstancedObjects;
+
+/// Traverses src in parallel, grouping the locations with objects by
+/// SceneInterface::objectKey(). Each distinct object is read only once,
+/// so clients can load it a single time and instance it to all paths.
+IECORESCENE_API InstancedObjects instancedObjects( const SceneInterface *src, double time );
+
+/// Returns a SceneBVH for the scene at the specified time, sharing it
+/// with other callers via a cache. The cache is keyed on
+/// `SceneInterface::hash( HierarchyHash )`, along with the file name, path
+/// and time, so should only be used with scenes whose hashes change when
+/// the hierarchy does.
+IECORESCENE_API ConstSceneBVHPtr sceneBVH( const SceneInterface *src, double time );
+/// Limits the memory used by the cache of SceneBVHs, in bytes.
+IECORESCENE_API void setSceneBVHCacheMemoryLimit( size_t bytes );
+IECORESCENE_API size_t getSceneBVHCacheMemoryLimit();
+IECORESCENE_API void clearSceneBVHCache();
+
 } // SceneAlgo
 
 } // IECoreScene
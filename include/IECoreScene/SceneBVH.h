@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IECORESCENE_SCENEBVH_H
+#define IECORESCENE_SCENEBVH_H
+
+#include "IECoreScene/Export.h"
+#include "IECoreScene/SceneInterface.h"
+
+#include "IECore/PathMatcher.h"
+#include "IECore/RefCounted.h"
+
+#include "OpenEXR/ImathBox.h"
+#include "OpenEXR/ImathFrustum.h"
+#include "OpenEXR/ImathLine.h"
+#include "OpenEXR/ImathMatrix.h"
+
+#include <vector>
+
+namespace IECoreScene
+{
+
+/// A bounding volume hierarchy over the world space bounds of the leaf
+/// locations of a scene at a particular time, for finding the locations
+/// within a region of space without reading the whole scene. Leaf locations
+/// are those with objects and those without children. Because the bound of
+/// a location includes its descendants, locations with both an object and
+/// children may be reported conservatively. Paths and world space are relative
+/// to the location the hierarchy was built from. Use SceneAlgo::sceneBVH()
+/// to share hierarchies between clients.
+/// \ingroup ioGroup
+class IECORESCENE_API SceneBVH : public IECore::RefCounted
+{
+
+	public :
+
+		IE_CORE_DECLAREMEMBERPTR( SceneBVH );
+
+		/// Traverses the scene in parallel to build the hierarchy.
+		SceneBVH( const SceneInterface *scene, double time );
+		~SceneBVH() override;
+
+		/// The world space bound of all the leaves.
+		const Imath::Box3d &bound() const;
+		/// The number of leaf locations in the hierarchy.
+		size_t numLeaves() const;
+		/// An approximation of the memory used by the hierarchy, in bytes.
+		size_t memoryUsage() const;
+
+		/// Returns the paths of leaves whose bounds intersect the box.
+		IECore::PathMatcher intersectingPaths( const Imath::Box3d &box ) const;
+		/// Returns the paths of leaves whose bounds intersect the frustum of a
+		/// camera with the specified transform.
+		IECore::PathMatcher intersectingPaths( const Imath::Frustumd &frustum, const Imath::M44d &cameraToWorld ) const;
+		/// Returns the paths of leaves whose bounds are hit by the ray starting
+		/// at `ray.pos` and travelling in the direction `ray.dir`.
+		IECore::PathMatcher intersectingPaths( const Imath::Line3d &ray ) const;
+
+		/// Bulk queries, answering many queries in parallel. The result
+		/// holds the paths for each query, in the order of the queries.
+		/// The frustums and cameraToWorld transforms must be of equal length.
+		std::vector<IECore::PathMatcher> intersectingPaths( const std::vector<Imath::Box3d> &boxes ) const;
+		std::vector<IECore::PathMatcher> intersectingPaths( const std::vector<Imath::Frustumd> &frustums, const std::vector<Imath::M44d> &cameraToWorld ) const;
+		std::vector<IECore::PathMatcher> intersectingPaths( const std::vector<Imath::Line3d> &rays ) const;
+
+	private :
+
+		// Nodes are stored depth first, so the first child of an
+		// internal node immediately follows it.
+		struct Node
+		{
+			Imath::Box3d bound;
+			// For leaf nodes, the index into m_paths, otherwise
+			// the index of the second child.
+			size_t index;
+			bool leaf;
+		};
+
+		struct Leaf;
+		void build( std::vector<Leaf> &leaves, size_t begin, size_t end, size_t nodeIndex );
+
+		template<typename Predicate>
+		void query( const Predicate &predicate, IECore::PathMatcher &result ) const;
+
+		template<typename Predicate>
+		std::vector<IECore::PathMatcher> bulkQuery( const std::vector<Predicate> &predicates ) const;
+
+		std::vector<Node> m_nodes;
+		std::vector<SceneInterface::Path> m_paths;
+
+};
+
+IE_CORE_DECLAREPTR( SceneBVH );
+
+} // namespace IECoreScene
+
+#endif // IECORESCENE_SCENEBVH_H
@@ -50,7 +50,9 @@ IE_CORE_FORWARDDECLARE( SceneCache );
 /// When saving, it's important to keep the initial root SceneCache object alive until the very end.
 /// The destruction of the root scene will trigger the recursive computation of the bounding boxes for all the
 /// locations that no bounds were written. It will also store (without duplication) all the
-/// sample times used by objects, transforms, bounds and attributes.
+/// sample times used by objects, transforms, bounds and attributes, and an index of set and tag
+/// membership which allows readSet() to load sets in time proportional to their size. Sets are
+/// read from files written without an index by walking the hierarchy in parallel.
 /// \ingroup ioGroup
 class IECORESCENE_API SceneCache : public SampledSceneInterface
 {
@@ -74,7 +76,9 @@ class IECORESCENE_API SceneCache : public SampledSceneInterface
 		/// implementation for the backend. The given IndexedIO should be
 		/// pointing to the root location on the file. The open mode will
 		/// be the same from the given IndexedIO object. Append mode is not
-		/// supported.
+		/// supported. Transforms and objects are written below directories
+		/// named "transform" and "object" respectively, so the "compressionHints"
+		/// option of FileIndexedIO may be used to compress them differently.
 		SceneCache( IECore::IndexedIOPtr indexedIO );
 
 		~SceneCache() override;
@@ -125,6 +129,15 @@ class IECORESCENE_API SceneCache : public SampledSceneInterface
 		IECore::ConstObjectPtr readObjectAtSample( size_t sampleIndex ) const override;
 		PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<IECore::InternedString> &primVarNames, double time ) const override;
 		void writeObject( const IECore::Object *object, double time ) override;
+		/// Returns the content hashes stored in the file, so the object isn't read.
+		/// Files written without them fall back to the base class implementation.
+		IECore::MurmurHash objectKey( double time ) const override;
+
+		/// Equivalent to writeAttribute() and writeObject(), but taking the content
+		/// hash stored in the file from the caller. This avoids hashing again when
+		/// the caller has already computed it, perhaps in parallel ahead of writing.
+		void writeAttribute( const Name &name, const IECore::Object *attribute, double time, const IECore::MurmurHash &hash );
+		void writeObject( const IECore::Object *object, double time, const IECore::MurmurHash &hash );
 
 		bool hasChild( const Name &name ) const override;
 		void childNames( NameList &childNames ) const override;
@@ -134,6 +147,10 @@ class IECORESCENE_API SceneCache : public SampledSceneInterface
 		SceneInterfacePtr scene( const Path &path, MissingBehaviour missingBehaviour = ThrowIfMissing ) override;
 		ConstSceneInterfacePtr scene( const Path &path, SceneInterface::MissingBehaviour missingBehaviour = ThrowIfMissing ) const override;
 
+		/// Files store content hashes for each sample of the transforms, attributes, bounds
+		/// and objects, so the hashes for those are independent of the file and location
+		/// and may be shared between files. Older files fall back to hashing the file name
+		/// and location.
 		void hash( HashType hashType, double time, IECore::MurmurHash &h ) const override;
 
 		/// tells you if this scene cache is read only or writable:
@@ -144,6 +161,24 @@ class IECORESCENE_API SceneCache : public SampledSceneInterface
 		static const Name &animatedObjectTopologyAttribute;
 		static const Name &animatedObjectPrimVarsAttribute;
 
+		/// Statistics for the lookups made by a single thread into the caches
+		/// of transforms, attributes and objects shared by the readers of a file,
+		/// accumulated over the lifetime of the process. Intended for profiling,
+		/// by taking the difference between values captured before and after an
+		/// operation.
+		struct IECORESCENE_API CacheStatistics
+		{
+			CacheStatistics();
+
+			size_t hits;
+			size_t misses;
+
+			CacheStatistics operator - ( const CacheStatistics &other ) const;
+		};
+
+		/// Returns the statistics for the lookups made by the calling thread.
+		static CacheStatistics threadCacheStatistics();
+
 	protected:
 
 		IE_CORE_FORWARDDECLARE( Implementation );
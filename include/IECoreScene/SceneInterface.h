@@ -234,6 +234,12 @@ class IECORESCENE_API SceneInterface : public IECore::RunTimeTyped
 		/// Reads primitive variables from the object of type Primitive stored at this path in the scene at the given time.
 		/// Raises exception if it turns out not to be a Primitive object.
 		virtual PrimitiveVariableMap readObjectPrimitiveVariables( const std::vector<IECore::InternedString> &primVarNames, double time ) const = 0;
+		/// Returns a key identifying the object at the given time. Locations with equal keys
+		/// hold identical objects, so the object may be read once and instanced at the others.
+		/// Returns a default MurmurHash when there is no object. The default implementation
+		/// reads the object and hashes it, and derived classes should override it when they
+		/// can identify the object without reading it.
+		virtual IECore::MurmurHash objectKey( double time ) const;
 		/// Writes a geometry to this path in the scene.
 		/// Raises an exception if you try to write an object in the root path.
 		virtual void writeObject( const IECore::Object *object, double time ) = 0;
@@ -46,6 +46,8 @@
 namespace IECoreScene
 {
 
+IE_CORE_FORWARDDECLARE( ShaderNetwork )
+
 /// Contains a collection of `Shader` objects and maintains connections between them.
 class IECORESCENE_API ShaderNetwork : public IECore::BlindDataHolder
 {
@@ -84,6 +86,11 @@ class IECORESCENE_API ShaderNetwork : public IECore::BlindDataHolder
 		/// assert( shader == nullptr );
 		/// ```
 		IECore::InternedString addShader( const IECore::InternedString &handle, ShaderPtr &&shader );
+		/// As above, but adds the shader `sourceHandle` from `sourceNetwork`. Because
+		/// networks never modify their shaders, the shader is shared between the two
+		/// networks rather than copied, along with any hashing and parsing already
+		/// performed for it.
+		IECore::InternedString addShader( const IECore::InternedString &handle, const ShaderNetwork *sourceNetwork, const IECore::InternedString &sourceHandle );
 		/// Sets the shader with the named handle. Replaces any existing shader with the same
 		/// handle. A copy of the shader is taken, so subsequent modifications to it will
 		/// not affect the network.
@@ -215,6 +222,12 @@ class IECORESCENE_API ShaderNetwork : public IECore::BlindDataHolder
 		/// based on the provided attributes.
 		void applySubstitutions( const IECore::CompoundObject *attributes );
 
+		/// Returns the result of applying substitutions for each of the attribute
+		/// sets in turn. Attribute sets which yield the same substitutions share
+		/// a single result, and if the network requires no substitutions then
+		/// `this` is returned for every set. Work is performed in parallel.
+		std::vector<ConstShaderNetworkPtr> substitutedNetworks( const std::vector<const IECore::CompoundObject *> &attributeSets ) const;
+
 	private :
 
 		class Implementation;
@@ -0,0 +1,66 @@
+##########################################################################
+#
+#  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import IECore
+
+class IndexedIOBlockStoreCompactOp( IECore.Op ) :
+
+	def __init__( self ) :
+
+		IECore.Op.__init__( self, "Deletes the blocks in an IndexedIOBlockStore which are no longer referenced by any file.",
+			IECore.FloatParameter(
+				name = "result",
+				description = "The number of megabytes freed.",
+				defaultValue = 0,
+			)
+		)
+
+		self.parameters().addParameters(
+			[
+				IECore.DirNameParameter(
+					name = "store",
+					description = "The block store to compact.",
+					defaultValue = "",
+					check = IECore.DirNameParameter.CheckType.MustExist,
+					allowEmptyString = False,
+				),
+			]
+		)
+
+	def doOperation( self, operands ) :
+
+		store = IECore.IndexedIOBlockStore( operands["store"].value )
+		return IECore.FloatData( store.compact() / ( 1024.0 * 1024.0 ) )
+
+IECore.registerRunTimeTyped( IndexedIOBlockStoreCompactOp )
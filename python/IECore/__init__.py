@@ -81,6 +81,7 @@ from OptionalCompoundParameter import OptionalCompoundParameter
 from Struct import Struct
 import Enum
 from LsHeaderOp import LsHeaderOp
+from IndexedIOBlockStoreCompactOp import IndexedIOBlockStoreCompactOp
 from curry import curry
 from MenuItemDefinition import MenuItemDefinition
 from MenuDefinition import MenuDefinition
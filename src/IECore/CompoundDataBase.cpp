@@ -82,7 +82,9 @@ void CompoundDataBase::copyFrom( const Object *other, CopyContext *context )
 		{
 			throw Exception( "Cannot copy CompoundData will NULL data pointers!" );
 		}
-		data[it->first] = context->copy<Data>( it->second.get() );
+		// Members are visited in sorted order, so inserting at the
+		// end is constant time for both node based and flat maps.
+		data.emplace_hint( data.end(), it->first, context->copy<Data>( it->second.get() ) );
 	}
 }
 
@@ -164,10 +166,13 @@ void CompoundDataBase::load( LoadContextPtr context )
 
 	IndexedIO::EntryIDList memberNames;
 	container->entryIds( memberNames );
+	// Sorting first means that each insertion is at the end of the
+	// map, which is constant time for both node based and flat maps.
+	std::sort( memberNames.begin(), memberNames.end() );
 	IndexedIO::EntryIDList::const_iterator it;
 	for( it=memberNames.begin(); it!=memberNames.end(); it++ )
 	{
-		m[*it] = context->load<Data>( container.get(), *it );
+		m.emplace_hint( m.end(), *it, context->load<Data>( container.get(), *it ) );
 	}
 }
 
@@ -76,7 +76,9 @@ void CompoundObject::copyFrom( const Object *other, CopyContext *context )
 		{
 			throw Exception( "Cannot copy CompoundObject will NULL data pointers!" );
 		}
-		m_members[it->first] = context->copy<Object>( it->second.get() );
+		// Members are visited in sorted order, so inserting at the
+		// end is constant time for both node based and flat maps.
+		m_members.emplace_hint( m_members.end(), it->first, context->copy<Object>( it->second.get() ) );
 	}
 }
 
@@ -103,11 +105,14 @@ void CompoundObject::load( LoadContextPtr context )
 
 	IndexedIO::EntryIDList memberNames;
 	container->entryIds( memberNames );
+	// Sorting first means that each insertion is at the end of the
+	// map, which is constant time for both node based and flat maps.
+	std::sort( memberNames.begin(), memberNames.end() );
 	IndexedIO::EntryIDList::const_iterator it;
 
 	for( it=memberNames.begin(); it!=memberNames.end(); it++ )
 	{
-		m_members[*it] = context->load<Object>( container.get(), *it );
+		m_members.emplace_hint( m_members.end(), *it, context->load<Object>( container.get(), *it ) );
 	}
 }
 
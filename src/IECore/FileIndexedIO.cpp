@@ -65,6 +65,8 @@ class FileIndexedIO::StreamFile : public StreamIndexedIO::StreamFile
 
 		static bool canRead( const std::string &path );
 
+		std::string fileName() const override;
+
 		void flush( size_t endPosition ) override;
 
 };
@@ -147,6 +149,11 @@ FileIndexedIO::StreamFile::StreamFile( const std::string &filename, IndexedIO::O
 	}
 }
 
+std::string FileIndexedIO::StreamFile::fileName() const
+{
+	return m_filename;
+}
+
 void FileIndexedIO::StreamFile::flush( size_t endPosition )
 {
 	m_endPosition = endPosition;
@@ -0,0 +1,813 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/FrozenPathMatcher.h"
+
+#include "IECore/Exception.h"
+#include "IECore/StringAlgo.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+using namespace IECore;
+
+namespace
+{
+
+InternedString g_ellipsis( "..." );
+
+// Combining is performed in parallel for the first location
+// encountered that has at least this many children to combine.
+const size_t g_parallelThreshold = 8;
+
+// Child spans smaller than this are searched linearly rather than
+// with a binary search, since that is quicker for small sizes.
+const uint32_t g_linearSearchThreshold = 8;
+
+enum Operation
+{
+	Union,
+	Difference,
+	Intersection
+};
+
+typedef std::vector<IECore::InternedString>::const_iterator NameIterator;
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Tree
+//////////////////////////////////////////////////////////////////////////
+
+class FrozenPathMatcher::Tree : public IECore::RefCounted
+{
+
+	public :
+
+		struct Location
+		{
+
+			Location()
+				:	childrenBegin( 0 ), wildcardsBegin( 0 ), childrenEnd( 0 ), ellipsis( 0 ), terminator( false )
+			{
+			}
+
+			// The children of each location occupy the range
+			// [childrenBegin, childrenEnd). Plain names come first,
+			// sorted by InternedString address, followed by
+			// wildcarded names sorted in the same way.
+			uint32_t childrenBegin;
+			uint32_t wildcardsBegin;
+			uint32_t childrenEnd;
+			// Index of the "..." child, or 0 if there is none.
+			uint32_t ellipsis;
+			bool terminator;
+
+		};
+
+		// Location 0 is always the root. Since the root is never
+		// a child, 0 is also used to mean "no location".
+		Tree()
+			:	locations( 1 ), names( 1 ), numExactMatches( 0 ), numHoles( 0 )
+		{
+		}
+
+		std::vector<Location> locations;
+		// The name of each location, indexed in parallel with `locations`.
+		std::vector<InternedString> names;
+		size_t numExactMatches;
+		// Number of unreachable locations left behind by `combineWalk()`.
+		size_t numHoles;
+
+		bool isEmpty() const
+		{
+			const Location &root = locations[0];
+			return !root.terminator && root.childrenBegin == root.childrenEnd;
+		}
+
+		// Appends `count` default locations, returning the index of the first.
+		uint32_t allocate( size_t count )
+		{
+			const size_t begin = locations.size();
+			if( begin + count > std::numeric_limits<uint32_t>::max() )
+			{
+				throw IECore::Exception( "FrozenPathMatcher : Too many locations" );
+			}
+			locations.resize( begin + count );
+			names.resize( begin + count );
+			return begin;
+		}
+
+		void truncate( size_t size )
+		{
+			locations.resize( size );
+			names.resize( size );
+		}
+
+		// Returns the child with the specified name from the range
+		// [begin, end), or 0 if it doesn't exist.
+		uint32_t child( uint32_t begin, uint32_t end, const InternedString &name ) const
+		{
+			if( end - begin <= g_linearSearchThreshold )
+			{
+				for( uint32_t i = begin; i < end; ++i )
+				{
+					if( names[i] == name )
+					{
+						return i;
+					}
+				}
+				return 0;
+			}
+
+			const InternedString *namesBegin = names.data() + begin;
+			const InternedString *namesEnd = names.data() + end;
+			const InternedString *it = std::lower_bound( namesBegin, namesEnd, name );
+			if( it != namesEnd && *it == name )
+			{
+				return it - names.data();
+			}
+			return 0;
+		}
+
+		// Equivalent to PathMatcher::matchWalk(), but iterating rather
+		// than recursing for as long as there are no wildcards to consider.
+		void matchWalk( uint32_t index, NameIterator start, const NameIterator &end, unsigned &result ) const
+		{
+			while( true )
+			{
+				const Location &location = locations[index];
+				if( start == end )
+				{
+					if( location.terminator )
+					{
+						result |= PathMatcher::ExactMatch;
+					}
+					if( location.childrenBegin != location.childrenEnd )
+					{
+						result |= PathMatcher::DescendantMatch;
+					}
+					if( location.ellipsis )
+					{
+						result |= PathMatcher::DescendantMatch;
+						if( locations[location.ellipsis].terminator )
+						{
+							result |= PathMatcher::ExactMatch;
+						}
+					}
+					return;
+				}
+
+				if( location.terminator )
+				{
+					result |= PathMatcher::AncestorMatch;
+				}
+
+				const uint32_t plainChild = child( location.childrenBegin, location.wildcardsBegin, *start );
+				const NameIterator newStart = start + 1;
+				if( location.wildcardsBegin == location.childrenEnd )
+				{
+					if( !plainChild )
+					{
+						return;
+					}
+					index = plainChild;
+					start = newStart;
+					continue;
+				}
+
+				if( plainChild )
+				{
+					matchWalk( plainChild, newStart, end, result );
+					if( result == PathMatcher::EveryMatch )
+					{
+						return;
+					}
+				}
+
+				for( uint32_t i = location.wildcardsBegin; i < location.childrenEnd; ++i )
+				{
+					if( i == location.ellipsis )
+					{
+						continue;
+					}
+					if( StringAlgo::match( start->c_str(), names[i].c_str() ) )
+					{
+						matchWalk( i, newStart, end, result );
+						if( result == PathMatcher::EveryMatch )
+						{
+							return;
+						}
+					}
+				}
+
+				if( location.ellipsis )
+				{
+					result |= PathMatcher::DescendantMatch;
+					if( locations[location.ellipsis].terminator )
+					{
+						result |= PathMatcher::ExactMatch;
+					}
+
+					for( NameIterator it = start; it != end; ++it )
+					{
+						matchWalk( location.ellipsis, it, end, result );
+						if( result == PathMatcher::EveryMatch )
+						{
+							return;
+						}
+					}
+				}
+
+				return;
+			}
+		}
+
+		void pathsWalk( uint32_t index, const std::string &path, std::vector<std::string> &paths ) const
+		{
+			const Location &location = locations[index];
+			if( location.terminator )
+			{
+				paths.push_back( path.size() ? path : "/" );
+			}
+			for( uint32_t i = location.childrenBegin; i < location.childrenEnd; ++i )
+			{
+				pathsWalk( i, path + "/" + names[i].string(), paths );
+			}
+		}
+
+		// Generates the depth-first stream used by PathMatcher::initDepthFirst().
+		void depthFirstWalk( uint32_t index, unsigned depth, std::vector<InternedString> &depthFirstNames, std::vector<unsigned> &depths, std::vector<unsigned char> &exactMatches ) const
+		{
+			const Location &location = locations[index];
+			if( depth )
+			{
+				depthFirstNames.push_back( names[index] );
+			}
+			depths.push_back( depth );
+			exactMatches.push_back( location.terminator );
+			for( uint32_t i = location.childrenBegin; i < location.childrenEnd; ++i )
+			{
+				depthFirstWalk( i, depth + 1, depthFirstNames, depths, exactMatches );
+			}
+		}
+
+		static bool equalWalk( const Tree &a, uint32_t ai, const Tree &b, uint32_t bi )
+		{
+			const Location &la = a.locations[ai];
+			const Location &lb = b.locations[bi];
+			if(
+				la.terminator != lb.terminator ||
+				la.childrenEnd - la.childrenBegin != lb.childrenEnd - lb.childrenBegin ||
+				la.wildcardsBegin - la.childrenBegin != lb.wildcardsBegin - lb.childrenBegin
+			)
+			{
+				return false;
+			}
+
+			for( uint32_t i = la.childrenBegin, j = lb.childrenBegin; i < la.childrenEnd; ++i, ++j )
+			{
+				if( a.names[i] != b.names[j] || !equalWalk( a, i, b, j ) )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Copies the subtree at `src.locations[srcIndex]` into `locations[index]`,
+		// which must already have been allocated. The name is not copied.
+		void copyWalk( const Tree &src, uint32_t srcIndex, uint32_t index )
+		{
+			const Location &srcLocation = src.locations[srcIndex];
+			Location location;
+			location.terminator = srcLocation.terminator;
+			if( location.terminator )
+			{
+				numExactMatches++;
+			}
+
+			const uint32_t numChildren = srcLocation.childrenEnd - srcLocation.childrenBegin;
+			if( numChildren )
+			{
+				const uint32_t begin = allocate( numChildren );
+				location.childrenBegin = begin;
+				location.wildcardsBegin = begin + ( srcLocation.wildcardsBegin - srcLocation.childrenBegin );
+				location.childrenEnd = begin + numChildren;
+				location.ellipsis = srcLocation.ellipsis ? begin + ( srcLocation.ellipsis - srcLocation.childrenBegin ) : 0;
+				std::copy( src.names.begin() + srcLocation.childrenBegin, src.names.begin() + srcLocation.childrenEnd, names.begin() + begin );
+				for( uint32_t i = 0; i < numChildren; ++i )
+				{
+					copyWalk( src, srcLocation.childrenBegin + i, begin + i );
+				}
+			}
+
+			locations[index] = location;
+		}
+
+		// Pairs of child indices from the two trees being combined,
+		// with 0 denoting a child which exists in only one tree.
+		typedef std::pair<uint32_t, uint32_t> ChildPair;
+		typedef std::vector<ChildPair> ChildPairs;
+
+		// Merges the sorted child ranges from two trees, appending the pairs
+		// which may contribute to the result of `operation`.
+		static void pairChildren( Operation operation, const Tree &a, uint32_t aBegin, uint32_t aEnd, const Tree &b, uint32_t bBegin, uint32_t bEnd, ChildPairs &pairs )
+		{
+			while( aBegin < aEnd || bBegin < bEnd )
+			{
+				if( bBegin == bEnd || ( aBegin < aEnd && a.names[aBegin] < b.names[bBegin] ) )
+				{
+					if( operation != Intersection )
+					{
+						pairs.push_back( ChildPair( aBegin, 0 ) );
+					}
+					aBegin++;
+				}
+				else if( aBegin == aEnd || b.names[bBegin] < a.names[aBegin] )
+				{
+					if( operation == Union )
+					{
+						pairs.push_back( ChildPair( 0, bBegin ) );
+					}
+					bBegin++;
+				}
+				else
+				{
+					pairs.push_back( ChildPair( aBegin++, bBegin++ ) );
+				}
+			}
+		}
+
+		// Fills `locations[index]` with the combination of the two children
+		// in `pair`, returning false if the result is empty. In that case, any
+		// locations allocated by the call must be removed by the caller.
+		bool combineChild( Operation operation, const Tree &a, const Tree &b, const ChildPair &pair, uint32_t index, ChildPairs &pairs, bool parallel )
+		{
+			if( pair.first && pair.second )
+			{
+				return combineWalk( operation, a, pair.first, b, pair.second, index, pairs, parallel );
+			}
+			else if( pair.first )
+			{
+				copyWalk( a, pair.first, index );
+			}
+			else
+			{
+				copyWalk( b, pair.second, index );
+			}
+			return true;
+		}
+
+		// Combines the children in `pairs[pairsBegin:pairsEnd]` into the
+		// block of locations starting at `blockBegin`, returning the number
+		// of non-empty children.
+		uint32_t combineChildren( Operation operation, const Tree &a, const Tree &b, size_t pairsBegin, size_t pairsEnd, uint32_t blockBegin, ChildPairs &pairs, bool parallel, uint32_t &ellipsis )
+		{
+			uint32_t numChildren = 0;
+			for( size_t p = pairsBegin; p < pairsEnd; ++p )
+			{
+				// Copy, because `pairs` is appended to by the recursion.
+				const ChildPair pair = pairs[p];
+				const uint32_t slot = blockBegin + numChildren;
+				const size_t size = locations.size();
+				if( combineChild( operation, a, b, pair, slot, pairs, parallel ) )
+				{
+					names[slot] = pair.first ? a.names[pair.first] : b.names[pair.second];
+					if( names[slot] == g_ellipsis )
+					{
+						ellipsis = slot;
+					}
+					numChildren++;
+				}
+				else
+				{
+					truncate( size );
+				}
+			}
+			return numChildren;
+		}
+
+		// As above, but combining each child into a separate tree in
+		// parallel, and then stitching the results together.
+		uint32_t combineChildrenParallel( Operation operation, const Tree &a, const Tree &b, size_t pairsBegin, size_t pairsEnd, uint32_t blockBegin, const ChildPairs &pairs, uint32_t &ellipsis, uint32_t &wildcardsBegin, size_t wildcardPairsBegin )
+		{
+			const size_t numPairs = pairsEnd - pairsBegin;
+			std::vector<boost::intrusive_ptr<Tree>> fragments( numPairs );
+
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numPairs ),
+				[&]( const tbb::blocked_range<size_t> &range ) {
+					ChildPairs fragmentPairs;
+					for( size_t i = range.begin(); i != range.end(); ++i )
+					{
+						const ChildPair &pair = pairs[pairsBegin + i];
+						boost::intrusive_ptr<Tree> fragment = new Tree;
+						if( fragment->combineChild( operation, a, b, pair, 0, fragmentPairs, /* parallel = */ false ) )
+						{
+							fragment->names[0] = pair.first ? a.names[pair.first] : b.names[pair.second];
+							fragments[i] = fragment;
+						}
+					}
+				},
+				taskGroupContext
+			);
+
+			// The root of each fragment goes into the block, and its
+			// remaining locations are appended contiguously.
+
+			std::vector<uint32_t> slots( numPairs, 0 );
+			std::vector<size_t> offsets( numPairs, 0 );
+			uint32_t numChildren = 0;
+			size_t numFragmentLocations = 0;
+			for( size_t i = 0; i < numPairs; ++i )
+			{
+				if( pairsBegin + i == wildcardPairsBegin )
+				{
+					wildcardsBegin = blockBegin + numChildren;
+				}
+				if( const Tree *fragment = fragments[i].get() )
+				{
+					slots[i] = blockBegin + numChildren++;
+					offsets[i] = numFragmentLocations;
+					numFragmentLocations += fragment->locations.size() - 1;
+					numExactMatches += fragment->numExactMatches;
+					numHoles += fragment->numHoles;
+					if( fragment->names[0] == g_ellipsis )
+					{
+						ellipsis = slots[i];
+					}
+				}
+			}
+			if( wildcardPairsBegin == pairsEnd )
+			{
+				wildcardsBegin = blockBegin + numChildren;
+			}
+
+			truncate( blockBegin + numChildren );
+			const size_t fragmentsBegin = allocate( numFragmentLocations );
+
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numPairs ),
+				[&]( const tbb::blocked_range<size_t> &range ) {
+					for( size_t i = range.begin(); i != range.end(); ++i )
+					{
+						const Tree *fragment = fragments[i].get();
+						if( !fragment )
+						{
+							continue;
+						}
+						// Fragment location `j > 0` maps to `fragmentsBegin + offsets[i] + j - 1`.
+						const uint32_t offset = fragmentsBegin + offsets[i] - 1;
+						for( size_t j = 0, e = fragment->locations.size(); j < e; ++j )
+						{
+							Location location = fragment->locations[j];
+							if( location.childrenBegin != location.childrenEnd )
+							{
+								location.childrenBegin += offset;
+								location.wildcardsBegin += offset;
+								location.childrenEnd += offset;
+							}
+							if( location.ellipsis )
+							{
+								location.ellipsis += offset;
+							}
+							const size_t index = j ? offset + j : slots[i];
+							locations[index] = location;
+							names[index] = fragment->names[j];
+						}
+					}
+				},
+				taskGroupContext
+			);
+
+			return numChildren;
+		}
+
+		// Fills `locations[index]` with the combination of the two locations,
+		// returning false if the result is empty.
+		bool combineWalk( Operation operation, const Tree &a, uint32_t ai, const Tree &b, uint32_t bi, uint32_t index, ChildPairs &pairs, bool parallel )
+		{
+			const Location &la = a.locations[ai];
+			const Location &lb = b.locations[bi];
+
+			Location location;
+			switch( operation )
+			{
+				case Union :
+					location.terminator = la.terminator || lb.terminator;
+					break;
+				case Difference :
+					location.terminator = la.terminator && !lb.terminator;
+					break;
+				case Intersection :
+					location.terminator = la.terminator && lb.terminator;
+					break;
+			}
+
+			const size_t pairsBegin = pairs.size();
+			pairChildren( operation, a, la.childrenBegin, la.wildcardsBegin, b, lb.childrenBegin, lb.wildcardsBegin, pairs );
+			const size_t wildcardPairsBegin = pairs.size();
+			pairChildren( operation, a, la.wildcardsBegin, la.childrenEnd, b, lb.wildcardsBegin, lb.childrenEnd, pairs );
+			const size_t pairsEnd = pairs.size();
+
+			const size_t numPairs = pairsEnd - pairsBegin;
+			if( numPairs )
+			{
+				const uint32_t blockBegin = allocate( numPairs );
+				uint32_t numChildren = 0;
+				if( parallel && numPairs >= g_parallelThreshold )
+				{
+					numChildren = combineChildrenParallel( operation, a, b, pairsBegin, pairsEnd, blockBegin, pairs, location.ellipsis, location.wildcardsBegin, wildcardPairsBegin );
+				}
+				else
+				{
+					numChildren = combineChildren( operation, a, b, pairsBegin, wildcardPairsBegin, blockBegin, pairs, parallel, location.ellipsis );
+					location.wildcardsBegin = blockBegin + numChildren;
+					numChildren += combineChildren( operation, a, b, wildcardPairsBegin, pairsEnd, blockBegin + numChildren, pairs, parallel, location.ellipsis );
+					if( locations.size() == blockBegin + numPairs )
+					{
+						// Nothing follows the block, so we can
+						// discard any unused slots at the end.
+						truncate( blockBegin + numChildren );
+					}
+					else
+					{
+						numHoles += numPairs - numChildren;
+					}
+				}
+
+				if( numChildren )
+				{
+					location.childrenBegin = blockBegin;
+					location.childrenEnd = blockBegin + numChildren;
+				}
+				else
+				{
+					location.wildcardsBegin = location.ellipsis = 0;
+				}
+			}
+
+			pairs.resize( pairsBegin );
+
+			if( !location.terminator && location.childrenBegin == location.childrenEnd )
+			{
+				locations[index] = Location();
+				return false;
+			}
+
+			if( location.terminator )
+			{
+				numExactMatches++;
+			}
+			locations[index] = location;
+			return true;
+		}
+
+		static boost::intrusive_ptr<const Tree> combine( Operation operation, const Tree &a, const Tree &b )
+		{
+			boost::intrusive_ptr<Tree> result = new Tree;
+			ChildPairs pairs;
+			result->combineWalk( operation, a, 0, b, 0, 0, pairs, /* parallel = */ true );
+			if( !result->numHoles )
+			{
+				return result;
+			}
+
+			// Remove the unreachable locations left behind
+			// by children which turned out to be empty.
+			boost::intrusive_ptr<Tree> compacted = new Tree;
+			compacted->copyWalk( *result, 0, 0 );
+			return compacted;
+		}
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// FrozenPathMatcher
+//////////////////////////////////////////////////////////////////////////
+
+const size_t FrozenPathMatcher::npos = std::numeric_limits<size_t>::max();
+
+FrozenPathMatcher::FrozenPathMatcher()
+	:	m_tree( new Tree )
+{
+}
+
+FrozenPathMatcher::FrozenPathMatcher( const PathMatcher &matcher )
+{
+	// Lay out the locations breadth first, allocating a
+	// contiguous block for the children of each location.
+	// ChildMap is already sorted in the order we require.
+
+	boost::intrusive_ptr<Tree> tree = new Tree;
+	typedef std::pair<const PathMatcher::Node *, uint32_t> QueueEntry;
+	std::vector<QueueEntry> queue;
+	queue.push_back( QueueEntry( matcher.m_root.get(), 0 ) );
+	for( size_t q = 0; q < queue.size(); ++q )
+	{
+		const PathMatcher::Node *node = queue[q].first;
+		Tree::Location location;
+		location.terminator = node->terminator;
+		if( location.terminator )
+		{
+			tree->numExactMatches++;
+		}
+
+		if( const size_t numChildren = node->children.size() )
+		{
+			const uint32_t begin = tree->allocate( numChildren );
+			location.childrenBegin = begin;
+			location.childrenEnd = location.wildcardsBegin = begin + numChildren;
+			uint32_t i = begin;
+			for( PathMatcher::Node::ConstChildMapIterator it = node->children.begin(), eIt = node->children.end(); it != eIt; ++it, ++i )
+			{
+				tree->names[i] = it->first.name;
+				if( it->first.type == PathMatcher::Name::Wildcarded && location.wildcardsBegin == location.childrenEnd )
+				{
+					location.wildcardsBegin = i;
+				}
+				if( it->first.name == g_ellipsis )
+				{
+					location.ellipsis = i;
+				}
+				queue.push_back( QueueEntry( it->second.get(), i ) );
+			}
+		}
+
+		tree->locations[queue[q].second] = location;
+	}
+
+	m_tree = tree;
+}
+
+FrozenPathMatcher::FrozenPathMatcher( const FrozenPathMatcher &other )
+	:	m_tree( other.m_tree )
+{
+}
+
+FrozenPathMatcher::FrozenPathMatcher( const ConstTreePtr &tree )
+	:	m_tree( tree )
+{
+}
+
+FrozenPathMatcher::~FrozenPathMatcher()
+{
+}
+
+FrozenPathMatcher &FrozenPathMatcher::operator = ( const FrozenPathMatcher &other )
+{
+	m_tree = other.m_tree;
+	return *this;
+}
+
+PathMatcher FrozenPathMatcher::thaw() const
+{
+	PathMatcher result;
+	if( m_tree->isEmpty() )
+	{
+		return result;
+	}
+
+	std::vector<InternedString> names;
+	std::vector<unsigned> depths;
+	std::vector<unsigned char> exactMatches;
+	names.reserve( m_tree->locations.size() );
+	depths.reserve( m_tree->locations.size() );
+	exactMatches.reserve( m_tree->locations.size() );
+	m_tree->depthFirstWalk( 0, 0, names, depths, exactMatches );
+
+	result.initDepthFirst( names.data(), names.size(), depths.data(), exactMatches.data(), depths.size() );
+	return result;
+}
+
+bool FrozenPathMatcher::isEmpty() const
+{
+	return m_tree->isEmpty();
+}
+
+size_t FrozenPathMatcher::size() const
+{
+	return m_tree->numExactMatches;
+}
+
+void FrozenPathMatcher::paths( std::vector<std::string> &paths ) const
+{
+	m_tree->pathsWalk( 0, "", paths );
+}
+
+unsigned FrozenPathMatcher::match( const std::string &path ) const
+{
+	if( path.empty() )
+	{
+		return PathMatcher::NoMatch;
+	}
+	std::vector<IECore::InternedString> tokenizedPath;
+	StringAlgo::tokenize( path, '/', tokenizedPath );
+	return match( tokenizedPath );
+}
+
+unsigned FrozenPathMatcher::match( const std::vector<IECore::InternedString> &path ) const
+{
+	unsigned result = PathMatcher::NoMatch;
+	m_tree->matchWalk( 0, path.begin(), path.end(), result );
+	return result;
+}
+
+size_t FrozenPathMatcher::find( const std::vector<IECore::InternedString> &path ) const
+{
+	if( m_tree->isEmpty() )
+	{
+		return npos;
+	}
+
+	uint32_t index = 0;
+	for( const auto &name : path )
+	{
+		const Tree::Location &location = m_tree->locations[index];
+		uint32_t child = m_tree->child( location.childrenBegin, location.wildcardsBegin, name );
+		if( !child )
+		{
+			child = m_tree->child( location.wildcardsBegin, location.childrenEnd, name );
+			if( !child )
+			{
+				return npos;
+			}
+		}
+		index = child;
+	}
+
+	return index;
+}
+
+bool FrozenPathMatcher::exactMatch( size_t location ) const
+{
+	return m_tree->locations[location].terminator;
+}
+
+FrozenPathMatcher FrozenPathMatcher::unionWith( const FrozenPathMatcher &paths ) const
+{
+	return FrozenPathMatcher( Tree::combine( Union, *m_tree, *paths.m_tree ) );
+}
+
+FrozenPathMatcher FrozenPathMatcher::difference( const FrozenPathMatcher &paths ) const
+{
+	return FrozenPathMatcher( Tree::combine( Difference, *m_tree, *paths.m_tree ) );
+}
+
+FrozenPathMatcher FrozenPathMatcher::intersection( const FrozenPathMatcher &paths ) const
+{
+	return FrozenPathMatcher( Tree::combine( Intersection, *m_tree, *paths.m_tree ) );
+}
+
+bool FrozenPathMatcher::operator == ( const FrozenPathMatcher &other ) const
+{
+	if( m_tree == other.m_tree )
+	{
+		return true;
+	}
+	return m_tree->numExactMatches == other.m_tree->numExactMatches && Tree::equalWalk( *m_tree, 0, *other.m_tree, 0 );
+}
+
+bool FrozenPathMatcher::operator != ( const FrozenPathMatcher &other ) const
+{
+	return !( *this == other );
+}
@@ -38,52 +38,57 @@
 #include "IECore/Exception.h"
 #include "IECore/TestTypedData.h"
 
-#include <fstream>
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 using namespace IECore;
 
-IFFFile::IFFFile( const std::string &fileName ) : m_iStream( nullptr ), m_streamFileName( fileName ), m_root( nullptr )
+IFFFile::IFFFile( const std::string &fileName ) : m_data( nullptr ), m_size( 0 ), m_streamFileName( fileName ), m_root( nullptr )
 {
 }
 
 IFFFile::~IFFFile()
 {
-	delete m_iStream;
 }
 
 bool IFFFile::open()
 {
-	if( !m_iStream || !m_root )
+	if( !m_root )
 	{
-		delete m_iStream;
-		m_iStream = new std::ifstream( m_streamFileName.c_str() );
-		if( !m_iStream->is_open() || !m_iStream->good() )
+		m_region.reset();
+		m_data = nullptr;
+		m_size = 0;
+
+		try
+		{
+			boost::interprocess::file_mapping file( m_streamFileName.c_str(), boost::interprocess::read_only );
+			m_region.reset( new boost::interprocess::mapped_region( file, boost::interprocess::read_only ) );
+		}
+		catch( const boost::interprocess::interprocess_exception & )
 		{
+			// missing, unreadable or empty file
 			return false;
 		}
 
-		delete m_root;
-		std::streampos begin = m_iStream->tellg();
-
-		char id[4];
-		m_iStream->read( id, 4 );
-		if( !m_iStream->good() )
+		m_data = static_cast<const char *>( m_region->get_address() );
+		m_size = m_region->get_size();
+		if( m_size < (size_t)IFFFile::Tag::TagSize )
 		{
 			return false;
 		}
 
-		IFFFile::Tag testTag( id );
+		IFFFile::Tag testTag( m_data );
 		if( !testTag.isGroup() )
 		{
 			return false;
 		}
 
-		m_iStream->seekg( 0, std::ios_base::end );
-		std::streampos end = m_iStream->tellg();
-		m_root = new IFFFile::Chunk( "FOR4", end - begin, this, begin, 4 );
-		m_iStream->seekg( 0, std::ios_base::beg );
+		m_root = new IFFFile::Chunk( "FOR4", m_size, this, 0, 4 );
 	}
-	return m_iStream->good() && m_root;
+	return m_root;
 }
 
 IFFFile::Chunk::Chunk()
@@ -164,22 +169,32 @@ void IFFFile::Chunk::ls()
 
 void IFFFile::Chunk::readHeader( std::streampos *pos )
 {
-	m_file->m_iStream->seekg( *pos, std::ios_base::beg );
+	size_t position = (std::streamoff)*pos;
+	const size_t headerSize = IFFFile::Tag::TagSize + sizeof( m_dataSize );
+	if( position + headerSize > m_file->m_size )
+	{
+		throw IOException( ( boost::format( "Truncated chunk header in \"%s\"." ) % m_file->m_streamFileName ).str() );
+	}
 
 	// read type
-	char tagBuffer[IFFFile::Tag::TagSize];
-	m_file->m_iStream->read( tagBuffer, IFFFile::Tag::TagSize );
-	m_type = IFFFile::Tag( tagBuffer );
+	m_type = IFFFile::Tag( m_file->m_data + position );
+	position += IFFFile::Tag::TagSize;
 
 	// read dataSize
-	m_file->m_iStream->read( (char *)&m_dataSize, sizeof(m_dataSize) );
+	memcpy( &m_dataSize, m_file->m_data + position, sizeof( m_dataSize ) );
 	m_dataSize = asBigEndian( m_dataSize );
+	position += sizeof( m_dataSize );
 
 	if ( isGroup() )
 	{
+		if( position + IFFFile::Tag::TagSize > m_file->m_size )
+		{
+			throw IOException( ( boost::format( "Truncated group header in \"%s\"." ) % m_file->m_streamFileName ).str() );
+		}
+
 		// read groupName
-		m_file->m_iStream->read( tagBuffer, IFFFile::Tag::TagSize );
-		m_groupName = IFFFile::Tag( tagBuffer );
+		m_groupName = IFFFile::Tag( m_file->m_data + position );
+		position += IFFFile::Tag::TagSize;
 
 		// modify dataSize
 		m_dataSize -= IFFFile::Tag::TagSize;
@@ -189,19 +204,18 @@ void IFFFile::Chunk::readHeader( std::streampos *pos )
 	}
 
 	// set the file position of the data
-	m_filePosition = m_file->m_iStream->tellg();
+	m_filePosition = position;
 	*pos = m_filePosition;
 }
 
 void IFFFile::Chunk::read( std::string &data )
 {
-	m_file->m_iStream->seekg( m_filePosition, std::ios_base::beg );
-
-	std::vector<char> buffer( m_dataSize );
-	m_file->m_iStream->read( buffer.data(), m_dataSize );
+	const size_t position = (std::streamoff)m_filePosition;
+	const size_t size = std::min<size_t>( m_dataSize, m_file->m_size - std::min( position, m_file->m_size ) );
 
-	data.clear();
-	data = buffer.data();
+	// the string is null terminated within the chunk
+	const char *begin = m_file->m_data + position;
+	data.assign( begin, std::find( begin, begin + size, '\0' ) );
 }
 
 int IFFFile::Chunk::alignmentQuota()
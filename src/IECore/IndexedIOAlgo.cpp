@@ -34,10 +34,13 @@
 
 #include "IECore/IndexedIOAlgo.h"
 
+#include "tbb/pipeline.h"
 #include "tbb/task_scheduler_init.h"
 #include "tbb/task.h"
 
 #include <atomic>
+#include <functional>
+#include <memory>
 
 using namespace IECore;
 using namespace IECore::IndexedIOAlgo;
@@ -45,23 +48,31 @@ using namespace IECore::IndexedIOAlgo;
 namespace
 {
 
+// Reads a file, storing a function which will write it to the
+// destination into the callback. The callback is a CopyItem.
 template<typename T, typename Callback>
-class Copier
+class Loader
 {
 	public:
 		void handleValue( const IndexedIO *src, IndexedIO *dst, const IndexedIO::Entry &entry, Callback &callback )
 		{
 			T value;
 			src->read( entry.id(), value );
-			dst->write( entry.id(), value );
+			const IndexedIO::EntryID id = entry.id();
+			callback.write = [id, value]( IndexedIO *dst ) {
+				dst->write( id, value );
+			};
 		}
 
 		void handleArray( const IndexedIO *src, IndexedIO *dst, const IndexedIO::Entry &entry, Callback &callback )
 		{
-			std::vector<T> array( entry.arrayLength() );
-			T *ptr = array.data();
+			std::shared_ptr<std::vector<T> > array( new std::vector<T>( entry.arrayLength() ) );
+			T *ptr = array->data();
 			src->read( entry.id(), ptr, entry.arrayLength() );
-			dst->write( entry.id(), ptr, entry.arrayLength() );
+			const IndexedIO::EntryID id = entry.id();
+			callback.write = [id, array]( IndexedIO *dst ) {
+				dst->write( id, array->data(), array->size() );
+			};
 		}
 };
 
@@ -207,26 +218,100 @@ void handleFile( const IndexedIO *src, IndexedIO *dst, IndexedIO::EntryID fileNa
 	}
 }
 
-void recursiveCopy( const IndexedIO *src, IndexedIO *dst )
+// A directory being copied. Directories are created in the destination by
+// the writer, so `dst` and `parent` are only accessed from the writer stage.
+struct CopyDirectory
 {
-	IndexedIO::EntryIDList fileNames;
-	src->entryIds( fileNames, IndexedIO::EntryType::File );
+	ConstIndexedIOPtr src;
+	IndexedIOPtr dst;
+	std::shared_ptr<CopyDirectory> parent;
+	IndexedIO::EntryID name;
+};
 
-	for( const auto &fileName : fileNames )
-	{
-		int dummy = 0;
-		handleFile<Copier, int>( src, dst, fileName, dummy );
-	}
+typedef std::shared_ptr<CopyDirectory> CopyDirectoryPtr;
 
-	IndexedIO::EntryIDList directoryNames;
-	src->entryIds( directoryNames, IndexedIO::EntryType::Directory );
+// A unit of work flowing through the copy pipeline. Items for a
+// directory have no fileName and just ensure that the directory is
+// created, even if it is empty.
+struct CopyItem
+{
+	CopyDirectoryPtr directory;
+	IndexedIO::EntryID fileName;
+	std::function<void ( IndexedIO * )> write;
+};
 
-	for( const auto &directoryName : directoryNames )
-	{
-		IndexedIOPtr childDst = dst->subdirectory( directoryName, IndexedIO::CreateIfMissing );
-		recursiveCopy( src->subdirectory( directoryName, IndexedIO::ThrowIfMissing ).get(), childDst.get() );
-	}
-}
+typedef std::shared_ptr<CopyItem> CopyItemPtr;
+
+// Generates CopyItems in the order of a serial depth first copy : the files
+// of a directory, followed by each of its subdirectories in turn.
+class CopyTraversal
+{
+
+	public :
+
+		CopyTraversal( const IndexedIO *src, IndexedIO *dst )
+			:	m_nextFile( 0 )
+		{
+			CopyDirectoryPtr root( new CopyDirectory );
+			root->src = src;
+			root->dst = dst;
+			m_stack.push_back( root );
+		}
+
+		CopyItemPtr next()
+		{
+			while( true )
+			{
+				if( m_directory && m_nextFile < m_fileNames.size() )
+				{
+					CopyItemPtr item( new CopyItem );
+					item->directory = m_directory;
+					item->fileName = m_fileNames[m_nextFile++];
+					return item;
+				}
+
+				if( m_directory )
+				{
+					// push the subdirectories in reverse, so that they
+					// are popped in their natural order.
+					IndexedIO::EntryIDList directoryNames;
+					m_directory->src->entryIds( directoryNames, IndexedIO::EntryType::Directory );
+					for( IndexedIO::EntryIDList::const_reverse_iterator it = directoryNames.rbegin(); it != directoryNames.rend(); ++it )
+					{
+						CopyDirectoryPtr child( new CopyDirectory );
+						child->src = m_directory->src->subdirectory( *it, IndexedIO::ThrowIfMissing );
+						child->parent = m_directory;
+						child->name = *it;
+						m_stack.push_back( child );
+					}
+					m_directory.reset();
+				}
+
+				if( m_stack.empty() )
+				{
+					return CopyItemPtr();
+				}
+
+				m_directory = m_stack.back();
+				m_stack.pop_back();
+				m_fileNames.clear();
+				m_directory->src->entryIds( m_fileNames, IndexedIO::EntryType::File );
+				m_nextFile = 0;
+
+				CopyItemPtr item( new CopyItem );
+				item->directory = m_directory;
+				return item;
+			}
+		}
+
+	private :
+
+		std::vector<CopyDirectoryPtr> m_stack;
+		CopyDirectoryPtr m_directory;
+		IndexedIO::EntryIDList m_fileNames;
+		size_t m_nextFile;
+
+};
 
 //! Task for traversing all files in parallel. New tasks are spawned for each directory
 template<template<typename, typename> class FileHandler, typename FileCallback>
@@ -291,7 +376,53 @@ namespace IndexedIOAlgo
 
 void copy( const IndexedIO *src, IndexedIO *dst )
 {
-	::recursiveCopy( src, dst );
+	CopyTraversal traversal( src, dst );
+
+	// limit the number of files in flight, so that memory
+	// usage is bounded if the writer can't keep up.
+	const size_t maxItems = 4 * tbb::task_scheduler_init::default_num_threads();
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_pipeline(
+		maxItems,
+		tbb::make_filter<void, CopyItemPtr>(
+			tbb::filter::serial_in_order,
+			[&traversal]( tbb::flow_control &flowControl ) -> CopyItemPtr {
+				CopyItemPtr item = traversal.next();
+				if( !item )
+				{
+					flowControl.stop();
+				}
+				return item;
+			}
+		) &
+		tbb::make_filter<CopyItemPtr, CopyItemPtr>(
+			tbb::filter::parallel,
+			[]( CopyItemPtr item ) -> CopyItemPtr {
+				if( !item->fileName.string().empty() )
+				{
+					handleFile<Loader, CopyItem>( item->directory->src.get(), nullptr, item->fileName, *item );
+				}
+				return item;
+			}
+		) &
+		tbb::make_filter<CopyItemPtr, void>(
+			tbb::filter::serial_in_order,
+			[]( CopyItemPtr item ) {
+				CopyDirectory *directory = item->directory.get();
+				if( !directory->dst )
+				{
+					directory->dst = directory->parent->dst->subdirectory( directory->name, IndexedIO::CreateIfMissing );
+					directory->parent.reset();
+				}
+				if( item->write )
+				{
+					item->write( directory->dst.get() );
+				}
+			}
+		),
+		taskGroupContext
+	);
 }
 
 FileStats<size_t> parallelReadAll( const IndexedIO *src )
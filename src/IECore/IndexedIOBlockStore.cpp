@@ -0,0 +1,353 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/IndexedIOBlockStore.h"
+
+#include "IECore/ByteOrder.h"
+#include "IECore/Exception.h"
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/format.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+using namespace IECore;
+
+namespace fs = boost::filesystem;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// Layout of the store :
+///
+/// <path>/blocks/<first two characters of hash>/<hash>
+/// <path>/manifests/<hash of referencing file name>
+///
+/// Manifest ::= Version FileNameLength FileName NumHashes Hash*
+/// Version ::= uint64
+/// FileNameLength ::= uint64
+/// NumHashes ::= uint64
+/// Hash ::= uint64 uint64
+
+const uint64_t g_manifestVersion = 1;
+
+template<typename T>
+void writeLittleEndian( std::ostream &o, T n )
+{
+	n = asLittleEndian( n );
+	o.write( (const char *)&n, sizeof( T ) );
+}
+
+template<typename T>
+void readLittleEndian( std::istream &i, T &n )
+{
+	i.read( (char *)&n, sizeof( T ) );
+	n = asLittleEndian( n );
+}
+
+bool hashFromString( const std::string &s, MurmurHash &hash )
+{
+	if( s.size() != 32 || s.find_first_not_of( "0123456789abcdef" ) != std::string::npos )
+	{
+		return false;
+	}
+
+	hash = MurmurHash(
+		strtoull( s.substr( 0, 16 ).c_str(), nullptr, 16 ),
+		strtoull( s.substr( 16, 16 ).c_str(), nullptr, 16 )
+	);
+	return true;
+}
+
+/// Writes to a uniquely named temporary file alongside 'fileName' and then renames
+/// it into place, so that readers never see a partially written file.
+template<typename F>
+void writeAtomically( const fs::path &fileName, F &&writer )
+{
+	fs::create_directories( fileName.parent_path() );
+
+	const fs::path tmpFileName = fileName.parent_path() / fs::unique_path( fileName.filename().string() + ".%%%%%%%%.tmp" );
+	{
+		std::ofstream o( tmpFileName.string().c_str(), std::ios::binary | std::ios::trunc );
+		if( !o.is_open() )
+		{
+			throw IOException( "IndexedIOBlockStore : Cannot open \"" + tmpFileName.string() + "\" for writing" );
+		}
+		writer( o );
+		if( !o.good() )
+		{
+			o.close();
+			fs::remove( tmpFileName );
+			throw IOException( "IndexedIOBlockStore : Error writing \"" + tmpFileName.string() + "\"" );
+		}
+	}
+
+	fs::rename( tmpFileName, fileName );
+}
+
+bool readManifest( const fs::path &manifestFileName, std::string &fileName, std::vector<MurmurHash> &hashes )
+{
+	std::ifstream i( manifestFileName.string().c_str(), std::ios::binary );
+	if( !i.is_open() )
+	{
+		return false;
+	}
+
+	uint64_t version = 0, fileNameLength = 0, numHashes = 0;
+	readLittleEndian( i, version );
+	if( version != g_manifestVersion )
+	{
+		throw IOException( "IndexedIOBlockStore : Unsupported manifest version in \"" + manifestFileName.string() + "\"" );
+	}
+
+	readLittleEndian( i, fileNameLength );
+	fileName.resize( fileNameLength );
+	i.read( &fileName[0], fileNameLength );
+
+	readLittleEndian( i, numHashes );
+	hashes.reserve( hashes.size() + numHashes );
+	for( uint64_t h = 0; h < numHashes; ++h )
+	{
+		uint64_t h1 = 0, h2 = 0;
+		readLittleEndian( i, h1 );
+		readLittleEndian( i, h2 );
+		hashes.push_back( MurmurHash( h1, h2 ) );
+	}
+
+	if( !i.good() )
+	{
+		throw IOException( "IndexedIOBlockStore : Truncated manifest \"" + manifestFileName.string() + "\"" );
+	}
+
+	return true;
+}
+
+std::string absoluteFileName( const std::string &fileName )
+{
+	return fs::absolute( fs::path( fileName ) ).string();
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// IndexedIOBlockStore
+//////////////////////////////////////////////////////////////////////////
+
+IndexedIOBlockStore::IndexedIOBlockStore( const std::string &path )
+	:	m_path( absoluteFileName( path ) )
+{
+}
+
+IndexedIOBlockStore::~IndexedIOBlockStore()
+{
+}
+
+const std::string &IndexedIOBlockStore::path() const
+{
+	return m_path;
+}
+
+bool IndexedIOBlockStore::contains( const MurmurHash &hash ) const
+{
+	return fs::exists( blockFileName( hash ) );
+}
+
+void IndexedIOBlockStore::write( const MurmurHash &hash, const char *data, size_t size )
+{
+	const fs::path fileName = blockFileName( hash );
+	boost::system::error_code ec;
+	const uintmax_t existingSize = fs::file_size( fileName, ec );
+	if( !ec && existingSize == size )
+	{
+		// Already stored, possibly by another file.
+		return;
+	}
+
+	writeAtomically( fileName, [data, size] ( std::ostream &o ) { o.write( data, size ); } );
+}
+
+void IndexedIOBlockStore::read( const MurmurHash &hash, char *buffer, size_t size ) const
+{
+	const std::string fileName = blockFileName( hash );
+	std::ifstream i( fileName.c_str(), std::ios::binary );
+	if( !i.is_open() )
+	{
+		throw IOException( "IndexedIOBlockStore : Missing block \"" + fileName + "\"" );
+	}
+
+	i.read( buffer, size );
+	if( (size_t)i.gcount() != size )
+	{
+		throw IOException(
+			boost::str(
+				boost::format( "IndexedIOBlockStore : Block \"%1%\" is %2% bytes but %3% were expected" ) % fileName % i.gcount() % size
+			)
+		);
+	}
+}
+
+void IndexedIOBlockStore::setReferences( const std::string &fileName, const std::vector<MurmurHash> &hashes )
+{
+	const std::string absFileName = absoluteFileName( fileName );
+	writeAtomically(
+		manifestFileName( fileName ),
+		[&absFileName, &hashes] ( std::ostream &o ) {
+			writeLittleEndian<uint64_t>( o, g_manifestVersion );
+			writeLittleEndian<uint64_t>( o, absFileName.size() );
+			o.write( absFileName.c_str(), absFileName.size() );
+			writeLittleEndian<uint64_t>( o, hashes.size() );
+			for( const auto &h : hashes )
+			{
+				writeLittleEndian( o, h.h1() );
+				writeLittleEndian( o, h.h2() );
+			}
+		}
+	);
+}
+
+bool IndexedIOBlockStore::getReferences( const std::string &fileName, std::vector<MurmurHash> &hashes ) const
+{
+	std::string manifestSource;
+	return readManifest( manifestFileName( fileName ), manifestSource, hashes );
+}
+
+void IndexedIOBlockStore::removeReferences( const std::string &fileName )
+{
+	fs::remove( manifestFileName( fileName ) );
+}
+
+void IndexedIOBlockStore::referenceCounts( ReferenceCounts &counts ) const
+{
+	const fs::path blocksPath = fs::path( m_path ) / "blocks";
+	if( fs::is_directory( blocksPath ) )
+	{
+		for( fs::recursive_directory_iterator it( blocksPath ), eIt; it != eIt; ++it )
+		{
+			MurmurHash hash;
+			if( fs::is_regular_file( it->status() ) && hashFromString( it->path().filename().string(), hash ) )
+			{
+				counts.insert( ReferenceCounts::value_type( hash, 0 ) );
+			}
+		}
+	}
+
+	const fs::path manifestsPath = fs::path( m_path ) / "manifests";
+	if( !fs::is_directory( manifestsPath ) )
+	{
+		return;
+	}
+
+	for( fs::directory_iterator it( manifestsPath ), eIt; it != eIt; ++it )
+	{
+		std::string manifestSource;
+		std::vector<MurmurHash> hashes;
+		if( !fs::is_regular_file( it->status() ) || !readManifest( it->path(), manifestSource, hashes ) )
+		{
+			continue;
+		}
+
+		// A file may reference the same block many times, but
+		// that only counts as one reference.
+		std::sort( hashes.begin(), hashes.end() );
+		hashes.erase( std::unique( hashes.begin(), hashes.end() ), hashes.end() );
+		for( const auto &h : hashes )
+		{
+			counts[h]++;
+		}
+	}
+}
+
+size_t IndexedIOBlockStore::compact()
+{
+	const fs::path manifestsPath = fs::path( m_path ) / "manifests";
+	if( fs::is_directory( manifestsPath ) )
+	{
+		std::vector<fs::path> staleManifests;
+		for( fs::directory_iterator it( manifestsPath ), eIt; it != eIt; ++it )
+		{
+			std::string manifestSource;
+			std::vector<MurmurHash> hashes;
+			if( fs::is_regular_file( it->status() ) && readManifest( it->path(), manifestSource, hashes ) && !fs::exists( manifestSource ) )
+			{
+				staleManifests.push_back( it->path() );
+			}
+		}
+
+		for( const auto &m : staleManifests )
+		{
+			fs::remove( m );
+		}
+	}
+
+	ReferenceCounts counts;
+	referenceCounts( counts );
+
+	size_t freed = 0;
+	for( const auto &c : counts )
+	{
+		if( c.second )
+		{
+			continue;
+		}
+
+		const fs::path fileName = blockFileName( c.first );
+		boost::system::error_code ec;
+		const uintmax_t size = fs::file_size( fileName, ec );
+		if( !ec && fs::remove( fileName, ec ) )
+		{
+			freed += size;
+		}
+	}
+
+	return freed;
+}
+
+std::string IndexedIOBlockStore::blockFileName( const MurmurHash &hash ) const
+{
+	const std::string h = hash.toString();
+	return ( fs::path( m_path ) / "blocks" / h.substr( 0, 2 ) / h ).string();
+}
+
+std::string IndexedIOBlockStore::manifestFileName( const std::string &fileName ) const
+{
+	MurmurHash h;
+	h.append( absoluteFileName( fileName ) );
+	return ( fs::path( m_path ) / "manifests" / h.toString() ).string();
+}
@@ -35,13 +35,16 @@
 #include "IECore/InternedString.h"
 
 #include "boost/lexical_cast.hpp"
-#include "boost/multi_index/hashed_index.hpp"
-#include "boost/multi_index_container.hpp"
 
 #include "tbb/concurrent_hash_map.h"
 #include "tbb/spin_rw_mutex.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
 #include <string.h>
+#include <vector>
 
 namespace IECore
 {
@@ -49,150 +52,272 @@ namespace IECore
 namespace Detail
 {
 
-// Simple type for specifying a range of characters, to
-// represent non-null-terminated strings.
-typedef std::pair<const char *, const char *> CharRange;
+// The table of unique strings is split into shards, each with its own lock,
+// so that threads interning different strings rarely contend with one another.
+// Each shard is an open addressing hash table of pointers to Entries, which
+// store the string along with its precomputed hash. Entries live in an
+// append-only arena and are never moved or freed, so InternedStrings
+// may point directly to them.
 
-// Hash for strings of various types.
-// By overloading it for multiple types, we are able to do
-// lookups into HashSet using any type as a key, and without
-// needing to construct a temporary std::string when the type
-// is a raw c string.
-struct Hash
+struct Entry
 {
 
-	// Dan Bernstein's original string hash
-	size_t operator()( const char *s ) const
+	Entry( const char *s, size_t length, uint64_t hash )
+		:	string( s, length ), hash( hash )
 	{
-		size_t hash = 5381;
-		while( *s )
-		{
-			hash = ( ( hash << 5 ) + hash ) + *s++;
-		}
-
-		return hash;
 	}
 
-	size_t operator()( const std::string &s ) const
+	const std::string string;
+	const uint64_t hash;
+
+};
+
+// Dan Bernstein's original string hash, followed by the
+// MurmurHash3 finalizer so that the high bits (which select
+// the shard) are as well distributed as the low bits (which
+// select the slot within the shard).
+inline uint64_t hash( const char *s, size_t length )
+{
+	uint64_t h = 5381;
+	for( const char *e = s + length; s != e; ++s )
 	{
-		return (*this)( s.c_str() );
+		h = ( ( h << 5 ) + h ) + *s;
 	}
 
-	size_t operator()( const CharRange &range ) const
-	{
-		size_t hash = 5381;
-		for( const char *s = range.first; s != range.second; ++s )
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+const size_t g_numShardsLog2 = 6;
+const size_t g_numShards = 1 << g_numShardsLog2;
+
+inline size_t shardIndex( uint64_t hash )
+{
+	return hash >> ( 64 - g_numShardsLog2 );
+}
+
+// Aligned to avoid false sharing between the locks of neighbouring shards.
+class alignas( 64 ) Shard
+{
+
+	public :
+
+		typedef tbb::spin_rw_mutex Mutex;
+
+		Shard()
+			:	m_slots( 64, nullptr ), m_size( 0 )
 		{
-			hash = ( ( hash << 5 ) + hash ) + *s;
 		}
 
-		return hash;
-	}
+		// Must be called with at least a read lock held.
+		const Entry *find( const char *s, size_t length, uint64_t hash ) const
+		{
+			const size_t mask = m_slots.size() - 1;
+			for( size_t i = hash & mask; ; i = ( i + 1 ) & mask )
+			{
+				const Entry *e = m_slots[i];
+				if( !e )
+				{
+					return nullptr;
+				}
+				if( e->hash == hash && e->string.size() == length && memcmp( e->string.c_str(), s, length ) == 0 )
+				{
+					return e;
+				}
+			}
+		}
+
+		// Must be called with a write lock held.
+		const Entry *insert( const char *s, size_t length, uint64_t hash )
+		{
+			// Another thread may have inserted the string while
+			// we were waiting for the write lock.
+			if( const Entry *e = find( s, length, hash ) )
+			{
+				return e;
+			}
+
+			if( ( m_size + 1 ) * 4 > m_slots.size() * 3 )
+			{
+				grow();
+			}
+
+			m_entries.emplace_back( s, length, hash );
+			const Entry *e = &m_entries.back();
+			insertSlot( e );
+			m_size++;
+			return e;
+		}
+
+		size_t size() const
+		{
+			return m_size;
+		}
+
+		mutable Mutex mutex;
+
+	private :
+
+		void insertSlot( const Entry *e )
+		{
+			const size_t mask = m_slots.size() - 1;
+			size_t i = e->hash & mask;
+			while( m_slots[i] )
+			{
+				i = ( i + 1 ) & mask;
+			}
+			m_slots[i] = e;
+		}
+
+		void grow()
+		{
+			std::vector<const Entry *> slots( m_slots.size() * 2, nullptr );
+			slots.swap( m_slots );
+			for( const Entry *e : slots )
+			{
+				if( e )
+				{
+					insertSlot( e );
+				}
+			}
+		}
+
+		std::vector<const Entry *> m_slots;
+		size_t m_size;
+		// std::deque never relocates existing elements when
+		// appending, so it serves as our arena.
+		std::deque<Entry> m_entries;
 
 };
 
-// Equality operator between strings of various types.
-// As above, this allows HashSet lookups to be performed
-// using any type, without the overhead of constructing
-// temporary std::strings.
-struct Equal
+typedef std::array<Shard, g_numShards> Shards;
+
+static Shards &shards()
 {
+	static Shards g_shards;
+	return g_shards;
+}
 
-	bool operator()( const std::string &s1, const std::string &s2 ) const
-	{
-		return s1 == s2;
-	}
+} // namespace Detail
+
+const std::string *InternedString::internedString( const char *value )
+{
+	return internedString( value, strlen( value ) );
+}
+
+const std::string *InternedString::internedString( const char *value, size_t length )
+{
+	const uint64_t hash = Detail::hash( value, length );
+	Detail::Shard &shard = Detail::shards()[Detail::shardIndex( hash )];
 
-	bool operator()( const char *c, const std::string &s ) const
 	{
-		return strcmp( c, s.c_str() )==0;
+		Detail::Shard::Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+		if( const Detail::Entry *e = shard.find( value, length, hash ) )
+		{
+			return &e->string;
+		}
 	}
 
-	bool operator()( const std::string &s, const char *c ) const
+	Detail::Shard::Mutex::scoped_lock lock( shard.mutex, true );
+	return &shard.insert( value, length, hash )->string;
+}
+
+void InternedString::internStrings( const StringRange *begin, const StringRange *end, InternedString *result )
+{
+	const size_t size = end - begin;
+
+	// Compute hashes, and sort the strings by shard so that
+	// we only need to lock each shard once.
+
+	std::vector<uint64_t> hashes( size );
+	std::array<size_t, Detail::g_numShards + 1> shardOffsets;
+	shardOffsets.fill( 0 );
+	for( size_t i = 0; i < size; ++i )
 	{
-		return strcmp( c, s.c_str() )==0;
+		hashes[i] = Detail::hash( begin[i].first, begin[i].second );
+		shardOffsets[Detail::shardIndex( hashes[i] ) + 1]++;
 	}
 
-	bool operator()( const CharRange &c, const std::string &s ) const
+	for( size_t i = 1; i < shardOffsets.size(); ++i )
 	{
-		return s.compare( 0, std::string::npos, c.first, c.second - c.first )==0;
+		shardOffsets[i] += shardOffsets[i-1];
 	}
 
-	bool operator()( const std::string &s, const CharRange &c ) const
+	std::vector<size_t> order( size );
+	std::array<size_t, Detail::g_numShards> shardInsertPositions;
+	std::copy( shardOffsets.begin(), shardOffsets.end() - 1, shardInsertPositions.begin() );
+	for( size_t i = 0; i < size; ++i )
 	{
-		return s.compare( 0, std::string::npos, c.first, c.second - c.first )==0;
+		order[shardInsertPositions[Detail::shardIndex( hashes[i] )]++] = i;
 	}
 
-};
+	// Look up each shard's strings under a read lock, and only
+	// take a write lock if some of them are missing.
 
-typedef boost::multi_index::multi_index_container<
-	std::string,
-	boost::multi_index::indexed_by<
-		boost::multi_index::hashed_unique<
-			boost::multi_index::identity<std::string>,
-			Hash,
-			Equal
-		>
-	>
-> HashSet;
-
-typedef HashSet::nth_index<0>::type Index;
-typedef HashSet::nth_index_const_iterator<0>::type ConstIterator;
-typedef tbb::spin_rw_mutex Mutex;
-
-static HashSet *hashSet()
-{
-	static HashSet g_hashSet;
-	return &g_hashSet;
-}
+	std::vector<size_t> missing;
+	for( size_t shardIndex = 0; shardIndex < Detail::g_numShards; ++shardIndex )
+	{
+		const size_t shardBegin = shardOffsets[shardIndex];
+		const size_t shardEnd = shardOffsets[shardIndex+1];
+		if( shardBegin == shardEnd )
+		{
+			continue;
+		}
 
-static Mutex *mutex()
-{
-	static Detail::Mutex g_mutex;
-	return &g_mutex;
-}
+		Detail::Shard &shard = Detail::shards()[shardIndex];
+		missing.clear();
 
-} // namespace Detail
+		{
+			Detail::Shard::Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+			for( size_t j = shardBegin; j < shardEnd; ++j )
+			{
+				const size_t i = order[j];
+				if( const Detail::Entry *e = shard.find( begin[i].first, begin[i].second, hashes[i] ) )
+				{
+					result[i].m_value = &e->string;
+				}
+				else
+				{
+					missing.push_back( i );
+				}
+			}
+		}
 
-const std::string *InternedString::internedString( const char *value )
-{
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( value );
-	if( it!=hashIndex.end() )
-	{
-		return &(*it);
-	}
-	else
-	{
-		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value ) ).first ) );
+		if( missing.size() )
+		{
+			Detail::Shard::Mutex::scoped_lock lock( shard.mutex, true );
+			for( size_t i : missing )
+			{
+				result[i].m_value = &shard.insert( begin[i].first, begin[i].second, hashes[i] )->string;
+			}
+		}
 	}
 }
 
-const std::string *InternedString::internedString( const char *value, size_t length )
+void InternedString::internStrings( const std::string *begin, const std::string *end, InternedString *result )
 {
-	Detail::HashSet *hashSet = Detail::hashSet();
-	Detail::Index &hashIndex = hashSet->get<0>();
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet::const_iterator it = hashIndex.find( Detail::CharRange( value, value + length ) );
-	if( it!=hashIndex.end() )
+	std::vector<StringRange> ranges;
+	ranges.reserve( end - begin );
+	for( const std::string *s = begin; s != end; ++s )
 	{
-		return &(*it);
-	}
-	else
-	{
-		lock.upgrade_to_writer();
-		return &(*(hashSet->insert( std::string( value, length ) ).first ) );
+		ranges.push_back( StringRange( s->c_str(), s->size() ) );
 	}
+	internStrings( ranges.data(), ranges.data() + ranges.size(), result );
 }
 
 size_t InternedString::numUniqueStrings()
 {
-	Detail::Mutex::scoped_lock lock( *Detail::mutex(), false ); // read-only lock
-	Detail::HashSet *hashSet = Detail::hashSet();
-	return hashSet->size();
+	size_t result = 0;
+	for( const Detail::Shard &shard : Detail::shards() )
+	{
+		Detail::Shard::Mutex::scoped_lock lock( shard.mutex, false ); // read-only lock
+		result += shard.size();
+	}
+	return result;
 }
 
 static InternedString g_emptyString("");
@@ -37,8 +37,14 @@
 
 #include "IECore/PathMatcher.h"
 
+#include "IECore/Exception.h"
+#include "IECore/FrozenPathMatcher.h"
 #include "IECore/StringAlgo.h"
 
+#include "boost/format.hpp"
+
+#include <algorithm>
+
 using namespace std;
 using namespace IECore;
 
@@ -185,6 +191,132 @@ void PathMatcher::clear()
 	m_root = new Node;
 }
 
+void PathMatcher::initDepthFirst( const IECore::InternedString *names, size_t numNames, const unsigned int *depths, const unsigned char *exactMatches, size_t numLocations )
+{
+	// The children of all the locations on the current branch are
+	// accumulated in a single flat buffer as they are visited. When a
+	// location is complete, its children are sorted into ChildMap order
+	// so that the map can be filled using end-hinted insertion, which
+	// is amortised constant time, and then removed from the buffer.
+
+	struct Child
+	{
+		IECore::InternedString name;
+		unsigned char type;
+		NodePtr node;
+	};
+
+	struct ChildLess
+	{
+		bool operator()( const Child &a, const Child &b ) const
+		{
+			return a.type < b.type || ( ( a.type == b.type ) && a.name < b.name );
+		}
+	};
+
+	struct Level
+	{
+		IECore::InternedString name;
+		unsigned char type;
+		bool terminator;
+		size_t childrenBegin;
+	};
+
+	std::vector<Level> levels;
+	std::vector<Child> children;
+
+	auto popLevel = [&levels, &children] () -> NodePtr
+	{
+		const Level &level = levels.back();
+		const std::vector<Child>::iterator childrenBegin = children.begin() + level.childrenBegin;
+
+		NodePtr node;
+		if( childrenBegin == children.end() )
+		{
+			// Share leaf nodes in the same way that addWalk() does.
+			// Non-terminators without children are empty, and are
+			// omitted entirely.
+			if( level.terminator )
+			{
+				node = Node::leaf();
+			}
+		}
+		else
+		{
+			node = new Node( level.terminator );
+			std::sort( childrenBegin, children.end(), ChildLess() );
+			for( std::vector<Child>::iterator it = childrenBegin, eIt = children.end(); it != eIt; ++it )
+			{
+				node->children.emplace_hint( node->children.end(), Name( it->name, (Name::Type)it->type ), std::move( it->node ) );
+			}
+			children.erase( childrenBegin, children.end() );
+		}
+
+		levels.pop_back();
+		return node;
+	};
+
+	auto popLevelToParent = [&levels, &children, &popLevel] ()
+	{
+		const Level &level = levels.back();
+		Child child = { level.name, level.type, nullptr };
+		child.node = popLevel();
+		if( child.node )
+		{
+			children.push_back( std::move( child ) );
+		}
+	};
+
+	if( !numLocations )
+	{
+		m_root = new Node;
+		return;
+	}
+
+	if( depths[0] != 0 )
+	{
+		throw IECore::Exception( "PathMatcher::initDepthFirst : First location is not the root" );
+	}
+
+	const IECore::InternedString *namesEnd = names + numNames;
+	levels.push_back( { IECore::InternedString(), Name::Plain, (bool)exactMatches[0], 0 } );
+	for( size_t i = 1; i < numLocations; ++i )
+	{
+		const size_t depth = depths[i];
+		if( depth == 0 || depth > levels.size() )
+		{
+			throw IECore::Exception( boost::str( boost::format( "PathMatcher::initDepthFirst : Invalid depth %d for location %d" ) % depth % i ) );
+		}
+		if( names == namesEnd )
+		{
+			throw IECore::Exception( "PathMatcher::initDepthFirst : Not enough names" );
+		}
+
+		while( levels.size() > depth )
+		{
+			popLevelToParent();
+		}
+
+		const Name name( *names++ );
+		levels.push_back( { name.name, name.type, (bool)exactMatches[i], children.size() } );
+	}
+
+	while( levels.size() > 1 )
+	{
+		popLevelToParent();
+	}
+
+	// The root is never shared with the leaf node, because
+	// it is edited in place by the methods that modify us.
+	const bool rootTerminator = levels.back().terminator;
+	NodePtr root = popLevel();
+	if( !root || root == Node::leaf() )
+	{
+		root = new Node( rootTerminator );
+	}
+	m_root = root;
+}
+
 bool PathMatcher::isEmpty() const
 {
 	return m_root->isEmpty();
@@ -515,6 +647,11 @@ PathMatcher::RawIterator PathMatcher::find( const std::vector<IECore::InternedSt
 	return RawIterator( *this, path );
 }
 
+FrozenPathMatcher PathMatcher::freeze() const
+{
+	return FrozenPathMatcher( *this );
+}
+
 PathMatcher::Node *PathMatcher::writable( Node *node, NodePtr &writableCopy, bool shared )
 {
 	if( !shared )
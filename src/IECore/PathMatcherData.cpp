@@ -34,6 +34,7 @@
 
 #include "IECore/PathMatcherData.h"
 
+#include "IECore/Exception.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/TypedData.inl"
 
@@ -141,19 +142,12 @@ void PathMatcherData::load( LoadContextPtr context )
 	unsigned char *exactMatchesPtr = exactMatches.data();
 	container->read( "exactMatches", exactMatchesPtr, exactMatchesEntry.arrayLength() );
 
-	std::vector<InternedString> path;
-	for( size_t i = 0, e = pathLengths.size(); i < e; ++i )
+	if( exactMatches.size() != pathLengths.size() )
 	{
-		path.resize( pathLengths[i] );
-		if( pathLengths[i] )
-		{
-			path.back() = *stringsPtr++;
-		}
-		if( exactMatches[i] )
-		{
-			writable().addPath( path );
-		}
+		throw Exception( "PathMatcherData::load : Mismatched \"pathLengths\" and \"exactMatches\"" );
 	}
+
+	writable().initDepthFirst( strings.data(), strings.size(), pathLengths.data(), exactMatches.data(), pathLengths.size() );
 }
 
 // Our hash is complicated by the fact that PathMatcher::Iterator doesn't
@@ -37,14 +37,17 @@
 
 #include "IECore/ByteOrder.h"
 #include "IECore/CompoundData.h"
+#include "IECore/IndexedIOBlockStore.h"
 #include "IECore/MemoryStream.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/MurmurHash.h"
 #include "IECore/SimpleTypedData.h"
+#include "IECore/Timer.h"
 #include "IECore/VectorTypedData.h"
 
 #include "blosc.h"
 
+#include "tbb/enumerable_thread_specific.h"
 #include "tbb/spin_rw_mutex.h"
 
 #include "boost/format.hpp"
@@ -58,10 +61,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <list>
 #include <map>
 #include <set>
+#include <type_traits>
 
 #include <fcntl.h>
 #ifndef _MSC_VER
@@ -82,12 +87,15 @@ static const Imf::Int64 g_versionedMagicNumber = 0xB00B1E50;
 ///            Removed the linkCount field on the data nodes.
 /// Version 6: compress large (1kb) DataNodes using blosc
 /// Version 7: compress index using blosc(lz4) instead of gzip
+/// Version 8: data nodes may refer to blocks held in an IndexedIOBlockStore. Only files using a block store are written as version 8.
 /// \todo Store SubIndexSize and NodeCount as unsigned 64bit integers
 static const Imf::Int64 g_currentVersion = 7;
+static const Imf::Int64 g_blockStoreVersion = 8;
 
 /// FileFormat ::= Data Index IndexOffset Version MagicNumber
 /// Data ::= DataEntry*
-/// Index ::= zip(StringCache NodeTree FreePages)
+/// Index ::= zip(StringCache BlockStorePath NodeTree FreePages)
+/// BlockStorePath ::= StringLength char* ( version 8 onwards )
 
 /// DataEntry ::= Stores data from nodes:
 ///                [Data nodes] binary data indexed by DataOffset/DataSize and
@@ -103,6 +111,7 @@ static const Imf::Int64 g_currentVersion = 7;
 /// Node ::= EntryType EntryStringCacheID NodeCount ( if EntryType == Directory )
 ///          EntryType EntryStringCacheID DataType ArrayLength DataOffset DataSize ( if EntryType == File )
 ///			 EntryType EntryStringCacheID SubIndexOffset ( If EntryType == SUBINDEX_DIR )
+///          EntryType EntryStringCacheID DataType ArrayLength BlockHash DataSize DecompressedSize NumCompressedBlocks ( if EntryType == StoredData )
 /// EntryType ::= char ( value from IndexedIO::EntryType )
 /// EntryStringCacheID ::= int64 ( index in StringCache )
 /// DataType ::= char ( value from IndexedIO::DataType )
@@ -113,6 +122,7 @@ static const Imf::Int64 g_currentVersion = 7;
 /// DataSize ::= int64 ( number of bytes stored in the data section )
 /// NodeCount ::= uint32 ( number of child nodes in the directory - stored right after this node leading to recursive definition of a tree )
 /// SubIndexOffset :: = int64 ( offset in the Data block where there's a zipped index that contains all the child nodes from this node - and possibly other nodes )
+/// BlockHash ::= uint64 uint64 ( MurmurHash of the data, used as the key into the block store )
 
 /// FreePages ::= NumFreePages FreePage*
 /// NumFreePages ::= int64
@@ -222,34 +232,63 @@ class StreamIndexedIO::StringCache
 {
 	public:
 
-		StringCache() : m_prevId(0), m_ioBuffer(nullptr), m_ioBufferLen(0)
+		StringCache() : m_prevId(0)
 		{
 			m_idToStringMap.reserve(100);
 		}
 
 		template < typename F >
-		StringCache( F &f ) : m_prevId(0), m_ioBuffer(nullptr), m_ioBufferLen(0)
+		StringCache( F &f ) : m_prevId(0)
 		{
 			Imf::Int64 sz;
 			readLittleEndian(f,sz);
 
 			m_idToStringMap.reserve(sz + 100);
 
+			// Read all the strings into a single buffer, and then intern
+			// them in one batch, which is much quicker than interning them
+			// individually.
+			std::vector<char> chars;
+			std::vector<std::pair<size_t, size_t>> offsetsAndLengths;
+			std::vector<Imf::Int64> ids;
+			offsetsAndLengths.reserve( sz );
+			ids.reserve( sz );
+
 			for (Imf::Int64 i = 0; i < sz; ++i)
 			{
-				const char *s = read(f);
+				Imf::Int64 length;
+				readLittleEndian( f, length );
+				const size_t offset = chars.size();
+				chars.resize( offset + length );
+				f.read( chars.data() + offset, length * sizeof(char) );
+				offsetsAndLengths.push_back( std::make_pair( offset, length ) );
 
 				Imf::Int64 id;
 				readLittleEndian( f,id );
+				ids.push_back( id );
+			}
+
+			std::vector<InternedString::StringRange> ranges;
+			ranges.reserve( sz );
+			for( const auto &o : offsetsAndLengths )
+			{
+				ranges.push_back( InternedString::StringRange( chars.data() + o.first, o.second ) );
+			}
+
+			std::vector<IndexedIO::EntryID> strings( sz );
+			InternedString::internStrings( ranges.data(), ranges.data() + ranges.size(), strings.data() );
 
+			for (Imf::Int64 i = 0; i < sz; ++i)
+			{
+				const Imf::Int64 id = ids[i];
 				m_prevId = std::max( id, m_prevId );
 
-				m_stringToIdMap[s] = id;
+				m_stringToIdMap[strings[i]] = id;
 				if ( id >= m_idToStringMap.size() )
 				{
 					m_idToStringMap.resize(id+1, (const char *)"");
 				}
-				m_idToStringMap[id] = s;
+				m_idToStringMap[id] = strings[i];
 			}
 		}
 
@@ -337,26 +376,6 @@ class StreamIndexedIO::StringCache
 			f.write( s.c_str(), sz * sizeof(char) );
 		}
 
-		template < typename F >
-		const char *read( F &f ) const
-		{
-			Imf::Int64 sz;
-			readLittleEndian( f, sz );
-
-			if ( m_ioBufferLen < sz + 1 )
-			{
-				if ( m_ioBuffer )
-				{
-					delete [] m_ioBuffer;
-				}
-				m_ioBufferLen = sz+1;
-				m_ioBuffer = new char[m_ioBufferLen];
-			}
-			f.read( m_ioBuffer, sz*sizeof(char));
-			m_ioBuffer[sz] = '\0';
-			return m_ioBuffer;
-		}
-
 		Imf::Int64 m_prevId;
 
 		typedef std::map< IndexedIO::EntryID, Imf::Int64 > StringToIdMap;
@@ -364,9 +383,6 @@ class StreamIndexedIO::StringCache
 
 		StringToIdMap m_stringToIdMap;
 		IdToStringMap m_idToStringMap;
-
-		mutable char *m_ioBuffer;
-		mutable unsigned long m_ioBufferLen;
 };
 
 namespace
@@ -402,8 +418,41 @@ std::string getCompressor( int code )
 	return "unknown";
 }
 
+const size_t g_defaultMinCompressedBlockSize = 1024;
+
+/// The element size given to the blosc shuffle filter for each type we write.
+/// Strings are flattened to a mixture of lengths and characters, so aren't shuffled
+/// on any particular boundary.
+template<typename T>
+struct CompressionTypeSize : public std::integral_constant<size_t, sizeof( T )>
+{
+};
+
+template<>
+struct CompressionTypeSize<std::string> : public std::integral_constant<size_t, 1>
+{
+};
+
+//! map the "shuffle" option to the blosc filter. Returns -1 for unrecognised names.
+int getShuffle( const std::string &shuffle )
+{
+	if( shuffle == "none" )
+	{
+		return StreamIndexedIO::CompressionHint::NoShuffle;
+	}
+	else if( shuffle == "byte" )
+	{
+		return StreamIndexedIO::CompressionHint::ByteShuffle;
+	}
+	else if( shuffle == "bit" )
+	{
+		return StreamIndexedIO::CompressionHint::BitShuffle;
+	}
+	return -1;
+}
+
 /// compress 'size' bytes at 'data' into 'outputBuffer'
-/// compressionLevel, compressor & threadCount are passed directly to blosc ( see blosc.h )
+/// compressionLevel, shuffle, typeSize, compressor & threadCount are passed directly to blosc ( see blosc.h )
 /// if  'size' is greater than the max buffer blosc can handle we split into a number of independently compressed blocks.
 /// returns the number of compression blocks
 /// 'outputBuffer' contains the compressed block data and is resized in this function.
@@ -413,10 +462,12 @@ size_t compress(
 	size_t size,
 	std::vector<char> &outputBuffer,
 	int compressionLevel,
+	int shuffle,
+	size_t typeSize,
 	const std::string &compressor,
 	int threadCount,
 	boost::optional<size_t> maxBlockSize = boost::optional<size_t>(),
-	size_t minCompressedBlockSize = 1024U
+	size_t minCompressedBlockSize = g_defaultMinCompressedBlockSize
 )
 {
 	size_t maxCompressedBlockSize = maxBlockSize ? maxBlockSize.get() : BLOSC_MAX_BUFFERSIZE;
@@ -434,8 +485,6 @@ size_t compress(
 	/// this isn't enough space in some edge cases but is sufficient in the common case
 	/// and we check if we have enough size in the compression loop
 	outputBuffer.resize( size + BLOSC_MAX_OVERHEAD );
-	char *writePtr = outputBuffer.data();
-	size_t writerBufferBytes = outputBuffer.size();
 
 	size_t totalCompressedSize = 0;
 
@@ -443,34 +492,32 @@ size_t compress(
 	{
 		size_t currentBlockUncompressedSize = std::min( maxCompressedBlockSize, bytesToCompress );
 		size_t compressedBufferMaxSize = currentBlockUncompressedSize + BLOSC_MAX_OVERHEAD;
-		if( writerBufferBytes < compressedBufferMaxSize )
+		if( outputBuffer.size() - totalCompressedSize < compressedBufferMaxSize )
 		{
-			size_t additionalBytes = (size_t) ( compressedBufferMaxSize - writerBufferBytes );
-			outputBuffer.resize( outputBuffer.size() + additionalBytes );
+			outputBuffer.resize( totalCompressedSize + compressedBufferMaxSize );
 		}
 
+		// blosc ignores the shuffle for type sizes it doesn't support, storing
+		// the data unshuffled, so this is always safe.
 		int compressedSize = blosc_compress_ctx(
 			compressionLevel,
-			true,
-			4,
+			shuffle,
+			typeSize,
 			currentBlockUncompressedSize,
 			currentBlockCompressed,
-			writePtr,
+			outputBuffer.data() + totalCompressedSize,
 			compressedBufferMaxSize,
 			compressor.c_str(),
 			0,
 			threadCount
 		);
 
-		if ( compressedSize < 0 )
+		if ( compressedSize <= 0 )
 		{
 			outputBuffer.clear();
 			return 0;
 		}
 
-		writerBufferBytes -= compressedSize;
-		writePtr += compressedSize;
-
 		totalCompressedSize += compressedSize;
 
 		currentBlockCompressed += currentBlockUncompressedSize;
@@ -528,6 +575,8 @@ size_t decompress( const char *data, size_t size, std::vector<char> &outputBuffe
 	return blockSizes.size();
 }
 
+tbb::enumerable_thread_specific<StreamIndexedIO::ReadStatistics> g_readStatistics;
+
 } // namespace
 
 
@@ -546,7 +595,8 @@ class NodeBase
 			SmallData = 1,
 			Data = 2,
 			Directory = 3,
-			SubIndex = 4
+			SubIndex = 4,
+			StoredData = 5
 		};
 
 		NodeBase( NodeType type, IndexedIO::EntryID name ) : m_name(name), m_nodeType(type) {}
@@ -732,6 +782,74 @@ class DataNode : public NodeBase
 };
 
 
+/// Class that represents Data nodes whose data is held in an IndexedIOBlockStore
+/// rather than in the file itself.
+class StoredDataNode : public NodeBase
+{
+	public :
+
+		StoredDataNode(
+			IndexedIO::EntryID name,
+			IndexedIO::DataType dataType,
+			Imf::Int64 arrayLength,
+			Imf::Int64 size,
+			const MurmurHash &hash,
+			Imf::Int64 decompressedSize,
+			unsigned short numCompressedBlocks
+		) : NodeBase(
+			NodeBase::StoredData, name
+		),
+			m_dataType( dataType ),
+			m_arrayLength( arrayLength ),
+			m_size( size ),
+			m_decompressedSize( decompressedSize ),
+			m_numCompressedBlocks( numCompressedBlocks ),
+			m_hash( hash )
+		{
+		}
+
+		inline IndexedIO::DataType dataType() const
+		{
+			return m_dataType;
+		}
+
+		inline Imf::Int64 arrayLength() const
+		{
+			return m_arrayLength;
+		}
+
+		inline Imf::Int64 size() const
+		{
+			return m_size;
+		}
+
+		inline const MurmurHash &hash() const
+		{
+			return m_hash;
+		}
+
+		inline Imf::Int64 decompressedSize() const
+		{
+			return m_decompressedSize;
+		}
+
+		inline unsigned short compressedBlocks() const
+		{
+			return m_numCompressedBlocks;
+		}
+
+	protected :
+
+		IndexedIO::DataType m_dataType;
+		Imf::Int64 m_arrayLength;
+		Imf::Int64 m_size;
+		Imf::Int64 m_decompressedSize;
+		unsigned short m_numCompressedBlocks;
+
+		/// The key for the data in the block store
+		MurmurHash m_hash;
+};
+
 /// A compressed subindex node
 class SubIndexNode : public NodeBase
 {
@@ -873,7 +991,7 @@ class StreamIndexedIO::Node
 		// location & size information of data block in a file
 		struct Info
 		{
-			Info() : offset( 0 ), size( 0 ), decompressedSize( 0 )
+			Info() : offset( 0 ), size( 0 ), decompressedSize( 0 ), numCompressedBlocks( 0 ), blockStore( nullptr )
 			{
 			}
 
@@ -881,6 +999,10 @@ class StreamIndexedIO::Node
 			size_t size;
 			size_t decompressedSize;
 			size_t numCompressedBlocks;
+
+			/// Set for data held in a block store rather than the file.
+			const IndexedIOBlockStore *blockStore;
+			MurmurHash blockHash;
 		};
 
 		/// Construct a new Node in the given index with the given numeric id
@@ -900,6 +1022,7 @@ class StreamIndexedIO::Node
 		bool dataChildInfo( const IndexedIO::EntryID &name, Info &info ) const;
 
 		DirectoryNode* addChild( const IndexedIO::EntryID & childName );
+		/// If 'blockHash' is specified then the data is held in the block store, and 'offset' is ignored.
 		void addDataChild(
 			const IndexedIO::EntryID &childName,
 			IndexedIO::DataType dataType,
@@ -907,13 +1030,15 @@ class StreamIndexedIO::Node
 			size_t offset,
 			size_t size,
 			size_t decompressedSize,
-			size_t numCompressedBlocks
+			size_t numCompressedBlocks,
+			const MurmurHash *blockHash = nullptr
 		);
 
 		void removeChild( const IndexedIO::EntryID &childName, bool throwException = true );
 
 		StreamIndexedIO::IndexPtr m_idx;
 		DirectoryNode *m_node;
+		CompressionHint m_compressionHint;
 };
 
 //! Small scoped class to read from a given data block in a file, 
@@ -936,10 +1061,15 @@ class StreamIndexedIO::Reader
 				m_decompressedData = new char[m_decompressedSize];
 			}
 
+			StreamIndexedIO::ReadStatistics &statistics = g_readStatistics.local();
+			statistics.bytesRead += info.size;
+
 			if( info.numCompressedBlocks > 0 )
 			{
 				m_data = new char[info.size];
-				f.read( m_data, info.size, info.offset );
+				read( f, info, m_data );
+
+				const auto startTime = std::chrono::steady_clock::now();
 
 				const char* readPtr = m_data;
 				char* writePtr = m_decompressedData;
@@ -962,10 +1092,13 @@ class StreamIndexedIO::Reader
 					writePtr += decompressedNumBytes;
 					writeBufferSize -= decompressedNumBytes;
 				}
+
+				statistics.bytesDecompressed += m_decompressedSize;
+				statistics.decompressionTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
 			}
 			else
 			{
-				f.read( m_decompressedData, info.size, info.offset );
+				read( f, info, m_decompressedData );
 			}
 		}
 
@@ -1000,6 +1133,19 @@ class StreamIndexedIO::Reader
 		}
 
 	private:
+
+		static void read( StreamIndexedIO::StreamFile &f, const Node::Info &info, char *buffer )
+		{
+			if( info.blockStore )
+			{
+				info.blockStore->read( info.blockHash, buffer, info.size );
+			}
+			else
+			{
+				f.read( buffer, info.size, info.offset );
+			}
+		}
+
 		char *m_data;
 		char *m_decompressedData;
 		Imf::Int64 m_size;
@@ -1055,9 +1201,18 @@ class StreamIndexedIO::Index : public RefCounted
 
 			/// We split up files into compressed blocks as required by the BLOSC_MAX_BUFFERSIZE define.
 			size_t numCompressedBlocks;
+
+			/// Set if the data was written to the block store rather than the file, in which case offset is 0.
+			boost::optional<MurmurHash> blockHash;
 		};
 
-		WriteInfo writeUniqueDataCompressed( const char *data, size_t size, bool prefixSize = false );
+		/// Compresses according to the file settings, overridden by any non-default members of 'hint'.
+		/// \param typeSize The size of the elements in 'data', used by the shuffle filter.
+		WriteInfo writeUniqueDataCompressed( const char *data, size_t size, size_t typeSize, const CompressionHint &hint, bool prefixSize = false );
+
+		/// Returns the hint registered for directories called 'name' by the "compressionHints"
+		/// option, or 'parentHint' if there is none.
+		const CompressionHint &compressionHint( const IndexedIO::EntryID &name, const CompressionHint &parentHint ) const;
 
 		/// flushes the children of the given directory node to a subindex in the file
 		void commitNodeToSubIndex( DirectoryNode *n );
@@ -1073,6 +1228,8 @@ class StreamIndexedIO::Index : public RefCounted
 
 		int decompressionThreadCount() const { return m_decompressionThreadCount; }
 
+		const IndexedIOBlockStore *blockStore() const { return m_blockStore.get(); }
+
 		CompoundDataPtr metadata() const
 		{
 			CompoundDataPtr meta(new CompoundData());
@@ -1127,8 +1284,39 @@ class StreamIndexedIO::Index : public RefCounted
 		int m_compressionThreadCount;
 		int m_decompressionThreadCount;
 		boost::optional<size_t> m_maxCompressedBlockSize;
+		size_t m_minCompressedBlockSize;
+		int m_shuffle;
 		std::string m_compressor;
 
+		typedef std::map<IndexedIO::EntryID, CompressionHint> CompressionHints;
+		CompressionHints m_compressionHints;
+
+		/// Accumulated results of trialling each compressor on the first
+		/// blocks written, when the "autoTune" option is on.
+		struct AutoTuneCandidate
+		{
+			std::string compressor;
+			size_t compressedSize;
+			double decompressionTime;
+		};
+
+		std::vector<AutoTuneCandidate> m_autoTuneCandidates;
+		size_t m_autoTuneSamples;
+
+		/// Data blocks of at least m_blockStoreMinSize bytes are written here
+		/// instead of the file, if the "blockStore" option was specified.
+		IndexedIOBlockStorePtr m_blockStore;
+		size_t m_blockStoreMinSize;
+		/// The blocks referenced by this file, to be recorded in the store's manifest on flush.
+		std::set<MurmurHash> m_blockStoreReferences;
+
+		/// Compresses 'data' with every candidate, storing the smallest result
+		/// in 'outputBuffer', and selects the file compressor once enough
+		/// samples have been taken.
+		size_t autoTuneCompress( const char *data, size_t size, std::vector<char> &outputBuffer, int compressionLevel, int shuffle, size_t typeSize, size_t minCompressedBlockSize );
+		/// Sets m_compressor to the candidate which is quickest to read back and ends the trial.
+		void autoTuneSelect();
+
 		struct FreePage
 		{
 			FreePage( Imf::Int64 offset, Imf::Int64 sz ) : m_offset(offset), m_size(sz) {}
@@ -1155,6 +1343,10 @@ class StreamIndexedIO::Index : public RefCounted
 		template < typename F >
 		void writeNode( SubIndexNode *n, F &f );
 
+		/// Write the block store data node to a stream
+		template < typename F >
+		void writeNode( StoredDataNode *n, F &f );
+
 		/// Write the data node to a stream
 		template < typename F, typename D >
 		void writeDataNode( D *n, F &f );
@@ -1218,6 +1410,12 @@ void NodeBase::destroy( NodeBase *n )
 				delete dn;
 				break;
 			}
+		case NodeBase::StoredData :
+			{
+				StoredDataNode *dn = static_cast< StoredDataNode *>(n);
+				delete dn;
+				break;
+			}
 		case NodeBase::SubIndex :
 			{
 				SubIndexNode *dn = static_cast< SubIndexNode *>(n);
@@ -1402,6 +1600,16 @@ bool StreamIndexedIO::Node::dataChildInfo( const IndexedIO::EntryID &name, Info
 			info.numCompressedBlocks = n->compressedBlocks();
 			return true;
 		}
+		else if ( p->nodeType() == NodeBase::StoredData )
+		{
+			StoredDataNode *n = static_cast< StoredDataNode *>( p );
+			info.size = n->size();
+			info.decompressedSize = n->decompressedSize();
+			info.numCompressedBlocks = n->compressedBlocks();
+			info.blockStore = m_idx->blockStore();
+			info.blockHash = n->hash();
+			return true;
+		}
 	}
 	return false;
 }
@@ -1439,7 +1647,8 @@ void StreamIndexedIO::Node::addDataChild(
 	size_t offset,
 	size_t size,
 	size_t decompressedSize,
-	size_t numCompressedBlocks
+	size_t numCompressedBlocks,
+	const MurmurHash *blockHash
 )
 {
 	if ( m_node->subindex() )
@@ -1454,8 +1663,12 @@ void StreamIndexedIO::Node::addDataChild(
 
 	m_idx->m_stringCache.add( childName );
 
+	if( blockHash )
+	{
+		m_node->registerChild( new StoredDataNode( childName, dataType, arrayLen, size, *blockHash, decompressedSize, numCompressedBlocks ) );
+	}
 	// SmallDataNodes should not be compressed.
-	if( arrayLen <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize && ( size == decompressedSize ) && (numCompressedBlocks == 0) )
+	else if( arrayLen <= SmallDataNode::maxArrayLength && size <= SmallDataNode::maxSize && ( size == decompressedSize ) && (numCompressedBlocks == 0) )
 	{
 		SmallDataNode* child = new SmallDataNode(childName, dataType, arrayLen, size, offset);
 		if ( !child )
@@ -1565,8 +1778,12 @@ StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream, const Comp
 	m_next( 0 ),
 	m_stream( stream ), m_compressionLevel( 0 ),
 	m_compressionThreadCount(1),
-	m_decompressionThreadCount(1), m_compressor( "lz4" )
-
+	m_decompressionThreadCount(1),
+	m_minCompressedBlockSize( g_defaultMinCompressedBlockSize ),
+	m_shuffle( CompressionHint::ByteShuffle ),
+	m_compressor( "lz4" ),
+	m_autoTuneSamples( 0 ),
+	m_blockStoreMinSize( 4096 )
 {
 	m_stringCache.add(IndexedIO::rootName);
 
@@ -1606,12 +1823,88 @@ StreamIndexedIO::Index::Index( StreamIndexedIO::StreamFilePtr stream, const Comp
 		{
 			m_maxCompressedBlockSize = maxCompressedBlockSize->readable();
 		}
+
+		if ( const UIntData* minCompressedBlockSize = options->member<UIntData>("minCompressedBlockSize", false) )
+		{
+			m_minCompressedBlockSize = minCompressedBlockSize->readable();
+		}
+
+		if ( const StringData* shuffle = options->member<StringData>("shuffle", false) )
+		{
+			m_shuffle = getShuffle( shuffle->readable() );
+		}
+
+		if ( const CompoundData* compressionHints = options->member<CompoundData>("compressionHints", false) )
+		{
+			for( const auto &h : compressionHints->readable() )
+			{
+				const CompoundData *hintData = runTimeCast<const CompoundData>( h.second.get() );
+				if( !hintData )
+				{
+					continue;
+				}
+
+				CompressionHint &hint = m_compressionHints[h.first];
+				if ( const StringData* compressor = hintData->member<StringData>("compressor", false) )
+				{
+					hint.compressor = getCompressionCode( compressor->readable() ) != -1 ? compressor->readable() : "";
+				}
+				if ( const IntData* compressionLevel = hintData->member<IntData>("compressionLevel", false) )
+				{
+					hint.compressionLevel = std::min( std::max( 0, compressionLevel->readable() ), 9 );
+				}
+				if ( const StringData* shuffle = hintData->member<StringData>("shuffle", false) )
+				{
+					hint.shuffle = (CompressionHint::Shuffle)getShuffle( shuffle->readable() );
+				}
+				if ( const IntData* typeSize = hintData->member<IntData>("typeSize", false) )
+				{
+					hint.typeSize = std::max( 0, typeSize->readable() );
+				}
+				if ( const UIntData* minCompressedBlockSize = hintData->member<UIntData>("minCompressedBlockSize", false) )
+				{
+					hint.minCompressedBlockSize = minCompressedBlockSize->readable();
+				}
+			}
+		}
+
+		if ( const StringData* blockStore = options->member<StringData>("blockStore", false) )
+		{
+			if( !blockStore->readable().empty() )
+			{
+				m_blockStore = new IndexedIOBlockStore( blockStore->readable() );
+			}
+		}
+
+		if ( const UIntData* blockStoreMinSize = options->member<UIntData>("blockStoreMinSize", false) )
+		{
+			m_blockStoreMinSize = blockStoreMinSize->readable();
+		}
+
+		if ( const BoolData* autoTune = options->member<BoolData>("autoTune", false) )
+		{
+			if( autoTune->readable() )
+			{
+				for( const auto &c : nameCodeMapping )
+				{
+					// skip compressors blosc was built without
+					if( blosc_compname_to_compcode( c.first.c_str() ) >= 0 )
+					{
+						m_autoTuneCandidates.push_back( { c.first, 0, 0.0 } );
+					}
+				}
+			}
+		}
 	}
 
 	// validate our parameters
 	m_compressionLevel = std::min( std::max( 0, m_compressionLevel ), 9 ); // todo replace with std::clamp in C++17
 	m_compressionThreadCount = std::min( std::max( 1, m_compressionThreadCount ), 32 );
 	m_decompressionThreadCount = std::min( std::max( 1, m_decompressionThreadCount ), 32 );
+	if( m_shuffle < 0 )
+	{
+		m_shuffle = CompressionHint::ByteShuffle;
+	}
 
 	if ( getCompressionCode( m_compressor ) == -1)
 	{
@@ -1646,10 +1939,29 @@ void StreamIndexedIO::Index::flush()
 {
 	if ( m_hasChanged )
 	{
+		// Make sure the header records the compressor chosen by a trial
+		// which didn't see enough entries to complete.
+		autoTuneSelect();
+
 		Imf::Int64 end = write();
 		assert( m_stream.get() );
 		assert( m_hasChanged == false );
 		m_stream->flush( end );
+
+		// Record our references in the block store, so they are protected
+		// from compaction. Streams which aren't files can't be tracked, and
+		// their blocks are only guaranteed to survive until the next compaction.
+		const std::string fileName = m_stream->fileName();
+		if( m_blockStore && !fileName.empty() )
+		{
+			std::vector<MurmurHash> references;
+			if( m_stream->openMode() & IndexedIO::Append )
+			{
+				m_blockStore->getReferences( fileName, references );
+			}
+			references.insert( references.end(), m_blockStoreReferences.begin(), m_blockStoreReferences.end() );
+			m_blockStore->setReferences( fileName, references );
+		}
 	}
 }
 
@@ -2028,6 +2340,29 @@ NodeBase *StreamIndexedIO::Index::readNode( F &f )
 		SubIndexNode *n = new SubIndexNode( m_stringCache.findById( stringId ), offset );
 		return n;
 	}
+	else if( nodeType == NodeBase::NodeType::StoredData )
+	{
+		char t;
+		f.read( &t, sizeof(char) );
+		IndexedIO::DataType dataType = (IndexedIO::DataType)t;
+
+		Imf::Int64 arrayLength = 0;
+		if ( IndexedIO::Entry::isArray( dataType ) )
+		{
+			readLittleEndian( f, arrayLength );
+		}
+
+		uint64_t h1, h2;
+		Imf::Int64 size, decompressedSize;
+		unsigned short numCompressedBlocks;
+		readLittleEndian( f, h1 );
+		readLittleEndian( f, h2 );
+		readLittleEndian( f, size );
+		readLittleEndian( f, decompressedSize );
+		readLittleEndian( f, numCompressedBlocks );
+
+		return new StoredDataNode( m_stringCache.findById( stringId ), dataType, arrayLength, size, MurmurHash( h1, h2 ), decompressedSize, numCompressedBlocks );
+	}
 	else
 	{
 		throw IOException( boost::str( boost::format( "StreamIndexedIO::Index::readNode - Invalid EntryType found '%1%'" ) % nodeType ) );
@@ -2042,6 +2377,20 @@ void StreamIndexedIO::Index::read( F &f )
 		m_stringCache = StringCache( f );
 	}
 
+	if( m_version >= 8 )
+	{
+		Imf::Int64 pathLength;
+		readLittleEndian( f, pathLength );
+		std::string path( pathLength, ' ' );
+		f.read( &path[0], pathLength );
+
+		// The "blockStore" option takes precedence, allowing stores to be relocated.
+		if( !m_blockStore )
+		{
+			m_blockStore = new IndexedIOBlockStore( path );
+		}
+	}
+
 	if( m_version >= 6 )
 	{
 		/// current file format reading
@@ -2172,6 +2521,30 @@ void StreamIndexedIO::Index::writeDataNode( D *node, F &f )
 
 }
 
+template < typename F >
+void StreamIndexedIO::Index::writeNode( StoredDataNode *node, F &f )
+{
+	NodeBase::NodeType nodeType = node->nodeType();
+	f.write( (char *) &nodeType, sizeof( char ) );
+
+	Imf::Int64 id = m_stringCache.find( node->name() );
+	writeLittleEndian( f, id );
+
+	char t = node->dataType();
+	f.write( &t, sizeof(char) );
+
+	if ( IndexedIO::Entry::isArray(node->dataType()) )
+	{
+		writeLittleEndian<F,Imf::Int64>( f, node->arrayLength() );
+	}
+
+	writeLittleEndian<F, uint64_t>( f, node->hash().h1() );
+	writeLittleEndian<F, uint64_t>( f, node->hash().h2() );
+	writeLittleEndian<F, Imf::Int64>( f, node->size() );
+	writeLittleEndian<F, Imf::Int64>( f, node->decompressedSize() );
+	writeLittleEndian<F, unsigned short>( f, node->compressedBlocks() );
+}
+
 template < typename F >
 void StreamIndexedIO::Index::writeNode( SubIndexNode *node, F &f )
 {
@@ -2206,6 +2579,12 @@ void StreamIndexedIO::Index::writeNodeChildren( DirectoryNode *n, F &f )
 				writeDataNode( childNode, f );
 				break;
 			}
+			case NodeBase::StoredData :
+			{
+				StoredDataNode *childNode = static_cast< StoredDataNode * >(p);
+				writeNode( childNode, f );
+				break;
+			}
 			case NodeBase::Directory :
 			{
 				DirectoryNode *childNode = static_cast< DirectoryNode *>(p);
@@ -2265,6 +2644,14 @@ Imf::Int64 StreamIndexedIO::Index::write()
 
 	m_stringCache.write( indexOutStream );
 
+	const Imf::Int64 version = m_blockStore ? g_blockStoreVersion : g_currentVersion;
+	if( version >= 8 )
+	{
+		const std::string &path = m_blockStore->path();
+		writeLittleEndian<io::filtering_ostream, Imf::Int64>( indexOutStream, path.size() );
+		indexOutStream.write( path.c_str(), path.size() );
+	}
+
 	writeNode( m_root, indexOutStream );
 
 	assert( m_freePagesOffset.size() == m_freePagesSize.size() );
@@ -2290,7 +2677,7 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	sink.get(indexData, indexDataSize);
 
 	std::vector<char> compressedIndex;
-	compress( indexData, indexDataSize, compressedIndex, indexCompressionLevel, indexCompressor, 1, BLOSC_MAX_BUFFERSIZE, 0);
+	compress( indexData, indexDataSize, compressedIndex, indexCompressionLevel, StreamIndexedIO::CompressionHint::ByteShuffle, 4, indexCompressor, 1, BLOSC_MAX_BUFFERSIZE, 0);
 
 	f.write( &compressedIndex[0], compressedIndex.size() );
 
@@ -2298,7 +2685,7 @@ Imf::Int64 StreamIndexedIO::Index::write()
 	writeLittleEndian( f, m_compressionLevel );
 
 	writeLittleEndian( f, m_offset );
-	writeLittleEndian( f, g_currentVersion );
+	writeLittleEndian( f, version );
 	writeLittleEndian( f, g_versionedMagicNumber );
 
 	m_hasChanged = false;
@@ -2549,21 +2936,65 @@ Imf::Int64 StreamIndexedIO::Index::writeUniqueData( const char *data, size_t siz
 	return loc;
 }
 
-StreamIndexedIO::Index::WriteInfo StreamIndexedIO::Index::writeUniqueDataCompressed( const char *data, size_t size, bool prefixSize )
+StreamIndexedIO::Index::WriteInfo StreamIndexedIO::Index::writeUniqueDataCompressed( const char *data, size_t size, size_t typeSize, const CompressionHint &hint, bool prefixSize )
 {
 	WriteInfo writeInfo;
 
 	std::vector<char> compressedBuffer;
 	size_t numBlocks = 0;
 
-	if ( m_compressionLevel )
+	// blosc block headers record the compressor, shuffle and type size, so
+	// the reader needs no knowledge of the settings used for each entry.
+	const int compressionLevel = hint.compressionLevel >= 0 ? hint.compressionLevel : m_compressionLevel;
+	const int shuffle = hint.shuffle != CompressionHint::DefaultShuffle ? hint.shuffle : m_shuffle;
+	const size_t minCompressedBlockSize = hint.minCompressedBlockSize >= 0 ? (size_t)hint.minCompressedBlockSize : m_minCompressedBlockSize;
+	if( hint.typeSize > 0 )
+	{
+		typeSize = hint.typeSize;
+	}
+
+	if ( compressionLevel )
 	{
-		numBlocks = compress( data, size, compressedBuffer, m_compressionLevel, m_compressor, m_compressionThreadCount, m_maxCompressedBlockSize );
+		if( hint.compressor.empty() && m_autoTuneCandidates.size() )
+		{
+			numBlocks = autoTuneCompress( data, size, compressedBuffer, compressionLevel, shuffle, typeSize, minCompressedBlockSize );
+		}
+		else
+		{
+			numBlocks = compress(
+				data, size, compressedBuffer, compressionLevel, shuffle, typeSize,
+				hint.compressor.empty() ? m_compressor : hint.compressor,
+				m_compressionThreadCount, m_maxCompressedBlockSize, minCompressedBlockSize
+			);
+		}
 	}
 
 	//! if compression fails or produces a buffer larger than the original
 	//! write the original source data uncompressed
-	if( numBlocks && !compressedBuffer.empty() && ( compressedBuffer.size() < size ) )
+	const bool compressed = numBlocks && !compressedBuffer.empty() && ( compressedBuffer.size() < size );
+
+	if( m_blockStore && !prefixSize )
+	{
+		const char *storedData = compressed ? compressedBuffer.data() : data;
+		const size_t storedSize = compressed ? compressedBuffer.size() : size;
+		if( storedSize >= m_blockStoreMinSize )
+		{
+			MurmurHash hash;
+			hash.append( storedData, storedSize );
+			if( m_blockStoreReferences.insert( hash ).second )
+			{
+				m_blockStore->write( hash, storedData, storedSize );
+			}
+			m_hasChanged = true;
+
+			writeInfo.size = storedSize;
+			writeInfo.numCompressedBlocks = compressed ? numBlocks : 0;
+			writeInfo.blockHash = hash;
+			return writeInfo;
+		}
+	}
+
+	if( compressed )
 	{
 		writeInfo.offset = writeUniqueData( compressedBuffer.data(), compressedBuffer.size(), prefixSize );
 		writeInfo.size = compressedBuffer.size();
@@ -2580,6 +3011,94 @@ StreamIndexedIO::Index::WriteInfo StreamIndexedIO::Index::writeUniqueDataCompres
 	return writeInfo;
 }
 
+size_t StreamIndexedIO::Index::autoTuneCompress( const char *data, size_t size, std::vector<char> &outputBuffer, int compressionLevel, int shuffle, size_t typeSize, size_t minCompressedBlockSize )
+{
+	// Number of entries sampled before choosing a compressor.
+	static const size_t g_autoTuneSampleCount = 32;
+
+	if( size < minCompressedBlockSize )
+	{
+		return 0;
+	}
+
+	size_t bestNumBlocks = 0;
+	std::vector<char> candidateBuffer;
+	std::vector<char> decompressedBuffer;
+	for( auto &candidate : m_autoTuneCandidates )
+	{
+		size_t numBlocks = compress(
+			data, size, candidateBuffer, compressionLevel, shuffle, typeSize, candidate.compressor,
+			m_compressionThreadCount, m_maxCompressedBlockSize, minCompressedBlockSize
+		);
+
+		if( !numBlocks || candidateBuffer.size() >= size )
+		{
+			// Incompressible with this candidate, so reading it would mean reading the raw data.
+			candidate.compressedSize += size;
+			continue;
+		}
+
+		Timer timer( true, Timer::WallClock );
+		decompress( candidateBuffer.data(), candidateBuffer.size(), decompressedBuffer, m_decompressionThreadCount );
+		candidate.decompressionTime += timer.stop();
+		candidate.compressedSize += candidateBuffer.size();
+
+		if( !bestNumBlocks || candidateBuffer.size() < outputBuffer.size() )
+		{
+			bestNumBlocks = numBlocks;
+			outputBuffer.swap( candidateBuffer );
+		}
+	}
+
+	if( ++m_autoTuneSamples >= g_autoTuneSampleCount )
+	{
+		autoTuneSelect();
+	}
+
+	return bestNumBlocks;
+}
+
+void StreamIndexedIO::Index::autoTuneSelect()
+{
+	// Read bandwidth used to weigh file size against decompression speed.
+	// It is typical of files being served over a network.
+	static const double g_autoTuneBandwidth = 500.0 * 1024 * 1024;
+
+	if( !m_autoTuneSamples )
+	{
+		return;
+	}
+
+	const AutoTuneCandidate *best = nullptr;
+	double bestCost = 0;
+	for( const auto &candidate : m_autoTuneCandidates )
+	{
+		const double cost = candidate.compressedSize / g_autoTuneBandwidth + candidate.decompressionTime;
+		if( !best || cost < bestCost )
+		{
+			best = &candidate;
+			bestCost = cost;
+		}
+	}
+
+	if( best )
+	{
+		m_compressor = best->compressor;
+	}
+	m_autoTuneCandidates.clear();
+}
+
+const StreamIndexedIO::CompressionHint &StreamIndexedIO::Index::compressionHint( const IndexedIO::EntryID &name, const CompressionHint &parentHint ) const
+{
+	if( m_compressionHints.empty() )
+	{
+		return parentHint;
+	}
+
+	CompressionHints::const_iterator it = m_compressionHints.find( name );
+	return it != m_compressionHints.end() ? it->second : parentHint;
+}
+
 void StreamIndexedIO::Index::deallocateWalk( NodeBase* n )
 {
 	assert(n);
@@ -2631,7 +3150,7 @@ void StreamIndexedIO::Index::commitNodeToSubIndex( DirectoryNode *n )
 		sink.get(indexData, indexDataSize);
 
 		std::vector<char> compressedIndex;
-		compress( indexData, indexDataSize, compressedIndex, indexCompressionLevel, indexCompressor, 1, BLOSC_MAX_BUFFERSIZE, 0);
+		compress( indexData, indexDataSize, compressedIndex, indexCompressionLevel, StreamIndexedIO::CompressionHint::ByteShuffle, 4, indexCompressor, 1, BLOSC_MAX_BUFFERSIZE, 0);
 
 		uint32_t subindexSize = compressedIndex.size();
 
@@ -2664,8 +3183,14 @@ void StreamIndexedIO::Index::readNodeFromSubIndex( DirectoryNode *n )
 	if (m_version >= 7)
 	{
 		std::vector<char> decompressedIndex;
+		const auto startTime = std::chrono::steady_clock::now();
 		decompress( data, subindexSize, decompressedIndex, 1 );
 
+		StreamIndexedIO::ReadStatistics &statistics = g_readStatistics.local();
+		statistics.bytesRead += subindexSize;
+		statistics.bytesDecompressed += decompressedIndex.size();
+		statistics.decompressionTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
 		MemoryStreamSource source( &decompressedIndex[0], decompressedIndex.size(), false );
 		indexInStream.push( source );
 		assert( indexInStream.is_complete() );
@@ -2752,6 +3277,11 @@ IndexedIO::OpenMode StreamIndexedIO::StreamFile::openMode() const
 	return m_openmode;
 }
 
+std::string StreamIndexedIO::StreamFile::fileName() const
+{
+	return "";
+}
+
 void StreamIndexedIO::StreamFile::setInput( std::iostream *stream, bool emptyFile, const std::string& fileName )
 {
 	m_stream = stream;
@@ -2870,6 +3400,46 @@ void StreamIndexedIO::StreamFile::write( const char *buffer, size_t size )
 //
 ///////////////////////////////////////////////
 
+StreamIndexedIO::CompressionHint::CompressionHint()
+	:	compressionLevel( -1 ), shuffle( DefaultShuffle ), typeSize( 0 ), minCompressedBlockSize( -1 )
+{
+}
+
+bool StreamIndexedIO::CompressionHint::operator == ( const CompressionHint &other ) const
+{
+	return
+		compressor == other.compressor &&
+		compressionLevel == other.compressionLevel &&
+		shuffle == other.shuffle &&
+		typeSize == other.typeSize &&
+		minCompressedBlockSize == other.minCompressedBlockSize
+	;
+}
+
+bool StreamIndexedIO::CompressionHint::operator != ( const CompressionHint &other ) const
+{
+	return !( *this == other );
+}
+
+StreamIndexedIO::ReadStatistics::ReadStatistics()
+	:	bytesRead( 0 ), bytesDecompressed( 0 ), decompressionTime( 0 )
+{
+}
+
+StreamIndexedIO::ReadStatistics StreamIndexedIO::ReadStatistics::operator - ( const ReadStatistics &other ) const
+{
+	ReadStatistics result;
+	result.bytesRead = bytesRead - other.bytesRead;
+	result.bytesDecompressed = bytesDecompressed - other.bytesDecompressed;
+	result.decompressionTime = decompressionTime - other.decompressionTime;
+	return result;
+}
+
+StreamIndexedIO::ReadStatistics StreamIndexedIO::threadReadStatistics()
+{
+	return g_readStatistics.local();
+}
+
 StreamIndexedIO::StreamIndexedIO() : m_node(nullptr)
 {
 }
@@ -3014,6 +3584,7 @@ IndexedIOPtr StreamIndexedIO::subdirectory( const IndexedIO::EntryID &name, Inde
 		}
 	}
 	StreamIndexedIO::Node *newNode = new StreamIndexedIO::Node( m_node->m_idx.get(), childNode );
+	newNode->m_compressionHint = m_node->m_idx->compressionHint( name, m_node->m_compressionHint );
 	return duplicate(*newNode);
 }
 
@@ -3052,6 +3623,7 @@ IndexedIOPtr StreamIndexedIO::createSubdirectory( const IndexedIO::EntryID &name
 		throw IOException( "StreamIndexedIO: Could not insert child '" + name.value() + "'" );
 	}
 	StreamIndexedIO::Node *newNode = new StreamIndexedIO::Node( m_node->m_idx.get(), childNode );
+	newNode->m_compressionHint = m_node->m_idx->compressionHint( name, m_node->m_compressionHint );
 	return duplicate(*newNode);
 }
 
@@ -3121,6 +3693,12 @@ IndexedIO::Entry StreamIndexedIO::entry(const IndexedIO::EntryID &name) const
 				return IndexedIO::Entry( dn->name(), IndexedIO::File, dn->dataType(), dn->arrayLength() );
 			}
 
+		case NodeBase::StoredData:
+			{
+				StoredDataNode *dn = static_cast< StoredDataNode * >(node);
+				return IndexedIO::Entry( dn->name(), IndexedIO::File, dn->dataType(), dn->arrayLength() );
+			}
+
 		case NodeBase::Directory:
 		case NodeBase::SubIndex:
 			return IndexedIO::Entry( node->name(), IndexedIO::Directory, IndexedIO::Invalid, 0 );
@@ -3194,6 +3772,18 @@ ConstIndexedIOPtr StreamIndexedIO::directory( const IndexedIO::EntryIDList &path
 	return const_cast< StreamIndexedIO * >(this)->directory( path, missingBehaviour == IndexedIO::CreateIfMissing ? IndexedIO::ThrowIfMissing : missingBehaviour );
 }
 
+void StreamIndexedIO::setCompressionHint( const CompressionHint &hint )
+{
+	assert( m_node );
+	m_node->m_compressionHint = hint;
+}
+
+const StreamIndexedIO::CompressionHint &StreamIndexedIO::getCompressionHint() const
+{
+	assert( m_node );
+	return m_node->m_compressionHint;
+}
+
 void StreamIndexedIO::commit()
 {
 	m_node->m_idx->commitNodeToSubIndex( m_node->m_node );
@@ -3223,8 +3813,8 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const InternedString
 
 	IndexedIO::DataFlattenTraits<Imf::Int64*>::flatten(constIds, arrayLength, data);
 
-	Index::WriteInfo info = index->writeUniqueDataCompressed( data, size );
-	m_node->addDataChild( name, dataType, arrayLength, info.offset, info.size, size, info.numCompressedBlocks );
+	Index::WriteInfo info = index->writeUniqueDataCompressed( data, size, sizeof( Imf::Int64 ), m_node->m_compressionHint );
+	m_node->addDataChild( name, dataType, arrayLength, info.offset, info.size, size, info.numCompressedBlocks, info.blockHash.get_ptr() );
 
 	delete [] ids;
 }
@@ -3284,8 +3874,8 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T *x, unsigned
 	assert(data);
 	IndexedIO::DataFlattenTraits<T*>::flatten(x, arrayLength, data);
 
-	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( data, size );
-	m_node->addDataChild( name, dataType, arrayLength, info.offset, info.size, size, info.numCompressedBlocks );
+	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( data, size, CompressionTypeSize<T>::value, m_node->m_compressionHint );
+	m_node->addDataChild( name, dataType, arrayLength, info.offset, info.size, size, info.numCompressedBlocks, info.blockHash.get_ptr() );
 }
 
 template<typename T>
@@ -3297,8 +3887,8 @@ void StreamIndexedIO::rawWrite(const IndexedIO::EntryID &name, const T *x, unsig
 	unsigned long size = IndexedIO::DataSizeTraits<T*>::size(x, arrayLength);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T*>::type();
 
-	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( (char *) x, size );
-	m_node->addDataChild( name, dataType, arrayLength, info.offset, info.size, size, info.numCompressedBlocks );
+	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( (char *) x, size, CompressionTypeSize<T>::value, m_node->m_compressionHint );
+	m_node->addDataChild( name, dataType, arrayLength, info.offset, info.size, size, info.numCompressedBlocks, info.blockHash.get_ptr() );
 }
 
 template<typename T>
@@ -3314,8 +3904,8 @@ void StreamIndexedIO::write(const IndexedIO::EntryID &name, const T &x)
 	assert(data);
 	IndexedIO::DataFlattenTraits<T>::flatten(x, data);
 
-	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( data, size );
-	m_node->addDataChild( name, dataType, 0, info.offset, info.size, size, info.numCompressedBlocks );
+	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( data, size, CompressionTypeSize<T>::value, m_node->m_compressionHint );
+	m_node->addDataChild( name, dataType, 0, info.offset, info.size, size, info.numCompressedBlocks, info.blockHash.get_ptr() );
 }
 
 template<typename T>
@@ -3327,8 +3917,8 @@ void StreamIndexedIO::rawWrite(const IndexedIO::EntryID &name, const T &x)
 	unsigned long size = IndexedIO::DataSizeTraits<T>::size(x);
 	IndexedIO::DataType dataType = IndexedIO::DataTypeTraits<T>::type();
 
-	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( (char *) &x, size );
-	m_node->addDataChild( name, dataType, 0, info.offset, info.size, size, info.numCompressedBlocks );
+	Index::WriteInfo info = m_node->m_idx->writeUniqueDataCompressed( (char *) &x, size, CompressionTypeSize<T>::value, m_node->m_compressionHint );
+	m_node->addDataChild( name, dataType, 0, info.offset, info.size, size, info.numCompressedBlocks, info.blockHash.get_ptr() );
 }
 
 template<typename T>
@@ -3413,7 +4003,7 @@ void StreamIndexedIO::rawRead(const IndexedIO::EntryID &name, T &x) const
 		throw Exception( "Simple type can't be compressed" );
 	}
 
-	streamFile().read( (char *) &x, nodeInfo.size, nodeInfo.offset );
+	Reader reader( streamFile(), nodeInfo, 1, reinterpret_cast<char *>( &x ) );
 }
 
 #ifdef IE_CORE_LITTLE_ENDIAN
@@ -486,8 +486,10 @@ ConstObjectPtr SOP_SceneCacheSource::modifyObject( const IECore::Object *object,
 					}
 
 					// we need to copy the data in case either copy will be modified later on
+					// and we must make the copy before inserting, as insertion may invalidate `orig`
 					const PrimitiveVariable &orig = modified->variables[values[0]];
-					modified->variables[values[1]] = PrimitiveVariable( orig.interpolation, orig.data->copy() );
+					PrimitiveVariable copy( orig.interpolation, orig.data->copy() );
+					modified->variables[values[1]] = copy;
 				}
 			}
 
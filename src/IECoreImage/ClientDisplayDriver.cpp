@@ -41,6 +41,7 @@
 #include "boost/asio.hpp"
 
 #include "IECoreImage/Private/DisplayDriverServerHeader.h"
+#include "IECoreImage/Private/DisplayDriverSharedMemory.h"
 
 #include "IECore/MemoryIndexedIO.h"
 #include "IECore/SimpleTypedData.h"
@@ -48,6 +49,9 @@
 #include "boost/array.hpp"
 #include "boost/bind.hpp"
 
+#include <cstring>
+#include <memory>
+
 using namespace std;
 using boost::asio::ip::tcp;
 using namespace boost;
@@ -55,6 +59,14 @@ using namespace Imath;
 using namespace IECore;
 using namespace IECoreImage;
 
+namespace
+{
+
+// Large enough to hold many 64x64 RGBA buckets in flight.
+const int g_defaultSharedMemorySize = 32 * 1024 * 1024;
+
+} // namespace
+
 class ClientDisplayDriver::PrivateData : public RefCounted
 {
 	public :
@@ -74,6 +86,7 @@ class ClientDisplayDriver::PrivateData : public RefCounted
 		bool m_scanLineOrderOnly;
 		bool m_acceptsRepeatedData;
 		boost::asio::ip::tcp::socket m_socket;
+		std::unique_ptr<DisplayDriverSharedMemory> m_sharedMemory;
 };
 
 IE_CORE_DEFINERUNTIMETYPED( ClientDisplayDriver );
@@ -119,6 +132,29 @@ ClientDisplayDriver::ClientDisplayDriver( const Imath::Box2i &displayWindow, con
 	IECore::CompoundDataPtr tmpParameters = parameters->copy();
 	tmpParameters->writable()[ "clientPID" ] = new IntData( getpid() );
 
+	// When the server is on the same host, offer it a shared memory segment
+	// to receive pixel data through. Failure to create one isn't an error,
+	// as we can always fall back to sending the data over the socket.
+	int sharedMemorySize = g_defaultSharedMemorySize;
+	if( const IntData *sharedMemorySizeData = parameters->member<IntData>( "sharedMemorySize" ) )
+	{
+		sharedMemorySize = sharedMemorySizeData->readable();
+	}
+
+	if( sharedMemorySize > 0 && m_data->m_socket.local_endpoint().address() == m_data->m_socket.remote_endpoint().address() )
+	{
+		try
+		{
+			m_data->m_sharedMemory.reset( new DisplayDriverSharedMemory( sharedMemorySize ) );
+			tmpParameters->writable()[ "sharedMemorySegment" ] = new StringData( m_data->m_sharedMemory->name() );
+		}
+		catch( const std::exception & )
+		{
+			m_data->m_sharedMemory.reset();
+			tmpParameters->writable().erase( "sharedMemorySegment" );
+		}
+	}
+
 	// build the data block
 	io = new MemoryIndexedIO( ConstCharVectorDataPtr(), IndexedIO::rootPath, IndexedIO::Exclusive | IndexedIO::Write );
 	displayWindowData->Object::save( io, "displayWindow" );
@@ -133,7 +169,11 @@ ClientDisplayDriver::ClientDisplayDriver( const Imath::Box2i &displayWindow, con
 
 	boost::asio::write( m_data->m_socket, boost::asio::buffer( &(buf->readable()[0]), dataSize ) );
 
-	if ( receiveHeader( DisplayDriverServerHeader::imageOpen ) != sizeof(m_data->m_scanLineOrderOnly) )
+	// Servers which support shared memory advertise it via the protocol version
+	// of their replies. Older servers ignore the offer, so we mustn't wait for
+	// them to reply to it.
+	unsigned char serverProtocolVersion = 0;
+	if ( receiveHeader( DisplayDriverServerHeader::imageOpen, &serverProtocolVersion ) != sizeof(m_data->m_scanLineOrderOnly) )
 	{
 		throw Exception( "Invalid returned scanLineOrder from display driver server!" );
 	}
@@ -144,6 +184,26 @@ ClientDisplayDriver::ClientDisplayDriver( const Imath::Box2i &displayWindow, con
 		throw Exception( "Invalid returned acceptsRepeatedData from display driver server!" );
 	}
 	m_data->m_socket.receive( boost::asio::buffer( &m_data->m_acceptsRepeatedData, sizeof(m_data->m_acceptsRepeatedData) ) );
+
+	if( m_data->m_sharedMemory && serverProtocolVersion < DisplayDriverServerHeader::sharedMemoryProtocolVersion )
+	{
+		m_data->m_sharedMemory.reset();
+	}
+
+	if( m_data->m_sharedMemory )
+	{
+		// The server only replies about the shared memory segment if we offered one.
+		bool sharedMemoryAccepted = false;
+		if ( receiveHeader( DisplayDriverServerHeader::imageOpen ) != sizeof(sharedMemoryAccepted) )
+		{
+			throw Exception( "Invalid returned sharedMemory from display driver server!" );
+		}
+		m_data->m_socket.receive( boost::asio::buffer( &sharedMemoryAccepted, sizeof(sharedMemoryAccepted) ) );
+		if( !sharedMemoryAccepted )
+		{
+			m_data->m_sharedMemory.reset();
+		}
+	}
 }
 
 ClientDisplayDriver::~ClientDisplayDriver()
@@ -160,6 +220,11 @@ std::string ClientDisplayDriver::port() const
 	return m_data->m_port;
 }
 
+bool ClientDisplayDriver::usingSharedMemory() const
+{
+	return m_data->m_sharedMemory != nullptr;
+}
+
 bool ClientDisplayDriver::scanLineOrderOnly() const
 {
 	return m_data->m_scanLineOrderOnly;
@@ -172,11 +237,18 @@ bool ClientDisplayDriver::acceptsRepeatedData() const
 
 void ClientDisplayDriver::sendHeader( int msg, size_t dataSize )
 {
-	DisplayDriverServerHeader header( (DisplayDriverServerHeader::MessageType)msg, dataSize );
+	// Only imageDataShared needs the newer protocol. Everything else is stamped
+	// with the base version so that older servers accept it.
+	unsigned char protocolVersion = DisplayDriverServerHeader::baseProtocolVersion;
+	if( msg == DisplayDriverServerHeader::imageDataShared )
+	{
+		protocolVersion = DisplayDriverServerHeader::sharedMemoryProtocolVersion;
+	}
+	DisplayDriverServerHeader header( (DisplayDriverServerHeader::MessageType)msg, dataSize, protocolVersion );
 	boost::asio::write( m_data->m_socket, boost::asio::buffer( header.buffer(), header.headerLength ) );
 }
 
-size_t ClientDisplayDriver::receiveHeader( int msg )
+size_t ClientDisplayDriver::receiveHeader( int msg, unsigned char *protocolVersion )
 {
 	DisplayDriverServerHeader header;
 	m_data->m_socket.receive( boost::asio::buffer( header.buffer(), header.headerLength ) );
@@ -197,11 +269,33 @@ size_t ClientDisplayDriver::receiveHeader( int msg )
 	{
 		throw Exception( "Unexpected message type on display driver socket package." );
 	}
+	if( protocolVersion )
+	{
+		*protocolVersion = header.protocolVersion();
+	}
 	return bytesAhead;
 }
 
 void ClientDisplayDriver::imageData( const Box2i &box, const float *data, size_t dataSize )
 {
+	if( m_data->m_sharedMemory )
+	{
+		// If the server is still busy with earlier buckets there may not be room
+		// in the segment, in which case we send this bucket over the socket instead.
+		// Messages are processed in order, so mixing the two is safe.
+		const size_t payloadSize = sizeof( box ) + dataSize * sizeof( float );
+		uint64_t position[2];
+		if( char *payload = m_data->m_sharedMemory->reserve( payloadSize, position[0] ) )
+		{
+			memcpy( payload, &box, sizeof( box ) );
+			memcpy( payload + sizeof( box ), data, dataSize * sizeof( float ) );
+			position[1] = payloadSize;
+			sendHeader( DisplayDriverServerHeader::imageDataShared, sizeof( position ) );
+			boost::asio::write( m_data->m_socket, boost::asio::buffer( position, sizeof( position ) ) );
+			return;
+		}
+	}
+
 	sendHeader( DisplayDriverServerHeader::imageData, sizeof( box ) + dataSize * sizeof( float ) );
 
 	boost::array<boost::asio::const_buffer, 2> buffers = { {
@@ -216,5 +310,6 @@ void ClientDisplayDriver::imageClose()
 	sendHeader( DisplayDriverServerHeader::imageClose, 0 );
 	receiveHeader( DisplayDriverServerHeader::imageClose );
 	m_data->m_socket.close();
+	m_data->m_sharedMemory.reset();
 }
 
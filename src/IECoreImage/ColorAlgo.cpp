@@ -51,6 +51,36 @@ using namespace IECoreImage;
 namespace
 {
 
+void transformBuffer( void *data, TypeDesc type, size_t size, const std::string &inputSpace, const std::string &outputSpace )
+{
+	// present it as a single channel, single scanline image
+	ImageSpec spec( size, 1, 1, type );
+	ImageBuf buffer( spec, data );
+
+	ROI roi(
+		/* xbegin */ spec.x, /* xend */ spec.width,
+		/* ybegin */ spec.y, /* yend */ spec.height,
+		/* zbegin */ 0, /* zend */ 1,
+		/* chbegin */ 0, /* chend */ 1
+	);
+
+	// convert in-place
+	bool status = ImageBufAlgo::colorconvert(
+		/* dst */ buffer, /* src */ buffer,
+		/* from */ inputSpace, /* to */ outputSpace,
+		/* unpremult */ false,
+		/* context_key */ "",
+		/* context_value */ "",
+		/* colorconfig */ OpenImageIOAlgo::colorConfig(),
+		/* roi */ roi
+	);
+
+	if( !status )
+	{
+		throw Exception( std::string( "ColorAlgo::transformChannel : " + buffer.geterror() ) );
+	}
+}
+
 struct ColorTransformer
 {
 	typedef void ReturnType;
@@ -63,33 +93,8 @@ struct ColorTransformer
 	template<typename T>
 	ReturnType operator()( T *data )
 	{
-		// present it as a single channel, single scanline image
 		OpenImageIOAlgo::DataView dataView( data );
-		ImageSpec spec( dataView.type.arraylen, 1, 1, dataView.type.elementtype() );
-		ImageBuf buffer( spec, data->baseWritable() );
-
-		ROI roi(
-			/* xbegin */ spec.x, /* xend */ spec.width,
-			/* ybegin */ spec.y, /* yend */ spec.height,
-			/* zbegin */ 0, /* zend */ 1,
-			/* chbegin */ 0, /* chend */ 1
-		);
-
-		// convert in-place
-		bool status = ImageBufAlgo::colorconvert(
-			/* dst */ buffer, /* src */ buffer,
-			/* from */ m_inputSpace, /* to */ m_outputSpace,
-			/* unpremult */ false,
-			/* context_key */ "",
-			/* context_value */ "",
-			/* colorconfig */ OpenImageIOAlgo::colorConfig(),
-			/* roi */ roi
-		);
-
-		if( !status )
-		{
-			throw Exception( std::string( "ColorAlgo::transformChannel : " + buffer.geterror() ) );
-		}
+		transformBuffer( data->baseWritable(), dataView.type.elementtype(), dataView.type.arraylen, m_inputSpace, m_outputSpace );
 	}
 
 	const std::string &m_inputSpace;
@@ -115,6 +120,16 @@ void transformChannel( Data *channel, const std::string &inputSpace, const std::
 	IECore::despatchTypedData<ColorTransformer, IECore::TypeTraits::IsNumericVectorTypedData>( channel, transformer );
 }
 
+void transformChannel( float *channel, size_t size, const std::string &inputSpace, const std::string &outputSpace )
+{
+	if( outputSpace == inputSpace || !size )
+	{
+		return;
+	}
+
+	transformBuffer( channel, TypeDesc::FLOAT, size, inputSpace, outputSpace );
+}
+
 void transformImage( ImagePrimitive *image, const std::string &inputSpace, const std::string &outputSpace )
 {
 	if( outputSpace == inputSpace )
@@ -40,6 +40,7 @@
 #include "boost/asio.hpp"
 
 #include "IECoreImage/Private/DisplayDriverServerHeader.h"
+#include "IECoreImage/Private/DisplayDriverSharedMemory.h"
 
 #include "IECore/MemoryIndexedIO.h"
 #include "IECore/MessageHandler.h"
@@ -49,7 +50,11 @@
 
 #include "tbb/tbb_thread.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fcntl.h>
+#include <memory>
+#include <vector>
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
@@ -61,11 +66,31 @@ using namespace IECoreImage;
 
 IE_CORE_DEFINERUNTIMETYPED( DisplayDriverServer );
 
+namespace
+{
+
+// Coalesced updates are limited to this many pixels, so that a fast
+// renderer can't delay updates to the display indefinitely.
+const size_t g_maxCoalescedPixels = 256 * 256;
+
+// Shared between the server and its sessions, which may outlive it
+// briefly while the io_service is destroyed.
+struct BucketCounts
+{
+	BucketCounts() : received( 0 ), forwarded( 0 ) {}
+	std::atomic<size_t> received;
+	std::atomic<size_t> forwarded;
+};
+
+using BucketCountsPtr = std::shared_ptr<BucketCounts>;
+
+} // namespace
+
 class DisplayDriverServer::Session : public RefCounted
 {
 	public:
 
-		Session( boost::asio::io_service& io_service );
+		Session( boost::asio::io_service& io_service, bool coalesceBuckets, const BucketCountsPtr &bucketCounts );
 		~Session() override;
 
 		boost::asio::ip::tcp::socket& socket();
@@ -73,17 +98,34 @@ class DisplayDriverServer::Session : public RefCounted
 
 	private:
 
+		void readHeader();
+		// Passes data on to the display driver, coalescing it with
+		// adjacent buckets first if requested.
+		void imageData( const Imath::Box2i &box, const float *data, size_t dataSize );
+		void flushImageData();
+
 		void handleReadHeader( const boost::system::error_code& error );
 		void handleReadOpenParameters( const boost::system::error_code& error );
 		void handleReadDataParameters( const boost::system::error_code& error );
-		void sendResult( DisplayDriverServerHeader::MessageType msg, size_t dataSize );
+		void handleReadSharedDataParameters( const boost::system::error_code& error );
+		void sendResult( DisplayDriverServerHeader::MessageType msg, size_t dataSize, unsigned char protocolVersion = DisplayDriverServerHeader::baseProtocolVersion );
 		void sendException( const char *message );
 
 	private:
 		boost::asio::ip::tcp::socket m_socket;
+		// All handlers for a session are run through its strand, so that the
+		// display driver is only ever called by one thread at a time, even
+		// when the server is running several threads.
+		boost::asio::io_service::strand m_strand;
 		DisplayDriverPtr m_displayDriver;
 		DisplayDriverServerHeader m_header;
 		CharVectorDataPtr m_buffer;
+		std::unique_ptr<DisplayDriverSharedMemory> m_sharedMemory;
+
+		const bool m_coalesceBuckets;
+		const BucketCountsPtr m_bucketCounts;
+		Imath::Box2i m_pendingBox;
+		std::vector<float> m_pendingData;
 };
 
 class DisplayDriverServer::PrivateData : public RefCounted
@@ -95,14 +137,17 @@ class DisplayDriverServer::PrivateData : public RefCounted
 		boost::asio::ip::tcp::endpoint m_endpoint;
 		boost::asio::io_service m_service;
 		boost::asio::ip::tcp::acceptor m_acceptor;
-		tbb::tbb_thread m_thread;
+		std::vector<std::unique_ptr<tbb::tbb_thread>> m_threads;
+		bool m_coalesceBuckets;
+		BucketCountsPtr m_bucketCounts;
 
-		PrivateData( int portNumber ) :
+		PrivateData( int portNumber, bool coalesceBuckets ) :
 			m_success(false),
 			m_endpoint(tcp::v4(), portNumber),
 			m_service(),
 			m_acceptor( m_service ),
-			m_thread()
+			m_coalesceBuckets( coalesceBuckets ),
+			m_bucketCounts( new BucketCounts )
 		{
 			m_acceptor.open(  m_endpoint.protocol() );
 			m_acceptor.set_option( boost::asio::ip::tcp::acceptor::reuse_address(true));
@@ -117,7 +162,10 @@ class DisplayDriverServer::PrivateData : public RefCounted
 			{
 				m_acceptor.cancel();
 				m_acceptor.close();
-				m_thread.join();
+				for( auto &thread : m_threads )
+				{
+					thread->join();
+				}
 			}
 		}
 
@@ -135,18 +183,25 @@ static void fixSocketFlags( int socketDesc )
 #endif
 }
 
-DisplayDriverServer::DisplayDriverServer( int portNumber ) :
+DisplayDriverServer::DisplayDriverServer( int portNumber, int numThreads, bool coalesceBuckets ) :
 		m_data( nullptr )
 {
-	m_data = new DisplayDriverServer::PrivateData( portNumber );
+	m_data = new DisplayDriverServer::PrivateData( portNumber, coalesceBuckets );
 
-	DisplayDriverServer::SessionPtr newSession( new DisplayDriverServer::Session( m_data->m_service ) );
+	DisplayDriverServer::SessionPtr newSession( new DisplayDriverServer::Session( m_data->m_service, m_data->m_coalesceBuckets, m_data->m_bucketCounts ) );
 	m_data->m_acceptor.async_accept( newSession->socket(),
 			boost::bind( &DisplayDriverServer::handleAccept, this, newSession,
 			boost::asio::placeholders::error));
 	fixSocketFlags( m_data->m_acceptor.native() );
-	tbb::tbb_thread newThread( boost::bind(&DisplayDriverServer::serverThread, this) );
-	m_data->m_thread.swap( newThread );
+
+	if( numThreads <= 0 )
+	{
+		numThreads = std::max( 1u, tbb::tbb_thread::hardware_concurrency() );
+	}
+	for( int i = 0; i < numThreads; ++i )
+	{
+		m_data->m_threads.emplace_back( new tbb::tbb_thread( boost::bind(&DisplayDriverServer::serverThread, this) ) );
+	}
 }
 
 DisplayDriverServer::~DisplayDriverServer()
@@ -158,6 +213,26 @@ int DisplayDriverServer::portNumber()
 	return m_data->m_acceptor.local_endpoint().port();
 }
 
+int DisplayDriverServer::numThreads() const
+{
+	return m_data->m_threads.size();
+}
+
+bool DisplayDriverServer::coalesceBuckets() const
+{
+	return m_data->m_coalesceBuckets;
+}
+
+size_t DisplayDriverServer::numBucketsReceived() const
+{
+	return m_data->m_bucketCounts->received;
+}
+
+size_t DisplayDriverServer::numBucketsForwarded() const
+{
+	return m_data->m_bucketCounts->forwarded;
+}
+
 void DisplayDriverServer::serverThread()
 {
 	try
@@ -174,7 +249,7 @@ void DisplayDriverServer::handleAccept( DisplayDriverServer::SessionPtr session,
 {
 	if (!error)
 	{
-		DisplayDriverServer::SessionPtr newSession( new DisplayDriverServer::Session( m_data->m_service ) );
+		DisplayDriverServer::SessionPtr newSession( new DisplayDriverServer::Session( m_data->m_service, m_data->m_coalesceBuckets, m_data->m_bucketCounts ) );
 		m_data->m_acceptor.async_accept( newSession->socket(),
 				boost::bind( &DisplayDriverServer::handleAccept,  this, newSession,
 				boost::asio::placeholders::error));
@@ -186,8 +261,9 @@ void DisplayDriverServer::handleAccept( DisplayDriverServer::SessionPtr session,
  * DisplayDriverServer::Session functions
  */
 
-DisplayDriverServer::Session::Session( boost::asio::io_service& io_service ) :
-	m_socket( io_service ), m_displayDriver(nullptr), m_buffer( new CharVectorData( ) )
+DisplayDriverServer::Session::Session( boost::asio::io_service& io_service, bool coalesceBuckets, const BucketCountsPtr &bucketCounts ) :
+	m_socket( io_service ), m_strand( io_service ), m_displayDriver(nullptr), m_buffer( new CharVectorData( ) ),
+	m_coalesceBuckets( coalesceBuckets ), m_bucketCounts( bucketCounts )
 {
 }
 
@@ -202,15 +278,92 @@ boost::asio::ip::tcp::socket& DisplayDriverServer::Session::socket()
 }
 
 void DisplayDriverServer::Session::start()
+{
+	readHeader();
+	fixSocketFlags( m_socket.native() );
+}
+
+void DisplayDriverServer::Session::readHeader()
 {
 	boost::asio::async_read( m_socket,
 			boost::asio::buffer( m_header.buffer(), m_header.headerLength),
-			boost::bind(
+			m_strand.wrap( boost::bind(
 				&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
 				boost::asio::placeholders::error
-			)
+			) )
 	);
-	fixSocketFlags( m_socket.native() );
+}
+
+void DisplayDriverServer::Session::imageData( const Imath::Box2i &box, const float *data, size_t dataSize )
+{
+	m_bucketCounts->received++;
+	if( !m_coalesceBuckets )
+	{
+		m_bucketCounts->forwarded++;
+		m_displayDriver->imageData( box, data, dataSize );
+		return;
+	}
+
+	const size_t width = box.max.x - box.min.x + 1;
+	const size_t height = box.max.y - box.min.y + 1;
+	const size_t numChannels = dataSize / ( width * height );
+
+	if( !m_pendingBox.isEmpty() )
+	{
+		const size_t pendingWidth = m_pendingBox.max.x - m_pendingBox.min.x + 1;
+		const size_t pendingHeight = m_pendingBox.max.y - m_pendingBox.min.y + 1;
+		const bool fits =
+			numChannels == m_pendingData.size() / ( pendingWidth * pendingHeight ) &&
+			m_pendingData.size() / numChannels + width * height <= g_maxCoalescedPixels
+		;
+
+		if( fits && box.min.x == m_pendingBox.min.x && box.max.x == m_pendingBox.max.x && box.min.y == m_pendingBox.max.y + 1 )
+		{
+			// Directly below the pending data, so we can simply append.
+			m_pendingData.insert( m_pendingData.end(), data, data + dataSize );
+			m_pendingBox.max.y = box.max.y;
+			return;
+		}
+		else if( fits && box.min.y == m_pendingBox.min.y && box.max.y == m_pendingBox.max.y && box.min.x == m_pendingBox.max.x + 1 )
+		{
+			// Directly to the right of the pending data, so we must
+			// interleave the rows of the two.
+			const size_t pendingRowSize = pendingWidth * numChannels;
+			const size_t rowSize = width * numChannels;
+			std::vector<float> merged( m_pendingData.size() + dataSize );
+			float *out = merged.data();
+			for( size_t y = 0; y < height; ++y )
+			{
+				out = std::copy( m_pendingData.data() + y * pendingRowSize, m_pendingData.data() + ( y + 1 ) * pendingRowSize, out );
+				out = std::copy( data + y * rowSize, data + ( y + 1 ) * rowSize, out );
+			}
+			m_pendingData.swap( merged );
+			m_pendingBox.max.x = box.max.x;
+			return;
+		}
+
+		flushImageData();
+	}
+
+	m_pendingBox = box;
+	m_pendingData.assign( data, data + dataSize );
+}
+
+void DisplayDriverServer::Session::flushImageData()
+{
+	if( m_pendingBox.isEmpty() )
+	{
+		return;
+	}
+
+	// Clear the pending state first, so that an exception from the
+	// display driver doesn't leave us trying to send the data again.
+	Imath::Box2i box;
+	std::vector<float> data;
+	std::swap( box, m_pendingBox );
+	data.swap( m_pendingData );
+	m_bucketCounts->forwarded++;
+	m_displayDriver->imageData( box, data.data(), data.size() );
 }
 
 void DisplayDriverServer::Session::handleReadHeader( const boost::system::error_code& error )
@@ -241,15 +394,22 @@ void DisplayDriverServer::Session::handleReadHeader( const boost::system::error_
 	case DisplayDriverServerHeader::imageOpen:
 		boost::asio::async_read( m_socket,
 				boost::asio::buffer( &data[0], bytesAhead ),
-				boost::bind( &DisplayDriverServer::Session::handleReadOpenParameters, SessionPtr(this), boost::asio::placeholders::error)
+				m_strand.wrap( boost::bind( &DisplayDriverServer::Session::handleReadOpenParameters, SessionPtr(this), boost::asio::placeholders::error) )
 		);
 		break;
 
 	case DisplayDriverServerHeader::imageData:
 		boost::asio::async_read( m_socket,
 				boost::asio::buffer( &data[0], bytesAhead ),
-				boost::bind(&DisplayDriverServer::Session::handleReadDataParameters, SessionPtr(this),
-				boost::asio::placeholders::error));
+				m_strand.wrap( boost::bind(&DisplayDriverServer::Session::handleReadDataParameters, SessionPtr(this),
+				boost::asio::placeholders::error) ) );
+		break;
+
+	case DisplayDriverServerHeader::imageDataShared:
+		boost::asio::async_read( m_socket,
+				boost::asio::buffer( &data[0], bytesAhead ),
+				m_strand.wrap( boost::bind(&DisplayDriverServer::Session::handleReadSharedDataParameters, SessionPtr(this),
+				boost::asio::placeholders::error) ) );
 		break;
 
 	case DisplayDriverServerHeader::imageClose:
@@ -257,6 +417,7 @@ void DisplayDriverServer::Session::handleReadHeader( const boost::system::error_
 		{
 			try
 			{
+				flushImageData();
 				m_displayDriver->imageClose();
 			}
 			catch ( std::exception &e )
@@ -305,6 +466,8 @@ void DisplayDriverServer::Session::handleReadOpenParameters( const boost::system
 	CompoundDataPtr parameters;
 	bool scanLineOrder = false;
 	bool acceptsRepeatedData = false;
+	bool sharedMemoryRequested = false;
+	bool sharedMemoryAccepted = false;
 
 	// handle imageOpen parameters.
 	try
@@ -317,11 +480,35 @@ void DisplayDriverServer::Session::handleReadOpenParameters( const boost::system
 
 		const StringData *displayType = parameters->member<StringData>( "remoteDisplayType", true /* throw if missing */ );
 
+		// The segment is an implementation detail of the transport, so we don't
+		// pass it on to the display driver.
+		std::string sharedMemorySegment;
+		if( const StringData *sharedMemorySegmentData = parameters->member<StringData>( "sharedMemorySegment" ) )
+		{
+			sharedMemoryRequested = true;
+			sharedMemorySegment = sharedMemorySegmentData->readable();
+			parameters->writable().erase( "sharedMemorySegment" );
+		}
+
 		// create a displayDriver using the factory function.
 		m_displayDriver = DisplayDriver::create( displayType->readable(), displayWindow->readable(), dataWindow->readable(), channelNames->readable(), parameters );
 
 		scanLineOrder = m_displayDriver->scanLineOrderOnly();
 		acceptsRepeatedData = m_displayDriver->acceptsRepeatedData();
+
+		if( sharedMemoryRequested )
+		{
+			// Failure here just means the client will send pixels over the socket.
+			try
+			{
+				m_sharedMemory.reset( new DisplayDriverSharedMemory( sharedMemorySegment ) );
+				sharedMemoryAccepted = true;
+			}
+			catch( std::exception &e )
+			{
+				msg( Msg::Debug, "DisplayDriverServer::Session::handleReadOpenParameters", e.what() );
+			}
+		}
 	}
 	catch( std::exception &e )
 	{
@@ -333,21 +520,28 @@ void DisplayDriverServer::Session::handleReadOpenParameters( const boost::system
 
 	try
 	{
-		// send the result back.
-		sendResult( DisplayDriverServerHeader::imageOpen, sizeof(scanLineOrder) );
+		// send the result back. Only clients which offered shared memory understand
+		// the newer protocol version, which tells them to expect a reply to the offer.
+		unsigned char protocolVersion = DisplayDriverServerHeader::baseProtocolVersion;
+		if( sharedMemoryRequested )
+		{
+			protocolVersion = DisplayDriverServerHeader::sharedMemoryProtocolVersion;
+		}
+
+		sendResult( DisplayDriverServerHeader::imageOpen, sizeof(scanLineOrder), protocolVersion );
 		m_socket.send( boost::asio::buffer( &scanLineOrder, sizeof(scanLineOrder) ) );
 
-		sendResult( DisplayDriverServerHeader::imageOpen, sizeof(acceptsRepeatedData) );
+		sendResult( DisplayDriverServerHeader::imageOpen, sizeof(acceptsRepeatedData), protocolVersion );
 		m_socket.send( boost::asio::buffer( &acceptsRepeatedData, sizeof(acceptsRepeatedData) ) );
 
+		if( sharedMemoryRequested )
+		{
+			sendResult( DisplayDriverServerHeader::imageOpen, sizeof(sharedMemoryAccepted), protocolVersion );
+			m_socket.send( boost::asio::buffer( &sharedMemoryAccepted, sizeof(sharedMemoryAccepted) ) );
+		}
+
 		// prepare for getting imageData packages
-		boost::asio::async_read( m_socket,
-			boost::asio::buffer( m_header.buffer(), m_header.headerLength),
-			boost::bind(
-				&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
-				boost::asio::placeholders::error
-			)
-		);
+		readHeader();
 	}
 	catch( std::exception &e )
 	{
@@ -385,16 +579,16 @@ void DisplayDriverServer::Session::handleReadDataParameters( const boost::system
 		const size_t dataSize = ( m_buffer->readable().size() - sizeof( box ) ) / sizeof( float );
 
 		// call imageData passing the data
-		m_displayDriver->imageData( box, data, dataSize );
+		imageData( box, data, dataSize );
+		if( m_socket.available() < m_header.headerLength )
+		{
+			// No more data is waiting, so we update the display
+			// rather than waiting for more buckets to coalesce.
+			flushImageData();
+		}
 
 		// prepare for getting more imageData packages or a imageClose.
-		boost::asio::async_read( m_socket,
-			boost::asio::buffer( m_header.buffer(), m_header.headerLength),
-			boost::bind(
-				&DisplayDriverServer::Session::handleReadHeader, SessionPtr(this),
-				boost::asio::placeholders::error
-			)
-		);
+		readHeader();
 	}
 	catch( std::exception &e )
 	{
@@ -404,9 +598,64 @@ void DisplayDriverServer::Session::handleReadDataParameters( const boost::system
 	}
 }
 
-void DisplayDriverServer::Session::sendResult( DisplayDriverServerHeader::MessageType msg, size_t dataSize )
+void DisplayDriverServer::Session::handleReadSharedDataParameters( const boost::system::error_code& error )
+{
+	if (error)
+	{
+		msg( Msg::Error, "DisplayDriverServer::Session::handleReadSharedDataParameters", error.message().c_str() );
+		m_socket.close();
+		return;
+	}
+
+	if ( !m_displayDriver || !m_sharedMemory )
+	{
+		msg( Msg::Error, "DisplayDriverServer::Session::handleReadSharedDataParameters", "No shared memory segment!" );
+		m_socket.close();
+		return;
+	}
+
+	try
+	{
+		const std::vector<char> &buffer = m_buffer->readable();
+		uint64_t position[2];
+		if( buffer.size() != sizeof( position ) )
+		{
+			throw Exception( "Invalid shared memory message" );
+		}
+		memcpy( position, &buffer[0], sizeof( position ) );
+		if( position[1] < sizeof( Imath::Box2i ) )
+		{
+			throw Exception( "Invalid shared memory payload size" );
+		}
+
+		// The payload is passed straight from the segment to the display driver,
+		// and only released for reuse by the client once the driver is done with it.
+		const char *payload = m_sharedMemory->payload( position[0], position[1] );
+		const Imath::Box2i box = *reinterpret_cast<const Imath::Box2i *>( payload );
+		const float *data = reinterpret_cast<const float *>( payload + sizeof( box ) );
+		const size_t dataSize = ( position[1] - sizeof( box ) ) / sizeof( float );
+
+		imageData( box, data, dataSize );
+		m_sharedMemory->release( position[0], position[1] );
+		if( m_socket.available() < m_header.headerLength )
+		{
+			flushImageData();
+		}
+
+		// prepare for getting more imageData packages or a imageClose.
+		readHeader();
+	}
+	catch( std::exception &e )
+	{
+		msg( Msg::Error, "DisplayDriverServer::Session::handleReadSharedDataParameters", e.what() );
+		m_socket.close();
+		return;
+	}
+}
+
+void DisplayDriverServer::Session::sendResult( DisplayDriverServerHeader::MessageType msg, size_t dataSize, unsigned char protocolVersion )
 {
-	DisplayDriverServerHeader header( msg, dataSize );
+	DisplayDriverServerHeader header( msg, dataSize, protocolVersion );
 	m_socket.send( boost::asio::buffer( header.buffer(), header.headerLength ) );
 }
 
@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECoreImage/Private/DisplayDriverSharedMemory.h"
+
+#include "IECore/Exception.h"
+
+#include "boost/format.hpp"
+
+#include <atomic>
+#include <new>
+
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace boost::interprocess;
+using namespace IECore;
+using namespace IECoreImage;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const uint32_t g_magicNumber = 0x82534d52;
+// Payloads are aligned so that the box and float data at the start of
+// each one can be read in place by the server.
+const size_t g_alignment = 16;
+const size_t g_dataOffset = 64;
+
+size_t align( size_t size )
+{
+	return ( size + g_alignment - 1 ) & ~( g_alignment - 1 );
+}
+
+std::string uniqueName()
+{
+	static std::atomic<unsigned> g_count( 0 );
+	return boost::str( boost::format( "IECoreImageDisplayDriver.%d.%d" ) % getpid() % g_count++ );
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// DisplayDriverSharedMemory
+//////////////////////////////////////////////////////////////////////////
+
+struct DisplayDriverSharedMemory::Control
+{
+	uint32_t magicNumber;
+	uint64_t capacity;
+	std::atomic<uint64_t> readPosition;
+};
+
+DisplayDriverSharedMemory::DisplayDriverSharedMemory( size_t capacity )
+	:	m_name( uniqueName() ), m_owner( true ),
+		m_object( create_only, m_name.c_str(), read_write ),
+		m_control( nullptr ), m_data( nullptr ), m_writePosition( 0 )
+{
+	static_assert( sizeof( Control ) <= g_dataOffset, "Control block too large" );
+
+	capacity = align( capacity );
+	try
+	{
+		m_object.truncate( g_dataOffset + capacity );
+		map();
+	}
+	catch( ... )
+	{
+		shared_memory_object::remove( m_name.c_str() );
+		throw;
+	}
+
+	m_control = new( m_control ) Control;
+	m_control->magicNumber = g_magicNumber;
+	m_control->capacity = capacity;
+	m_control->readPosition.store( 0, std::memory_order_release );
+}
+
+DisplayDriverSharedMemory::DisplayDriverSharedMemory( const std::string &name )
+	:	m_name( name ), m_owner( false ),
+		m_object( open_only, m_name.c_str(), read_write ),
+		m_control( nullptr ), m_data( nullptr ), m_writePosition( 0 )
+{
+	map();
+	if(
+		m_region.get_size() < g_dataOffset ||
+		m_control->magicNumber != g_magicNumber ||
+		m_control->capacity == 0 ||
+		m_region.get_size() < g_dataOffset + m_control->capacity
+	)
+	{
+		throw IECore::Exception( boost::str( boost::format( "Shared memory segment \"%s\" is not a valid display driver buffer" ) % m_name ) );
+	}
+}
+
+DisplayDriverSharedMemory::~DisplayDriverSharedMemory()
+{
+	if( m_owner )
+	{
+		shared_memory_object::remove( m_name.c_str() );
+	}
+}
+
+const std::string &DisplayDriverSharedMemory::name() const
+{
+	return m_name;
+}
+
+size_t DisplayDriverSharedMemory::capacity() const
+{
+	return m_control->capacity;
+}
+
+char *DisplayDriverSharedMemory::reserve( size_t size, uint64_t &position )
+{
+	const uint64_t capacity = m_control->capacity;
+	size = align( size );
+	if( size > capacity )
+	{
+		return nullptr;
+	}
+
+	// Payloads must be contiguous, so if there isn't room before the
+	// end of the ring we skip to the start. The skipped space is released
+	// implicitly when the server releases this payload.
+	uint64_t begin = m_writePosition;
+	uint64_t offset = begin % capacity;
+	if( offset + size > capacity )
+	{
+		begin += capacity - offset;
+		offset = 0;
+	}
+
+	const uint64_t readPosition = m_control->readPosition.load( std::memory_order_acquire );
+	if( begin + size - readPosition > capacity )
+	{
+		return nullptr;
+	}
+
+	m_writePosition = begin + size;
+	position = begin;
+	return m_data + offset;
+}
+
+const char *DisplayDriverSharedMemory::payload( uint64_t position, size_t size ) const
+{
+	const uint64_t capacity = m_control->capacity;
+	const uint64_t offset = position % capacity;
+	if( size > capacity || offset + size > capacity )
+	{
+		throw IECore::Exception( "Shared memory payload lies outside segment" );
+	}
+	return m_data + offset;
+}
+
+void DisplayDriverSharedMemory::release( uint64_t position, size_t size )
+{
+	m_control->readPosition.store( position + align( size ), std::memory_order_release );
+}
+
+void DisplayDriverSharedMemory::map()
+{
+	m_region = mapped_region( m_object, read_write );
+	m_control = static_cast<Control *>( m_region.get_address() );
+	m_data = static_cast<char *>( m_region.get_address() ) + g_dataOffset;
+}
@@ -36,7 +36,11 @@
 
 #include "boost/algorithm/string/predicate.hpp"
 
+#include "tbb/blocked_range.h"
 #include "tbb/mutex.h"
+#include "tbb/parallel_for.h"
+
+#include <cstring>
 
 using namespace std;
 using namespace boost;
@@ -52,6 +56,68 @@ typedef std::map<std::string, ConstImagePrimitivePtr> ImagePool;
 static ImagePool g_pool;
 static tbb::mutex g_poolMutex;
 
+namespace
+{
+
+const int g_tileSize = 64;
+
+// Buckets smaller than this number of values are copied serially,
+// since they would not benefit from the overhead of parallelism.
+const size_t g_parallelThreshold = 64 * 64 * 4;
+
+// Copies one row of interleaved pixels into `numChannels` separate
+// channels. Versions for common channel counts allow the compiler
+// to unroll the inner loop.
+template<size_t N>
+void deinterleave( const float *source, size_t width, float *const *channels, size_t offset )
+{
+	float *targets[N];
+	for( size_t c = 0; c < N; ++c )
+	{
+		targets[c] = channels[c] + offset;
+	}
+
+	for( size_t x = 0; x < width; ++x )
+	{
+		for( size_t c = 0; c < N; ++c )
+		{
+			targets[c][x] = *source++;
+		}
+	}
+}
+
+void deinterleave( const float *source, size_t width, size_t numChannels, float *const *channels, size_t offset )
+{
+	switch( numChannels )
+	{
+		case 1 :
+			memcpy( channels[0] + offset, source, width * sizeof( float ) );
+			break;
+		case 2 :
+			deinterleave<2>( source, width, channels, offset );
+			break;
+		case 3 :
+			deinterleave<3>( source, width, channels, offset );
+			break;
+		case 4 :
+			deinterleave<4>( source, width, channels, offset );
+			break;
+		default :
+			for( size_t c = 0; c < numChannels; ++c )
+			{
+				float *target = channels[c] + offset;
+				const float *s = source + c;
+				for( size_t x = 0; x < width; ++x )
+				{
+					target[x] = *s;
+					s += numChannels;
+				}
+			}
+	}
+}
+
+} // namespace
+
 ImageDisplayDriver::ImageDisplayDriver( const Box2i &displayWindow, const Box2i &dataWindow, const vector<string> &channelNames, ConstCompoundDataPtr parameters ) :
 		DisplayDriver( displayWindow, dataWindow, channelNames, parameters ),
 		m_image( new ImagePrimitive( dataWindow, displayWindow ) )
@@ -60,6 +126,28 @@ ImageDisplayDriver::ImageDisplayDriver( const Box2i &displayWindow, const Box2i
 	{
 		m_image->createChannel<float>( *it );
 	}
+
+	m_channels.reserve( channelNames.size() );
+	for( const auto &name : channelNames )
+	{
+		m_channels.push_back( m_image->getChannel<float>( name ) );
+	}
+
+	if( dataWindow.hasVolume() )
+	{
+		const V2i size = dataWindow.size() + V2i( 1 );
+		m_numTiles = V2i( ( size.x + g_tileSize - 1 ) / g_tileSize, ( size.y + g_tileSize - 1 ) / g_tileSize );
+	}
+	else
+	{
+		m_numTiles = V2i( 0 );
+	}
+	const size_t numTiles = (size_t)m_numTiles.x * m_numTiles.y;
+	m_tileUpdateCounts.reset( new std::atomic<unsigned>[numTiles] );
+	for( size_t i = 0; i < numTiles; ++i )
+	{
+		m_tileUpdateCounts[i] = 0;
+	}
 	if( parameters )
 	{
 		// Add all entries that follow our 'header:' metadata convention to the blindData.
@@ -108,39 +196,62 @@ void ImageDisplayDriver::imageData( const Box2i &box, const float *data, size_t
 		throw Exception("The box is outside image data window.");
 	}
 
-	int pixelSize = channelNames().size();
-	if ( dataSize != (box.max.x - box.min.x + 1) * (box.max.y - box.min.y + 1) * channelNames().size() )
+	const size_t numChannels = m_channels.size();
+	if ( dataSize != (box.max.x - box.min.x + 1) * (box.max.y - box.min.y + 1) * numChannels )
 	{
 		throw Exception("Invalid dataSize value.");
 	}
 
-	int channelId, targetX, targetY, sourceWidth, sourceHeight, targetWidth;
-	sourceWidth = box.max.x - box.min.x + 1;
-	sourceHeight = box.max.y - box.min.y + 1;
-	targetWidth = dataWindow.max.x - dataWindow.min.x + 1;
-	channelId = 0;
-	targetX = box.min.x - dataWindow.min.x;
-	targetY = box.min.y - dataWindow.min.y;
+	const size_t sourceWidth = box.max.x - box.min.x + 1;
+	const size_t sourceHeight = box.max.y - box.min.y + 1;
+	const size_t targetWidth = dataWindow.max.x - dataWindow.min.x + 1;
+	const size_t targetX = box.min.x - dataWindow.min.x;
+	const size_t targetY = box.min.y - dataWindow.min.y;
 
-	for( const auto &name : channelNames() )
+	// We get writable pointers once per bucket rather than once per
+	// pixel. This is cheap, but still takes care of copy-on-write in
+	// case the image has been copied since the last bucket.
+	std::vector<float *> channels( numChannels );
+	for( size_t c = 0; c < numChannels; ++c )
 	{
-		vector< float > &target = boost::static_pointer_cast< FloatVectorData >( m_image->channels[name] )->writable();
-		vector< float >::iterator targetIt;
-		const float *sourceIt = data+channelId;
-		targetIt = target.begin()+targetWidth*targetY+targetX;
+		channels[c] = m_channels[c]->baseWritable();
+	}
 
-		for ( int y = 0; y < sourceHeight; y++ )
+	auto copyRows = [&]( size_t begin, size_t end ) {
+		for( size_t y = begin; y < end; ++y )
 		{
-			for ( int x = 0; x < sourceWidth; x++ )
-			{
-				*targetIt = *sourceIt;
-				sourceIt += pixelSize;
-				targetIt++;
-			}
-			targetIt += targetWidth - sourceWidth;
+			deinterleave(
+				data + y * sourceWidth * numChannels, sourceWidth, numChannels,
+				channels.data(), ( targetY + y ) * targetWidth + targetX
+			);
 		}
+	};
 
-		++channelId;
+	if( dataSize < g_parallelThreshold )
+	{
+		copyRows( 0, sourceHeight );
+	}
+	else
+	{
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, sourceHeight ),
+			[&]( const tbb::blocked_range<size_t> &range ) {
+				copyRows( range.begin(), range.end() );
+			},
+			taskGroupContext
+		);
+	}
+
+	// Publish the update to any readers polling the tiles.
+	const V2i minTile = ( box.min - dataWindow.min ) / g_tileSize;
+	const V2i maxTile = ( box.max - dataWindow.min ) / g_tileSize;
+	for( int y = minTile.y; y <= maxTile.y; ++y )
+	{
+		for( int x = minTile.x; x <= maxTile.x; ++x )
+		{
+			m_tileUpdateCounts[y * m_numTiles.x + x].fetch_add( 1, std::memory_order_release );
+		}
 	}
 }
 
@@ -153,6 +264,38 @@ ConstImagePrimitivePtr ImageDisplayDriver::image() const
 	return m_image;
 }
 
+int ImageDisplayDriver::tileSize()
+{
+	return g_tileSize;
+}
+
+Imath::V2i ImageDisplayDriver::numTiles() const
+{
+	return m_numTiles;
+}
+
+Imath::Box2i ImageDisplayDriver::tileBound( const Imath::V2i &tileIndex ) const
+{
+	const Box2i &dataWindow = m_image->getDataWindow();
+	const V2i min = dataWindow.min + tileIndex * g_tileSize;
+	return Box2i(
+		min,
+		V2i(
+			std::min( min.x + g_tileSize - 1, dataWindow.max.x ),
+			std::min( min.y + g_tileSize - 1, dataWindow.max.y )
+		)
+	);
+}
+
+unsigned ImageDisplayDriver::tileUpdateCount( const Imath::V2i &tileIndex ) const
+{
+	if( tileIndex.x < 0 || tileIndex.y < 0 || tileIndex.x >= m_numTiles.x || tileIndex.y >= m_numTiles.y )
+	{
+		throw InvalidArgumentException( "Tile index out of range" );
+	}
+	return m_tileUpdateCounts[tileIndex.y * m_numTiles.x + tileIndex.x].load( std::memory_order_acquire );
+}
+
 ConstImagePrimitivePtr ImageDisplayDriver::storedImage( const std::string &handle )
 {
 	tbb::mutex::scoped_lock lock( g_poolMutex );
@@ -244,19 +244,12 @@ class ImageReader::Implementation
 			members["dataWindow"] = new Box2iData( dataWindow() );
 		}
 
-		DataPtr readChannel( const std::string &name, bool raw )
+		DataPtr readChannel( const std::string &name, const Imath::Box2i &region, bool raw )
 		{
 			open( /* throwOnFailure */ true );
 
 			const ImageSpec *spec = m_cache->imagespec( m_inputFileName, /* subimage = */ 0, miplevel() );
-
-			const auto channelIt = find( spec->channelnames.begin(), spec->channelnames.end(), name );
-			if( channelIt == spec->channelnames.end() )
-			{
-				throw InvalidArgumentException( "Image Reader : Non-existent image channel \"" + name + "\" requested." );
-			}
-
-			size_t channelIndex = channelIt - spec->channelnames.begin();
+			const size_t channelIndex = this->channelIndex( spec, name );
 
 			if( raw )
 			{
@@ -264,39 +257,39 @@ class ImageReader::Implementation
 				{
 					case TypeDesc::UCHAR :
 					{
-						return readTypedChannel<unsigned char>( channelIndex, spec->format );
+						return readTypedChannel<unsigned char>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::CHAR :
 					{
-						return readTypedChannel<char>( channelIndex, spec->format );
+						return readTypedChannel<char>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::USHORT :
 					{
-						return readTypedChannel<unsigned short>( channelIndex, spec->format );
+						return readTypedChannel<unsigned short>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::SHORT :
 					{
-						return readTypedChannel<short>( channelIndex, spec->format );
+						return readTypedChannel<short>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::UINT :
 					{
-						return readTypedChannel<unsigned int>( channelIndex, spec->format );
+						return readTypedChannel<unsigned int>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::INT :
 					{
-						return readTypedChannel<int>( channelIndex, spec->format );
+						return readTypedChannel<int>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::HALF :
 					{
-						return readTypedChannel<half>( channelIndex, spec->format );
+						return readTypedChannel<half>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::FLOAT :
 					{
-						return readTypedChannel<float>( channelIndex, spec->format );
+						return readTypedChannel<float>( channelIndex, region, spec->format );
 					}
 					case TypeDesc::DOUBLE :
 					{
-						return readTypedChannel<double>( channelIndex, spec->format );
+						return readTypedChannel<double>( channelIndex, region, spec->format );
 					}
 					default :
 					{
@@ -306,37 +299,11 @@ class ImageReader::Implementation
 			}
 			else
 			{
-				DataPtr data = readTypedChannel<float>( channelIndex, TypeDesc::FLOAT );
-				if( (int)channelIndex != spec->alpha_channel && (int)channelIndex != spec->z_channel )
+				DataPtr data = readTypedChannel<float>( channelIndex, region, TypeDesc::FLOAT );
+				std::string linearColorSpace;
+				std::string currentColorSpace;
+				if( colorSpaces( spec, channelIndex, currentColorSpace, linearColorSpace ) )
 				{
-					const char *fileFormat = nullptr;
-					m_cache->get_image_info(
-						m_inputFileName,
-						0, miplevel(), // subimage, miplevel
-						ustring( "fileformat" ),
-						TypeDesc::TypeString, &fileFormat
-					);
-
-					std::string linearColorSpace;
-					std::string currentColorSpace;
-					if( strcmp( fileFormat, "png" ) == 0 )
-					{
-						// The most common use for loading PNGs via Cortex is for icons in Gaffer.
-						// If we were to use the OCIO config to guess the colorspaces as below, we
-						// would get it spectacularly wrong. For instance, with an ACES config the
-						// resulting icons are so washed out as to be illegible. Instead, we hardcode
-						// the rudimentary colour spaces much more likely to be associated with a PNG.
-						// These are supported by OIIO regardless of what OCIO config is in use.
-						/// \todo Should this apply to other formats too? Can we somehow fix
-						/// `OpenImageIOAlgo::colorSpace` instead?
-						linearColorSpace = "linear";
-						currentColorSpace = "sRGB";
-					}
-					else
-					{
-						linearColorSpace = OpenImageIOAlgo::colorSpace( "", *spec );
-						currentColorSpace = OpenImageIOAlgo::colorSpace( fileFormat, *spec );
-					}
 					ColorAlgo::transformChannel( data.get(), currentColorSpace, linearColorSpace );
 				}
 
@@ -344,36 +311,132 @@ class ImageReader::Implementation
 			}
 		}
 
+		Imath::V2i tileSize()
+		{
+			open( /* throwOnFailure */ true );
+
+			// The spec we get from the image cache by default has a tiling
+			// setting based on the caching settings, so we must ask for the
+			// native spec to see how the file is stored on disk.
+			const ImageSpec *spec = m_cache->imagespec( m_inputFileName, /* subimage = */ 0, miplevel(), /* native = */ true );
+			return Imath::V2i( spec->tile_width, spec->tile_height );
+		}
+
+		void readRegion( const Imath::Box2i &region, const std::vector<std::string> &channelNames, float *buffer, bool raw )
+		{
+			open( /* throwOnFailure */ true );
+
+			if( region.isEmpty() )
+			{
+				return;
+			}
+
+			const ImageSpec *spec = m_cache->imagespec( m_inputFileName, /* subimage = */ 0, miplevel() );
+			const size_t numPixels = (size_t)( region.size().x + 1 ) * (size_t)( region.size().y + 1 );
+
+			for( const auto &name : channelNames )
+			{
+				const size_t channelIndex = this->channelIndex( spec, name );
+				readPixels( channelIndex, region, TypeDesc::FLOAT, buffer );
+
+				std::string linearColorSpace;
+				std::string currentColorSpace;
+				if( !raw && colorSpaces( spec, channelIndex, currentColorSpace, linearColorSpace ) )
+				{
+					ColorAlgo::transformChannel( buffer, numPixels, currentColorSpace, linearColorSpace );
+				}
+
+				buffer += numPixels;
+			}
+		}
+
 	private :
 
+		size_t channelIndex( const ImageSpec *spec, const std::string &name ) const
+		{
+			const auto channelIt = find( spec->channelnames.begin(), spec->channelnames.end(), name );
+			if( channelIt == spec->channelnames.end() )
+			{
+				throw InvalidArgumentException( "Image Reader : Non-existent image channel \"" + name + "\" requested." );
+			}
+
+			return channelIt - spec->channelnames.begin();
+		}
+
+		// Returns true if the channel requires a transformation from `currentColorSpace`
+		// to `linearColorSpace`, filling in the color spaces accordingly.
+		bool colorSpaces( const ImageSpec *spec, size_t channelIndex, std::string &currentColorSpace, std::string &linearColorSpace )
+		{
+			if( (int)channelIndex == spec->alpha_channel || (int)channelIndex == spec->z_channel )
+			{
+				return false;
+			}
+
+			const char *fileFormat = nullptr;
+			m_cache->get_image_info(
+				m_inputFileName,
+				0, miplevel(), // subimage, miplevel
+				ustring( "fileformat" ),
+				TypeDesc::TypeString, &fileFormat
+			);
+
+			if( strcmp( fileFormat, "png" ) == 0 )
+			{
+				// The most common use for loading PNGs via Cortex is for icons in Gaffer.
+				// If we were to use the OCIO config to guess the colorspaces as below, we
+				// would get it spectacularly wrong. For instance, with an ACES config the
+				// resulting icons are so washed out as to be illegible. Instead, we hardcode
+				// the rudimentary colour spaces much more likely to be associated with a PNG.
+				// These are supported by OIIO regardless of what OCIO config is in use.
+				/// \todo Should this apply to other formats too? Can we somehow fix
+				/// `OpenImageIOAlgo::colorSpace` instead?
+				linearColorSpace = "linear";
+				currentColorSpace = "sRGB";
+			}
+			else
+			{
+				linearColorSpace = OpenImageIOAlgo::colorSpace( "", *spec );
+				currentColorSpace = OpenImageIOAlgo::colorSpace( fileFormat, *spec );
+			}
+
+			return currentColorSpace != linearColorSpace;
+		}
+
 		template<class T>
-		DataPtr readTypedChannel( size_t channelIndex, TypeDesc dataType )
+		DataPtr readTypedChannel( size_t channelIndex, const Imath::Box2i &region, TypeDesc dataType )
 		{
 			typedef TypedData<vector<T> > DataType;
 			typename DataType::Ptr data = new DataType;
 
-			bool status;
+			if( region.isEmpty() )
+			{
+				return data;
+			}
 
-			const ImageSpec *spec = m_cache->imagespec( m_inputFileName, 0, miplevel() );
+			data->writable().resize( (size_t)( region.size().x + 1 ) * (size_t)( region.size().y + 1 ) );
+			readPixels( channelIndex, region, dataType, &( data->writable()[0] ) );
 
-			data->writable().resize( spec->width * spec->height );
-			status = m_cache->get_pixels(
+			return data;
+		}
+
+		void readPixels( size_t channelIndex, const Imath::Box2i &region, TypeDesc dataType, void *buffer )
+		{
+			const bool status = m_cache->get_pixels(
 				m_inputFileName,
 				0, miplevel(), // subimage, miplevel
-				spec->x, spec->width + spec->x,
-				spec->y, spec->height + spec->y,
+				region.min.x, region.max.x + 1,
+				region.min.y, region.max.y + 1,
 				0, 1, // z begin, z end
 				channelIndex, channelIndex + 1,
 				/* format */ dataType,
-				/* data */ &( data->writable()[0] )
+				/* data */ buffer
 			);
 
 			if( !status )
 			{
+				const ImageSpec *spec = m_cache->imagespec( m_inputFileName, 0, miplevel() );
 				throw IOException( string( "ImageReader : Failed to read channel \"" ) + spec->channelnames[channelIndex] + "\". " + m_cache->geterror() );
 			}
-
-			return data;
 		}
 
 		void addMetadata( const std::string &name, DataPtr data, CompoundData *metadata )
@@ -467,6 +530,25 @@ class ImageReader::Implementation
 
 const Reader::ReaderDescription<ImageReader> ImageReader::g_readerDescription( OpenImageIOAlgo::extensions() );
 
+namespace
+{
+
+const int g_scanlinesPerBand = 64;
+
+// Rounds `x` down to the nearest multiple of `step` from `origin`.
+int alignDown( int x, int origin, int step )
+{
+	int offset = x - origin;
+	int remainder = offset % step;
+	if( remainder < 0 )
+	{
+		remainder += step;
+	}
+	return x - remainder;
+}
+
+} // namespace
+
 ImageReader::ImageReader() :
 	Reader( "Reads image files using OpenImageIO.", new ObjectParameter( "result", "The loaded object", new NullObject, ImagePrimitive::staticTypeId() ) ),
 	m_implementation( new ImageReader::Implementation( this ) )
@@ -538,9 +620,10 @@ ObjectPtr ImageReader::doOperation( const CompoundObject *operands )
 	vector<string> channelNames;
 	channelsToRead( channelNames );
 
+	const Box2i window = image->getDataWindow();
 	for( size_t ci = 0, cend = channelNames.size(); ci != cend; ++ci )
 	{
-		DataPtr d = m_implementation->readChannel( channelNames[ci], rawChannels );
+		DataPtr d = m_implementation->readChannel( channelNames[ci], window, rawChannels );
 		assert( d  );
 		assert( rawChannels || d->typeId()==FloatVectorDataTypeId );
 
@@ -556,7 +639,41 @@ ObjectPtr ImageReader::doOperation( const CompoundObject *operands )
 
 DataPtr ImageReader::readChannel( const std::string &name, bool raw )
 {
-	return m_implementation->readChannel( name, raw );
+	return m_implementation->readChannel( name, dataWindow(), raw );
+}
+
+DataPtr ImageReader::readChannel( const std::string &name, const Imath::Box2i &region, bool raw )
+{
+	return m_implementation->readChannel( name, region, raw );
+}
+
+Imath::V2i ImageReader::tileSize()
+{
+	return m_implementation->tileSize();
+}
+
+void ImageReader::readRegion( const Imath::Box2i &region, const std::vector<std::string> &channelNames, float *buffer, bool raw )
+{
+	m_implementation->readRegion( region, channelNames, buffer, raw );
+}
+
+ImageReader::TileIterator ImageReader::tilesBegin( const Imath::Box2i &region )
+{
+	const Box2i window = dataWindow();
+	V2i size = tileSize();
+	if( size.x <= 0 || size.y <= 0 )
+	{
+		// Scanline image. Iterate in bands of full width scanlines, since
+		// that is the granularity in which they are decompressed.
+		size = V2i( window.size().x + 1, g_scanlinesPerBand );
+	}
+
+	return TileIterator( region, size, window.min );
+}
+
+ImageReader::TileIterator ImageReader::tilesEnd()
+{
+	return TileIterator();
 }
 
 void ImageReader::channelsToRead( vector<string> &names )
@@ -630,3 +747,64 @@ CompoundObjectPtr ImageReader::readHeader()
 
 	return header;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// ImageReader::TileIterator
+////////////////////////////////////////////////////////////////////////////////
+
+ImageReader::TileIterator::TileIterator()
+{
+}
+
+ImageReader::TileIterator::TileIterator( const Imath::Box2i &region, const Imath::V2i &tileSize, const Imath::V2i &origin )
+	:	m_region( region ), m_tileSize( tileSize )
+{
+	if( region.isEmpty() || tileSize.x <= 0 || tileSize.y <= 0 )
+	{
+		// Leave m_tile empty, making us equal to the end iterator.
+		return;
+	}
+
+	m_firstTileMin = V2i(
+		alignDown( region.min.x, origin.x, tileSize.x ),
+		alignDown( region.min.y, origin.y, tileSize.y )
+	);
+	m_tileMin = m_firstTileMin;
+	updateTile();
+}
+
+void ImageReader::TileIterator::increment()
+{
+	m_tileMin.x += m_tileSize.x;
+	if( m_tileMin.x > m_region.max.x )
+	{
+		m_tileMin.x = m_firstTileMin.x;
+		m_tileMin.y += m_tileSize.y;
+		if( m_tileMin.y > m_region.max.y )
+		{
+			m_tile = Box2i();
+			return;
+		}
+	}
+
+	updateTile();
+}
+
+bool ImageReader::TileIterator::equal( const TileIterator &other ) const
+{
+	return m_tile == other.m_tile;
+}
+
+const Imath::Box2i &ImageReader::TileIterator::dereference() const
+{
+	return m_tile;
+}
+
+void ImageReader::TileIterator::updateTile()
+{
+	const V2i tileMax = m_tileMin + m_tileSize - V2i( 1 );
+	m_tile = Box2i(
+		V2i( std::max( m_tileMin.x, m_region.min.x ), std::max( m_tileMin.y, m_region.min.y ) ),
+		V2i( std::min( tileMax.x, m_region.max.x ), std::min( tileMax.y, m_region.max.y ) )
+	);
+}
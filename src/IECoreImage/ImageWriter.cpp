@@ -39,12 +39,11 @@
 #include "IECoreImage/OpenImageIOAlgo.h"
 
 #include "IECore/CompoundParameter.h"
-#include "IECore/DataInterleaveOp.h"
-#include "IECore/DespatchTypedData.h"
+#include "IECore/DataAlgo.h"
 #include "IECore/Exception.h"
 #include "IECore/FileNameParameter.h"
+#include "IECore/HalfTypeTraits.h"
 #include "IECore/MessageHandler.h"
-#include "IECore/ObjectVector.h"
 #include "IECore/TypedParameter.h"
 
 #include "OpenImageIO/imageio.h"
@@ -59,6 +58,10 @@
 #include "boost/static_assert.hpp"
 #include "boost/type_traits.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_group.h"
+
 #ifndef _MSC_VER
 #include <sys/utsname.h>
 #endif
@@ -232,6 +235,434 @@ void setImageSpecFormatOptions( const CompoundObject *operands, ImageSpec *spec,
 	}
 }
 
+// The number of scanlines converted and written in one go. This bounds
+// the memory required for the interleaved pixels, while still being
+// large enough to amortise the cost of parallelising the conversion.
+const int g_scanlinesPerBlock = 64;
+
+bool isIntegerType( TypeDesc type )
+{
+	return type.basetype != TypeDesc::HALF && type.basetype != TypeDesc::FLOAT && type.basetype != TypeDesc::DOUBLE;
+}
+
+// Copies `count` values from a channel, starting at `srcBegin`, into every
+// `stride`th element of `dst`, converting to the output type on the way.
+template<typename Out>
+struct ChannelInterleaver
+{
+
+	template<typename T>
+	typename std::enable_if<boost::is_arithmetic<T>::value>::type operator()( const TypedData<std::vector<T>> *data, Out *dst, size_t stride, size_t srcBegin, size_t count ) const
+	{
+		const std::vector<T> &src = data->readable();
+		for( size_t i = srcBegin, e = srcBegin + count; i < e; ++i )
+		{
+			*dst = Out( src[i] );
+			dst += stride;
+		}
+	}
+
+	void operator()( const Data *data, Out *dst, size_t stride, size_t srcBegin, size_t count ) const
+	{
+		throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Unsupported channel type \"%s\"" ) % data->typeName() ) );
+	}
+
+};
+
+// Returns a copy of rows [begin, end) of a channel, where each row has `width` values.
+struct RowsCopier
+{
+
+	template<typename T>
+	DataPtr operator()( const TypedData<std::vector<T>> *data, size_t width, size_t begin, size_t end ) const
+	{
+		const std::vector<T> &src = data->readable();
+		typename TypedData<std::vector<T>>::Ptr result = new TypedData<std::vector<T>>;
+		result->writable().assign( src.begin() + begin * width, src.begin() + end * width );
+		return result;
+	}
+
+	DataPtr operator()( const Data *data, size_t width, size_t begin, size_t end ) const
+	{
+		throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Unsupported channel type \"%s\"" ) % data->typeName() ) );
+	}
+
+};
+
+// Converts and interleaves the channels of an image into blocks of
+// scanlines ready for passing to `ImageOutput::write_scanlines()`.
+template<typename Out>
+class ScanlineBlockWriter
+{
+
+	public :
+
+		ScanlineBlockWriter(
+			ImageOutput *out, TypeDesc format, const ImageSpec &spec, const Box2i &dataWindow,
+			const std::vector<const Data *> &channels, const std::vector<bool> &transformChannel,
+			const std::string &inputColorSpace, const std::string &outputColorSpace
+		)
+			:	m_out( out ), m_format( format ), m_spec( spec ), m_dataWindow( dataWindow ), m_channels( channels ),
+				m_transformChannel( transformChannel ), m_inputColorSpace( inputColorSpace ), m_outputColorSpace( outputColorSpace )
+		{
+		}
+
+		void write( const std::string &fileName )
+		{
+			const size_t blockSize = (size_t)g_scanlinesPerBlock * m_spec.width * m_channels.size();
+			std::vector<Out> blocks[2] = { std::vector<Out>( blockSize ), std::vector<Out>( blockSize ) };
+
+			// We overlap the conversion of the next block with the writing
+			// of the current one, since OIIO compresses and writes on the
+			// calling thread.
+			fillBlock( 0, blocks[0] );
+			for( int y = 0, i = 0; y < m_spec.height; y += g_scanlinesPerBlock, i = 1 - i )
+			{
+				const int yEnd = std::min( y + g_scanlinesPerBlock, m_spec.height );
+
+				tbb::task_group taskGroup;
+				if( yEnd < m_spec.height )
+				{
+					std::vector<Out> &nextBlock = blocks[1-i];
+					taskGroup.run( [this, yEnd, &nextBlock] { fillBlock( yEnd, nextBlock ); } );
+				}
+
+				bool status = m_out->write_scanlines(
+					/* ybegin */ m_spec.y + y,
+					/* yend */ m_spec.y + yEnd,
+					/* z */ 0,
+					/* format */ m_format,
+					/* data */ blocks[i].data()
+				);
+
+				taskGroup.wait();
+
+				if( !status )
+				{
+					throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Failed to write \"%s\", error = %s" ) % fileName % m_out->geterror() ) );
+				}
+			}
+		}
+
+	private :
+
+		// Fills the block starting at scanline `y` (relative to the spec origin).
+		void fillBlock( int y, std::vector<Out> &block ) const
+		{
+			const int yEnd = std::min( y + g_scanlinesPerBlock, m_spec.height );
+
+			// Rows of the data window which overlap the block.
+			const int dataYBegin = std::max( m_spec.y + y, m_dataWindow.min.y );
+			const int dataYEnd = std::min( m_spec.y + yEnd - 1, m_dataWindow.max.y ) + 1;
+
+			// Source data for each channel, along with the data window row
+			// which corresponds to its first element. Channels requiring a
+			// colour transform are copied and transformed one block at a
+			// time, rather than copying the whole image up front.
+			const size_t dataWidth = m_dataWindow.size().x + 1;
+			std::vector<ConstDataPtr> sources( m_channels.size() );
+			std::vector<int> sourceYBegin( m_channels.size(), m_dataWindow.min.y );
+
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, m_channels.size() ),
+				[&]( const tbb::blocked_range<size_t> &range )
+				{
+					for( size_t c = range.begin(); c != range.end(); ++c )
+					{
+						if( !m_transformChannel[c] || dataYBegin >= dataYEnd )
+						{
+							sources[c] = m_channels[c];
+							continue;
+						}
+
+						DataPtr rows = dispatch(
+							m_channels[c], RowsCopier(), dataWidth,
+							(size_t)( dataYBegin - m_dataWindow.min.y ), (size_t)( dataYEnd - m_dataWindow.min.y )
+						);
+						ColorAlgo::transformChannel( rows.get(), m_inputColorSpace, m_outputColorSpace );
+						sources[c] = rows;
+						sourceYBegin[c] = dataYBegin;
+					}
+				},
+				taskGroupContext
+			);
+
+			// Interleave the scanlines in parallel.
+			const size_t numChannels = m_channels.size();
+			const size_t scanlineSize = m_spec.width * numChannels;
+			const int xBegin = std::max( m_spec.x, m_dataWindow.min.x );
+			const int xEnd = std::min( m_spec.x + m_spec.width - 1, m_dataWindow.max.x ) + 1;
+
+			tbb::parallel_for(
+				tbb::blocked_range<int>( y, yEnd ),
+				[&]( const tbb::blocked_range<int> &range )
+				{
+					for( int scanline = range.begin(); scanline != range.end(); ++scanline )
+					{
+						Out *dst = block.data() + ( scanline - y ) * scanlineSize;
+						const int dataY = m_spec.y + scanline;
+						if( dataY < dataYBegin || dataY >= dataYEnd || xBegin >= xEnd )
+						{
+							std::fill( dst, dst + scanlineSize, Out( 0 ) );
+							continue;
+						}
+
+						if( xBegin > m_spec.x || xEnd < m_spec.x + m_spec.width )
+						{
+							// Data window doesn't cover the whole scanline, so
+							// zero everything first.
+							std::fill( dst, dst + scanlineSize, Out( 0 ) );
+						}
+
+						for( size_t c = 0; c < numChannels; ++c )
+						{
+							const size_t srcBegin = ( dataY - sourceYBegin[c] ) * dataWidth + ( xBegin - m_dataWindow.min.x );
+							dispatch(
+								sources[c].get(), ChannelInterleaver<Out>(),
+								dst + ( xBegin - m_spec.x ) * numChannels + c, numChannels,
+								srcBegin, (size_t)( xEnd - xBegin )
+							);
+						}
+					}
+				},
+				taskGroupContext
+			);
+		}
+
+		ImageOutput *m_out;
+		const TypeDesc m_format;
+		const ImageSpec &m_spec;
+		const Box2i m_dataWindow;
+		const std::vector<const Data *> &m_channels;
+		const std::vector<bool> &m_transformChannel;
+		const std::string &m_inputColorSpace;
+		const std::string &m_outputColorSpace;
+
+};
+
+// Calls `ScanlineBlockWriter<T>::write()` with `T` matching the element
+// type of the channel data.
+struct ScanlineWriterDispatcher
+{
+
+	template<typename T>
+	typename std::enable_if<boost::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type operator()(
+		const TypedData<std::vector<T>> *data,
+		ImageOutput *out, const ImageSpec &spec, const Box2i &dataWindow,
+		const std::vector<const Data *> &channels, const std::vector<bool> &transformChannel,
+		const std::string &inputColorSpace, const std::string &outputColorSpace,
+		const std::string &fileName
+	) const
+	{
+		const TypeDesc format = OpenImageIOAlgo::DataView( data ).type.elementtype();
+		if( format == TypeDesc::UNKNOWN )
+		{
+			throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Failed to write \"%s\". Unsupported dataType %s." ) % fileName % data->typeName() ) );
+		}
+
+		ScanlineBlockWriter<T> writer( out, format, spec, dataWindow, channels, transformChannel, inputColorSpace, outputColorSpace );
+		writer.write( fileName );
+	}
+
+	void operator()(
+		const Data *data,
+		ImageOutput *out, const ImageSpec &spec, const Box2i &dataWindow,
+		const std::vector<const Data *> &channels, const std::vector<bool> &transformChannel,
+		const std::string &inputColorSpace, const std::string &outputColorSpace,
+		const std::string &fileName
+	) const
+	{
+		throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Failed to write \"%s\". Unsupported dataType %s." ) % fileName % data->typeName() ) );
+	}
+
+};
+
+void writeImage( const ImagePrimitive *image, const std::string &fileName, const CompoundObject *operands )
+{
+	if( !image->channelsValid() )
+	{
+		throw InvalidArgumentException( "ImageWriter: Invalid channels on image" );
+	}
+
+	const Box2i &dataWindow = image->getDataWindow();
+	const Box2i &displayWindow = image->getDisplayWindow();
+
+	/// \todo: nearly everything below this point is copied from GafferImage::ImageWriter
+	/// Can we consolidate some of this into IECoreImage::OpenImageIOAlgo?
+
+	std::unique_ptr<ImageOutput, decltype(&ImageOutput::destroy)> out( ImageOutput::create( fileName ), &ImageOutput::destroy );
+	if( !out )
+	{
+		throw IECore::Exception( OIIO::geterror() );
+	}
+
+	const std::string fileFormatName = out->format_name();
+	const bool supportsDisplayWindow = (bool)out->supports( "displaywindow" ) && fileFormatName != "dpx";
+
+	ImageSpec spec( TypeDesc::UNKNOWN );
+
+	// Specify the display window.
+	spec.full_x = displayWindow.min.x;
+	spec.full_y = displayWindow.min.y;
+	spec.full_width = displayWindow.size().x + 1;
+	spec.full_height = displayWindow.size().y + 1;
+
+	bool validDisplayWindow = supportsDisplayWindow && dataWindow.hasVolume();
+	if( validDisplayWindow )
+	{
+		spec.x = dataWindow.min.x;
+		spec.y = dataWindow.min.y;
+		spec.width = dataWindow.size().x + 1;
+		spec.height = dataWindow.size().y + 1;
+	}
+	else
+	{
+		spec.x = spec.full_x;
+		spec.y = spec.full_y;
+		spec.width = spec.full_width;
+		spec.height = spec.full_height;
+	}
+
+	// Cleanse the image blindData and then add it to the spec
+	CompoundDataPtr metadata = image->blindData()->copy();
+	metadata->writable().erase( "oiio:ColorSpace" );
+	metadata->writable().erase( "oiio:Gamma" );
+	metadata->writable().erase( "oiio:UnassociatedAlpha" );
+	metadata->writable().erase( "fileFormat" );
+	metadata->writable().erase( "dataType" );
+
+	metadataToImageSpecAttributes( metadata.get(), &spec );
+
+	setImageSpecFormatOptions( operands->member<const CompoundObject>( "formatSettings" ), &spec, out->format_name() );
+
+	// Add common attribs to the spec
+	std::string software = ( boost::format( "Cortex %d.%d.%d" ) % IE_CORE_MAJORVERSION % IE_CORE_MINORVERSION % IE_CORE_PATCHVERSION ).str();
+	spec.attribute( "Software", software );
+#ifndef _MSC_VER
+	struct utsname info;
+	if ( !(bool)uname( &info ) )
+	{
+		spec.attribute( "HostComputer", info.nodename );
+	}
+#else
+	if ( const char *hostcomputer = getenv( "COMPUTERNAME" ) )
+	{
+		spec.attribute( "HostComputer", hostcomputer );
+	}
+#endif
+	if ( const char *artist = getenv( "USER" ) )
+	{
+		spec.attribute( "Artist", artist );
+	}
+
+	std::vector<std::string> channels;
+	::channelsToWrite( image, out.get(), operands, channels );
+	if( channels.empty() )
+	{
+		throw IECore::Exception( std::string( "IECoreImage::ImageWriter : No valid channels were specified for the file format \"" ) + out->format_name() + "\"." );
+	}
+
+	spec.nchannels = (int)channels.size();
+	spec.channelnames.clear();
+	spec.channelnames.reserve( channels.size() );
+
+	std::vector<const Data *> channelData;
+	channelData.reserve( channels.size() );
+	bool uniformType = true;
+
+	for( auto it = channels.begin(), cEnd = channels.end(); it != cEnd; ++it )
+	{
+		spec.channelnames.push_back( *it );
+
+		const Data *data = image->channels.find( *it )->second.get();
+		uniformType = uniformType && ( channelData.empty() || data->typeId() == channelData.front()->typeId() );
+		channelData.push_back( data );
+
+		// OIIO has a special attribute for the Alpha and Z channels. If we find some, we should tag them...
+		if( *it == "A" )
+		{
+			spec.alpha_channel = (int)(it - channels.begin());
+		}
+		else if( *it == "Z" )
+		{
+			spec.z_channel = (int)(it - channels.begin());
+		}
+	}
+
+	// Channels of differing types are interleaved as floats. Where the
+	// format supports it, integer channels are stored with their own type
+	// rather than that specified by the format settings, so that values
+	// such as ids survive the round trip.
+	if( !uniformType && out->supports( "channelformats" ) )
+	{
+		bool perChannelFormats = false;
+		std::vector<TypeDesc> channelFormats;
+		for( const auto &data : channelData )
+		{
+			const TypeDesc type = OpenImageIOAlgo::DataView( data ).type.elementtype();
+			if( isIntegerType( type ) )
+			{
+				channelFormats.push_back( type );
+				perChannelFormats = true;
+			}
+			else
+			{
+				channelFormats.push_back( spec.format );
+			}
+		}
+		if( perChannelFormats )
+		{
+			spec.channelformats = channelFormats;
+		}
+	}
+
+	// Create the directory we need and open the file
+	boost::filesystem::path directory = boost::filesystem::path( fileName ).parent_path();
+	if( !directory.empty() )
+	{
+		boost::filesystem::create_directories( directory );
+	}
+
+	if ( out->open( fileName, spec ) )
+	{
+		IECore::msg( IECore::MessageHandler::Info, "IECoreImage::ImageWriter", "Writing " + fileName );
+	}
+	else
+	{
+		throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Could not open \"%s\", error = %s" ) % fileName % out->geterror() ) );
+	}
+
+	std::vector<bool> transformChannel( channels.size(), false );
+	std::string linearColorSpace;
+	std::string targetColorSpace;
+	if( !operands->member<const BoolData>( "rawChannels" )->readable() )
+	{
+		linearColorSpace = OpenImageIOAlgo::colorSpace( "", spec );
+		targetColorSpace = OpenImageIOAlgo::colorSpace( out->format_name(), spec );
+		if( linearColorSpace != targetColorSpace )
+		{
+			for( size_t i = 0; i < channels.size(); ++i )
+			{
+				transformChannel[i] = channels[i] != "A" && channels[i] != "Z";
+			}
+		}
+	}
+
+	// The pixels are interleaved in the type of the channels where they
+	// all match, and as floats otherwise. OIIO takes care of the final
+	// conversion to the format stored in the file.
+	ConstDataPtr interleaveType = uniformType ? ConstDataPtr( channelData.front() ) : ConstDataPtr( new FloatVectorData );
+
+	dispatch(
+		interleaveType.get(), ScanlineWriterDispatcher(),
+		out.get(), spec, dataWindow, channelData, transformChannel,
+		linearColorSpace, targetColorSpace, fileName
+	);
+
+	out->close();
+}
+
 } // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -404,20 +835,11 @@ bool ImageWriter::canWrite( ConstObjectPtr object, const string &fileName )
 		return false;
 	}
 
-	const Data *firstChannelData = image->channels.begin()->second.get();
-
-	const OpenImageIOAlgo::DataView dataView( firstChannelData );
-	if( dataView.type == TypeDesc::UNKNOWN )
-	{
-		return false;
-	}
-
 	for( const auto &channel : image->channels )
 	{
-		// OpenImageIO claims to handle non-matching types (if the format supports it)
-		// but when it comes time to write the scanlines, we must pass a single buffer
-		// of interleaved pixels, so we only support a single type for now.
-		if( channel.second->typeId() != firstChannelData->typeId() )
+		// Channels of differing types are supported, provided
+		// OpenImageIO knows how to convert each of them.
+		if( OpenImageIOAlgo::DataView( channel.second.get() ).type == TypeDesc::UNKNOWN )
 		{
 			return false;
 		}
@@ -449,226 +871,30 @@ const ImagePrimitive *ImageWriter::getImage() const
 
 void ImageWriter::doWrite( const CompoundObject *operands )
 {
-	const ImagePrimitive *image = getImage();
-	if( !image->channelsValid() )
-	{
-		throw InvalidArgumentException( "ImageWriter: Invalid channels on image" );
-	}
-
-	const Box2i &dataWindow = image->getDataWindow();
-	const Box2i &displayWindow = image->getDisplayWindow();
-
-	/// \todo: nearly everything below this point is copied from GafferImage::ImageWriter
-	/// Can we consolidate some of this into IECoreImage::OpenImageIOAlgo?
-
-	std::unique_ptr<ImageOutput, decltype(&ImageOutput::destroy)> out( ImageOutput::create( fileName() ), &ImageOutput::destroy );
-	if( !out )
-	{
-		throw IECore::Exception( OIIO::geterror() );
-	}
-
-	const std::string fileFormatName = out->format_name();
-	const bool supportsDisplayWindow = (bool)out->supports( "displaywindow" ) && fileFormatName != "dpx";
-
-	ImageSpec spec( TypeDesc::UNKNOWN );
-
-	// Specify the display window.
-	spec.full_x = displayWindow.min.x;
-	spec.full_y = displayWindow.min.y;
-	spec.full_width = displayWindow.size().x + 1;
-	spec.full_height = displayWindow.size().y + 1;
-
-	bool validDisplayWindow = supportsDisplayWindow && dataWindow.hasVolume();
-	if( validDisplayWindow )
-	{
-		spec.x = dataWindow.min.x;
-		spec.y = dataWindow.min.y;
-		spec.width = dataWindow.size().x + 1;
-		spec.height = dataWindow.size().y + 1;
-	}
-	else
-	{
-		spec.x = spec.full_x;
-		spec.y = spec.full_y;
-		spec.width = spec.full_width;
-		spec.height = spec.full_height;
-	}
-
-	// Cleanse the image blindData and then add it to the spec
-	CompoundDataPtr metadata = image->blindData()->copy();
-	metadata->writable().erase( "oiio:ColorSpace" );
-	metadata->writable().erase( "oiio:Gamma" );
-	metadata->writable().erase( "oiio:UnassociatedAlpha" );
-	metadata->writable().erase( "fileFormat" );
-	metadata->writable().erase( "dataType" );
-
-	metadataToImageSpecAttributes( metadata.get(), &spec );
-
-	setImageSpecFormatOptions( operands->member<const CompoundObject>( "formatSettings" ), &spec, out->format_name() );
-
-	// Add common attribs to the spec
-	std::string software = ( boost::format( "Cortex %d.%d.%d" ) % IE_CORE_MAJORVERSION % IE_CORE_MINORVERSION % IE_CORE_PATCHVERSION ).str();
-	spec.attribute( "Software", software );
-#ifndef _MSC_VER
-	struct utsname info;
-	if ( !(bool)uname( &info ) )
-	{
-		spec.attribute( "HostComputer", info.nodename );
-	}
-#else
-	if ( const char *hostcomputer = getenv( "COMPUTERNAME" ) )
-	{
-		spec.attribute( "HostComputer", hostcomputer );
-	}
-#endif
-	if ( const char *artist = getenv( "USER" ) )
-	{
-		spec.attribute( "Artist", artist );
-	}
-
-	std::vector<std::string> channels;
-	::channelsToWrite( image, out.get(), operands, channels );
-	if( channels.empty() )
-	{
-		throw IECore::Exception( std::string( "IECoreImage::ImageWriter : No valid channels were specified for the file format \"" ) + out->format_name() + "\"." );
-	}
-
-	spec.nchannels = (int)channels.size();
-	spec.channelnames.clear();
-	spec.channelnames.reserve( channels.size() );
-
-	const Data *firstChannelData = image->channels.begin()->second.get();
-
-	for( auto it = channels.begin(), cEnd = channels.end(); it != cEnd; ++it )
-	{
-		spec.channelnames.push_back( *it );
-
-		// OpenImageIO claims to handle non-matching types (if the format supports it)
-		// but when it comes time to write the scanlines, we must pass a single buffer
-		// of interleaved pixels, so we only support a single type for now.
-		if( image->channels.find( *it )->second->typeId() != firstChannelData->typeId() )
-		{
-			throw IECore::Exception( "IECoreImage::ImageWriter : Image must have channels of the same type." );
-		}
-
-		// OIIO has a special attribute for the Alpha and Z channels. If we find some, we should tag them...
-		if( *it == "A" )
-		{
-			spec.alpha_channel = (int)(it - channels.begin());
-		}
-		else if( *it == "Z" )
-		{
-			spec.z_channel = (int)(it - channels.begin());
-		}
-	}
-
-	// Create the directory we need and open the file
-	boost::filesystem::path directory = boost::filesystem::path( fileName() ).parent_path();
-	if( !directory.empty() )
-	{
-		boost::filesystem::create_directories( directory );
-	}
-
-	if ( out->open( fileName(), spec ) )
-	{
-		IECore::msg( IECore::MessageHandler::Info, "IECoreImage::ImageWriter", "Writing " + fileName() );
-	}
-	else
-	{
-		throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Could not open \"%s\", error = %s" ) % fileName() % out->geterror() ) );
-	}
+	writeImage( getImage(), fileName(), operands );
+}
 
-	ImagePrimitivePtr correctedImage = nullptr;
-	if( !operands->member<const BoolData>( "rawChannels" )->readable() )
+std::future<void> ImageWriter::writeAsync()
+{
+	// Take copies of everything we need, so that the parameters may be
+	// modified while the write is in progress. The image is the exception :
+	// we hold a reference to it rather than paying for a copy.
+	const CompoundObject *values = parameters()->getTypedValidatedValue<CompoundObject>();
+	const CompoundObjectPtr operands = new CompoundObject;
+	for( const auto &member : values->members() )
 	{
-		std::string linearColorSpace = OpenImageIOAlgo::colorSpace( "", spec );
-		std::string targetColorSpace = OpenImageIOAlgo::colorSpace( out->format_name(), spec );
-		if( linearColorSpace != targetColorSpace )
+		if( member.first != m_objectParameter->internedName() )
 		{
-			correctedImage = image->copy();
-			ColorAlgo::transformImage( correctedImage.get(), linearColorSpace, targetColorSpace );
+			operands->members()[member.first] = member.second->copy();
 		}
 	}
+	const ConstImagePrimitivePtr image = getImage();
+	const std::string fileName = this->fileName();
 
-	const auto &channelMap = ( correctedImage ) ? correctedImage->channels : image->channels;
-
-	DataInterleaveOpPtr op = new DataInterleaveOp();
-	op->targetTypeParameter()->setNumericValue( firstChannelData->typeId() );
-	auto &vectors = static_cast<ObjectVector *>( op->dataParameter()->getValue() )->members();
-	vectors.reserve( (size_t)spec.nchannels );
-	for( const auto &channel : channels )
-	{
-		vectors.push_back( channelMap.find( channel )->second );
-	}
-
-	DataPtr buffer = static_pointer_cast<Data>( op->operate() );
-	const OpenImageIOAlgo::DataView dataView( buffer.get() );
-	if( dataView.type == TypeDesc::UNKNOWN )
-	{
-		throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Failed to write \"%s\". Unsupported dataType %s." ) % fileName() % buffer->typeName() ) );
-	}
-
-	const unsigned char *rawBuffer = (const unsigned char *)dataView.data;
-	size_t stride = spec.nchannels * spec.width * dataView.type.elementsize();
-
-	IECore::UCharVectorDataPtr scanLineData = new IECore::UCharVectorData();
-	std::vector<unsigned char>& scanLineBuffer = scanLineData->writable();
-	scanLineBuffer.resize(stride);
-
-	auto getScanLine = [&rawBuffer, &spec, &stride, &dataWindow, &dataView, validDisplayWindow, &scanLineBuffer](int y) -> const unsigned char*
-	{
-		if ( validDisplayWindow )
-		{
-			return &rawBuffer[stride * y];
-		}
-		else
-		{
-			memset( &scanLineBuffer[0], 0, stride );
-
-			// ensure the dataWindow is inside the image display window
-			int clampedXStart = std::max( dataWindow.min.x, 0 );
-			int clampedWidth = std::min( dataWindow.size().x + 1, (spec.width - clampedXStart) );
-
-			size_t dataWindowStride = ( dataWindow.size().x + 1) * spec.nchannels * dataView.type.elementsize();
-			size_t bytesToCopy = clampedWidth  * spec.nchannels * dataView.type.elementsize();
-
-			if( y < dataWindow.min.y )
-			{
-				return &scanLineBuffer[0];
-			}
-			else if( y > dataWindow.max.y )
-			{
-				return &scanLineBuffer[0];
-			}
-			else
-			{
-				if ( clampedWidth > 0 )
-				{
-					memcpy(
-						&scanLineBuffer[clampedXStart * spec.nchannels * dataView.type.elementsize()],
-						&rawBuffer[dataWindowStride * ( y - dataWindow.min.y )],
-						bytesToCopy
-					);
-				}
-				return &scanLineBuffer[0];
-			}
+	return std::async(
+		std::launch::async,
+		[operands, image, fileName] {
+			writeImage( image.get(), fileName, operands.get() );
 		}
-	};
-
-	for( int y = 0; y < spec.height; ++y )
-	{
-		bool status = out->write_scanline(
-			/* y */ spec.y + y,
-			/* z */ 0,
-			/* format */ dataView.type,
-			/* data */ getScanLine( y )
-		);
-
-		if( !status )
-		{
-			throw IECore::Exception( boost::str( boost::format( "IECoreImage::ImageWriter : Failed to write \"%s\", error = %s" ) % fileName() % out->geterror() ) );
-		}
-	}
-
-	out->close();
+	);
 }
@@ -153,7 +153,10 @@ const IntParameter * MedianCutSampler::projectionParameter() const
 
 /// \todo This functionality and the code in SummedAreaOp should be
 /// refactored into a low level templated SummedAreaTable class that
-/// operates on data passed to it.
+/// operates on data passed to it. Such a class could be filled a tile at
+/// a time using ImageReader::tilesBegin() and ImageReader::readRegion(),
+/// avoiding the need to load the whole input image. The table itself
+/// must still be held in memory, since the cuts access it randomly.
 typedef boost::multi_array_ref<float, 2> Array2D;
 static inline float energy( const Array2D &summedLuminance, const Box2i &area )
 {
@@ -218,17 +221,23 @@ static void medianCut( const Array2D &luminance, const Array2D &summedLuminance,
 
 ObjectPtr MedianCutSampler::doOperation( const CompoundObject * operands )
 {
-	ImagePrimitivePtr image = static_cast<ImagePrimitive *>( imageParameter()->getValue() )->copy();
-	Box2i dataWindow = image->getDataWindow();
+	const ImagePrimitive *inputImage = static_cast<const ImagePrimitive *>( imageParameter()->getValue() );
+	Box2i dataWindow = inputImage->getDataWindow();
 
 	// find the right channel
 	const std::string &channelName = m_channelNameParameter->getTypedValue();
-	FloatVectorDataPtr luminance = image->getChannel<float>( channelName );
-	if( !luminance )
+	const FloatVectorData *inputLuminance = inputImage->getChannel<float>( channelName );
+	if( !inputLuminance )
 	{
 		throw Exception( str( format( "No FloatVectorData channel named \"%s\"." ) % channelName ) );
 	}
 
+	// we only need the one channel, so we copy just that rather than
+	// the whole image, which may have many more channels.
+	ImagePrimitivePtr image = new ImagePrimitive( dataWindow, inputImage->getDisplayWindow() );
+	FloatVectorDataPtr luminance = inputLuminance->copy();
+	image->channels[channelName] = luminance;
+
 	// if the projection requires it, weight the luminances so they're less
 	// important towards the poles of the sphere
 	Projection projection = (Projection)m_projectionParameter->getNumericValue();
@@ -261,7 +270,7 @@ ObjectPtr MedianCutSampler::doOperation( const CompoundObject * operands )
 	summedAreaOp->inputParameter()->setValue( image );
 	summedAreaOp->copyParameter()->setTypedValue( false );
 	summedAreaOp->channelNamesParameter()->getTypedValue().clear();
-	summedAreaOp->channelNamesParameter()->getTypedValue().push_back( "Y" );
+	summedAreaOp->channelNamesParameter()->getTypedValue().push_back( channelName );
 	summedAreaOp->operate();
 
 	// do the median cut thing
@@ -79,6 +79,7 @@ void bindClientDisplayDriver()
 		.def( "__init__", make_constructor( &clientDisplayDriverConstructor, default_call_policies(), ( boost::python::arg_( "displayWindow" ), boost::python::arg_( "dataWindow" ), boost::python::arg_( "channelNames" ), boost::python::arg_( "parameters" ) ) ) )
 		.def( "host", &ClientDisplayDriver::host )
 		.def( "port", &ClientDisplayDriver::port )
+		.def( "usingSharedMemory", &ClientDisplayDriver::usingSharedMemory )
 	;
 }
 
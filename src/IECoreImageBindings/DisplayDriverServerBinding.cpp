@@ -54,8 +54,12 @@ void bindDisplayDriverServer()
 	using boost::python::arg;
 
 	RunTimeTypedClass<DisplayDriverServer>()
-		.def( init< int >( ( arg( "portNumber" ) = 0 ) ) )
+		.def( init< int, int, bool >( ( arg( "portNumber" ) = 0, arg( "numThreads" ) = 1, arg( "coalesceBuckets" ) = false ) ) )
 		.def( "portNumber", &DisplayDriverServer::portNumber )
+		.def( "numThreads", &DisplayDriverServer::numThreads )
+		.def( "coalesceBuckets", &DisplayDriverServer::coalesceBuckets )
+		.def( "numBucketsReceived", &DisplayDriverServer::numBucketsReceived )
+		.def( "numBucketsForwarded", &DisplayDriverServer::numBucketsForwarded )
 	;
 
 }
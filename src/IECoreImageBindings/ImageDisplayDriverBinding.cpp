@@ -100,6 +100,10 @@ void bindImageDisplayDriver()
 	RunTimeTypedClass<ImageDisplayDriver>()
 		.def( "__init__", make_constructor( &imageDisplayDriverConstructor, default_call_policies(), ( boost::python::arg_( "displayWindow" ), boost::python::arg_( "dataWindow" ), boost::python::arg_( "channelNames" ), boost::python::arg_( "parameters" ) ) ) )
 		.def( "image", &image )
+		.def( "tileSize", &ImageDisplayDriver::tileSize ).staticmethod( "tileSize" )
+		.def( "numTiles", &ImageDisplayDriver::numTiles )
+		.def( "tileBound", &ImageDisplayDriver::tileBound )
+		.def( "tileUpdateCount", &ImageDisplayDriver::tileUpdateCount )
 		.def( "storedImage", &storedImage ).staticmethod( "storedImage" )
 		.def( "removeStoredImage", &removeStoredImage ).staticmethod( "removeStoredImage" )
 	;
@@ -36,6 +36,7 @@
 
 #include "IECore/VectorTypedData.h"
 #include "IECorePython/ReaderBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "IECoreImage/ImageReader.h"
 #include "IECoreImageBindings/ImageReaderBinding.h"
@@ -57,6 +58,29 @@ static StringVectorDataPtr channelNames( ImageReader &that )
 	return result;
 }
 
+static Box2iVectorDataPtr tiles( ImageReader &that, const Imath::Box2i &region )
+{
+	Box2iVectorDataPtr result( new Box2iVectorData );
+	for( ImageReader::TileIterator it = that.tilesBegin( region ), eIt = that.tilesEnd(); it != eIt; ++it )
+	{
+		result->writable().push_back( *it );
+	}
+	return result;
+}
+
+static FloatVectorDataPtr readRegion( ImageReader &that, const Imath::Box2i &region, const StringVectorData *channelNames, bool raw )
+{
+	FloatVectorDataPtr result( new FloatVectorData );
+	if( !region.isEmpty() )
+	{
+		const std::vector<std::string> &names = channelNames->readable();
+		result->writable().resize( names.size() * ( region.size().x + 1 ) * ( region.size().y + 1 ) );
+		IECorePython::ScopedGILRelease gilRelease;
+		that.readRegion( region, names, result->baseWritable(), raw );
+	}
+	return result;
+}
+
 } // namespace
 
 namespace IECoreImageBindings
@@ -74,6 +98,10 @@ void bindImageReader()
 		.def( "dataWindow", &ImageReader::dataWindow )
 		.def( "displayWindow", &ImageReader::displayWindow )
 		.def( "readChannel", (DataPtr (ImageReader::*)( const std::string &, bool ))&ImageReader::readChannel, ( arg_("name"), arg_( "raw" ) = false ) )
+		.def( "readChannel", (DataPtr (ImageReader::*)( const std::string &, const Imath::Box2i &, bool ))&ImageReader::readChannel, ( arg_("name"), arg_( "region" ), arg_( "raw" ) = false ) )
+		.def( "tileSize", &ImageReader::tileSize )
+		.def( "tiles", &tiles, ( arg_( "region" ) ) )
+		.def( "readRegion", &readRegion, ( arg_( "region" ), arg_( "channelNames" ), arg_( "raw" ) = false ) )
 	;
 
 }
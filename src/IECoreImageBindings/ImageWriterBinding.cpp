@@ -36,6 +36,7 @@
 #include "boost/python.hpp"
 
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "IECoreImage/ImageWriter.h"
 #include "IECoreImageBindings/ImageWriterBinding.h"
@@ -47,15 +48,60 @@ using namespace IECore;
 using namespace IECorePython;
 using namespace IECoreImage;
 
+namespace
+{
+
+// Wraps the future returned by `ImageWriter::writeAsync()`, so that
+// it can be waited on from Python.
+class AsyncWrite
+{
+
+	public :
+
+		AsyncWrite( std::future<void> &&future )
+			:	m_future( future.share() )
+		{
+		}
+
+		void wait()
+		{
+			IECorePython::ScopedGILRelease gilRelease;
+			m_future.get();
+		}
+
+		bool done() const
+		{
+			return m_future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+		}
+
+	private :
+
+		std::shared_future<void> m_future;
+
+};
+
+AsyncWrite writeAsync( ImageWriter &writer )
+{
+	return AsyncWrite( writer.writeAsync() );
+}
+
+} // namespace
+
 namespace IECoreImageBindings
 {
 
 void bindImageWriter()
 {
-	RunTimeTypedClass<ImageWriter>()
+	scope s = RunTimeTypedClass<ImageWriter>()
 		.def( init<>() )
 		.def( init<IECore::ObjectPtr, const std::string &>() )
 		.def( "canWrite", &ImageWriter::canWrite ).staticmethod( "canWrite" )
+		.def( "writeAsync", &writeAsync )
+	;
+
+	class_<AsyncWrite>( "AsyncWrite", no_init )
+		.def( "wait", &AsyncWrite::wait )
+		.def( "done", &AsyncWrite::done )
 	;
 }
 
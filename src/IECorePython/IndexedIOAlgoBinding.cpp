@@ -36,6 +36,8 @@
 
 #include "IECorePython/IndexedIOAlgoBinding.h"
 
+#include "IECorePython/ScopedGILRelease.h"
+
 #include "IECore/IndexedIOAlgo.h"
 
 using namespace boost::python;
@@ -44,6 +46,12 @@ using namespace IECore;
 namespace
 {
 
+void copy( const IndexedIO *src, IndexedIO *dst )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	IndexedIOAlgo::copy( src, dst );
+}
+
 list parallelReadAll( const IndexedIO* src )
 {
 	IECore::IndexedIOAlgo::FileStats<size_t> stats = IECore::IndexedIOAlgo::parallelReadAll( src );
@@ -79,7 +87,7 @@ void bindIndexedIOAlgo()
 
 	scope meshAlgoScope( module );
 
-	def( "copy", &IndexedIOAlgo::copy );
+	def( "copy", &::copy );
 	def( "parallelReadAll", &::parallelReadAll );
 }
 
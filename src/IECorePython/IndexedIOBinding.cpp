@@ -412,7 +412,32 @@ void bindIndexedIOBase()
 
 void bindStreamIndexedIO()
 {
-	IECorePython::RunTimeTypedClass<StreamIndexedIO>();
+	IECorePython::RunTimeTypedClass<StreamIndexedIO> streamIndexedIOClass;
+	{
+		scope s( streamIndexedIOClass );
+
+		scope hintScope = class_<StreamIndexedIO::CompressionHint>( "CompressionHint" )
+			.def_readwrite( "compressor", &StreamIndexedIO::CompressionHint::compressor )
+			.def_readwrite( "compressionLevel", &StreamIndexedIO::CompressionHint::compressionLevel )
+			.def_readwrite( "shuffle", &StreamIndexedIO::CompressionHint::shuffle )
+			.def_readwrite( "typeSize", &StreamIndexedIO::CompressionHint::typeSize )
+			.def_readwrite( "minCompressedBlockSize", &StreamIndexedIO::CompressionHint::minCompressedBlockSize )
+			.def( self == self )
+			.def( self != self )
+		;
+
+		enum_<StreamIndexedIO::CompressionHint::Shuffle>( "Shuffle" )
+			.value( "DefaultShuffle", StreamIndexedIO::CompressionHint::DefaultShuffle )
+			.value( "NoShuffle", StreamIndexedIO::CompressionHint::NoShuffle )
+			.value( "ByteShuffle", StreamIndexedIO::CompressionHint::ByteShuffle )
+			.value( "BitShuffle", StreamIndexedIO::CompressionHint::BitShuffle )
+		;
+	}
+
+	streamIndexedIOClass
+		.def( "setCompressionHint", &StreamIndexedIO::setCompressionHint )
+		.def( "getCompressionHint", &StreamIndexedIO::getCompressionHint, return_value_policy<copy_const_reference>() )
+	;
 }
 
 void bindFileIndexedIO()
@@ -41,6 +41,7 @@
 
 #include "IECorePython/RunTimeTypedBinding.h"
 
+#include "IECore/FrozenPathMatcher.h"
 #include "IECore/PathMatcher.h"
 #include "IECore/PathMatcherData.h"
 #include "IECore/VectorTypedData.h"
@@ -292,7 +293,8 @@ PathMatcher *constructFromVectorData( IECore::ConstStringVectorDataPtr paths )
 	return new PathMatcher( paths->readable().begin(), paths->readable().end() );
 }
 
-list paths( const PathMatcher &p )
+template<typename T>
+list paths( const T &p )
 {
 	std::vector<std::string> paths;
 	p.paths( paths );
@@ -337,6 +339,24 @@ void IECorePython::bindPathMatcher()
 		.def( "__repr__", &pathMatcherDataRepr )
 	;
 
+	class_<FrozenPathMatcher>( "FrozenPathMatcher" )
+		.def( init<const PathMatcher &>() )
+		.def( "thaw", &FrozenPathMatcher::thaw )
+		.def( "isEmpty", &FrozenPathMatcher::isEmpty )
+		.def( "size", &FrozenPathMatcher::size )
+		.def( "paths", &paths<FrozenPathMatcher> )
+		.def( "match", (unsigned (FrozenPathMatcher::*)( const std::vector<IECore::InternedString> & ) const)&FrozenPathMatcher::match )
+		.def( "match", (unsigned (FrozenPathMatcher::*)( const std::string & ) const)&FrozenPathMatcher::match )
+		.def( "find", &FrozenPathMatcher::find )
+		.def( "exactMatch", &FrozenPathMatcher::exactMatch )
+		.def_readonly( "npos", &FrozenPathMatcher::npos )
+		.def( "unionWith", &FrozenPathMatcher::unionWith )
+		.def( "difference", &FrozenPathMatcher::difference )
+		.def( "intersection", &FrozenPathMatcher::intersection )
+		.def( self == self )
+		.def( self != self )
+	;
+
 	scope s = class_<PathMatcher>( "PathMatcher" )
 		.def( "__init__", make_constructor( constructFromObject ) )
 		.def( "__init__", make_constructor( constructFromVectorData ) )
@@ -357,9 +377,10 @@ void IECorePython::bindPathMatcher()
 		.def( "clear", &PathMatcher::clear )
 		.def( "isEmpty", &PathMatcher::isEmpty )
 		.def( "size", &PathMatcher::size )
-		.def( "paths", &paths )
+		.def( "paths", &paths<PathMatcher> )
 		.def( "match", (unsigned (PathMatcher ::*)( const std::vector<IECore::InternedString> & ) const)&PathMatcher::match )
 		.def( "match", (unsigned (PathMatcher ::*)( const std::string & ) const)&PathMatcher::match )
+		.def( "freeze", &PathMatcher::freeze )
 		.def( "__repr__", &pathMatcherRepr )
 		.def( self == self )
 		.def( self != self )
@@ -155,6 +155,7 @@
 #include "IECorePython/PathMatcherBinding.h"
 #include "IECorePython/CancellerBinding.h"
 #include "IECorePython/IndexedIOAlgoBinding.h"
+#include "IECorePython/IndexedIOBlockStoreBinding.h"
 
 #include "IECore/IECore.h"
 
@@ -298,6 +299,7 @@ BOOST_PYTHON_MODULE(_IECore)
 	bindPathMatcher();
 	bindCanceller();
 	bindIndexedIOAlgo();
+	bindIndexedIOBlockStore();
 	bindTBB();
 
 	def( "majorVersion", &IECore::majorVersion );
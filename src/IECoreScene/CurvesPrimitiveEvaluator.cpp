@@ -44,6 +44,11 @@
 
 #include "OpenEXR/ImathFun.h"
 
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 using namespace IECore;
 using namespace IECoreScene;
 using namespace Imath;
@@ -726,3 +731,227 @@ const std::vector<int> &CurvesPrimitiveEvaluator::varyingDataOffsets() const
 {
 	return m_varyingDataOffsets;
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Batch queries
+//////////////////////////////////////////////////////////////////////////
+
+// Evaluates a single primitive variable into the output array for a batch query.
+// The function pointer is chosen once per variable, so the per-sample cost is a
+// non-virtual call to the templated Result::primVar().
+struct CurvesPrimitiveEvaluator::BatchVariable
+{
+
+	typedef void (*Function)( const BatchVariable &variable, const Result &result, size_t index );
+
+	template<typename T>
+	static BatchVariable create( const std::string &name, const PrimitiveVariable &primitiveVariable, size_t size )
+	{
+		typedef TypedData<vector<T> > OutputData;
+
+		const bool constant = primitiveVariable.interpolation == PrimitiveVariable::Constant;
+		if( constant ? !runTimeCast<const TypedData<T> >( primitiveVariable.data.get() ) : !runTimeCast<const OutputData>( primitiveVariable.data.get() ) )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "CurvesPrimitiveEvaluator : PrimitiveVariable \"%s\" has data incompatible with its interpolation" ) % name ) );
+		}
+
+		typename OutputData::Ptr output = new OutputData;
+		output->writable().resize( size );
+		return BatchVariable( primitiveVariable, output, output->writable().data(), &BatchVariable::evaluate<T> );
+	}
+
+	template<typename T>
+	static void evaluate( const BatchVariable &variable, const Result &result, size_t index )
+	{
+		static_cast<T *>( variable.outputBegin )[index] = result.primVar<T>( variable.primitiveVariable, result.m_coefficients );
+	}
+
+	PrimitiveVariable primitiveVariable;
+	DataPtr output;
+	void *outputBegin;
+	Function function;
+
+	private :
+
+		BatchVariable( const PrimitiveVariable &primitiveVariable, DataPtr output, void *outputBegin, Function function )
+			:	primitiveVariable( primitiveVariable ), output( output ), outputBegin( outputBegin ), function( function )
+		{
+		}
+
+};
+
+template<>
+void CurvesPrimitiveEvaluator::BatchVariable::evaluate<std::string>( const BatchVariable &variable, const Result &result, size_t index )
+{
+	static_cast<std::string *>( variable.outputBegin )[index] = result.stringPrimVar( variable.primitiveVariable );
+}
+
+void CurvesPrimitiveEvaluator::validateQueries( const std::vector<int> &curveIndices, const std::vector<float> &v ) const
+{
+	if( curveIndices.size() != v.size() )
+	{
+		throw InvalidArgumentException( "CurvesPrimitiveEvaluator : Number of curve indices does not match number of v parameters" );
+	}
+
+	const size_t numCurves = m_verticesPerCurve.size();
+	for( size_t i = 0, e = curveIndices.size(); i < e; ++i )
+	{
+		if( curveIndices[i] < 0 || (size_t)curveIndices[i] >= numCurves || v[i] < 0.0f || v[i] > 1.0f )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "CurvesPrimitiveEvaluator : Invalid query %d ( curveIndex %d, v %f )" ) % i % curveIndices[i] % v[i] ) );
+		}
+	}
+}
+
+void CurvesPrimitiveEvaluator::pointsAtV( const std::vector<int> &curveIndices, const std::vector<float> &v, std::vector<Imath::V3f> &points, std::vector<Imath::V3f> *vTangents ) const
+{
+	validateQueries( curveIndices, v );
+
+	points.resize( curveIndices.size() );
+	if( vTangents )
+	{
+		vTangents->resize( curveIndices.size() );
+	}
+
+	const bool linear = m_curvesPrimitive->basis() == CubicBasisf::linear();
+	const bool periodic = m_curvesPrimitive->periodic();
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, curveIndices.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			Result result( m_p, linear, periodic );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				(result.*result.m_init)( curveIndices[i], v[i], this );
+				points[i] = result.primVar<V3f>( m_p, result.m_coefficients );
+				if( vTangents )
+				{
+					(*vTangents)[i] = result.primVar<V3f>( m_p, result.m_derivativeCoefficients );
+				}
+			}
+		},
+		taskGroupContext
+	);
+}
+
+void CurvesPrimitiveEvaluator::closestPoints( const std::vector<Imath::V3f> &points, std::vector<int> &curveIndices, std::vector<float> &v ) const
+{
+	if( !m_verticesPerCurve.size() )
+	{
+		throw InvalidArgumentException( "CurvesPrimitiveEvaluator : Cannot find closest points without any curves" );
+	}
+
+	// Build the tree up front so that the parallel queries below
+	// don't all contend on the tree mutex.
+	const_cast<CurvesPrimitiveEvaluator *>( this )->buildTree();
+
+	curveIndices.resize( points.size() );
+	v.resize( points.size() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, points.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				unsigned curveIndex = 0;
+				float curveV = -1;
+				float distSquared = Imath::limits<float>::max();
+				closestPointWalk( m_tree.rootIndex(), points[i], curveIndex, curveV, distSquared );
+				curveIndices[i] = curveIndex;
+				v[i] = curveV;
+			}
+		},
+		taskGroupContext
+	);
+}
+
+IECore::CompoundDataPtr CurvesPrimitiveEvaluator::primitiveVariablesAtV( const std::vector<int> &curveIndices, const std::vector<float> &v, const std::vector<std::string> &names ) const
+{
+	validateQueries( curveIndices, v );
+
+	const size_t size = curveIndices.size();
+	std::vector<BatchVariable> variables;
+	variables.reserve( names.size() );
+	for( const auto &name : names )
+	{
+		PrimitiveVariableMap::const_iterator it = m_curvesPrimitive->variables.find( name );
+		if( it == m_curvesPrimitive->variables.end() )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "CurvesPrimitiveEvaluator : No PrimitiveVariable named \"%s\"" ) % name ) );
+		}
+		if( !m_curvesPrimitive->isPrimitiveVariableValid( it->second ) )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "CurvesPrimitiveEvaluator : PrimitiveVariable \"%s\" is not valid" ) % name ) );
+		}
+
+		// Result::primVar() doesn't account for indices, so we expand them here.
+		const PrimitiveVariable primitiveVariable( it->second.interpolation, it->second.indices ? it->second.expandedData() : it->second.data );
+
+		switch( primitiveVariable.data->typeId() )
+		{
+			case FloatDataTypeId :
+			case FloatVectorDataTypeId :
+				variables.push_back( BatchVariable::create<float>( name, primitiveVariable, size ) );
+				break;
+			case IntDataTypeId :
+			case IntVectorDataTypeId :
+				variables.push_back( BatchVariable::create<int>( name, primitiveVariable, size ) );
+				break;
+			case HalfDataTypeId :
+			case HalfVectorDataTypeId :
+				variables.push_back( BatchVariable::create<half>( name, primitiveVariable, size ) );
+				break;
+			case V2fDataTypeId :
+			case V2fVectorDataTypeId :
+				variables.push_back( BatchVariable::create<V2f>( name, primitiveVariable, size ) );
+				break;
+			case V3fDataTypeId :
+			case V3fVectorDataTypeId :
+				variables.push_back( BatchVariable::create<V3f>( name, primitiveVariable, size ) );
+				break;
+			case Color3fDataTypeId :
+			case Color3fVectorDataTypeId :
+				variables.push_back( BatchVariable::create<Color3f>( name, primitiveVariable, size ) );
+				break;
+			case StringDataTypeId :
+			case StringVectorDataTypeId :
+				if( primitiveVariable.interpolation != PrimitiveVariable::Constant && primitiveVariable.interpolation != PrimitiveVariable::Uniform )
+				{
+					throw InvalidArgumentException( boost::str( boost::format( "CurvesPrimitiveEvaluator : String PrimitiveVariable \"%s\" must have Constant or Uniform interpolation" ) % name ) );
+				}
+				variables.push_back( BatchVariable::create<std::string>( name, primitiveVariable, size ) );
+				break;
+			default :
+				throw InvalidArgumentException( boost::str( boost::format( "CurvesPrimitiveEvaluator : PrimitiveVariable \"%s\" has unsupported type \"%s\"" ) % name % primitiveVariable.data->typeName() ) );
+		}
+	}
+
+	const bool linear = m_curvesPrimitive->basis() == CubicBasisf::linear();
+	const bool periodic = m_curvesPrimitive->periodic();
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, size ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			Result result( m_p, linear, periodic );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				(result.*result.m_init)( curveIndices[i], v[i], this );
+				for( const auto &variable : variables )
+				{
+					variable.function( variable, result, i );
+				}
+			}
+		},
+		taskGroupContext
+	);
+
+	CompoundDataPtr result = new CompoundData;
+	for( size_t i = 0, e = names.size(); i < e; ++i )
+	{
+		result->writable()[names[i]] = variables[i].output;
+	}
+	return result;
+}
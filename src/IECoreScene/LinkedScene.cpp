@@ -38,10 +38,16 @@
 #include "IECoreScene/SharedSceneInterfaces.h"
 
 #include "IECore/FileIndexedIO.h"
+#include "IECore/Interpolator.h"
 #include "IECore/MessageHandler.h"
 
 #include "boost/foreach.hpp"
 
+#include "tbb/concurrent_hash_map.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
+
+#include <atomic>
 #include <set>
 using namespace IECore;
 using namespace IECoreScene;
@@ -74,6 +80,81 @@ namespace
 	const InternedString g_linkLocations( "linkLocations" );
 }
 
+class LinkedScene::TimeRemapping : public IECore::RefCounted
+{
+	public :
+
+		TimeRemapping( const SampledSceneInterface *mainScene )
+			:	m_mainScene( mainScene )
+		{
+			const size_t numSamples = mainScene->numAttributeSamples( timeLinkAttribute );
+			m_times.reserve( numSamples );
+			for( size_t i = 0; i < numSamples; ++i )
+			{
+				ConstDoubleDataPtr t = runTimeCast< const DoubleData >( mainScene->readAttributeAtSample( timeLinkAttribute, i ) );
+				if( !t )
+				{
+					throw Exception( "Invalid time when querying for time remapping!" );
+				}
+				m_times.push_back( t->readable() );
+			}
+		}
+
+		// Matches the interpolation performed by SampledSceneInterface::readAttribute(),
+		// without reading and interpolating DoubleData for every query.
+		double remappedTime( double time ) const
+		{
+			size_t floorIndex, ceilIndex;
+			const double x = m_mainScene->attributeSampleInterval( timeLinkAttribute, time, floorIndex, ceilIndex );
+			if( x == 0 )
+			{
+				return remappedTimeAtSample( floorIndex );
+			}
+			if( x == 1 )
+			{
+				return remappedTimeAtSample( ceilIndex );
+			}
+
+			double result;
+			LinearInterpolator<double>()( remappedTimeAtSample( floorIndex ), remappedTimeAtSample( ceilIndex ), x, result );
+			return result;
+		}
+
+		double remappedTimeAtSample( size_t sampleIndex ) const
+		{
+			if( sampleIndex >= m_times.size() )
+			{
+				throw Exception( "Sample index out of bounds!" );
+			}
+			return m_times[sampleIndex];
+		}
+
+	private :
+
+		ConstSampledSceneInterfacePtr m_mainScene;
+		std::vector<double> m_times;
+
+};
+
+class LinkedScene::LinkTargets : public IECore::RefCounted
+{
+	public :
+
+		typedef tbb::concurrent_hash_map<std::string, ConstSceneInterfacePtr> Map;
+		Map scenes;
+
+		ConstSceneInterfacePtr get( const std::string &fileName ) const
+		{
+			Map::const_accessor a;
+			if( scenes.find( a, fileName ) )
+			{
+				return a->second;
+			}
+			return nullptr;
+		}
+
+};
+
 LinkedScene::LinkedScene( const std::string &fileName, IndexedIO::OpenMode mode )
 	: m_mainScene( nullptr ),
 	m_linkedScene( nullptr ),
@@ -82,6 +163,7 @@ LinkedScene::LinkedScene( const std::string &fileName, IndexedIO::OpenMode mode
 	m_atLink( false ),
 	m_sampled( true ),
 	m_timeRemapped( false ),
+	m_linkTargets( new LinkTargets ),
 	m_linkLocationsData( new IECore::PathMatcherData() )
 {
 	if( mode & IndexedIO::Append )
@@ -106,6 +188,7 @@ LinkedScene::LinkedScene( ConstSceneInterfacePtr mainScene )
 	m_readOnly( true ),
 	m_atLink( false ),
 	m_timeRemapped( false ),
+	m_linkTargets( new LinkTargets ),
 	m_linkLocationsData( new IECore::PathMatcherData() )
 {
 	if( SceneCachePtr scc = runTimeCast<SceneCache>( m_mainScene ) )
@@ -120,10 +203,12 @@ LinkedScene::LinkedScene(
 	SceneInterface *mainScene,
 	const SceneInterface *linkedScene,
 	IECore::PathMatcherDataPtr linkLocationsData,
+	LinkTargetsPtr linkTargets,
 	int rootLinkDepth,
 	bool readOnly,
 	bool atLink,
-	bool timeRemapped
+	bool timeRemapped,
+	ConstTimeRemappingPtr timeRemapping
 )
 	: m_mainScene( mainScene ),
 	m_linkedScene( linkedScene ),
@@ -131,6 +216,8 @@ LinkedScene::LinkedScene(
 	m_readOnly( readOnly ),
 	m_atLink( atLink ),
 	m_timeRemapped( timeRemapped ),
+	m_timeRemapping( timeRemapping ),
+	m_linkTargets( linkTargets ),
 	m_linkLocationsData( linkLocationsData )
 {
 	if ( !mainScene )
@@ -147,6 +234,16 @@ LinkedScene::LinkedScene(
 		m_sampled = (runTimeCast<const SampledSceneInterface>(mainScene) != nullptr);
 	}
 
+	if( m_timeRemapped && m_readOnly && !m_timeRemapping )
+	{
+		// We're at a new link, so read the remapped times for all the locations below it.
+		const SampledSceneInterface *sampledMainScene = runTimeCast<const SampledSceneInterface>( mainScene );
+		if( sampledMainScene && sampledMainScene->hasAttribute( timeLinkAttribute ) )
+		{
+			m_timeRemapping = new TimeRemapping( sampledMainScene );
+		}
+	}
+
 }
 
 LinkedScene::~LinkedScene()
@@ -187,6 +284,123 @@ IECore::CompoundDataPtr LinkedScene::linkAttributeData( const SceneInterface *sc
 	return d;
 }
 
+size_t LinkedScene::prefetchLinks() const
+{
+	if( !m_readOnly )
+	{
+		throw Exception( "prefetchLinks() called on write-only LinkedScene!" );
+	}
+
+	std::atomic<size_t> result( 0 );
+	if( m_linkedScene )
+	{
+		if( const LinkedScene *linkedScene = runTimeCast<const LinkedScene>( m_linkedScene.get() ) )
+		{
+			result += linkedScene->prefetchLinks();
+		}
+		if( !m_atLink )
+		{
+			// Everything below us comes from the linked scene.
+			return result;
+		}
+	}
+
+	SceneInterface::Path path;
+	m_mainScene->path( path );
+	LinkTargetsPtr found = new LinkTargets;
+	collectLinkTargets( m_mainScene.get(), path, m_linkLocationsData->readable(), *found );
+
+	std::vector<std::string> fileNames;
+	for( const auto &target : found->scenes )
+	{
+		if( !m_linkTargets->get( target.first ) )
+		{
+			fileNames.push_back( target.first );
+		}
+	}
+
+	std::vector<ConstSceneInterfacePtr> scenes( fileNames.size() );
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, fileNames.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				try
+				{
+					scenes[i] = SharedSceneInterfaces::get( fileNames[i] );
+				}
+				catch( const IECore::Exception & )
+				{
+					// Reported by expandLink() if the link is traversed.
+					continue;
+				}
+
+				if( const LinkedScene *linkedScene = runTimeCast<const LinkedScene>( scenes[i].get() ) )
+				{
+					result += linkedScene->prefetchLinks();
+				}
+			}
+		},
+		taskGroupContext
+	);
+
+	for( size_t i = 0; i < fileNames.size(); ++i )
+	{
+		if( scenes[i] )
+		{
+			m_linkTargets->scenes.insert( LinkTargets::Map::value_type( fileNames[i], scenes[i] ) );
+			++result;
+		}
+	}
+
+	return result;
+}
+
+void LinkedScene::collectLinkTargets( const SceneInterface *mainScene, const SceneInterface::Path &path, const IECore::PathMatcher &linkLocations, LinkTargets &targets )
+{
+	if( mainScene->hasAttribute( fileNameLinkAttribute ) && mainScene->hasAttribute( rootLinkAttribute ) )
+	{
+		if( ConstStringDataPtr fileName = runTimeCast< const StringData >( mainScene->readAttribute( fileNameLinkAttribute, 0 ) ) )
+		{
+			targets.scenes.insert( fileName->readable() );
+		}
+	}
+	else if( mainScene->hasAttribute( linkAttribute ) )
+	{
+		ConstCompoundDataPtr d = runTimeCast< const CompoundData >( mainScene->readAttribute( linkAttribute, 0 ) );
+		if( const StringData *fileName = d ? d->member< const StringData >( g_fileName ) : nullptr )
+		{
+			targets.scenes.insert( fileName->readable() );
+		}
+	}
+
+	NameList childNames;
+	mainScene->childNames( childNames );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, childNames.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			SceneInterface::Path childPath( path );
+			childPath.push_back( SceneInterface::Name() );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				childPath.back() = childNames[i];
+				// Files record the link locations when they are written, letting
+				// us skip branches without links. Older files have to be walked fully.
+				if( !linkLocations.isEmpty() && !( linkLocations.match( childPath ) & ( PathMatcher::ExactMatch | PathMatcher::DescendantMatch ) ) )
+				{
+					continue;
+				}
+				ConstSceneInterfacePtr child = mainScene->child( childNames[i], SceneInterface::ThrowIfMissing );
+				collectLinkTargets( child.get(), childPath, linkLocations, targets );
+			}
+		},
+		taskGroupContext
+	);
+}
+
 std::string LinkedScene::fileName() const
 {
 	return m_mainScene->fileName();
@@ -1059,6 +1273,22 @@ ConstObjectPtr LinkedScene::readObject( double time ) const
 	}
 }
 
+MurmurHash LinkedScene::objectKey( double time ) const
+{
+	if ( m_linkedScene )
+	{
+		if ( m_timeRemapped )
+		{
+			time = remappedLinkTime( time );
+		}
+		return m_linkedScene->objectKey( time );
+	}
+	else
+	{
+		return m_mainScene->objectKey( time );
+	}
+}
+
 PrimitiveVariableMap LinkedScene::readObjectPrimitiveVariables( const std::vector<InternedString> &primVarNames, double time ) const
 {
 	if ( m_linkedScene )
@@ -1115,10 +1345,13 @@ ConstSceneInterfacePtr LinkedScene::expandLink( const StringData *fileName, cons
 {
 	if ( fileName && root )
 	{
-		ConstSceneInterfacePtr l = nullptr;
+		ConstSceneInterfacePtr l = m_linkTargets ? m_linkTargets->get( fileName->readable() ) : nullptr;
 		try
 		{
-			l = SharedSceneInterfaces::get( fileName->readable() );
+			if( !l )
+			{
+				l = SharedSceneInterfaces::get( fileName->readable() );
+			}
 		}
 		catch ( IECore::Exception &e )
 		{
@@ -1142,7 +1375,11 @@ ConstSceneInterfacePtr LinkedScene::expandLink( const StringData *fileName, cons
 
 double LinkedScene::remappedLinkTime( double time ) const
 {
-	if( m_mainScene->hasAttribute( timeLinkAttribute ) )
+	if( m_timeRemapping )
+	{
+		return m_timeRemapping->remappedTime( time );
+	}
+	else if( m_mainScene->hasAttribute( timeLinkAttribute ) )
 	{
 		ConstDoubleDataPtr t = runTimeCast< const DoubleData >( m_mainScene->readAttribute( timeLinkAttribute, time ) );
 		if ( !t )
@@ -1169,7 +1406,11 @@ double LinkedScene::remappedLinkTime( double time ) const
 
 double LinkedScene::remappedLinkTimeAtSample( size_t sampleIndex ) const
 {
-	if( m_mainScene->hasAttribute( timeLinkAttribute ) )
+	if( m_timeRemapping )
+	{
+		return m_timeRemapping->remappedTimeAtSample( sampleIndex );
+	}
+	else if( m_mainScene->hasAttribute( timeLinkAttribute ) )
 	{
 		ConstDoubleDataPtr t = runTimeCast< const DoubleData >( static_cast<const SampledSceneInterface*>(m_mainScene.get())->readAttributeAtSample( timeLinkAttribute, sampleIndex ) );
 		if ( !t )
@@ -1209,7 +1450,7 @@ SceneInterfacePtr LinkedScene::child( const Name &name, MissingBehaviour missing
 		ConstSceneInterfacePtr c = m_linkedScene->child( name, SceneInterface::NullIfMissing );
 		if ( c )
 		{
-			return new LinkedScene( m_mainScene.get(), c.get(), m_linkLocationsData, m_rootLinkDepth, m_readOnly, false, m_timeRemapped );
+			return new LinkedScene( m_mainScene.get(), c.get(), m_linkLocationsData, m_linkTargets, m_rootLinkDepth, m_readOnly, false, m_timeRemapped, m_timeRemapping );
 		}
 		if( !m_atLink )
 		{
@@ -1258,7 +1499,7 @@ SceneInterfacePtr LinkedScene::child( const Name &name, MissingBehaviour missing
 			ConstSceneInterfacePtr l = expandLink( fileName.get(), root.get(), linkDepth );
 			if ( l )
 			{
-				return new LinkedScene( c.get(), l.get(), m_linkLocationsData, linkDepth, m_readOnly, true, timeRemapped );
+				return new LinkedScene( c.get(), l.get(), m_linkLocationsData, m_linkTargets, linkDepth, m_readOnly, true, timeRemapped );
 			}
 		}
 		else if( c->hasAttribute( linkAttribute ) )
@@ -1272,12 +1513,12 @@ SceneInterfacePtr LinkedScene::child( const Name &name, MissingBehaviour missing
 			ConstSceneInterfacePtr l = expandLink( d->member< const StringData >( g_fileName ), d->member< const InternedStringVectorData >( g_root ), linkDepth );
 			if ( l )
 			{
-				return new LinkedScene( c.get(), l.get(), m_linkLocationsData, linkDepth, m_readOnly, true, timeRemapped );
+				return new LinkedScene( c.get(), l.get(), m_linkLocationsData, m_linkTargets, linkDepth, m_readOnly, true, timeRemapped );
 			}
 		}
 	}
 
-	return new LinkedScene( c.get(), nullptr, m_linkLocationsData, 0, m_readOnly, false, false );
+	return new LinkedScene( c.get(), nullptr, m_linkLocationsData, m_linkTargets, 0, m_readOnly, false, false );
 
 }
 
@@ -1386,7 +1627,7 @@ SceneInterfacePtr LinkedScene::scene( const Path &path, MissingBehaviour missing
 		}
 		atLink = false;
 	}
-	return new LinkedScene( s.get(), l.get(), m_linkLocationsData, linkDepth, m_readOnly, atLink, timeRemapped );
+	return new LinkedScene( s.get(), l.get(), m_linkLocationsData, m_linkTargets, linkDepth, m_readOnly, atLink, timeRemapped );
 }
 
 ConstSceneInterfacePtr LinkedScene::scene( const Path &path, LinkedScene::MissingBehaviour missingBehaviour ) const
@@ -47,6 +47,9 @@
 
 #include "boost/format.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 using namespace IECore;
 using namespace IECoreScene;
 using namespace Imath;
@@ -216,22 +219,15 @@ struct MeshPrimitiveShrinkWrapOp::ShrinkWrapFn
 		MeshPrimitivePtr triangulatedSourcePrimitive = MeshAlgo::triangulate( runTimeCast<MeshPrimitive>( m_sourceMesh.get() ), m_tolerance, true );
 
 		PrimitiveEvaluatorPtr sourceEvaluator = nullptr;
-		PrimitiveEvaluator::ResultPtr sourceResult = nullptr;
 
 		if ( m_method == Normal )
 		{
 			sourceEvaluator = PrimitiveEvaluator::create( triangulatedSourcePrimitive );
 			assert( sourceEvaluator );
-			sourceResult = sourceEvaluator->createResult();
-			assert( sourceResult );
 		}
 
 		PrimitiveEvaluatorPtr targetEvaluator = PrimitiveEvaluator::create( m_targetMesh );
 		assert( targetEvaluator );
-		PrimitiveEvaluator::ResultPtr insideResult = targetEvaluator->createResult();
-		PrimitiveEvaluator::ResultPtr outsideResult = targetEvaluator->createResult();
-		assert( insideResult );
-		assert( outsideResult );
 
 		PrimitiveVariableMap::const_iterator it = triangulatedSourcePrimitive->variables.find( "N" );
 		if (it == m_sourceMesh->variables.end())
@@ -241,91 +237,110 @@ struct MeshPrimitiveShrinkWrapOp::ShrinkWrapFn
 
 		const PrimitiveVariable &nPrimVar = it->second;
 
-		typename T::ValueType::size_type vertexId = 0;
-		for ( typename T::ValueType::iterator pit = vertices.begin(); pit != vertices.end(); ++pit, ++vertexId )
-		{
-			Vec &vertexPosition = *pit;
-
-			Vec rayDirection;
+		// The evaluators may be queried concurrently provided that each
+		// thread uses its own Results, so we process the vertices in parallel.
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, vertices.size() ),
+			[&]( const tbb::blocked_range<size_t> &range ) {
 
-			if ( m_method == Normal )
-			{
-				assert( sourceEvaluator );
-				assert( sourceResult );
-				sourceEvaluator->closestPoint( vertexPosition, sourceResult.get() );
-				rayDirection = sourceResult->vectorPrimVar( nPrimVar ).normalized();
-			}
-			else if ( m_method == XAxis )
-			{
-				rayDirection = Vec( 1.0, 0.0, 0.0 );
-			}
-			else if ( m_method == YAxis )
-			{
-				rayDirection = Vec( 0.0, 1.0, 0.0 );
-			}
-			else if ( m_method == ZAxis )
-			{
-				rayDirection = Vec( 0.0, 0.0, 1.0 );
-			}
-			else
-			{
-				assert( m_method == DirectionMesh );
-				assert( directionVerticesData );
-				assert( vertexId < directionVerticesData->readable().size() );
-
-				rayDirection = ( directionVerticesData->readable()[ vertexId ] - vertexPosition ).normalized();
-			}
-
-			bool hit = false;
-
-			if ( m_direction == Inside )
-			{
-				hit = targetEvaluator->intersectionPoint( vertexPosition, -rayDirection, insideResult.get() );
-				if ( hit )
+				PrimitiveEvaluator::ResultPtr sourceResult = nullptr;
+				if ( sourceEvaluator )
 				{
-					vertexPosition = insideResult->point();
+					sourceResult = sourceEvaluator->createResult();
 				}
-			}
-			else if ( m_direction == Outside )
-			{
-				hit = targetEvaluator->intersectionPoint( vertexPosition, rayDirection, outsideResult.get() );
-				if ( hit )
+				PrimitiveEvaluator::ResultPtr insideResult = targetEvaluator->createResult();
+				PrimitiveEvaluator::ResultPtr outsideResult = targetEvaluator->createResult();
+				assert( insideResult );
+				assert( outsideResult );
+
+				for ( size_t vertexId = range.begin(); vertexId != range.end(); ++vertexId )
 				{
-					vertexPosition = outsideResult->point();
-				}
-			}
-			else
-			{
-				assert( m_direction == Both );
+					Vec &vertexPosition = vertices[vertexId];
 
-				bool insideHit  = targetEvaluator->intersectionPoint( vertexPosition, -rayDirection, insideResult.get()  );
-				bool outsideHit = targetEvaluator->intersectionPoint( vertexPosition,  rayDirection, outsideResult.get() );
+					Vec rayDirection;
 
-				/// Choose the closest, or the only, intersection
-				if ( insideHit && outsideHit )
-				{
-					typename Vec::BaseType insideDist  = vecDistance2( vertexPosition, Vec( insideResult->point()  ) );
-					typename Vec::BaseType outsideDist = vecDistance2( vertexPosition, Vec( outsideResult->point() ) );
+					if ( m_method == Normal )
+					{
+						assert( sourceEvaluator );
+						assert( sourceResult );
+						sourceEvaluator->closestPoint( vertexPosition, sourceResult.get() );
+						rayDirection = sourceResult->vectorPrimVar( nPrimVar ).normalized();
+					}
+					else if ( m_method == XAxis )
+					{
+						rayDirection = Vec( 1.0, 0.0, 0.0 );
+					}
+					else if ( m_method == YAxis )
+					{
+						rayDirection = Vec( 0.0, 1.0, 0.0 );
+					}
+					else if ( m_method == ZAxis )
+					{
+						rayDirection = Vec( 0.0, 0.0, 1.0 );
+					}
+					else
+					{
+						assert( m_method == DirectionMesh );
+						assert( directionVerticesData );
+						assert( vertexId < directionVerticesData->readable().size() );
 
-					if ( insideDist < outsideDist )
+						rayDirection = ( directionVerticesData->readable()[ vertexId ] - vertexPosition ).normalized();
+					}
+
+					bool hit = false;
+
+					if ( m_direction == Inside )
 					{
-						vertexPosition = insideResult->point();
+						hit = targetEvaluator->intersectionPoint( vertexPosition, -rayDirection, insideResult.get() );
+						if ( hit )
+						{
+							vertexPosition = insideResult->point();
+						}
+					}
+					else if ( m_direction == Outside )
+					{
+						hit = targetEvaluator->intersectionPoint( vertexPosition, rayDirection, outsideResult.get() );
+						if ( hit )
+						{
+							vertexPosition = outsideResult->point();
+						}
 					}
 					else
 					{
-						vertexPosition = outsideResult->point();
+						assert( m_direction == Both );
+
+						bool insideHit  = targetEvaluator->intersectionPoint( vertexPosition, -rayDirection, insideResult.get()  );
+						bool outsideHit = targetEvaluator->intersectionPoint( vertexPosition,  rayDirection, outsideResult.get() );
+
+						/// Choose the closest, or the only, intersection
+						if ( insideHit && outsideHit )
+						{
+							typename Vec::BaseType insideDist  = vecDistance2( vertexPosition, Vec( insideResult->point()  ) );
+							typename Vec::BaseType outsideDist = vecDistance2( vertexPosition, Vec( outsideResult->point() ) );
+
+							if ( insideDist < outsideDist )
+							{
+								vertexPosition = insideResult->point();
+							}
+							else
+							{
+								vertexPosition = outsideResult->point();
+							}
+						}
+						else if ( insideHit )
+						{
+							vertexPosition = insideResult->point();
+						}
+						else if ( outsideHit )
+						{
+							vertexPosition = outsideResult->point();
+						}
 					}
 				}
-				else if ( insideHit )
-				{
-					vertexPosition = insideResult->point();
-				}
-				else if ( outsideHit )
-				{
-					vertexPosition = outsideResult->point();
-				}
-			}
-		}
+			},
+			taskGroupContext
+		);
 	}
 
 	struct ErrorHandler
@@ -42,8 +42,6 @@
 #include "IECore/Timer.h"
 #include "IECore/VectorTypedData.h"
 
-#include "OpenEXR/ImathRandom.h"
-
 #include "boost/algorithm/string/predicate.hpp"
 
 #include <algorithm>
@@ -249,31 +247,29 @@ const IntVectorData * NParticleReader::frameTimes()
 }
 
 template<typename T, typename F>
-typename T::Ptr NParticleReader::filterAttr( const F *attr, float percentage )
+typename T::Ptr NParticleReader::readArray( IFFFile::Chunk &chunk, int numParticles )
 {
-	if( percentage < 100.0f )
+	typedef typename F::ValueType::value_type ElementType;
+
+	typename F::Ptr attr( new F );
+	std::vector<size_t> indices;
+	if( filteredIndices( numParticles, particlePercentage(), nullptr, indices ) )
 	{
-		// percentage filtering (and type conversion if necessary)
-		typename T::Ptr result( new T );
-		const typename F::ValueType &in = attr->readable();
-		typename T::ValueType &out = result->writable();
-		int seed = particlePercentageSeed();
-		float fraction = percentage / 100.0f;
-		Rand48 r;
-		r.init( seed );
-		for( typename F::ValueType::size_type i=0; i<in.size(); i++ )
-		{
-			if( r.nextf() <= fraction )
-			{
-				out.push_back( in[i] );
-			}
-		}
-		return result;
+		// percentage filtering, reading only the selected particles from the file
+		chunk.read( attr->writable(), indices );
+	}
+	else
+	{
+		/// \todo: by all accounts the line below should be this :
+		/// attr->writable().resize( numParticles );
+		/// see PDCParticleReader for an explanation
+		attr->writable().resize( numParticles, ElementType( 0 ) );
+		chunk.read( attr->writable() );
 	}
 
 	if( T::staticTypeId()!=F::staticTypeId() )
 	{
-		// type conversion only
+		// type conversion
 		typename T::Ptr result( new T );
 		const typename F::ValueType &in = attr->readable();
 		typename T::ValueType &out = result->writable();
@@ -282,8 +278,7 @@ typename T::Ptr NParticleReader::filterAttr( const F *attr, float percentage )
 		return result;
 	}
 
-	// no filtering of any sort needed
-	return typename T::Ptr( (T *)attr );
+	return typename T::Ptr( (T *)attr.get() );
 }
 
 DataPtr NParticleReader::readAttribute( const std::string &name )
@@ -346,60 +341,39 @@ DataPtr NParticleReader::readAttribute( const std::string &name )
 	switch( (attrIt+2)->type().id() )
 	{
 		case kDBLA :
+			switch( realType() )
 			{
-				DoubleVectorDataPtr d( new DoubleVectorData );
-				d->writable().resize( numParticles );
-				(attrIt+2)->read( d->writable() );
-				switch( realType() )
-				{
-					case Native :
-					case Double :
-						result = filterAttr<DoubleVectorData, DoubleVectorData>( d.get(), particlePercentage() );
-						break;
-					case Float :
-						result = filterAttr<FloatVectorData, DoubleVectorData>( d.get(), particlePercentage() );
-						break;
-				}
+				case Native :
+				case Double :
+					result = readArray<DoubleVectorData, DoubleVectorData>( *(attrIt+2), numParticles );
+					break;
+				case Float :
+					result = readArray<FloatVectorData, DoubleVectorData>( *(attrIt+2), numParticles );
+					break;
 			}
 			break;
 		case kDVCA :
+			switch( realType() )
 			{
-				V3dVectorDataPtr d( new V3dVectorData );
-				/// \todo: by all accounts the line below should be this :
-				/// d->writable().resize( numParticles() );
-				/// see PDCParticleReader for an explanation
-				d->writable().resize( numParticles, V3d( 0 ) );
-				(attrIt+2)->read( d->writable() );
-				switch( realType() )
-				{
-					case Native :
-					case Double :
-						result = filterAttr<V3dVectorData, V3dVectorData>( d.get(), particlePercentage() );
-						break;
-					case Float :
-						result = filterAttr<V3fVectorData, V3dVectorData>( d.get(), particlePercentage() );
-						break;
-				}
+				case Native :
+				case Double :
+					result = readArray<V3dVectorData, V3dVectorData>( *(attrIt+2), numParticles );
+					break;
+				case Float :
+					result = readArray<V3fVectorData, V3dVectorData>( *(attrIt+2), numParticles );
+					break;
 			}
 			break;
 		case kFVCA :
+			switch( realType() )
 			{
-				V3fVectorDataPtr d( new V3fVectorData );
-				/// \todo: by all accounts the line below should be this :
-				/// d->writable().resize( numParticles() );
-				/// see PDCParticleReader for an explanation
-				d->writable().resize( numParticles, V3f( 0 ) );
-				(attrIt+2)->read( d->writable() );
-				switch( realType() )
-				{
-					case Native :
-					case Double :
-						result = filterAttr<V3dVectorData, V3fVectorData>( d.get(), particlePercentage() );
-						break;
-					case Float :
-						result = filterAttr<V3fVectorData, V3fVectorData>( d.get(), particlePercentage() );
-						break;
-				}
+				case Native :
+				case Double :
+					result = readArray<V3dVectorData, V3fVectorData>( *(attrIt+2), numParticles );
+					break;
+				case Float :
+					result = readArray<V3fVectorData, V3fVectorData>( *(attrIt+2), numParticles );
+					break;
 			}
 			break;
 		default :
@@ -39,6 +39,7 @@
 
 #include "IECore/CompoundData.h"
 #include "IECore/CompoundParameter.h"
+#include "IECore/Exception.h"
 #include "IECore/FileNameParameter.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/NullObject.h"
@@ -48,313 +49,633 @@
 #include "IECore/TypedParameter.h"
 #include "IECore/VectorTypedData.h"
 
-#include "boost/bind.hpp"
-#include "boost/version.hpp"
+#include "boost/filesystem/operations.hpp"
+#include "boost/format.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
 
-#if BOOST_VERSION >= 103600
-#define BOOST_SPIRIT_USE_OLD_NAMESPACE
-#include "boost/spirit/include/classic.hpp"
-#else
-#include "boost/spirit.hpp"
-#endif
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
-#include <iostream>
-#include <iterator>
+#include <memory>
 
 using namespace std;
 using namespace IECore;
 using namespace IECoreScene;
 using namespace Imath;
-using namespace boost;
-using namespace boost::spirit;
 
 IE_CORE_DEFINERUNTIMETYPED(OBJReader);
 
-// syntactic sugar for specifying our grammar
-typedef boost::spirit::rule<boost::spirit::phrase_scanner_t> srule;
-
 const Reader::ReaderDescription<OBJReader> OBJReader::m_readerDescription("obj");
 
-OBJReader::OBJReader( const std::string &fileName )
-	: Reader( "Alias Wavefront OBJ 3D data reader", new ObjectParameter("result", "the loaded 3D object", new
-	NullObject, MeshPrimitive::staticTypeId()))
+//////////////////////////////////////////////////////////////////////////
+// Parsing
+//////////////////////////////////////////////////////////////////////////
+
+namespace
 {
-	m_fileNameParameter->setTypedValue( fileName );
-}
 
-bool OBJReader::canRead( const string &fileName )
+// The target size for the chunks the file is split into for parallel
+// parsing. Chunks are always extended to finish at the end of a line.
+const size_t g_chunkSize = 1024 * 1024;
+
+// The results of parsing a contiguous range of lines from the file.
+// Positive OBJ indices are absolute, and are stored zero-based. Negative
+// indices are relative to the elements defined so far - they are resolved
+// relative to the start of the chunk, and their positions are recorded so
+// that they can be offset when the chunks are merged.
+struct Chunk
 {
-	// there really are no magic numbers, .obj is a simple ascii text file
+	std::vector<V3f> vertices;
+	std::vector<V2f> textureCoordinates;
+	std::vector<V3f> normals;
 
-	// so: enforce at least that the file has '.obj' extension
-	if(fileName.rfind(".obj") != fileName.length() - 4)
-		return false;
+	std::vector<int> verticesPerFace;
+	std::vector<int> vertexIds;
+	std::vector<int> textureCoordinateIds;
+	std::vector<int> normalIds;
 
-	// attempt to open the file
-	ifstream in(fileName.c_str());
-	return in.is_open();
+	std::vector<size_t> relativeVertexIds;
+	std::vector<size_t> relativeTextureCoordinateIds;
+	std::vector<size_t> relativeNormalIds;
+};
+
+inline bool isSpace( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r';
 }
 
-ObjectPtr OBJReader::doOperation(const CompoundObject * operands)
+inline bool isDigit( char c )
 {
-	// for now we are going to retrieve vertex, texture, normal coordinates, faces.
-	// later (when we have the primitives), we will handle a larger subset of the
-	// OBJ format
+	return c >= '0' && c <= '9';
+}
 
-	IntVectorDataPtr vpf = new IntVectorData();
-	m_vpf = &vpf->writable();
+inline void skipSpace( const char *&p, const char *end )
+{
+	while( p < end && isSpace( *p ) )
+	{
+		++p;
+	}
+}
 
-	IntVectorDataPtr vids = new IntVectorData();
-	m_vids = &vids->writable();
+// Fallback for anything the fast path doesn't handle, such as "inf",
+// "nan" or exponents outside the exactly representable range.
+bool parseFloatSlow( const char *&p, const char *end, float &result )
+{
+	char buffer[64];
+	size_t length = 0;
+	while( p + length < end && length < sizeof( buffer ) - 1 && !isSpace( p[length] ) && p[length] != '/' && p[length] != '\n' )
+	{
+		buffer[length] = p[length];
+		++length;
+	}
+	buffer[length] = '\0';
 
-	V3fVectorDataPtr vertices = new V3fVectorData();
-	m_vertices = &vertices->writable();
+	char *parsedEnd = nullptr;
+	const double value = strtod( buffer, &parsedEnd );
+	if( parsedEnd == buffer )
+	{
+		return false;
+	}
 
- 	// separate texture coordinates
-	FloatVectorDataPtr sTextureCoordinates = new FloatVectorData();
-	m_sTextureCoordinates = &sTextureCoordinates->writable();
+	result = value;
+	p += parsedEnd - buffer;
+	return true;
+}
 
-	FloatVectorDataPtr tTextureCoordinates = new FloatVectorData();
-	m_tTextureCoordinates = &tTextureCoordinates->writable();
+// Parses a decimal floating point number. Up to 19 significant digits are
+// accumulated into an integer mantissa, which is then scaled by an exactly
+// representable power of ten. This is accurate well beyond float precision
+// and avoids the locale handling and null termination requirements of strtod.
+bool parseFloat( const char *&p, const char *end, float &result )
+{
+	static const double powersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
 
-	// build normals
-	V3fVectorDataPtr normals = new V3fVectorData();
-	m_normals = &normals->writable();
+	const char *start = p;
+	const char *c = p;
 
-	// parse the file
-	parseOBJ();
+	bool negative = false;
+	if( c < end && ( *c == '-' || *c == '+' ) )
+	{
+		negative = *c == '-';
+		++c;
+	}
 
-	// create our MeshPrimitive
-	MeshPrimitivePtr mesh = new MeshPrimitive( vpf, vids, "linear", vertices );
-	if( sTextureCoordinates->readable().size() )
+	uint64_t mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool haveDigits = false;
+
+	for( ; c < end && isDigit( *c ); ++c )
 	{
-		mesh->variables.insert(PrimitiveVariableMap::value_type("s", PrimitiveVariable( PrimitiveVariable::FaceVarying, sTextureCoordinates)));
+		haveDigits = true;
+		if( significantDigits < 19 )
+		{
+			mantissa = mantissa * 10 + ( *c - '0' );
+			significantDigits += mantissa ? 1 : 0;
+		}
+		else
+		{
+			++exponent;
+		}
+	}
 
+	if( c < end && *c == '.' )
+	{
+		++c;
+		for( ; c < end && isDigit( *c ); ++c )
+		{
+			haveDigits = true;
+			if( significantDigits < 19 )
+			{
+				mantissa = mantissa * 10 + ( *c - '0' );
+				significantDigits += mantissa ? 1 : 0;
+				--exponent;
+			}
+		}
 	}
-	if( tTextureCoordinates->readable().size() )
+
+	if( !haveDigits )
 	{
-		mesh->variables.insert(PrimitiveVariableMap::value_type("t", PrimitiveVariable(  PrimitiveVariable::FaceVarying, tTextureCoordinates)));
+		return parseFloatSlow( p, end, result );
 	}
-	if( normals->readable().size() )
+
+	if( c < end && ( *c == 'e' || *c == 'E' ) )
 	{
-		mesh->variables.insert(PrimitiveVariableMap::value_type("N", PrimitiveVariable(  PrimitiveVariable::FaceVarying, normals)));
+		const char *e = c + 1;
+		bool negativeExponent = false;
+		if( e < end && ( *e == '-' || *e == '+' ) )
+		{
+			negativeExponent = *e == '-';
+			++e;
+		}
+		if( e < end && isDigit( *e ) )
+		{
+			int exponentValue = 0;
+			for( ; e < end && isDigit( *e ); ++e )
+			{
+				if( exponentValue < 10000 )
+				{
+					exponentValue = exponentValue * 10 + ( *e - '0' );
+				}
+			}
+			exponent += negativeExponent ? -exponentValue : exponentValue;
+			c = e;
+		}
 	}
-	return mesh;
-}
 
+	if( exponent < -22 || exponent > 22 )
+	{
+		p = start;
+		return parseFloatSlow( p, end, result );
+	}
 
-// parse a vertex
-void OBJReader::parseVertex(const char * begin, const char * end)
-{
-	vector<float> vec;
-	srule vertex = "v" >> real_p[append(vec)] >> real_p[append(vec)] >> real_p[append(vec)];
-	parse(begin, vertex, space_p);
-
-	// build v
-	V3f v;
-	v[0] = vec[0];
- 	v[1] = vec[1];
- 	v[2] = vec[2];
-
-	// add this vertex
-	m_vertices->push_back(v);
+	double value = (double)mantissa;
+	if( exponent < 0 )
+	{
+		value /= powersOfTen[-exponent];
+	}
+	else
+	{
+		value *= powersOfTen[exponent];
+	}
+
+	result = negative ? -value : value;
+	p = c;
+	return true;
 }
 
-// parse a texture coordinate
-void OBJReader::parseTextureCoordinate(const char * begin, const char * end)
+bool parseInt( const char *&p, const char *end, int &result )
 {
-	vector<float> vec;
-	srule vertex = "vt" >> real_p[append(vec)] >> real_p[append(vec)] >> *(real_p[append(vec)]);
-	parse(begin, vertex, space_p);
-
-	// build v
-	V3f vt;
-	vt[0] = vec[0];
- 	vt[1] = vec[1];
-	vt[2] = vec.size() == 3 ? vec[2] : 0.0f;
-
-	// add this texture coordinate
-	m_introducedTextureCoordinates.push_back(vt);
+	const char *c = p;
+	bool negative = false;
+	if( c < end && ( *c == '-' || *c == '+' ) )
+	{
+		negative = *c == '-';
+		++c;
+	}
+
+	if( c == end || !isDigit( *c ) )
+	{
+		return false;
+	}
+
+	int value = 0;
+	for( ; c < end && isDigit( *c ); ++c )
+	{
+		value = value * 10 + ( *c - '0' );
+	}
+
+	result = negative ? -value : value;
+	p = c;
+	return true;
 }
 
-// parse a normal
-void OBJReader::parseNormal(const char * begin, const char * end)
+// Parses n floats separated by whitespace, returning the number parsed.
+int parseFloats( const char *&p, const char *end, float *result, int n )
 {
-	vector<float> vec;
-	srule vertex = "vn" >> real_p[append(vec)] >> real_p[append(vec)] >> real_p[append(vec)];
-	parse(begin, vertex, space_p);
-
-	// build v
-	V3f vn;
-	vn[0] = vec[0];
-	vn[1] = vec[1];
-	vn[2] = vec[2];
-
-	// add this normal
-	m_introducedNormals.push_back(vn);
+	int i = 0;
+	for( ; i < n; ++i )
+	{
+		skipSpace( p, end );
+		if( !parseFloat( p, end, result[i] ) )
+		{
+			break;
+		}
+	}
+	return i;
 }
 
-// parse face
-void OBJReader::parseFace(const char * begin, const char * end)
+// Appends an index from a face statement, converting it to be zero based.
+void appendIndex( int index, size_t numElements, std::vector<int> &ids, std::vector<size_t> &relativeIds )
 {
-	vector<int> vec;
-	vector<int> tvec;
-	vector<int> nvec;
-
-	srule entry = int_p[append(vec)] >>
-		(
-			("/" >> (int_p[append(tvec)] | epsilon_p) >> "/" >> (int_p[append(nvec)] | epsilon_p))
-			| epsilon_p
-		);
-
-	srule face = "f"  >> entry >> entry >> entry >> *(entry);
-	parse(begin, face, space_p);
-
-	// push back the degree of the face
-	m_vpf->push_back(vec.size());
-
-	// merge in the edges.  we index from 0, so shift them down.
-	// also, vertices may be indexed negatively, in which case they are relative to
-	// the current set of vertices
-	for(vector<int>::const_iterator i = vec.begin(); i != vec.end(); ++i)
+	if( index > 0 )
 	{
-		m_vids->push_back(*i > 0 ? *i - 1 : m_vertices->size() + *i);
+		ids.push_back( index - 1 );
 	}
+	else if( index < 0 )
+	{
+		// vertices may be indexed negatively, in which case they are relative to
+		// the current set of vertices
+		relativeIds.push_back( ids.size() );
+		ids.push_back( (int)numElements + index );
+	}
+	else
+	{
+		throw Exception( "invalid face specification" );
+	}
+}
 
-
-	// merge in texture coordinates and normals, if present
+void parseFace( const char *p, const char *end, Chunk &chunk )
+{
 	// OBJ format requires an encoding for faces which uses one of the vertex/texture/normal specifications
-	// consistently across the entire face.  eg. we can have all v/vt/vn, or all v//vn, or all v, but not
+	// consistently across the entire face. eg. we can have all v/vt/vn, or all v//vn, or all v, but not
 	// v//vn then v/vt/vn ...
-	if(!nvec.empty())
+	int vertexIndices[3] = { 0, 0, 0 };
+	std::vector<int> &entries = chunk.vertexIds;
+	const size_t firstEntry = entries.size();
+	const size_t firstRelative = chunk.relativeVertexIds.size();
+	const size_t firstTextureCoordinate = chunk.textureCoordinateIds.size();
+	const size_t firstNormal = chunk.normalIds.size();
+
+	int numEntries = 0;
+	bool haveTextureCoordinates = false;
+	bool haveNormals = false;
+	while( true )
 	{
-		if(nvec.size() != vec.size())
-			throw Exception("invalid face specification");
+		skipSpace( p, end );
+		if( !parseInt( p, end, vertexIndices[0] ) )
+		{
+			break;
+		}
+
+		bool entryHasTextureCoordinate = false;
+		bool entryHasNormal = false;
+		if( p < end && *p == '/' )
+		{
+			++p;
+			entryHasTextureCoordinate = parseInt( p, end, vertexIndices[1] );
+			if( p < end && *p == '/' )
+			{
+				++p;
+				entryHasNormal = parseInt( p, end, vertexIndices[2] );
+			}
+		}
 
-		// copy in these references to normal vectors to the mesh's normal vector
-		for(vector<int>::const_iterator i = nvec.begin(); i != nvec.end(); ++i)
+		if( numEntries == 0 )
 		{
-			m_normals->push_back(m_introducedNormals[*i > 0 ? *i - 1 : m_introducedNormals.size() + *i]);
+			haveTextureCoordinates = entryHasTextureCoordinate;
+			haveNormals = entryHasNormal;
 		}
+		else if( entryHasTextureCoordinate != haveTextureCoordinates || entryHasNormal != haveNormals )
+		{
+			throw Exception( "invalid face specification" );
+		}
+
+		appendIndex( vertexIndices[0], chunk.vertices.size(), chunk.vertexIds, chunk.relativeVertexIds );
+		if( entryHasTextureCoordinate )
+		{
+			appendIndex( vertexIndices[1], chunk.textureCoordinates.size(), chunk.textureCoordinateIds, chunk.relativeTextureCoordinateIds );
+		}
+		if( entryHasNormal )
+		{
+			appendIndex( vertexIndices[2], chunk.normals.size(), chunk.normalIds, chunk.relativeNormalIds );
+		}
+		++numEntries;
 	}
-	// otherwise, check if we have specified normals in some previous face
-	// if so, and no normals were given here (examples, encoders that do this?), pump in
-	// default normal.  the default normal defined here is the zero normal, which is by
-	// definition orthogonal to every other vector.  this might result in odd lighting.
-	else
+
+	if( numEntries < 3 )
 	{
-		V3f zero(0.0f, 0.0f, 0.0f);
-		for(unsigned int i = 0; i < nvec.size(); ++i)
+		// not a valid face - discard anything we appended
+		entries.resize( firstEntry );
+		chunk.relativeVertexIds.resize( firstRelative );
+		chunk.textureCoordinateIds.resize( firstTextureCoordinate );
+		chunk.normalIds.resize( firstNormal );
+		while( chunk.relativeTextureCoordinateIds.size() && chunk.relativeTextureCoordinateIds.back() >= firstTextureCoordinate )
+		{
+			chunk.relativeTextureCoordinateIds.pop_back();
+		}
+		while( chunk.relativeNormalIds.size() && chunk.relativeNormalIds.back() >= firstNormal )
 		{
-			m_normals->push_back(zero);
+			chunk.relativeNormalIds.pop_back();
 		}
+		return;
 	}
 
+	chunk.verticesPerFace.push_back( numEntries );
+}
+
+// Parses all the lines in the range [begin, end), which must start at the
+// beginning of a line.
+void parseChunk( const char *begin, const char *end, Chunk &chunk )
+{
+	// see
+	// http://local.wasp.uwa.edu.au/~pbourke/dataformats/obj/
 	//
-	// merge in texture coordinates, if present
-	//
-	if(!tvec.empty())
+	// we currently only handle vertices, texture coordinates, normals and
+	// faces. all other statements, including comments and groups, are skipped.
+	/// \todo associate mesh objects with group names
+
+	const char *line = begin;
+	while( line < end )
 	{
-		if(tvec.size() != vec.size())
-			throw Exception("invalid face specification");
+		const char *lineEnd = static_cast<const char *>( memchr( line, '\n', end - line ) );
+		lineEnd = lineEnd ? lineEnd : end;
 
-		for(unsigned int i = 0; i < tvec.size(); ++i)
+		const char *p = line;
+		skipSpace( p, lineEnd );
+
+		if( p + 1 < lineEnd && p[0] == 'v' && isSpace( p[1] ) )
 		{
-			int index = tvec[i] > 0 ? tvec[i] - 1 : m_introducedTextureCoordinates.size() + tvec[i];
-			m_sTextureCoordinates->push_back(m_introducedTextureCoordinates[index][0]);
-			m_tTextureCoordinates->push_back(m_introducedTextureCoordinates[index][1]);
+			float v[3];
+			p += 1;
+			if( parseFloats( p, lineEnd, v, 3 ) == 3 )
+			{
+				chunk.vertices.push_back( V3f( v[0], v[1], v[2] ) );
+			}
 		}
-	}
-	else
-	{
-		for(unsigned int i = 0; i < tvec.size(); ++i)
+		else if( p + 2 < lineEnd && p[0] == 'v' && p[1] == 't' && isSpace( p[2] ) )
+		{
+			float vt[2];
+			p += 2;
+			if( parseFloats( p, lineEnd, vt, 2 ) == 2 )
+			{
+				chunk.textureCoordinates.push_back( V2f( vt[0], vt[1] ) );
+			}
+		}
+		else if( p + 2 < lineEnd && p[0] == 'v' && p[1] == 'n' && isSpace( p[2] ) )
 		{
-			m_sTextureCoordinates->push_back(0.0f);
-			m_tTextureCoordinates->push_back(0.0f);
+			float vn[3];
+			p += 2;
+			if( parseFloats( p, lineEnd, vn, 3 ) == 3 )
+			{
+				chunk.normals.push_back( V3f( vn[0], vn[1], vn[2] ) );
+			}
 		}
+		else if( p + 1 < lineEnd && p[0] == 'f' && isSpace( p[1] ) )
+		{
+			parseFace( p + 1, lineEnd, chunk );
+		}
+
+		line = lineEnd + 1;
 	}
 }
 
-void OBJReader::parseGroup(const char *begin, const char *end)
+//////////////////////////////////////////////////////////////////////////
+// Merging
+//////////////////////////////////////////////////////////////////////////
+
+// Computes the offset of each chunk's elements in the merged array,
+// returning the total number of elements.
+template<typename T>
+size_t prefixSum( const std::vector<Chunk> &chunks, std::vector<T> Chunk::*member, std::vector<size_t> &offsets )
 {
-	// set current group
-	vector<string> groupNames;
-	srule grouping = "g" >> *(lexeme_d[alnum_p >> *(alnum_p)][append(groupNames)]);
+	offsets.resize( chunks.size() + 1 );
+	offsets[0] = 0;
+	for( size_t i = 0; i < chunks.size(); ++i )
+	{
+		offsets[i+1] = offsets[i] + ( chunks[i].*member ).size();
+	}
+	return offsets.back();
+}
 
-	parse(begin, grouping, space_p);
+template<typename T>
+void merge( const std::vector<Chunk> &chunks, std::vector<T> Chunk::*member, std::vector<T> &result )
+{
+	std::vector<size_t> offsets;
+	result.resize( prefixSum( chunks, member, offsets ) );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, chunks.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::vector<T> &source = chunks[i].*member;
+				std::copy( source.begin(), source.end(), result.begin() + offsets[i] );
+			}
+		},
+		taskGroupContext
+	);
+}
+
+// Merges the ids from all chunks, offsetting the relative ids by the number
+// of elements defined in preceding chunks, and validating the result.
+void mergeIds(
+	const std::vector<Chunk> &chunks,
+	std::vector<int> Chunk::*ids, std::vector<size_t> Chunk::*relativeIds,
+	const std::vector<size_t> &elementOffsets, std::vector<int> &result
+)
+{
+	std::vector<size_t> offsets;
+	result.resize( prefixSum( chunks, ids, offsets ) );
+	const int numElements = elementOffsets.back();
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, chunks.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				const std::vector<int> &source = chunks[i].*ids;
+				std::vector<int>::iterator destination = result.begin() + offsets[i];
+				std::copy( source.begin(), source.end(), destination );
+
+				const int elementOffset = elementOffsets[i];
+				for( size_t r : chunks[i].*relativeIds )
+				{
+					destination[r] += elementOffset;
+				}
+
+				for( size_t j = 0, e = source.size(); j < e; ++j )
+				{
+					if( destination[j] < 0 || destination[j] >= numElements )
+					{
+						throw Exception( "invalid face specification" );
+					}
+				}
+			}
+		},
+		taskGroupContext
+	);
+}
+
+} // namespace
 
-	// from 'http://local.wasp.uwa.edu.au/~pbourke/dataformats/obj/':
-	// The default group name is default.
-	if(groupNames.empty())
+//////////////////////////////////////////////////////////////////////////
+// OBJReader
+//////////////////////////////////////////////////////////////////////////
+
+OBJReader::OBJReader( const std::string &fileName )
+	: Reader( "Alias Wavefront OBJ 3D data reader", new ObjectParameter("result", "the loaded 3D object", new
+	NullObject, MeshPrimitive::staticTypeId()))
+{
+	m_fileNameParameter->setTypedValue( fileName );
+}
+
+bool OBJReader::canRead( const string &fileName )
+{
+	// there really are no magic numbers, .obj is a simple ascii text file
+
+	// so: enforce at least that the file has '.obj' extension
+	if(fileName.rfind(".obj") != fileName.length() - 4)
+		return false;
+
+	// attempt to open the file
+	ifstream in(fileName.c_str());
+	return in.is_open();
+}
+
+ObjectPtr OBJReader::doOperation(const CompoundObject * operands)
+{
+	// for now we are going to retrieve vertex, texture, normal coordinates, faces.
+	// later (when we have the primitives), we will handle a larger subset of the
+	// OBJ format
+
+	// map the file and split it into chunks of whole lines
+
+	std::unique_ptr<boost::interprocess::mapped_region> region;
+	const char *data = nullptr;
+	size_t size = 0;
+	if( boost::filesystem::file_size( fileName() ) )
 	{
-		groupNames.push_back("default");
+		try
+		{
+			boost::interprocess::file_mapping file( fileName().c_str(), boost::interprocess::read_only );
+			region.reset( new boost::interprocess::mapped_region( file, boost::interprocess::read_only ) );
+		}
+		catch( const boost::interprocess::interprocess_exception &e )
+		{
+			throw IOException( boost::str( boost::format( "OBJReader : Failed to open \"%s\" (%s)." ) % fileName() % e.what() ) );
+		}
+		data = static_cast<const char *>( region->get_address() );
+		size = region->get_size();
 	}
 
-	// \todo associate mesh objects with group names
-}
+	std::vector<const char *> boundaries;
+	boundaries.push_back( data );
+	const char *end = data + size;
+	while( boundaries.back() < end )
+	{
+		const char *b = boundaries.back() + std::min( g_chunkSize, (size_t)( end - boundaries.back() ) );
+		if( b < end )
+		{
+			b = static_cast<const char *>( memchr( b, '\n', end - b ) );
+			b = b ? b + 1 : end;
+		}
+		boundaries.push_back( b );
+	}
 
-void OBJReader::parseOBJ() {
+	// parse the chunks in parallel
 
-	srule comment = comment_p("#");
+	std::vector<Chunk> chunks( boundaries.size() - 1 );
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, chunks.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				parseChunk( boundaries[i], boundaries[i+1], chunks[i] );
+			}
+		},
+		taskGroupContext
+	);
 
-	// see
-	// http://local.wasp.uwa.edu.au/~pbourke/dataformats/obj/
+	// merge the chunks
+
+	IntVectorDataPtr vpf = new IntVectorData();
+	merge( chunks, &Chunk::verticesPerFace, vpf->writable() );
+
+	V3fVectorDataPtr vertices = new V3fVectorData();
+	merge( chunks, &Chunk::vertices, vertices->writable() );
+
+	std::vector<size_t> elementOffsets;
+	prefixSum( chunks, &Chunk::vertices, elementOffsets );
+	IntVectorDataPtr vids = new IntVectorData();
+	mergeIds( chunks, &Chunk::vertexIds, &Chunk::relativeVertexIds, elementOffsets, vids->writable() );
+
+	// texture coordinates and normals are stored per face vertex
+
+	std::vector<V2f> textureCoordinates;
+	merge( chunks, &Chunk::textureCoordinates, textureCoordinates );
+	prefixSum( chunks, &Chunk::textureCoordinates, elementOffsets );
+	std::vector<int> textureCoordinateIds;
+	mergeIds( chunks, &Chunk::textureCoordinateIds, &Chunk::relativeTextureCoordinateIds, elementOffsets, textureCoordinateIds );
+
+	std::vector<V3f> normals;
+	merge( chunks, &Chunk::normals, normals );
+	prefixSum( chunks, &Chunk::normals, elementOffsets );
+	std::vector<int> normalIds;
+	mergeIds( chunks, &Chunk::normalIds, &Chunk::relativeNormalIds, elementOffsets, normalIds );
+
+	chunks.clear();
 
-	// vertices
-	srule vertex         = ("v"  >> real_p >> real_p >> real_p) [bind(&OBJReader::parseVertex,            this, _1, _2)];
-	srule vertex_texture = ("vt" >> real_p >> real_p)           [bind(&OBJReader::parseTextureCoordinate, this, _1, _2)];
-	srule vertex_normal  = ("vn" >> real_p >> real_p >> real_p) [bind(&OBJReader::parseNormal,            this, _1, _2)];
-	//srule vertex_parameter_space  = "vp" >> real_p >> real_p >> real_p;
-
-	// srule cs_types = ("bmatrix" | "bezier" | "bspline" | "cardinal" | "taylor");
-	// srule vertex_curve_or_surface = "cstype" >> "rat" >> cs_types;
-	// srule vertex_degree  = "deg" >> real_p >> real_p;
-	// srule vertex_basis_matrix  = "bmat";
-	// srule vertex_step_size  = "step" >> int_p >> int_p;
-	srule vertex_type = vertex | vertex_texture | vertex_normal;
-
-	// elements
-	srule point = "p" >> real_p >> *(real_p);
-	srule  line = "l" >> int_p >> int_p >> *(int_p);
-	srule  face = (ch_p('f') >> *(anychar_p))[bind(&OBJReader::parseFace, this, _1, _2)];
-	// srule curve = "curv";
-	// srule curve_2d = "curv2";
-	// srule surface = "surf";
-	srule element = point | line | face;
-
- 	// free-form curve / surface statements
-	// srule parameter = "parm";
-	// srule trim_loop = "trim";
-	// srule hole_loop = "hole";
-	// srule special_curve = "scrv";
-	// srule special_point = "sp";
-	// srule end_statement = "end";
-
-	// connectivity
-	//srule connect = "con";
-
-	// grouping
-	srule group_name = ("g" >> *(anychar_p))[bind(&OBJReader::parseGroup, this, _1, _2)];
-	//	srule smoothing_group = "s";
-	//	srule merging_group = "mg";
-	srule object_name = "o" >> int_p;
-	srule grouping = group_name | object_name;
-
-	// display and render attributes
-	// srule bevel_interpretation = "bevel";
-	// srule color_interpolation = "c_interp";
-	// srule dissolve_interpolation = "d_interp";
-	// srule level_of_detail = "lod";
-	// srule material_name = "usemtl";
-	// srule material_library = "mtllib";
-	// srule shadow_casting = "shadow_obj";
-	// srule ray_tracing = "trace_obj";
-	// srule curve_approximation_technique = "ctech";
-	// srule surface_approximation_technique = "stech";
-
-	ifstream in(fileName().c_str());
-	string str;
-	while(getline(in, str))
-		parse(str.c_str(), vertex_type | element | grouping | comment, space_p);
+	FloatVectorDataPtr sTextureCoordinates = new FloatVectorData();
+	FloatVectorDataPtr tTextureCoordinates = new FloatVectorData();
+	std::vector<float> &s = sTextureCoordinates->writable();
+	std::vector<float> &t = tTextureCoordinates->writable();
+	s.resize( textureCoordinateIds.size() );
+	t.resize( textureCoordinateIds.size() );
+
+	V3fVectorDataPtr faceVaryingNormals = new V3fVectorData();
+	std::vector<V3f> &n = faceVaryingNormals->writable();
+	n.resize( normalIds.size() );
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, std::max( s.size(), n.size() ) ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(), e = std::min( range.end(), s.size() ); i < e; ++i )
+			{
+				const V2f &st = textureCoordinates[textureCoordinateIds[i]];
+				s[i] = st[0];
+				t[i] = st[1];
+			}
+			for( size_t i = range.begin(), e = std::min( range.end(), n.size() ); i < e; ++i )
+			{
+				n[i] = normals[normalIds[i]];
+			}
+		},
+		taskGroupContext
+	);
+
+	// create our MeshPrimitive
+	MeshPrimitivePtr mesh = new MeshPrimitive( vpf, vids, "linear", vertices );
+	if( s.size() )
+	{
+		mesh->variables.insert(PrimitiveVariableMap::value_type("s", PrimitiveVariable( PrimitiveVariable::FaceVarying, sTextureCoordinates)));
+		mesh->variables.insert(PrimitiveVariableMap::value_type("t", PrimitiveVariable(  PrimitiveVariable::FaceVarying, tTextureCoordinates)));
+	}
+	if( n.size() )
+	{
+		mesh->variables.insert(PrimitiveVariableMap::value_type("N", PrimitiveVariable(  PrimitiveVariable::FaceVarying, faceVaryingNormals)));
+	}
+	return mesh;
 }
@@ -43,9 +43,14 @@
 #include "IECore/Timer.h"
 #include "IECore/VectorTypedData.h"
 
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <fstream>
+#include <type_traits>
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -57,20 +62,39 @@ IE_CORE_DEFINERUNTIMETYPED( PDCParticleReader );
 
 const Reader::ReaderDescription<PDCParticleReader> PDCParticleReader::m_readerDescription( "pdc" );
 
+namespace
+{
+
+template<typename T>
+void reverseElementBytes( T *elements, size_t n )
+{
+	IECore::reverseBytes( elements, n );
+}
+
+void reverseElementBytes( V3d *elements, size_t n )
+{
+	IECore::reverseBytes( elements->getValue(), n * 3 );
+}
+
+} // namespace
+
 PDCParticleReader::PDCParticleReader( )
-	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_iStream( nullptr ), m_idAttribute( nullptr )
+	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_data( nullptr ), m_size( 0 ), m_idAttribute( nullptr )
 {
+	m_header.valid = false;
+	m_filter.valid = false;
 }
 
 PDCParticleReader::PDCParticleReader( const std::string &fileName )
-	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_iStream( nullptr ), m_idAttribute( nullptr )
+	:	ParticleReader( "Reads Maya .pdc format particle caches" ), m_data( nullptr ), m_size( 0 ), m_idAttribute( nullptr )
 {
 	m_fileNameParameter->setTypedValue( fileName );
+	m_header.valid = false;
+	m_filter.valid = false;
 }
 
 PDCParticleReader::~PDCParticleReader()
 {
-	delete m_iStream;
 }
 
 bool PDCParticleReader::canRead( const std::string &fileName )
@@ -91,121 +115,159 @@ bool PDCParticleReader::canRead( const std::string &fileName )
 
 bool PDCParticleReader::open()
 {
-	if( !m_iStream || m_streamFileName!=fileName() )
+	if( m_region && m_streamFileName==fileName() )
+	{
+		return m_header.valid;
+	}
+
+	m_region.reset();
+	m_data = nullptr;
+	m_size = 0;
+	m_header.valid = false;
+	m_header.attributes.clear();
+	m_idAttribute = nullptr;
+	m_filter.valid = false;
+
+	try
 	{
-		delete m_iStream;
-		m_iStream = new ifstream( fileName().c_str() );
-		if( !m_iStream->is_open() || !m_iStream->good() )
+		boost::interprocess::file_mapping file( fileName().c_str(), boost::interprocess::read_only );
+		m_region.reset( new boost::interprocess::mapped_region( file, boost::interprocess::read_only ) );
+	}
+	catch( const boost::interprocess::interprocess_exception & )
+	{
+		// missing, unreadable or empty file
+		return false;
+	}
+
+	m_data = static_cast<const char *>( m_region->get_address() );
+	m_size = m_region->get_size();
+	m_streamFileName = fileName();
+
+	size_t pos = 0;
+	auto read = [this, &pos] ( void *dst, size_t n ) -> bool {
+		if( pos + n > m_size )
 		{
 			return false;
 		}
+		memcpy( dst, m_data + pos, n );
+		pos += n;
+		return true;
+	};
+
+	char pdc[4];
+	if( !read( pdc, 4 ) || strncmp( "PDC ", pdc, 4 ) )
+	{
+		return false;
+	}
+
+	int endian = 0;
+	if( !read( &m_header.version, sizeof( m_header.version ) ) || !read( &endian, sizeof( endian ) ) )
+	{
+		return false;
+	}
+
+	if( endian!=1 )
+	{
+		m_header.reverseBytes = true;
+		m_header.version = reverseBytes( m_header.version );
+	}
+	else
+	{
+		m_header.reverseBytes = false;
+	}
+
+	if( m_header.version > 1 )
+	{
+		msg( Msg::Warning, "PDCParticleReader::open()", format( "File \"%s\" has unknown version %d." ) % fileName() % m_header.version );
+	}
+
+	int unused[2];
+	int numAttributes;
+	if( !read( unused, sizeof( unused ) ) || !read( &m_header.numParticles, sizeof( m_header.numParticles ) ) || !read( &numAttributes, sizeof( numAttributes ) ) )
+	{
+		return false;
+	}
+
+	if( m_header.reverseBytes )
+	{
+		m_header.numParticles = reverseBytes( m_header.numParticles );
+		numAttributes = reverseBytes( numAttributes );
+	}
 
-		char pdc[4];
-		m_iStream->read( pdc, 4 );
-		if( strncmp( "PDC ", pdc, 4 ) )
+	for( int i=0; i<numAttributes; i++ )
+	{
+		int nameLength;
+		if( !read( &nameLength, sizeof( nameLength ) ) )
 		{
-			m_header.valid = false;
 			return false;
 		}
-
-		m_iStream->read( (char *)&m_header.version, sizeof( m_header.version ) );
-
-		int endian = 0;
-		m_iStream->read( (char *)&endian, sizeof( endian ) );
-		if( endian!=1 )
+		if( m_header.reverseBytes )
 		{
-			m_header.reverseBytes = true;
-			m_header.version = reverseBytes( m_header.version );
+			nameLength = reverseBytes( nameLength );
 		}
-		else
+		if( nameLength < 0 || pos + nameLength > m_size )
 		{
-			m_header.reverseBytes = false;
+			return false;
 		}
+		string attrName( m_data + pos, nameLength );
+		pos += nameLength;
 
-		if( m_header.version > 1 )
+		if( attrName=="ghostFrames" )
 		{
-			msg( Msg::Warning, "PDCParticleReader::open()", format( "File \"%s\" has unknown version %d." ) % fileName() % m_header.version );
+			// alias' own pdc files don't match their own spec.
+			// they have a junk attributes on the end with no
+			// type and no data. it's called ghostframes and
+			// we need to skip it to prevent our parsing from
+			// going bad.
+			assert( i==numAttributes-1 ); // we're assuming the bad attribute is always the last one
+			continue;
 		}
 
-		int unused = 0;
-		m_iStream->read( (char *)&unused, sizeof( unused ) );
-		m_iStream->read( (char *)&unused, sizeof( unused ) );
-
-		m_iStream->read( (char *)&m_header.numParticles, sizeof( m_header.numParticles ) );
-		if( m_header.reverseBytes )
+		Record r;
+		if( !read( &r.type, sizeof( r.type ) ) )
 		{
-			m_header.numParticles = reverseBytes( m_header.numParticles );
+			return false;
 		}
-
-		int numAttributes;
-		m_iStream->read( (char *)&numAttributes, sizeof( numAttributes ) );
 		if( m_header.reverseBytes )
 		{
-			numAttributes = reverseBytes( numAttributes );
+			r.type = reverseBytes( r.type );
 		}
-		for( int i=0; i<numAttributes; i++ )
-		{
-			int nameLength;
-			m_iStream->read( (char *)&nameLength, sizeof( nameLength ) );
-			if( m_header.reverseBytes )
-			{
-				nameLength = reverseBytes( nameLength );
-			}
-			string attrName; char c;
-			for( int j=0; j<nameLength; j++ )
-			{
-				m_iStream->read( &c, 1 );
-				attrName += c;
-			}
-			if( attrName=="ghostFrames" )
-			{
-				// alias' own pdc files don't match their own spec.
-				// they have a junk attributes on the end with no
-				// type and no data. it's called ghostframes and
-				// we need to skip it to prevent our stream from
-				// going bad.
-				assert( i==numAttributes-1 ); // we're assuming the bad attribute is always the last one
-				continue;
-			}
-			Record r;
-			m_iStream->read( (char *)&r.type, sizeof( r.type ) );
-			if( m_header.reverseBytes )
-			{
-				r.type = reverseBytes( r.type );
-			}
-			r.position = m_iStream->tellg();
-			m_header.attributes[attrName] = r;
-			switch( r.type )
-			{
-				case Integer :
-					m_iStream->seekg( sizeof( int ), ios_base::cur );
-					break;
-				case IntegerArray :
-					m_iStream->seekg( sizeof( int ) * m_header.numParticles, ios_base::cur );
-					break;
-				case Double :
-					m_iStream->seekg( sizeof( double ), ios_base::cur );
-					break;
-				case DoubleArray :
-					m_iStream->seekg( sizeof( double ) * m_header.numParticles, ios_base::cur );
-					break;
-				case Vector :
-					m_iStream->seekg( sizeof( double ) * 3, ios_base::cur );
-					break;
-				case VectorArray :
-					m_iStream->seekg( sizeof( double ) * 3 * m_header.numParticles, ios_base::cur );
-					break;
-				default :
-					assert( r.type < 6 ); // unknown type
-			}
+		r.position = pos;
+		m_header.attributes[attrName] = r;
 
+		switch( r.type )
+		{
+			case Integer :
+				pos += sizeof( int );
+				break;
+			case IntegerArray :
+				pos += sizeof( int ) * m_header.numParticles;
+				break;
+			case Double :
+				pos += sizeof( double );
+				break;
+			case DoubleArray :
+				pos += sizeof( double ) * m_header.numParticles;
+				break;
+			case Vector :
+				pos += sizeof( double ) * 3;
+				break;
+			case VectorArray :
+				pos += sizeof( double ) * 3 * m_header.numParticles;
+				break;
+			default :
+				assert( r.type < 6 ); // unknown type
 		}
 
-		m_header.valid = m_iStream->good();
-		m_streamFileName = fileName();
-		m_idAttribute = nullptr;
+		if( pos > m_size )
+		{
+			// truncated file
+			return false;
+		}
 	}
-	return m_iStream->good() && m_header.valid;
+
+	m_header.valid = true;
+	return true;
 }
 
 unsigned long PDCParticleReader::numParticles()
@@ -231,19 +293,69 @@ void PDCParticleReader::attributeNames( std::vector<std::string> &names )
 }
 
 template<typename T>
-void PDCParticleReader::readElements( T *buffer, std::streampos pos, unsigned long n ) const
+void PDCParticleReader::readElements( T *buffer, size_t position, unsigned long n ) const
 {
-	m_iStream->seekg( pos );
-	m_iStream->read( (char *)buffer, n * sizeof( T ) );
+	assert( position + n * sizeof( T ) <= m_size );
+	memcpy( buffer, m_data + position, n * sizeof( T ) );
 	if( m_header.reverseBytes )
 	{
-		for( unsigned long i=0; i<n; i++ )
+		reverseElementBytes( buffer, n );
+	}
+}
+
+template<typename T, typename F>
+typename T::Ptr PDCParticleReader::readArray( size_t position )
+{
+	typedef typename T::ValueType::value_type ElementType;
+
+	typename T::Ptr result = new T;
+	typename T::ValueType &out = result->writable();
+	const std::vector<size_t> *indices = selectedParticles();
+	const size_t n = indices ? indices->size() : m_header.numParticles;
+
+	/// \todo
+	/// we'd rather not initialise the memory here, but uninitialised resizes
+	/// of V3d vectors have historically been an order of magnitude slower
+	/// inside maya and python, due to the libstdc++ that maya ships with.
+	out.resize( n, ElementType( 0 ) );
+
+	if( !indices && std::is_same<ElementType, F>::value )
+	{
+		// straight copy out of the mapping, followed by a bulk byte swap
+		readElements( reinterpret_cast<F *>( out.data() ), position, n );
+		return result;
+	}
+
+	// gather the selected elements, converting them as we go
+	const char *source = m_data + position;
+	for( size_t i = 0; i < n; ++i )
+	{
+		const size_t index = indices ? (*indices)[i] : i;
+		assert( position + ( index + 1 ) * sizeof( F ) <= m_size );
+		F element;
+		memcpy( &element, source + index * sizeof( F ), sizeof( F ) );
+		if( m_header.reverseBytes )
 		{
-			*buffer = reverseBytes( *buffer );
-			buffer++;
+			reverseElementBytes( &element, 1 );
 		}
+		out[i] = IECore::convert<ElementType, F>( element );
+	}
+
+	return result;
+}
+
+const std::vector<size_t> *PDCParticleReader::selectedParticles()
+{
+	const float percentage = particlePercentage();
+	const int seed = particlePercentageSeed();
+	if( !m_filter.valid || m_filter.percentage != percentage || m_filter.seed != seed )
+	{
+		m_filter.filtered = filteredIndices( m_header.numParticles, percentage, idAttribute(), m_filter.indices );
+		m_filter.percentage = percentage;
+		m_filter.seed = seed;
+		m_filter.valid = true;
 	}
-	assert( m_iStream->good() );
+	return m_filter.filtered ? &m_filter.indices : nullptr;
 }
 
 DataPtr PDCParticleReader::readAttribute( const std::string &name )
@@ -276,12 +388,7 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 			}
 			break;
 		case IntegerArray :
-			{
-				IntVectorDataPtr d( new IntVectorData );
-				d->writable().resize( numParticles() );
-				readElements( &d->writable()[0], it->second.position, numParticles() );
-				result = filterAttr<IntVectorData, IntVectorData>( d.get(), particlePercentage(), idAttr );
-			}
+			result = readArray<IntVectorData, int>( it->second.position );
 			break;
 		case Double :
 			{
@@ -300,26 +407,21 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 			}
 			break;
 		case DoubleArray :
+			switch( realType() )
 			{
-				DoubleVectorDataPtr d( new DoubleVectorData );
-				d->writable().resize( numParticles() );
-				readElements( &d->writable()[0], it->second.position, numParticles() );
-				switch( realType() )
-				{
-					case PDCParticleReader::RealType::Native :
-					case PDCParticleReader::RealType::Double :
-						result = filterAttr<DoubleVectorData, DoubleVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-					case PDCParticleReader::RealType::Float :
-						result = filterAttr<FloatVectorData, DoubleVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-				}
+				case PDCParticleReader::RealType::Native :
+				case PDCParticleReader::RealType::Double :
+					result = readArray<DoubleVectorData, double>( it->second.position );
+					break;
+				case PDCParticleReader::RealType::Float :
+					result = readArray<FloatVectorData, double>( it->second.position );
+					break;
 			}
 			break;
 		case Vector :
 			{
 				V3dDataPtr d( new V3dData );
-				readElements( (double *)&d->writable(), it->second.position, 3 );
+				readElements( &d->writable(), it->second.position, 1 );
 				switch( realType() )
 				{
 					case PDCParticleReader::RealType::Native :
@@ -333,34 +435,15 @@ DataPtr PDCParticleReader::readAttribute( const std::string &name )
 			}
 			break;
 		case VectorArray :
+			switch( realType() )
 			{
-				V3dVectorDataPtr d( new V3dVectorData );
-				/// \todo
-				/// by all accounts the line below should be this :
-				///
-				/// d->writable().resize( numParticles() );
-				///
-				/// ie it shouldn't initialize the memory. but for some reason
-				/// that runs far far slower for us (at least an order of magnitude
-				/// slower) when we're in maya or python. we don't know why but it seems
-				/// to be related to libstdc++ (maya has it's own). so we're opting for
-				/// the initialized version - this seems slightly (~10%) slower when the planets
-				/// are aligned correctly, but so much faster when the planets are aligned against
-				/// us, as they seem to be whenever we're coding in maya. testing seems to show that
-				/// this resize problem only occurs with V3d, and not with V3f, or double, or even
-				/// a struct with 3 doubles in, or even a template struct with 3 doubles in.
-				d->writable().resize( numParticles(), V3d( 0 ) );
-				readElements( (double *)&d->writable()[0], it->second.position, numParticles() * 3 );
-				switch( realType() )
-				{
-					case PDCParticleReader::RealType::Native :
-					case PDCParticleReader::RealType::Double :
-						result = filterAttr<V3dVectorData, V3dVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-					case PDCParticleReader::RealType::Float :
-						result = filterAttr<V3fVectorData, V3dVectorData>( d.get(), particlePercentage(), idAttr );
-						break;
-				}
+				case PDCParticleReader::RealType::Native :
+				case PDCParticleReader::RealType::Double :
+					result = readArray<V3dVectorData, V3d>( it->second.position );
+					break;
+				case PDCParticleReader::RealType::Float :
+					result = readArray<V3fVectorData, V3d>( it->second.position );
+					break;
 			}
 			break;
 		default :
@@ -390,14 +473,14 @@ const Data * PDCParticleReader::idAttribute()
 			{
 				DoubleVectorDataPtr doubleVec = new DoubleVectorData;
 				doubleVec->writable().resize( numParticles() );
-				readElements( &doubleVec->writable()[0], it->second.position, numParticles() );
+				readElements( doubleVec->writable().data(), it->second.position, numParticles() );
 				m_idAttribute = doubleVec;
 			}
 			if( it->second.type==IntegerArray )
 			{
 				IntVectorDataPtr intVec = new IntVectorData;
 				intVec->writable().resize( numParticles() );
-				readElements( &intVec->writable()[0], it->second.position, numParticles() );
+				readElements( intVec->writable().data(), it->second.position, numParticles() );
 				m_idAttribute = intVec;
 			}
 		}
@@ -409,4 +492,3 @@ std::string PDCParticleReader::positionPrimVarName()
 {
 	return "position";
 }
-
@@ -48,6 +48,8 @@
 #include "IECore/TypedParameter.h"
 #include "IECore/VectorTypedData.h"
 
+#include "OpenEXR/ImathRandom.h"
+
 #include <algorithm>
 
 using namespace std;
@@ -57,6 +59,26 @@ using namespace boost;
 
 IE_CORE_DEFINERUNTIMETYPED( ParticleReader );
 
+namespace
+{
+
+template<typename U>
+void filteredIndicesFromIds( const std::vector<U> &ids, size_t numParticles, float fraction, int seed, std::vector<size_t> &indices )
+{
+	Imath::Rand48 r;
+	const size_t n = std::min( numParticles, ids.size() );
+	for( size_t i = 0; i < n; ++i )
+	{
+		r.init( seed + (int)ids[i] );
+		if( r.nextf() <= fraction )
+		{
+			indices.push_back( i );
+		}
+	}
+}
+
+} // namespace
+
 ParticleReader::ParticleReader( const std::string &description )
 		:	Reader( description, new ObjectParameter( "result", "The loaded object.", new NullObject, PointsPrimitive::staticTypeId() ) )
 {
@@ -243,3 +265,45 @@ bool ParticleReader::convertPrimVarNames() const
 	return m_convertPrimVarNamesParameter->getTypedValue();
 }
 
+bool ParticleReader::filteredIndices( size_t numParticles, float percentage, const IECore::Data *idAttr, std::vector<size_t> &indices ) const
+{
+	indices.clear();
+	if( percentage >= 100.0f )
+	{
+		return false;
+	}
+
+	const float fraction = percentage / 100.0f;
+	const int seed = particlePercentageSeed();
+	indices.reserve( (size_t)( numParticles * fraction ) );
+
+	if( idAttr )
+	{
+		if( const DoubleVectorData *ids = runTimeCast<const DoubleVectorData>( idAttr ) )
+		{
+			filteredIndicesFromIds( ids->readable(), numParticles, fraction, seed, indices );
+		}
+		else if( const IntVectorData *ids = runTimeCast<const IntVectorData>( idAttr ) )
+		{
+			filteredIndicesFromIds( ids->readable(), numParticles, fraction, seed, indices );
+		}
+		else
+		{
+			msg( Msg::Warning, "ParticleReader::filteredIndices", boost::format( "Unrecognized id data type in file \"%s\"! Disabling filtering." ) % fileName() );
+			return false;
+		}
+		return true;
+	}
+
+	// filtering based only on order
+	Imath::Rand48 r;
+	r.init( seed );
+	for( size_t i = 0; i < numParticles; ++i )
+	{
+		if( r.nextf() <= fraction )
+		{
+			indices.push_back( i );
+		}
+	}
+	return true;
+}
@@ -50,6 +50,9 @@
 #include "IECore/VectorOps.h"
 #include "IECore/VectorTypedData.h"
 
+#include "OpenEXR/ImathMatrixAlgo.h"
+#include "OpenEXR/ImathQuat.h"
+
 #include "boost/format.hpp"
 
 #include "tbb/tbb.h"
@@ -98,12 +101,13 @@ PointSmoothSkinningOp::PointSmoothSkinningOp() :
 
 	IntParameter::PresetsContainer blendPresets;
 	blendPresets.push_back( IntParameter::Preset( "Linear", Linear ) );
+	blendPresets.push_back( IntParameter::Preset( "DualQuaternion", DualQuaternion ) );
 	m_blendParameter = new IntParameter(
 	        "blend",
 	        "Blending algorithm used to deform the mesh.",
 	        Linear,
 	        Linear,
-	        Linear,
+	        DualQuaternion,
 	        blendPresets,
 	        true
 	);
@@ -206,116 +210,298 @@ const IntVectorParameter * PointSmoothSkinningOp::refIndicesParameter() const
 	return m_refIndicesParameter.get();
 }
 
-struct PointSmoothSkinningOp::DeformPositions
+//////////////////////////////////////////////////////////////////////////
+// PreparedSkin
+//////////////////////////////////////////////////////////////////////////
+
+namespace
 {
-	public :
 
-		DeformPositions( std::vector<V3f> &p_data, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, const std::vector<float> &pointInfluenceWeights, const std::vector<M44f> &skin_data, const std::vector<int> &refId_data )
-			:	m_pData( p_data ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ), m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights ), m_skinData(skin_data), m_refIdData(refId_data)
-		{
-		}
+// Number of influences stored in each block. Points with fewer influences
+// are padded with zero weights.
+const int g_blockWidth = 4;
 
-		void operator()( const tbb::blocked_range<size_t> &r ) const
-		{
-			for( size_t p_it=r.begin(); p_it!=r.end(); ++p_it )
-			{
-				V3f p_new(0,0,0);
+inline void accumulate( Quatf &result, const Quatf &q, float weight )
+{
+	result.r += q.r * weight;
+	result.v += q.v * weight;
+}
 
-				V3f &p_value = m_pData[p_it];
-				int p_id;
-				if( m_refIdData.size() )
-				{
-					// get the actual index to look up in the smooth skinning data
-					p_id = m_refIdData[p_it];
-				}
-				else
-				{
-					p_id = p_it;
-				}
+} // namespace
 
-				int p_influence_count = m_pointInfluenceCounts[p_id];
-				int p_index_offset = m_pointIndexOffsets[p_id];
+struct PointSmoothSkinningOp::PreparedSkin::Block
+{
+	int indices[g_blockWidth];
+	float weights[g_blockWidth];
+};
 
-				for (int p_influence_id = p_index_offset; p_influence_id < (p_index_offset+p_influence_count);
-						p_influence_id++)
-				{
-					int influence_id = m_pointInfluenceIndices[p_influence_id];
-					float weight = m_pointInfluenceWeights[p_influence_id];
-					p_new += p_value * m_skinData[influence_id] * weight;
-				}
-				p_value = p_new;
+struct PointSmoothSkinningOp::PreparedSkin::Transforms
+{
+	// Used for Linear blending
+	std::vector<M44f> matrices;
+	// Used for DualQuaternion blending
+	std::vector<Quatf> real;
+	std::vector<Quatf> dual;
+};
+
+PointSmoothSkinningOp::PreparedSkin::PreparedSkin( ConstSmoothSkinningDataPtr smoothSkinningData )
+	:	m_smoothSkinningData( smoothSkinningData )
+{
+	m_smoothSkinningData->validate();
+
+	const std::vector<int> &pointIndexOffsets = m_smoothSkinningData->pointIndexOffsets()->readable();
+	const std::vector<int> &pointInfluenceCounts = m_smoothSkinningData->pointInfluenceCounts()->readable();
+	const std::vector<int> &pointInfluenceIndices = m_smoothSkinningData->pointInfluenceIndices()->readable();
+	const std::vector<float> &pointInfluenceWeights = m_smoothSkinningData->pointInfluenceWeights()->readable();
+
+	const size_t numPoints = pointInfluenceCounts.size();
+	m_blockOffsets.reserve( numPoints + 1 );
+	int numBlocks = 0;
+	for( size_t i = 0; i < numPoints; ++i )
+	{
+		m_blockOffsets.push_back( numBlocks );
+		numBlocks += ( pointInfluenceCounts[i] + g_blockWidth - 1 ) / g_blockWidth;
+	}
+	m_blockOffsets.push_back( numBlocks );
+
+	m_blocks.resize( numBlocks );
+	for( size_t i = 0; i < numPoints; ++i )
+	{
+		Block *blocks = m_blocks.data() + m_blockOffsets[i];
+		const int count = pointInfluenceCounts[i];
+		const int offset = pointIndexOffsets[i];
+		const int paddedCount = ( m_blockOffsets[i+1] - m_blockOffsets[i] ) * g_blockWidth;
+		for( int j = 0; j < paddedCount; ++j )
+		{
+			Block &block = blocks[j / g_blockWidth];
+			if( j < count )
+			{
+				block.indices[j % g_blockWidth] = pointInfluenceIndices[offset + j];
+				block.weights[j % g_blockWidth] = pointInfluenceWeights[offset + j];
+			}
+			else
+			{
+				// pad with an influence the point already uses, so that
+				// the padding doesn't pull extra transforms into the cache.
+				block.indices[j % g_blockWidth] = pointInfluenceIndices[offset];
+				block.weights[j % g_blockWidth] = 0.0f;
 			}
 		}
+	}
+}
 
-	private :
+PointSmoothSkinningOp::PreparedSkin::~PreparedSkin()
+{
+}
 
-		std::vector<V3f> &m_pData;
-		const std::vector<int> &m_pointIndexOffsets;
-		const std::vector<int> &m_pointInfluenceCounts;
-		const std::vector<int> &m_pointInfluenceIndices;
-		const std::vector<float> &m_pointInfluenceWeights;
-		const std::vector<M44f> &m_skinData;
-		const std::vector<int> &m_refIdData;
+const SmoothSkinningData *PointSmoothSkinningOp::PreparedSkin::smoothSkinningData() const
+{
+	return m_smoothSkinningData.get();
+}
 
-};
+void PointSmoothSkinningOp::PreparedSkin::deformPoints( std::vector<Imath::V3f> &points, const std::vector<Imath::M44f> &deformationPose, Blend blend, const std::vector<int> &referenceIndices ) const
+{
+	deform( points, /* normals = */ false, deformationPose, blend, referenceIndices, std::vector<int>() );
+}
+
+void PointSmoothSkinningOp::PreparedSkin::deformNormals( std::vector<Imath::V3f> &normals, const std::vector<Imath::M44f> &deformationPose, Blend blend, const std::vector<int> &referenceIndices, const std::vector<int> &vertexIndices ) const
+{
+	deform( normals, /* normals = */ true, deformationPose, blend, referenceIndices, vertexIndices );
+}
 
-struct PointSmoothSkinningOp::DeformNormals
+void PointSmoothSkinningOp::PreparedSkin::skinningTransforms( const std::vector<Imath::M44f> &deformationPose, Blend blend, Transforms &transforms ) const
 {
-	public :
+	const std::vector<M44f> &influencePose = m_smoothSkinningData->influencePose()->readable();
+	if( deformationPose.size() != influencePose.size() )
+	{
+		throw InvalidArgumentException( "Number of elements in SmoothSkinningData.influencePose does not match number of elements in deformationPose" );
+	}
+
+	// we are pre-creating these as in the typical use-case the number of influence objects is much lower
+	// than the number of vertices that are going to be deformed
+	const size_t numInfluences = influencePose.size();
+	transforms.matrices.resize( numInfluences );
+	for( size_t i = 0; i < numInfluences; ++i )
+	{
+		transforms.matrices[i] = influencePose[i] * deformationPose[i];
+	}
 
-		DeformNormals( std::vector<V3f> &n_data, const std::vector<int> &pointIndexOffsets, const std::vector<int> &pointInfluenceCounts, const std::vector<int> &pointInfluenceIndices, const std::vector<float> &pointInfluenceWeights, const std::vector<M44f> &skin_data, const std::vector<int> &refId_data, std::vector<int> &vertexIndicesData )
-			:	m_nData( n_data ), m_pointIndexOffsets( pointIndexOffsets ), m_pointInfluenceCounts( pointInfluenceCounts ), m_pointInfluenceIndices( pointInfluenceIndices ), m_pointInfluenceWeights( pointInfluenceWeights ), m_skinData(skin_data), m_refIdData(refId_data), m_vertexIndicesData( vertexIndicesData )
+	if( blend != DualQuaternion )
+	{
+		return;
+	}
+
+	transforms.real.resize( numInfluences );
+	transforms.dual.resize( numInfluences );
+	for( size_t i = 0; i < numInfluences; ++i )
+	{
+		M44f rigid = transforms.matrices[i];
+		removeScalingAndShear( rigid, /* exc = */ false );
+		const Quatf real = extractQuat( rigid ).normalized();
+		const Quatf dual = Quatf( 0.0f, transforms.matrices[i].translation() ) * real;
+		transforms.real[i] = real;
+		transforms.dual[i] = Quatf( dual.r * 0.5f, dual.v * 0.5f );
+	}
+}
+
+void PointSmoothSkinningOp::PreparedSkin::deform( std::vector<Imath::V3f> &data, bool normals, const std::vector<Imath::M44f> &deformationPose, Blend blend, const std::vector<int> &referenceIndices, const std::vector<int> &vertexIndices ) const
+{
+	if( blend != Linear && blend != DualQuaternion )
+	{
+		throw InvalidArgumentException( "Unknown blend mode" );
+	}
+
+	Transforms transforms;
+	skinningTransforms( deformationPose, blend, transforms );
+
+	// find the point in the skinning data for each element, checking
+	// the indices up front rather than within the parallel loop.
+	const int numSkinPoints = m_blockOffsets.size() - 1;
+	auto skinPoint = [&]( size_t i ) {
+		int id = i;
+		if( vertexIndices.size() )
 		{
+			id = vertexIndices[id];
 		}
-
-		void operator()( const tbb::blocked_range<size_t> &r ) const
+		if( referenceIndices.size() )
 		{
-			for( size_t n_it=r.begin(); n_it!=r.end(); ++n_it )
-			{
-				V3f n_new(0,0,0);
+			id = referenceIndices[id];
+		}
+		return id;
+	};
 
-				V3f &n_value = m_nData[n_it];
-				V3f n_unw;
+	for( size_t i = 0, e = data.size(); i < e; ++i )
+	{
+		if( vertexIndices.size() && ( i >= vertexIndices.size() || vertexIndices[i] < 0 ) )
+		{
+			throw InvalidArgumentException( "Vertex index out of range" );
+		}
+		if( referenceIndices.size() && (size_t)( vertexIndices.size() ? vertexIndices[i] : i ) >= referenceIndices.size() )
+		{
+			throw InvalidArgumentException( "Reference index out of range" );
+		}
+		const int id = skinPoint( i );
+		if( id < 0 || id >= numSkinPoints )
+		{
+			throw InvalidArgumentException( "Point index out of range of SmoothSkinningData" );
+		}
+	}
 
-				int n_id = n_it;
+	const Block *blocks = m_blocks.data();
+	const int *blockOffsets = m_blockOffsets.data();
 
-				if( m_vertexIndicesData.size() )
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	if( blend == Linear )
+	{
+		const M44f *matrices = transforms.matrices.data();
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, data.size() ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
 				{
-					n_id = m_vertexIndicesData[n_id];
+					// blend the matrices and then transform once, rather
+					// than transforming once per influence. the fixed-size
+					// inner loops are straightforward for the compiler to vectorise.
+					const int id = skinPoint( i );
+					float m[16] = { 0.0f };
+					for( const Block *block = blocks + blockOffsets[id], *blockEnd = blocks + blockOffsets[id+1]; block != blockEnd; ++block )
+					{
+						for( int lane = 0; lane < g_blockWidth; ++lane )
+						{
+							const float *s = matrices[block->indices[lane]].getValue();
+							const float w = block->weights[lane];
+							for( int k = 0; k < 16; ++k )
+							{
+								m[k] += s[k] * w;
+							}
+						}
+					}
+
+					// the blended matrix is treated as affine, matching the result
+					// of transforming by each influence and summing the weighted
+					// results.
+					const V3f v = data[i];
+					V3f result(
+						v.x * m[0] + v.y * m[4] + v.z * m[8],
+						v.x * m[1] + v.y * m[5] + v.z * m[9],
+						v.x * m[2] + v.y * m[6] + v.z * m[10]
+					);
+					if( !normals )
+					{
+						result += V3f( m[12], m[13], m[14] );
+					}
+					data[i] = result;
 				}
-				if( m_refIdData.size() )
+			},
+			taskGroupContext
+		);
+	}
+	else
+	{
+		const Quatf *real = transforms.real.data();
+		const Quatf *dual = transforms.dual.data();
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, data.size() ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
 				{
-					n_id = m_refIdData[n_id];
-				}
+					const int id = skinPoint( i );
+					const Block *blockBegin = blocks + blockOffsets[id];
+					const Block *blockEnd = blocks + blockOffsets[id+1];
+					if( blockBegin == blockEnd )
+					{
+						// no influences, matching the Linear result
+						data[i] = V3f( 0 );
+						continue;
+					}
 
-				int n_influence_count = m_pointInfluenceCounts[n_id];
-				int n_index_offset = m_pointIndexOffsets[n_id];
+					// blend the dual quaternions, flipping any which lie in
+					// the opposite hemisphere to the first so that we
+					// take the shortest path.
+					const Quatf &pivot = real[blockBegin->indices[0]];
+					Quatf blendedReal( 0, 0, 0, 0 );
+					Quatf blendedDual( 0, 0, 0, 0 );
+					for( const Block *block = blockBegin; block != blockEnd; ++block )
+					{
+						for( int lane = 0; lane < g_blockWidth; ++lane )
+						{
+							const int index = block->indices[lane];
+							float w = block->weights[lane];
+							if( real[index].r * pivot.r + ( real[index].v ^ pivot.v ) < 0.0f )
+							{
+								w = -w;
+							}
+							accumulate( blendedReal, real[index], w );
+							accumulate( blendedDual, dual[index], w );
+						}
+					}
 
-				for (int n_influence_id = n_index_offset; n_influence_id < (n_index_offset+n_influence_count);
-						n_influence_id++)
-				{
-					int influence_id = m_pointInfluenceIndices[n_influence_id];
-					float weight = m_pointInfluenceWeights[n_influence_id];
+					const float length = sqrtf( blendedReal.r * blendedReal.r + blendedReal.v.length2() );
+					if( length == 0.0f )
+					{
+						data[i] = V3f( 0 );
+						continue;
+					}
+					blendedReal = Quatf( blendedReal.r / length, blendedReal.v / length );
+					blendedDual = Quatf( blendedDual.r / length, blendedDual.v / length );
 
-					m_skinData[influence_id].multDirMatrix(n_value,n_unw);
-					n_new += n_unw * weight;
+					V3f result = data[i] * blendedReal.toMatrix33();
+					if( !normals )
+					{
+						const Quatf translation = blendedDual * Quatf( blendedReal.r, -blendedReal.v );
+						result += translation.v * 2.0f;
+					}
+					data[i] = result;
 				}
-				n_value = n_new;
-			}
-		}
-
-	private :
-
-		std::vector<V3f> &m_nData;
-		const std::vector<int> &m_pointIndexOffsets;
-		const std::vector<int> &m_pointInfluenceCounts;
-		const std::vector<int> &m_pointInfluenceIndices;
-		const std::vector<float> &m_pointInfluenceWeights;
-		const std::vector<M44f> &m_skinData;
-		const std::vector<int> &m_refIdData;
-		const std::vector<int> &m_vertexIndicesData;
+			},
+			taskGroupContext
+		);
+	}
+}
 
-};
+//////////////////////////////////////////////////////////////////////////
+// PointSmoothSkinningOp
+//////////////////////////////////////////////////////////////////////////
 
 void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operands )
 {
@@ -377,15 +563,19 @@ void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operand
 	}
 
 	// check if the smooth skinning data has changed since the last time the op was used;
-	// validating the ssd can be expensive and unnecessary for the case that the ssd is not changing
-	// so we are storing an internal copy of the ssd as a comparison is much faster than a complete validation
-	if ( ssd != m_prevSmoothSkinningData )
+	// validating and preparing the ssd can be expensive and unnecessary for the case that the ssd
+	// is not changing so we are storing the prepared skin and reusing it when the ssd is the same.
+	// We compare hashes rather than pointers, because the ssd may have been edited in place.
+	const MurmurHash ssdHash = ssd->hash();
+	if ( !m_preparedSkin || ssdHash != m_preparedSkinHash )
 	{
-		ssd->validate();
-		m_prevSmoothSkinningData = ssd;
+		m_preparedSkin = new PreparedSkin( ssd );
+		m_preparedSkinHash = ssdHash;
 	}
 
 	// test n data
+	std::vector<int> emptyVertexIndices;
+	const std::vector<int> *vertexIndicesData = &emptyVertexIndices;
 	if ( deform_n )
 	{
 		PrimitiveVariableMap::const_iterator it = pt->variables.find(normal_var);
@@ -407,6 +597,10 @@ void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operand
 						throw Exception("Position and normal variables must be the same length!");
 					}
 				}
+				else
+				{
+					vertexIndicesData = &mesh->vertexIds()->readable();
+				}
 			}
 		}
 		else
@@ -415,80 +609,14 @@ void PointSmoothSkinningOp::modify( Object *input, const CompoundObject *operand
 		}
 	}
 
-	// generate skinning matrices
-	// we are pre-creating these as in the typical use-case the number of influence objects is much lower
-	// than the number of vertices that are going to be deformed
-    std::vector<M44f> skin_data;
-	skin_data.reserve( inf_size );
-
-	std::vector<M44f>::const_iterator ip_it = ssd->influencePose()->readable().begin();
-
-	for( std::vector<M44f>::const_iterator dp_it = def_data.begin();
-		 dp_it!=def_data.end(); ++dp_it )
-	{
+	// deform our P
+	m_preparedSkin->deformPoints( p_data, def_data, blend, refId_data );
 
-		M44f mat = (*ip_it) *  (*dp_it);
-		skin_data.push_back( mat );
-		++ip_it;
-	}
-
-
-	// iterate through all the points in the source primitive and deform using the weighted skinning matrices
-	if ( blend == Linear )
-	{
-		const std::vector<int> &pointIndexOffsets = ssd->pointIndexOffsets()->readable();
-		const std::vector<int> &pointInfluenceCounts = ssd->pointInfluenceCounts()->readable();
-		const std::vector<int> &pointInfluenceIndices = ssd->pointInfluenceIndices()->readable();
-		const std::vector<float> &pointInfluenceWeights = ssd->pointInfluenceWeights()->readable();
-
-		// deform our P
-		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
-		tbb::parallel_for(
-			tbb::blocked_range<size_t>( 0, p_size ),
-			DeformPositions( p_data, pointIndexOffsets, pointInfluenceCounts, pointInfluenceIndices, pointInfluenceWeights, skin_data, refId_data ),
-			taskGroupContext
-		);
-
-		// deform our N
-		if ( deform_n )
-		{
-			PrimitiveVariableMap::const_iterator it = pt->variables.find(normal_var);
-			if ( it != pt->variables.end() )
-			{
-				V3fVectorData *n = pt->variableData<V3fVectorData>(normal_var);
-				std::vector<V3f> &n_data =  n->writable();
-
-				std::vector<int> vertexIndicesData;
-				if (it->second.interpolation == PrimitiveVariable::FaceVarying )
-				{
-					MeshPrimitive *mesh = dynamic_cast<MeshPrimitive *>( pt );
-					if( mesh )
-					{
-						vertexIndicesData = mesh->vertexIds()->readable();
-					}
-				}
-
-				tbb::parallel_for(
-					tbb::blocked_range<size_t>( 0, n_data.size() ),
-					DeformNormals(
-						n_data,
-						pointIndexOffsets,
-						pointInfluenceCounts,
-						pointInfluenceIndices,
-						pointInfluenceWeights,
-						skin_data,
-						refId_data,
-						vertexIndicesData
-					),
-					taskGroupContext
-				);
-			}
-        }
-	}
-	else
+	// deform our N
+	if ( deform_n )
 	{
-		// this should never happen
-		assert(0);
+		V3fVectorData *n = pt->variableData<V3fVectorData>(normal_var);
+		m_preparedSkin->deformNormals( n->writable(), def_data, blend, refId_data, *vertexIndicesData );
 	}
 
 }
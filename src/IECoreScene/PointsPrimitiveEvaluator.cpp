@@ -36,8 +36,15 @@
 
 #include "IECoreScene/PointsPrimitive.h"
 
+#include "IECore/DespatchTypedData.h"
 #include "IECore/Exception.h"
 #include "IECore/SimpleTypedData.h"
+#include "IECore/TypeTraits.h"
+
+#include "boost/format.hpp"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 using namespace std;
 using namespace Imath;
@@ -48,6 +55,63 @@ IE_CORE_DEFINERUNTIMETYPED( PointsPrimitiveEvaluator );
 
 PrimitiveEvaluator::Description<PointsPrimitiveEvaluator> PointsPrimitiveEvaluator::g_evaluatorDescription;
 
+namespace
+{
+
+// Gathers the elements of a vector primitive variable for a batch of points.
+struct GatherPrimitiveVariable
+{
+	typedef DataPtr ReturnType;
+
+	GatherPrimitiveVariable( PrimitiveVariable::Interpolation interpolation, const std::vector<int> &pointIndices )
+		:	m_interpolation( interpolation ), m_pointIndices( pointIndices )
+	{
+	}
+
+	template<typename T>
+	ReturnType operator()( const T *data ) const
+	{
+		const typename T::ValueType &input = data->readable();
+		typename T::Ptr result = new T;
+		typename T::ValueType &output = result->writable();
+		if( m_interpolation == PrimitiveVariable::Uniform )
+		{
+			output.resize( m_pointIndices.size(), input[0] );
+			return result;
+		}
+
+		output.resize( m_pointIndices.size() );
+		auto gather = [&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				output[i] = input[m_pointIndices[i]];
+			}
+		};
+
+		const tbb::blocked_range<size_t> range( 0, m_pointIndices.size() );
+		if( std::is_same<typename T::ValueType::value_type, bool>::value )
+		{
+			// Elements of std::vector<bool> share storage, so can't be written concurrently.
+			gather( range );
+		}
+		else
+		{
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			tbb::parallel_for( range, gather, taskGroupContext );
+		}
+
+		return result;
+	}
+
+	private :
+
+		PrimitiveVariable::Interpolation m_interpolation;
+		const std::vector<int> &m_pointIndices;
+
+};
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // Implementation of Result
 //////////////////////////////////////////////////////////////////////////
@@ -250,6 +314,71 @@ int PointsPrimitiveEvaluator::intersectionPoints( const Imath::V3f &origin, cons
 	throw NotImplementedException( __PRETTY_FUNCTION__ );
 }
 
+void PointsPrimitiveEvaluator::closestPoints( const std::vector<Imath::V3f> &points, std::vector<int> &pointIndices ) const
+{
+	if( !m_pointsPrimitive->getNumPoints() )
+	{
+		throw InvalidArgumentException( "PointsPrimitiveEvaluator : Cannot find closest points without any points" );
+	}
+
+	// Build the tree up front so that the parallel queries below
+	// don't all contend on the tree mutex.
+	const_cast<PointsPrimitiveEvaluator *>( this )->buildTree();
+
+	pointIndices.resize( points.size() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, points.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				pointIndices[i] = m_tree.nearestNeighbour( points[i] ) - m_pVector->begin();
+			}
+		},
+		taskGroupContext
+	);
+}
+
+IECore::CompoundDataPtr PointsPrimitiveEvaluator::primitiveVariables( const std::vector<int> &pointIndices, const std::vector<std::string> &names ) const
+{
+	const int numPoints = m_pointsPrimitive->getNumPoints();
+	for( size_t i = 0, e = pointIndices.size(); i < e; ++i )
+	{
+		if( pointIndices[i] < 0 || pointIndices[i] >= numPoints )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "PointsPrimitiveEvaluator : Invalid point index %d" ) % pointIndices[i] ) );
+		}
+	}
+
+	CompoundDataPtr result = new CompoundData;
+	for( const auto &name : names )
+	{
+		PrimitiveVariableMap::const_iterator it = m_pointsPrimitive->variables.find( name );
+		if( it == m_pointsPrimitive->variables.end() )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "PointsPrimitiveEvaluator : No PrimitiveVariable named \"%s\"" ) % name ) );
+		}
+		if( !m_pointsPrimitive->isPrimitiveVariableValid( it->second ) )
+		{
+			throw InvalidArgumentException( boost::str( boost::format( "PointsPrimitiveEvaluator : PrimitiveVariable \"%s\" is not valid" ) % name ) );
+		}
+
+		if( it->second.interpolation == PrimitiveVariable::Constant )
+		{
+			// Copy, so that edits to the result can't modify the primitive.
+			result->writable()[name] = it->second.data->copy();
+			continue;
+		}
+
+		DataPtr data = it->second.indices ? it->second.expandedData() : it->second.data;
+		GatherPrimitiveVariable gather( it->second.interpolation, pointIndices );
+		result->writable()[name] = despatchTypedData<GatherPrimitiveVariable, TypeTraits::IsVectorTypedData>( data.get(), gather );
+	}
+
+	return result;
+}
+
 void PointsPrimitiveEvaluator::buildTree()
 {
 	if( m_haveTree )
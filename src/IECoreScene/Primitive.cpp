@@ -95,7 +95,7 @@ void Primitive::copyFrom( const Object *other, IECore::Object::CopyContext *cont
 	for( PrimitiveVariableMap::const_iterator it=tOther->variables.begin(); it!=tOther->variables.end(); it++ )
 	{
 		IntVectorDataPtr indices = ( it->second.indices ) ? context->copy<IntVectorData>( it->second.indices.get() ) : nullptr;
-		variables.insert( PrimitiveVariableMap::value_type( it->first, PrimitiveVariable( it->second.interpolation, context->copy<Data>( it->second.data.get() ), indices ) ) );
+		variables.insert( variables.end(), PrimitiveVariableMap::value_type( it->first, PrimitiveVariable( it->second.interpolation, context->copy<Data>( it->second.data.get() ), indices ) ) );
 	}
 }
 
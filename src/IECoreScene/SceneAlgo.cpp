@@ -37,11 +37,28 @@
 #include "IECoreScene/CurvesPrimitive.h"
 #include "IECoreScene/MeshPrimitive.h"
 #include "IECoreScene/PointsPrimitive.h"
+#include "IECoreScene/SceneCache.h"
 #include "IECoreScene/SceneInterface.h"
 
+#include "IECore/Exception.h"
+#include "IECore/LRUCache.h"
+#include "IECore/StreamIndexedIO.h"
+
+#include "boost/format.hpp"
+#include "boost/noncopyable.hpp"
+
+#include "tbb/concurrent_hash_map.h"
+#include "tbb/pipeline.h"
 #include "tbb/task.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_scheduler_init.h"
 
+#include <algorithm>
 #include <atomic>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -125,33 +142,110 @@ struct CopyInfo
 	T setCount;
 };
 
-CopyInfo<size_t> handleLocation( const SceneInterface *src, SceneInterface *dst, double time, unsigned int flags )
+// Everything read from a location, held so that it can be written
+// to the destination later.
+struct LocationData
+{
+	Imath::Box3d bound;
+	IECore::ConstDataPtr transform;
+	std::vector<std::pair<SceneInterface::Name, IECore::ConstObjectPtr> > attributes;
+	SceneInterface::NameList tags;
+	std::vector<std::pair<SceneInterface::Name, PathMatcher> > sets;
+	IECore::ConstObjectPtr object;
+	// Hashes of the attributes and object, computed in the parallel read
+	// stage so that a SceneCache destination needn't compute them again.
+	std::vector<IECore::MurmurHash> attributeHashes;
+	IECore::MurmurHash objectHash;
+};
+
+// Records a ReadProfile event for the lifetime of the scope,
+// if a profile has been provided.
+class PhaseScope : boost::noncopyable
+{
+
+	public :
+
+		PhaseScope( SceneAlgo::ReadProfile *profile, const SceneInterface::Path &path, double time, SceneAlgo::ProcessFlags phase )
+			:	m_profile( profile )
+		{
+			if( !m_profile )
+			{
+				return;
+			}
+
+			m_event.path = path;
+			m_event.time = time;
+			m_event.phase = phase;
+			m_event.thread = std::hash<std::thread::id>()( std::this_thread::get_id() );
+			m_readStatistics = StreamIndexedIO::threadReadStatistics();
+			m_cacheStatistics = SceneCache::threadCacheStatistics();
+			m_event.start = m_profile->elapsed();
+		}
+
+		~PhaseScope()
+		{
+			if( !m_profile )
+			{
+				return;
+			}
+
+			m_event.duration = m_profile->elapsed() - m_event.start;
+
+			const StreamIndexedIO::ReadStatistics readStatistics = StreamIndexedIO::threadReadStatistics() - m_readStatistics;
+			m_event.bytesRead = readStatistics.bytesRead;
+			m_event.bytesDecompressed = readStatistics.bytesDecompressed;
+			m_event.decompressionTime = readStatistics.decompressionTime;
+
+			const SceneCache::CacheStatistics cacheStatistics = SceneCache::threadCacheStatistics() - m_cacheStatistics;
+			m_event.cacheHits = cacheStatistics.hits;
+			m_event.cacheMisses = cacheStatistics.misses;
+
+			m_profile->addEvent( m_event );
+		}
+
+	private :
+
+		SceneAlgo::ReadProfile *m_profile;
+		SceneAlgo::ReadProfile::Event m_event;
+		StreamIndexedIO::ReadStatistics m_readStatistics;
+		SceneCache::CacheStatistics m_cacheStatistics;
+
+};
+
+// Reads everything specified by flags from src, storing it in data if
+// it is non-null, and recording events in profile if it is non-null.
+CopyInfo<size_t> readLocation( const SceneInterface *src, double time, unsigned int flags, LocationData *data, SceneAlgo::ReadProfile *profile = nullptr )
 {
 	SceneInterface::Path path;
 	src->path( path );
 	bool isRoot = path.empty();
 	CopyInfo<size_t> copyInfo;
 
+	PhaseScope locationScope( profile, path, time, SceneAlgo::None );
+
 	if( flags & SceneAlgo::Bounds )
 	{
+		PhaseScope phaseScope( profile, path, time, SceneAlgo::Bounds );
 		auto bound = src->readBound( time );
-		if( dst )
+		if( data )
 		{
-			dst->writeBound( bound, time );
+			data->bound = bound;
 		}
 	}
 
 	if( flags & SceneAlgo::Transforms )
 	{
+		PhaseScope phaseScope( profile, path, time, SceneAlgo::Transforms );
 		IECore::ConstDataPtr transform = src->readTransform( time );
-		if( dst && !isRoot )
+		if( data )
 		{
-			dst->writeTransform( transform.get(), time );
+			data->transform = transform;
 		}
 	}
 
 	if( flags & SceneAlgo::Attributes )
 	{
+		PhaseScope phaseScope( profile, path, time, SceneAlgo::Attributes );
 		SceneInterface::NameList attributeNames;
 		src->attributeNames( attributeNames );
 
@@ -159,40 +253,44 @@ CopyInfo<size_t> handleLocation( const SceneInterface *src, SceneInterface *dst,
 		for( const auto &attributeName : attributeNames )
 		{
 			IECore::ConstObjectPtr attr = src->readAttribute( attributeName, time );
-			if( dst )
+			if( data )
 			{
-				dst->writeAttribute( attributeName, attr.get(), time );
+				data->attributes.push_back( std::make_pair( attributeName, attr ) );
+				data->attributeHashes.push_back( attr->hash() );
 			}
 		}
 	}
 
 	if( flags & SceneAlgo::Tags )
 	{
+		PhaseScope phaseScope( profile, path, time, SceneAlgo::Tags );
 		SceneInterface::NameList tags;
 		src->readTags( tags );
 		copyInfo.tagCount += tags.size();
-		if( dst )
+		if( data )
 		{
-			dst->writeTags( tags );
+			data->tags = tags;
 		}
 	}
 
 	if( flags & SceneAlgo::Sets && isRoot )
 	{
+		PhaseScope phaseScope( profile, path, time, SceneAlgo::Sets );
 		SceneInterface::NameList setNames = src->setNames();
 		copyInfo.setCount += setNames.size();
 		for( const auto &setName : setNames )
 		{
 			PathMatcher set = src->readSet( setName );
-			if( dst )
+			if( data )
 			{
-				dst->writeSet( setName, set );
+				data->sets.push_back( std::make_pair( setName, set ) );
 			}
 		}
 	}
 
 	if( flags & SceneAlgo::Objects && src->hasObject() )
 	{
+		PhaseScope phaseScope( profile, path, time, SceneAlgo::Objects );
 		IECore::ConstObjectPtr obj = src->readObject( time );
 
 		if( IECoreScene::MeshPrimitive::ConstPtr mesh = IECore::runTimeCast<const IECoreScene::MeshPrimitive>( obj ) )
@@ -207,9 +305,10 @@ CopyInfo<size_t> handleLocation( const SceneInterface *src, SceneInterface *dst,
 		{
 			copyInfo.pointCount += points->getNumPoints();
 		}
-		if( dst )
+		if( data )
 		{
-			dst->writeObject( obj.get(), time );
+			data->object = obj;
+			data->objectHash = obj->hash();
 		}
 	}
 
@@ -217,19 +316,263 @@ CopyInfo<size_t> handleLocation( const SceneInterface *src, SceneInterface *dst,
 
 }
 
-template<typename LocationFn>
-void copy( const SceneInterface *src, SceneInterface *dst, double time, unsigned int flags, LocationFn &locationFn )
+// Writes data previously read by readLocation() to dst.
+void writeLocation( const LocationData &data, SceneInterface *dst, double time, unsigned int flags, bool isRoot )
 {
-	locationFn( src, dst, time, flags );
+	if( flags & SceneAlgo::Bounds )
+	{
+		dst->writeBound( data.bound, time );
+	}
 
-	SceneInterface::NameList childNames;
-	src->childNames( childNames );
+	if( flags & SceneAlgo::Transforms && !isRoot )
+	{
+		dst->writeTransform( data.transform.get(), time );
+	}
 
-	for( const auto &childName : childNames )
+	// SceneCache stores content hashes, so we pass on the ones we've already computed.
+	SceneCache *sceneCache = runTimeCast<SceneCache>( dst );
+
+	for( size_t i = 0; i < data.attributes.size(); ++i )
 	{
-		SceneInterfacePtr dstChild = dst->child( childName, SceneInterface::CreateIfMissing );
-		::copy( src->child( childName ).get(), dstChild.get(), time, flags, locationFn );
+		const auto &attribute = data.attributes[i];
+		if( sceneCache )
+		{
+			sceneCache->writeAttribute( attribute.first, attribute.second.get(), time, data.attributeHashes[i] );
+		}
+		else
+		{
+			dst->writeAttribute( attribute.first, attribute.second.get(), time );
+		}
 	}
+
+	if( flags & SceneAlgo::Tags )
+	{
+		dst->writeTags( data.tags );
+	}
+
+	for( const auto &set : data.sets )
+	{
+		dst->writeSet( set.first, set.second );
+	}
+
+	if( data.object )
+	{
+		if( sceneCache )
+		{
+			sceneCache->writeObject( data.object.get(), time, data.objectHash );
+		}
+		else
+		{
+			dst->writeObject( data.object.get(), time );
+		}
+	}
+}
+
+// A location being copied. Locations are created in the destination by
+// the writer, so `dst` and `parent` are only accessed from the writer stage.
+struct CopyLocation
+{
+	ConstSceneInterfacePtr src;
+	SceneInterfacePtr dst;
+	std::shared_ptr<CopyLocation> parent;
+	SceneInterface::Name name;
+	LocationData data;
+};
+
+typedef std::shared_ptr<CopyLocation> CopyLocationPtr;
+
+// Generates CopyLocations in the order of a serial depth first copy.
+class CopyTraversal
+{
+
+	public :
+
+		CopyTraversal( const SceneInterface *src, SceneInterface *dst )
+		{
+			CopyLocationPtr root( new CopyLocation );
+			root->src = src;
+			root->dst = dst;
+			m_stack.push_back( root );
+		}
+
+		CopyLocationPtr next()
+		{
+			if( m_stack.empty() )
+			{
+				return CopyLocationPtr();
+			}
+
+			CopyLocationPtr location = m_stack.back();
+			m_stack.pop_back();
+
+			// push the children in reverse, so that they
+			// are popped in their natural order.
+			SceneInterface::NameList childNames;
+			location->src->childNames( childNames );
+			for( SceneInterface::NameList::const_reverse_iterator it = childNames.rbegin(); it != childNames.rend(); ++it )
+			{
+				CopyLocationPtr child( new CopyLocation );
+				child->src = location->src->child( *it );
+				child->parent = location;
+				child->name = *it;
+				m_stack.push_back( child );
+			}
+
+			return location;
+		}
+
+	private :
+
+		std::vector<CopyLocationPtr> m_stack;
+
+};
+
+// Copies a single frame, reading locations in parallel and writing
+// them in the order of a serial depth first traversal.
+void copyFrame( const SceneInterface *src, SceneInterface *dst, double time, unsigned int flags )
+{
+	CopyTraversal traversal( src, dst );
+
+	// limit the number of locations in flight, so that memory
+	// usage is bounded if the writer can't keep up.
+	const size_t maxLocations = 4 * tbb::task_scheduler_init::default_num_threads();
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_pipeline(
+		maxLocations,
+		tbb::make_filter<void, CopyLocationPtr>(
+			tbb::filter::serial_in_order,
+			[&traversal]( tbb::flow_control &flowControl ) -> CopyLocationPtr {
+				CopyLocationPtr location = traversal.next();
+				if( !location )
+				{
+					flowControl.stop();
+				}
+				return location;
+			}
+		) &
+		tbb::make_filter<CopyLocationPtr, CopyLocationPtr>(
+			tbb::filter::parallel,
+			[time, flags]( CopyLocationPtr location ) -> CopyLocationPtr {
+				readLocation( location->src.get(), time, flags, &location->data );
+				return location;
+			}
+		) &
+		tbb::make_filter<CopyLocationPtr, void>(
+			tbb::filter::serial_in_order,
+			[time, flags]( CopyLocationPtr location ) {
+				const bool isRoot = !location->parent;
+				if( !location->dst )
+				{
+					location->dst = location->parent->dst->child( location->name, SceneInterface::CreateIfMissing );
+					location->parent.reset();
+				}
+				writeLocation( location->data, location->dst.get(), time, flags, isRoot );
+				// release the data now, rather than when the last
+				// child of this location has been written.
+				location->data = LocationData();
+			}
+		),
+		taskGroupContext
+	);
+}
+
+// Cache of SceneBVHs. We key on the hash, but need the scene
+// itself to build the hierarchy, so pass both via a GetterKey.
+struct SceneBVHCacheGetterKey
+{
+
+	SceneBVHCacheGetterKey( const SceneInterface *scene, double time )
+		:	scene( scene ), time( time )
+	{
+		scene->hash( SceneInterface::HierarchyHash, time, hash );
+		hash.append( scene->fileName() );
+		SceneInterface::Path path;
+		scene->path( path );
+		hash.append( path.data(), path.size() );
+		hash.append( time );
+	}
+
+	operator const MurmurHash & () const
+	{
+		return hash;
+	}
+
+	const SceneInterface *scene;
+	double time;
+	MurmurHash hash;
+
+};
+
+ConstSceneBVHPtr sceneBVHGetter( const SceneBVHCacheGetterKey &key, size_t &cost )
+{
+	// The cache holds a lock on this key while we build the hierarchy in
+	// parallel. Isolation stops a waiting worker from stealing an outer task
+	// which requests the same key, and deadlocking on that lock.
+	ConstSceneBVHPtr result;
+	tbb::this_task_arena::isolate(
+		[&result, &key] {
+			result = new SceneBVH( key.scene, key.time );
+		}
+	);
+	cost = result->memoryUsage();
+	return result;
+}
+
+typedef IECore::LRUCache<MurmurHash, ConstSceneBVHPtr, LRUCachePolicy::Parallel, SceneBVHCacheGetterKey> SceneBVHCache;
+
+SceneBVHCache &sceneBVHCache()
+{
+	static SceneBVHCache *cache = new SceneBVHCache( sceneBVHGetter, 500 * 1024 * 1024 );
+	return *cache;
+}
+
+const char *phaseName( SceneAlgo::ProcessFlags phase )
+{
+	switch( phase )
+	{
+		case SceneAlgo::Bounds :
+			return "bounds";
+		case SceneAlgo::Transforms :
+			return "transforms";
+		case SceneAlgo::Attributes :
+			return "attributes";
+		case SceneAlgo::Tags :
+			return "tags";
+		case SceneAlgo::Sets :
+			return "sets";
+		case SceneAlgo::Objects :
+			return "objects";
+		default :
+			return "location";
+	}
+}
+
+void writeJSONString( std::ostream &stream, const std::string &s )
+{
+	stream << '"';
+	for( const char c : s )
+	{
+		switch( c )
+		{
+			case '"' :
+				stream << "\\\"";
+				break;
+			case '\\' :
+				stream << "\\\\";
+				break;
+			default :
+				if( static_cast<unsigned char>( c ) < 0x20 )
+				{
+					stream << boost::format( "\\u%04x" ) % static_cast<int>( c );
+				}
+				else
+				{
+					stream << c;
+				}
+		}
+	}
+	stream << '"';
 }
 
 } // namespace
@@ -240,15 +583,94 @@ namespace IECoreScene
 namespace SceneAlgo
 {
 
-SceneStats parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, float frameRate, unsigned int flags )
+ReadProfile::ReadProfile()
+	:	m_startTime( std::chrono::steady_clock::now() )
+{
+}
+
+ReadProfile::~ReadProfile()
+{
+}
+
+std::vector<ReadProfile::Event> ReadProfile::events() const
+{
+	std::vector<Event> result( m_events.begin(), m_events.end() );
+	std::sort(
+		result.begin(), result.end(),
+		[]( const Event &a, const Event &b ) {
+			return a.start < b.start;
+		}
+	);
+	return result;
+}
+
+void ReadProfile::writeTrace( std::ostream &stream ) const
+{
+	// Map threads to small indices, so they're
+	// easier to identify in trace viewers.
+	std::map<size_t, size_t> threadIndices;
+
+	stream << "{\"traceEvents\":[";
+	bool first = true;
+	for( const auto &event : events() )
+	{
+		const size_t threadIndex = threadIndices.insert( std::make_pair( event.thread, threadIndices.size() ) ).first->second;
+
+		std::string path;
+		SceneInterface::pathToString( event.path, path );
+
+		stream << ( first ? "\n" : ",\n" );
+		first = false;
+
+		stream << "{\"name\":";
+		writeJSONString( stream, event.phase == None ? path : phaseName( event.phase ) );
+		stream << ",\"cat\":\"" << ( event.phase == None ? "location" : "phase" ) << "\"";
+		stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadIndex;
+		// Trace timestamps are in microseconds.
+		stream << boost::format( ",\"ts\":%.3f,\"dur\":%.3f" ) % ( event.start * 1e6 ) % ( event.duration * 1e6 );
+		stream << ",\"args\":{\"path\":";
+		writeJSONString( stream, path );
+		stream << ",\"time\":" << event.time;
+		stream << ",\"bytesRead\":" << event.bytesRead;
+		stream << ",\"bytesDecompressed\":" << event.bytesDecompressed;
+		stream << ",\"decompressionTime\":" << event.decompressionTime;
+		stream << ",\"cacheHits\":" << event.cacheHits;
+		stream << ",\"cacheMisses\":" << event.cacheMisses;
+		stream << "}}";
+	}
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void ReadProfile::writeTrace( const std::string &fileName ) const
+{
+	std::ofstream stream( fileName.c_str() );
+	if( !stream.is_open() )
+	{
+		throw IOException( "ReadProfile::writeTrace : Unable to open file \"" + fileName + "\"" );
+	}
+	writeTrace( stream );
+}
+
+double ReadProfile::elapsed() const
+{
+	return std::chrono::duration<double>( std::chrono::steady_clock::now() - m_startTime ).count();
+}
+
+void ReadProfile::addEvent( const Event &event )
+{
+	m_events.push_back( event );
+}
+
+SceneStats parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, float frameRate, unsigned int flags, ReadProfile *profile, const Canceller *canceller )
 {
 	std::atomic<size_t> locationCount( 0 );
 	::CopyInfo<std::atomic<size_t> > copyInfos;
 
-	auto locationFn = [&locationCount, &copyInfos]( const SceneInterface *src, SceneInterface *dst, double time, unsigned int flags )
+	auto locationFn = [&locationCount, &copyInfos, profile, canceller]( const SceneInterface *src, SceneInterface *dst, double time, unsigned int flags )
 	{
+		Canceller::check( canceller );
 		locationCount++;
-		::CopyInfo<size_t> copyInfo = ::handleLocation( src, nullptr, time, flags );
+		::CopyInfo<size_t> copyInfo = ::readLocation( src, time, flags, nullptr, profile );
 
 		copyInfos.polygonCount += copyInfo.polygonCount;
 		copyInfos.tagCount += copyInfo.tagCount;
@@ -276,6 +698,74 @@ SceneStats parallelReadAll( const SceneInterface *src, int startFrame, int endFr
 	return stats;
 }
 
+InstancedObjects instancedObjects( const SceneInterface *src, double time )
+{
+	typedef tbb::concurrent_hash_map<MurmurHash, InstancedObject> InstanceMap;
+	InstanceMap instances;
+
+	SceneInterface::Path rootPath;
+	src->path( rootPath );
+
+	auto locationFn = [&instances, &rootPath]( const SceneInterface *src, SceneInterface *dst, double time, unsigned int flags )
+	{
+		if( !src->hasObject() )
+		{
+			return;
+		}
+
+		SceneInterface::Path path;
+		src->path( path );
+		path.erase( path.begin(), path.begin() + rootPath.size() );
+
+		const MurmurHash key = src->objectKey( time );
+
+		bool inserted;
+		{
+			InstanceMap::accessor accessor;
+			inserted = instances.insert( accessor, key );
+			accessor->second.paths.addPath( path );
+		}
+
+		// Only the first location with a given key reads the object. We
+		// don't hold the accessor while reading, because the read may
+		// spawn TBB tasks of its own, and this thread could then steal
+		// another location's task and block on the same accessor.
+		if( inserted )
+		{
+			ConstObjectPtr object = src->readObject( time );
+			InstanceMap::accessor accessor;
+			instances.find( accessor, key );
+			accessor->second.object = object;
+		}
+	};
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	Task<decltype( locationFn )> *task = new( tbb::task::allocate_root( taskGroupContext ) ) Task<decltype( locationFn )>( src, nullptr, locationFn, time, None );
+	tbb::task::spawn_root_and_wait( *task );
+
+	return InstancedObjects( instances.begin(), instances.end() );
+}
+
+ConstSceneBVHPtr sceneBVH( const SceneInterface *src, double time )
+{
+	return sceneBVHCache().get( SceneBVHCacheGetterKey( src, time ) );
+}
+
+void setSceneBVHCacheMemoryLimit( size_t bytes )
+{
+	sceneBVHCache().setMaxCost( bytes );
+}
+
+size_t getSceneBVHCacheMemoryLimit()
+{
+	return sceneBVHCache().getMaxCost();
+}
+
+void clearSceneBVHCache()
+{
+	sceneBVHCache().clear();
+}
+
 void copy( const SceneInterface *src, SceneInterface *dst, int startFrame, int endFrame, float frameRate, unsigned int flags )
 {
 	for( int f = startFrame; f <= endFrame; ++f )
@@ -287,7 +777,7 @@ void copy( const SceneInterface *src, SceneInterface *dst, int startFrame, int e
 			flags &= ~Tags;
 		}
 
-		::copy( src, dst, time, flags, ::handleLocation );
+		::copyFrame( src, dst, time, flags );
 	}
 }
 
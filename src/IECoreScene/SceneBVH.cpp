@@ -0,0 +1,429 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "IECoreScene/SceneBVH.h"
+
+#include "IECore/Exception.h"
+
+#include "OpenEXR/ImathBoxAlgo.h"
+#include "OpenEXR/ImathPlane.h"
+
+#include "tbb/concurrent_vector.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_invoke.h"
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScene;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Below this number of leaves, the two halves of a node are built serially.
+const size_t g_parallelBuildThreshold = 1024;
+
+// The tree is balanced, so this allows for far more leaves than could
+// ever fit in memory.
+const size_t g_maxStackSize = 128;
+
+struct BoxPredicate
+{
+
+	BoxPredicate( const Box3d &box )
+		:	m_box( box )
+	{
+	}
+
+	bool operator()( const Box3d &bound ) const
+	{
+		return bound.intersects( m_box );
+	}
+
+	private :
+
+		Box3d m_box;
+
+};
+
+struct FrustumPredicate
+{
+
+	FrustumPredicate( const Frustumd &frustum, const M44d &cameraToWorld )
+	{
+		frustum.planes( m_planes, cameraToWorld );
+	}
+
+	bool operator()( const Box3d &bound ) const
+	{
+		// The plane normals point out of the frustum, so the bound
+		// is outside if its nearest corner is in front of any plane.
+		for( const auto &plane : m_planes )
+		{
+			V3d p;
+			for( int i = 0; i < 3; ++i )
+			{
+				p[i] = plane.normal[i] > 0 ? bound.min[i] : bound.max[i];
+			}
+			if( plane.distanceTo( p ) > 0 )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	private :
+
+		Plane3d m_planes[6];
+
+};
+
+struct RayPredicate
+{
+
+	RayPredicate( const Line3d &ray )
+		:	m_origin( ray.pos ), m_direction( ray.dir )
+	{
+	}
+
+	bool operator()( const Box3d &bound ) const
+	{
+		double tMin = 0;
+		double tMax = std::numeric_limits<double>::infinity();
+		for( int i = 0; i < 3; ++i )
+		{
+			if( m_direction[i] == 0 )
+			{
+				if( m_origin[i] < bound.min[i] || m_origin[i] > bound.max[i] )
+				{
+					return false;
+				}
+				continue;
+			}
+
+			double t0 = ( bound.min[i] - m_origin[i] ) / m_direction[i];
+			double t1 = ( bound.max[i] - m_origin[i] ) / m_direction[i];
+			if( t0 > t1 )
+			{
+				std::swap( t0, t1 );
+			}
+
+			tMin = std::max( tMin, t0 );
+			tMax = std::min( tMax, t1 );
+			if( tMin > tMax )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	private :
+
+		V3d m_origin;
+		V3d m_direction;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Leaf collection
+//////////////////////////////////////////////////////////////////////////
+
+struct SceneBVH::Leaf
+{
+	Box3d bound;
+	V3d center;
+	SceneInterface::Path path;
+};
+
+namespace
+{
+
+template<typename Leaf>
+void collectLeaves( const SceneInterface *scene, const SceneInterface::Path &path, const M44d &parentToWorld, double time, tbb::concurrent_vector<Leaf> &leaves )
+{
+	const M44d toWorld = path.empty() ? parentToWorld : scene->readTransformAsMatrix( time ) * parentToWorld;
+
+	SceneInterface::NameList childNames;
+	scene->childNames( childNames );
+
+	if( childNames.empty() || scene->hasObject() )
+	{
+		const Box3d bound = scene->readBound( time );
+		if( !bound.isEmpty() )
+		{
+			Leaf leaf;
+			leaf.bound = Imath::transform( bound, toWorld );
+			leaf.center = leaf.bound.center();
+			leaf.path = path;
+			leaves.push_back( leaf );
+		}
+	}
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, childNames.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			SceneInterface::Path childPath( path );
+			childPath.push_back( SceneInterface::Name() );
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				childPath.back() = childNames[i];
+				ConstSceneInterfacePtr child = scene->child( childNames[i] );
+				collectLeaves( child.get(), childPath, toWorld, time, leaves );
+			}
+		},
+		taskGroupContext
+	);
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// SceneBVH
+//////////////////////////////////////////////////////////////////////////
+
+SceneBVH::SceneBVH( const SceneInterface *scene, double time )
+{
+	tbb::concurrent_vector<Leaf> collectedLeaves;
+	collectLeaves( scene, SceneInterface::Path(), M44d(), time, collectedLeaves );
+
+	if( collectedLeaves.empty() )
+	{
+		return;
+	}
+
+	std::vector<Leaf> leaves( collectedLeaves.begin(), collectedLeaves.end() );
+	collectedLeaves.clear();
+
+	// A binary tree with one leaf per node always has
+	// this many nodes, so we can build it in place.
+	m_nodes.resize( 2 * leaves.size() - 1 );
+	build( leaves, 0, leaves.size(), 0 );
+
+	m_paths.reserve( leaves.size() );
+	for( auto &leaf : leaves )
+	{
+		m_paths.push_back( std::move( leaf.path ) );
+	}
+}
+
+SceneBVH::~SceneBVH()
+{
+}
+
+void SceneBVH::build( std::vector<Leaf> &leaves, size_t begin, size_t end, size_t nodeIndex )
+{
+	Node &node = m_nodes[nodeIndex];
+	if( end - begin == 1 )
+	{
+		node.bound = leaves[begin].bound;
+		node.index = begin;
+		node.leaf = true;
+		return;
+	}
+
+	Box3d centers;
+	for( size_t i = begin; i < end; ++i )
+	{
+		centers.extendBy( leaves[i].center );
+	}
+	const int axis = centers.majorAxis();
+
+	// Splitting at the median keeps the tree balanced, and means
+	// that the first child's subtree has exactly `2 * ( mid - begin ) - 1`
+	// nodes, so we know where to put the second child before building
+	// the first.
+	const size_t mid = begin + ( end - begin ) / 2;
+	std::nth_element(
+		leaves.begin() + begin, leaves.begin() + mid, leaves.begin() + end,
+		[axis]( const Leaf &a, const Leaf &b ) {
+			return a.center[axis] < b.center[axis];
+		}
+	);
+
+	const size_t secondChild = nodeIndex + 2 * ( mid - begin );
+	if( end - begin > g_parallelBuildThreshold )
+	{
+		tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+		tbb::parallel_invoke(
+			[this, &leaves, begin, mid, nodeIndex] { build( leaves, begin, mid, nodeIndex + 1 ); },
+			[this, &leaves, mid, end, secondChild] { build( leaves, mid, end, secondChild ); },
+			taskGroupContext
+		);
+	}
+	else
+	{
+		build( leaves, begin, mid, nodeIndex + 1 );
+		build( leaves, mid, end, secondChild );
+	}
+
+	node.bound = m_nodes[nodeIndex + 1].bound;
+	node.bound.extendBy( m_nodes[secondChild].bound );
+	node.index = secondChild;
+	node.leaf = false;
+}
+
+const Box3d &SceneBVH::bound() const
+{
+	static const Box3d g_emptyBound;
+	return m_nodes.empty() ? g_emptyBound : m_nodes.front().bound;
+}
+
+size_t SceneBVH::numLeaves() const
+{
+	return m_paths.size();
+}
+
+size_t SceneBVH::memoryUsage() const
+{
+	size_t result = sizeof( SceneBVH ) + m_nodes.capacity() * sizeof( Node ) + m_paths.capacity() * sizeof( SceneInterface::Path );
+	for( const auto &path : m_paths )
+	{
+		result += path.capacity() * sizeof( SceneInterface::Name );
+	}
+	return result;
+}
+
+IECore::PathMatcher SceneBVH::intersectingPaths( const Box3d &box ) const
+{
+	PathMatcher result;
+	query( BoxPredicate( box ), result );
+	return result;
+}
+
+IECore::PathMatcher SceneBVH::intersectingPaths( const Frustumd &frustum, const M44d &cameraToWorld ) const
+{
+	PathMatcher result;
+	query( FrustumPredicate( frustum, cameraToWorld ), result );
+	return result;
+}
+
+IECore::PathMatcher SceneBVH::intersectingPaths( const Line3d &ray ) const
+{
+	PathMatcher result;
+	query( RayPredicate( ray ), result );
+	return result;
+}
+
+std::vector<IECore::PathMatcher> SceneBVH::intersectingPaths( const std::vector<Box3d> &boxes ) const
+{
+	return bulkQuery( std::vector<BoxPredicate>( boxes.begin(), boxes.end() ) );
+}
+
+std::vector<IECore::PathMatcher> SceneBVH::intersectingPaths( const std::vector<Frustumd> &frustums, const std::vector<M44d> &cameraToWorld ) const
+{
+	if( frustums.size() != cameraToWorld.size() )
+	{
+		throw InvalidArgumentException( "SceneBVH::intersectingPaths : Number of frustums and transforms do not match" );
+	}
+
+	std::vector<FrustumPredicate> predicates;
+	predicates.reserve( frustums.size() );
+	for( size_t i = 0; i < frustums.size(); ++i )
+	{
+		predicates.push_back( FrustumPredicate( frustums[i], cameraToWorld[i] ) );
+	}
+	return bulkQuery( predicates );
+}
+
+std::vector<IECore::PathMatcher> SceneBVH::intersectingPaths( const std::vector<Line3d> &rays ) const
+{
+	return bulkQuery( std::vector<RayPredicate>( rays.begin(), rays.end() ) );
+}
+
+template<typename Predicate>
+void SceneBVH::query( const Predicate &predicate, IECore::PathMatcher &result ) const
+{
+	if( m_nodes.empty() )
+	{
+		return;
+	}
+
+	size_t stack[g_maxStackSize];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while( stackSize )
+	{
+		const size_t nodeIndex = stack[--stackSize];
+		const Node &node = m_nodes[nodeIndex];
+		if( !predicate( node.bound ) )
+		{
+			continue;
+		}
+
+		if( node.leaf )
+		{
+			result.addPath( m_paths[node.index] );
+		}
+		else
+		{
+			stack[stackSize++] = node.index;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+}
+
+template<typename Predicate>
+std::vector<IECore::PathMatcher> SceneBVH::bulkQuery( const std::vector<Predicate> &predicates ) const
+{
+	std::vector<PathMatcher> result( predicates.size() );
+
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, predicates.size() ),
+		[this, &predicates, &result]( const tbb::blocked_range<size_t> &range )
+		{
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				query( predicates[i], result[i] );
+			}
+		},
+		taskGroupContext
+	);
+
+	return result;
+}
@@ -34,8 +34,6 @@
 
 #include "IECoreScene/SceneCache.h"
 
-#include "TagSetAlgo.h"
-
 #include "IECoreScene/Primitive.h"
 #include "IECoreScene/ShaderNetworkAlgo.h"
 #include "IECoreScene/SharedSceneInterfaces.h"
@@ -55,6 +53,9 @@
 #include "boost/tuple/tuple.hpp"
 
 #include "tbb/concurrent_hash_map.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task.h"
 
 using namespace IECore;
 using namespace IECoreScene;
@@ -82,12 +83,32 @@ static InternedString objectEntry("object");
 static InternedString attributesEntry("attributes");
 static InternedString childrenEntry("children");
 static InternedString sampleTimesEntry("sampleTimes");
+static InternedString hashesEntry("hashes");
 static InternedString tagsEntry("tags");
 static InternedString localTagsEntry("localTags");
 static InternedString ancestorTagsEntry("ancestorTags");
 static InternedString descendentTagsEntry("descendentTags");
 static InternedString setsEntry("sets");
 static InternedString childSetsEntry("childSets");
+static InternedString setIndexEntry("setIndex");
+static InternedString setIndexTagsEntry("tags");
+static InternedString setIndexSetsEntry("sets");
+static InternedString setIndexSetLocationsEntry("setLocations");
+
+// Counts the cache lookups made by each thread. Hits are derived
+// by subtracting the misses, which are counted by the functions
+// that load data for the caches.
+struct CacheCounts
+{
+	CacheCounts() : lookups( 0 ), misses( 0 )
+	{
+	}
+
+	size_t lookups;
+	size_t misses;
+};
+
+static tbb::enumerable_thread_specific<CacheCounts> g_cacheCounts;
 
 const SceneInterface::Name &SceneCache::animatedObjectTopologyAttribute = InternedString( "sceneInterface:animatedObjectTopology" );
 const SceneInterface::Name &SceneCache::animatedObjectPrimVarsAttribute = InternedString( "sceneInterface:animatedObjectPrimVars" );
@@ -676,6 +697,10 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 			h.append( (unsigned char)hashType );
 
+			// Files written with content hashes let us hash the data itself, in
+			// which case the result doesn't depend on the file or the location.
+			bool contentHashed = false;
+
 			// all kinds of hashes, except the child names depend on time.
 			switch( hashType )
 			{
@@ -684,7 +709,11 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 					if ( m_indexedIO->hasEntry( transformEntry ) )
 					{
 						x = transformSampleInterval( time, s0, s1 );
-						h.append( lerp( (double)s0, (double)s1, x ) );
+						contentHashed = appendContentHash( contentHashes( transformEntry ), s0, s1, x, h );
+						if ( !contentHashed )
+						{
+							h.append( lerp( (double)s0, (double)s1, x ) );
+						}
 					}
 					else
 					{
@@ -702,6 +731,21 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 							// return a simple hash for no attributes (which does not include the scene location).
 							return;
 						}
+						MurmurHash contentHash;
+						contentHashed = true;
+						for ( NameList::const_iterator aIt = attrs.begin(); aIt != attrs.end() && contentHashed; aIt++ )
+						{
+							x = attributeSampleInterval( *aIt, time, s0, s1 );
+							contentHash.append( *aIt );
+							contentHashed = appendContentHash( contentHashes( attributesEntry, *aIt ), s0, s1, x, contentHash );
+						}
+
+						if ( contentHashed )
+						{
+							h.append( contentHash );
+							break;
+						}
+
 						for ( NameList::const_iterator aIt = attrs.begin(); aIt != attrs.end(); aIt++ )
 						{
 							x = attributeSampleInterval( *aIt, time, s0, s1 );
@@ -713,7 +757,11 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				case BoundHash:
 
 					x = boundSampleInterval( time, s0, s1 );
-					h.append( lerp( (double)s0, (double)s1, x ) );
+					contentHashed = appendContentHash( contentHashes( boundEntry ), s0, s1, x, h );
+					if ( !contentHashed )
+					{
+						h.append( lerp( (double)s0, (double)s1, x ) );
+					}
 					break;
 
 				case ObjectHash:
@@ -721,7 +769,11 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 					if ( m_indexedIO->hasEntry( objectEntry ) )
 					{
 						x = objectSampleInterval( time, s0, s1 );
-						h.append( lerp( (double)s0, (double)s1, x ) );
+						contentHashed = appendContentHash( contentHashes( objectEntry ), s0, s1, x, h );
+						if ( !contentHashed )
+						{
+							h.append( lerp( (double)s0, (double)s1, x ) );
+						}
 					}
 					else
 					{
@@ -753,13 +805,48 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 					}
 					break;
 			}
-			if ( !ignoreSceneHash )
+			if ( !ignoreSceneHash && !contentHashed )
 			{
 				// Because the hash computed so far is not based on the contents of the file, we have to add to the hash something that identifies the file and the location in the hierarchy.
 				sceneHash( h );
 			}
 		}
 
+		// Computes the object key from the content hashes stored by the writer,
+		// returning false for files written without them. When a single sample
+		// is read, the key matches the hash of the object itself.
+		bool objectKey( double time, MurmurHash &h ) const
+		{
+			if ( !m_indexedIO->hasEntry( objectEntry ) )
+			{
+				return true;
+			}
+
+			size_t s0, s1;
+			const double x = objectSampleInterval( time, s0, s1 );
+			const ContentHashes &hashes = contentHashes( objectEntry );
+			if ( hashes.size() <= std::max( s0, s1 ) )
+			{
+				return false;
+			}
+
+			if ( x == 0 || s0 == s1 )
+			{
+				h = hashes[s0];
+			}
+			else if ( x == 1 )
+			{
+				h = hashes[s1];
+			}
+			else
+			{
+				h.append( hashes[s0] );
+				h.append( hashes[s1] );
+				h.append( x );
+			}
+			return true;
+		}
+
 		static ReaderImplementation *reader( Implementation *impl, bool throwException = true )
 		{
 			ReaderImplementation *reader = dynamic_cast< ReaderImplementation* >( impl );
@@ -770,45 +857,49 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return reader;
 		}
 
-		PathMatcher readSet( const Name &name, bool includeDescendantSets) const
+		/// Returns the members of the set, including locations tagged with
+		/// the set name.
+		PathMatcher readSet( const Name &name, bool includeDescendantSets ) const
 		{
-			SceneInterface::Path prefix;
-			PathMatcher pathMatcher;
-			recurseReadSet( prefix, name, pathMatcher, includeDescendantSets );
+			ConstIndexedIOPtr setIndexIO = root()->m_indexedIO->subdirectory( setIndexEntry, IndexedIO::NullIfMissing );
+			if( !setIndexIO )
+			{
+				// Files written before the set index was introduced.
+				PathMatcher result;
+				readSetWalk( name, /* includeLocalSet = */ true, includeDescendantSets, result );
+				return result;
+			}
 
-			return pathMatcher;
-		}
+			SceneInterface::Path p;
+			path( p );
 
-		void recurseReadSet( const SceneInterface::Path &prefix, const Name &name, IECore::PathMatcher &pathMatcher, bool includeDescendantSets ) const
-		{
-			if( PathMatcherDataPtr pathMatcherData = readLocalSet( name ) )
+			PathMatcher result = readIndexedSet( setIndexIO.get(), setIndexTagsEntry, name ).subTree( p );
+			if( !includeDescendantSets )
 			{
-				pathMatcher.addPaths( pathMatcherData->readable(), prefix );
+				result.addPaths( readLocalSet( name )->readable() );
+				return result;
 			}
 
-			if ( !includeDescendantSets )
+			if( p.empty() )
 			{
-				return;
+				result.addPaths( readIndexedSet( setIndexIO.get(), setIndexSetsEntry, name ) );
+				return result;
 			}
 
-			NameList children;
-			childNames( children );
-
-			SceneInterface::Path childPrefix = prefix;
-			childPrefix.resize( prefix.size() + 1 );
-
-			NameList childSets = readChildSets();
-
-			// todo need to replace this linear scan with something with faster query performance
-			if( std::find( childSets.begin(), childSets.end(), name ) != childSets.end() )
+			// The index of set members includes sets written at our ancestors,
+			// which must be excluded. So instead we use the index of set locations
+			// to load just the sets written here and below.
+			const PathMatcher setLocations = readIndexedSet( setIndexIO.get(), setIndexSetLocationsEntry, name ).subTree( p );
+			for( PathMatcher::Iterator it = setLocations.begin(), eIt = setLocations.end(); it != eIt; ++it )
 			{
-				for( InternedString &childName : children )
+				ConstReaderImplementationPtr location = this;
+				for( const auto &childName : *it )
 				{
-					*childPrefix.rbegin() = childName;
-					child( childName, SceneInterface::ThrowIfMissing )->recurseReadSet( childPrefix, name, pathMatcher, includeDescendantSets );
+					location = location->child( childName, SceneInterface::ThrowIfMissing );
 				}
+				result.addPaths( location->readLocalSet( name )->readable(), *it );
 			}
-
+			return result;
 		}
 
 		NameList setNames( bool includeDescendantSets ) const
@@ -833,6 +924,81 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 
 	private :
 
+		const ReaderImplementation *root() const
+		{
+			const ReaderImplementation *result = this;
+			while( result->m_parent )
+			{
+				result = result->m_parent.get();
+			}
+			return result;
+		}
+
+		static PathMatcher readIndexedSet( const IndexedIO *setIndexIO, const IndexedIO::EntryID &entry, const Name &name )
+		{
+			ConstIndexedIOPtr io = setIndexIO->subdirectory( entry, IndexedIO::NullIfMissing );
+			if( io && io->hasEntry( name ) )
+			{
+				if( ConstPathMatcherDataPtr data = runTimeCast<const PathMatcherData>( Object::load( io, name ) ) )
+				{
+					return data->readable();
+				}
+			}
+			return PathMatcher();
+		}
+
+		bool hasChildSet( const Name &name ) const
+		{
+			ConstIndexedIOPtr childSetsIO = m_indexedIO->subdirectory( childSetsEntry, IndexedIO::NullIfMissing );
+			return childSetsIO && childSetsIO->hasEntry( name );
+		}
+
+		// Computes the set by visiting all locations with relevant tags or
+		// child sets, recursing to children in parallel. Used for files
+		// without a set index.
+		void readSetWalk( const Name &name, bool includeLocalSet, bool includeDescendantSets, PathMatcher &result ) const
+		{
+			if( hasTag( name, SceneInterface::LocalTag ) )
+			{
+				result.addPath( SceneInterface::Path() );
+			}
+
+			if( includeLocalSet )
+			{
+				result.addPaths( readLocalSet( name )->readable() );
+			}
+
+			const bool recurseForTags = hasTag( name, SceneInterface::DescendantTag );
+			const bool recurseForSets = includeDescendantSets && hasChildSet( name );
+			if( !recurseForTags && !recurseForSets )
+			{
+				return;
+			}
+
+			NameList children;
+			childNames( children );
+			std::vector<PathMatcher> childResults( children.size() );
+
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, children.size() ),
+				[&]( const tbb::blocked_range<size_t> &range ) {
+					for( size_t i = range.begin(); i != range.end(); ++i )
+					{
+						child( children[i], SceneInterface::ThrowIfMissing )->readSetWalk( name, recurseForSets, recurseForSets, childResults[i] );
+					}
+				},
+				taskGroupContext
+			);
+
+			SceneInterface::Path prefix( 1 );
+			for( size_t i = 0; i < children.size(); ++i )
+			{
+				prefix[0] = children[i];
+				result.addPaths( childResults[i], prefix );
+			}
+		}
+
 		/// read a set set explicitly defined at this location
 		PathMatcherDataPtr readLocalSet( const Name &name ) const
 		{
@@ -855,6 +1021,10 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		typedef tbb::concurrent_hash_map< uint64_t, SampleTimes > SampleTimesMap;
 		typedef std::map< IndexedIO::EntryID, const SampleTimes* > AttributeSamplesMap;
 		typedef tbb::spin_rw_mutex AttributeMapMutex;
+		typedef std::vector<MurmurHash> ContentHashes;
+		typedef std::pair< IndexedIO::EntryID, IndexedIO::EntryID > ContentHashesKey;
+		typedef std::map< ContentHashesKey, ContentHashes > ContentHashesMap;
+		typedef tbb::spin_rw_mutex ContentHashesMutex;
 
 		typedef std::pair< const ReaderImplementation *, size_t > SimpleCacheKey;
 		typedef tuple< const ReaderImplementation *, const SceneCache::Name &, size_t > AttributeCacheKey;
@@ -877,12 +1047,14 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				/// utility function used by the ReaderImplementation to use the LRUCache for transform reading
 				IECore::ConstDataPtr readTransformAtSample( const ReaderImplementation *reader, size_t sample )
 				{
+					g_cacheCounts.local().lookups++;
 					return runTimeCast< const Data >( transformCache->get( SimpleCacheKey(reader, sample) ) );
 				}
 
 				/// utility function used by the ReaderImplementation to use the LRUCache for object reading
 				IECore::ConstObjectPtr readObjectAtSample( const ReaderImplementation *reader, size_t sample )
 				{
+					g_cacheCounts.local().lookups++;
 					const size_t defaultSample = -1;
 					SimpleCacheKey currentKey( reader, sample );
 
@@ -906,6 +1078,8 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 									if ( prim )
 									{
 										// we managed to load the object from a different time sample from the cache, just have to load the changing prim vars...
+										// This still reads from the file, so counts as a miss.
+										g_cacheCounts.local().misses++;
 										mergeMaps( prim->variables, readObjectPrimitiveVariablesAtSample( reader->m_indexedIO, varNames->readable(), sample ) );
 										objectCache->set( currentKey, prim.get(), ObjectPool::StoreReference );
 										return prim;
@@ -927,6 +1101,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 				/// utility function used by the ReaderImplementation to use the LRUCache for attribute reading
 				IECore::ConstObjectPtr readAttributeAtSample( const ReaderImplementation *reader, const SceneCache::Name &name, size_t sample )
 				{
+					g_cacheCounts.local().lookups++;
 					return attributeCache->get( AttributeCacheKey(reader,name,sample) );
 				}
 
@@ -976,6 +1151,10 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		mutable AttributeMapMutex m_attributeMutex;
 		mutable const SampleTimes *m_objectSampleTimes;
 
+		/// Content hashes decoded from the file, keyed by data entry and attribute name.
+		mutable ContentHashesMap m_contentHashes;
+		mutable ContentHashesMutex m_contentHashesMutex;
+
 		IndexedIOPtr globalSampleTimes() const
 		{
 			if ( m_parent )
@@ -1047,6 +1226,84 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 			return &(it->second);
 		}
 
+		// Returns the content hashes stored by the writer for the data in childName,
+		// or for the attribute attribName within it. They are read from the file on
+		// first use, and are empty for files written without them.
+		const ContentHashes &contentHashes( const IndexedIO::EntryID &childName, const IndexedIO::EntryID &attribName = IndexedIO::EntryID() ) const
+		{
+			const ContentHashesKey key( childName, attribName );
+			ContentHashesMutex::scoped_lock lock( m_contentHashesMutex, false );
+			ContentHashesMap::const_iterator cit = m_contentHashes.find( key );
+			if ( cit != m_contentHashes.end() )
+			{
+				return cit->second;
+			}
+
+			lock.upgrade_to_writer();
+
+			std::pair< ContentHashesMap::iterator, bool > it = m_contentHashes.insert( ContentHashesMap::value_type( key, ContentHashes() ) );
+			if ( it.second )
+			{
+				try
+				{
+					ConstIndexedIOPtr io = m_indexedIO->subdirectory( childName, IndexedIO::NullIfMissing );
+					if ( io && !attribName.value().empty() )
+					{
+						io = io->subdirectory( attribName, IndexedIO::NullIfMissing );
+					}
+					if ( io )
+					{
+						readContentHashes( io.get(), it.first->second );
+					}
+				}
+				catch ( ... )
+				{
+					m_contentHashes.erase( it.first );
+					throw;
+				}
+			}
+			return it.first->second;
+		}
+
+		// Decodes the content hashes stored by the writer for the data in io,
+		// leaving hashes empty for files written without them.
+		static void readContentHashes( const IndexedIO *io, ContentHashes &hashes )
+		{
+			if ( !io->hasEntry( hashesEntry ) )
+			{
+				return;
+			}
+
+			const unsigned long length = io->entry( hashesEntry ).arrayLength();
+			std::vector<uint64_t> values( length );
+			uint64_t *valuesPtr = values.data();
+			io->read( hashesEntry, valuesPtr, length );
+
+			hashes.reserve( length / 2 );
+			for ( size_t i = 0; i + 1 < length; i += 2 )
+			{
+				hashes.push_back( MurmurHash( values[i], values[i+1] ) );
+			}
+		}
+
+		// Appends the content hashes for the samples s0 and s1, returning false
+		// for files written without them or with too few samples.
+		static bool appendContentHash( const ContentHashes &hashes, size_t s0, size_t s1, double x, MurmurHash &h )
+		{
+			if ( hashes.size() <= std::max( s0, s1 ) )
+			{
+				return false;
+			}
+
+			h.append( hashes[s0] );
+			if ( x > 0 && s1 != s0 )
+			{
+				h.append( hashes[s1] );
+				h.append( x );
+			}
+			return true;
+		}
+
 		void sceneHash( MurmurHash &h ) const
 		{
 			if( FileIndexedIO *fileIndexedIO = runTimeCast<FileIndexedIO>( m_indexedIO.get() ) )
@@ -1086,6 +1343,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		// static function used by the cache mechanism to actually load the object data from file.
 		static ObjectPtr doReadTransformAtSample( const SimpleCacheKey &key )
 		{
+			g_cacheCounts.local().misses++;
 			IndexedIOPtr io = key.first->m_indexedIO->subdirectory( transformEntry, IndexedIO::NullIfMissing );
 			if ( !io )
 			{
@@ -1104,6 +1362,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		// static function used by the cache mechanism to actually load the object data from file.
 		static ObjectPtr doReadObjectAtSample( const SimpleCacheKey &key )
 		{
+			g_cacheCounts.local().misses++;
 			return Object::load( key.first->m_indexedIO->subdirectory( objectEntry ), sampleEntry(key.second) );
 		}
 
@@ -1123,6 +1382,7 @@ class SceneCache::ReaderImplementation : public SceneCache::Implementation
 		// static function used by the cache mechanism to actually load the attribute data from file.
 		static ObjectPtr doReadAttributeAtSample( const AttributeCacheKey &key )
 		{
+			g_cacheCounts.local().misses++;
 			const SceneInterface::Name &name = get<1>( key );
 			ObjectPtr result = Object::load(
 				get<0>( key )->m_indexedIO->subdirectory( attributesEntry )->subdirectory( name ),
@@ -1199,7 +1459,8 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				try
 				{
-					flush();
+					SetIndex setIndex;
+					flush( setIndex );
 				}
 				catch ( Exception &e )
 				{
@@ -1295,9 +1556,10 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			IndexedIOPtr io = m_indexedIO->subdirectory( transformEntry, IndexedIO::CreateIfMissing );
 			((const Object *)transform)->save( io, sampleEntry(sampleIndex) );
 			m_transformSamples.push_back( transform );
+			m_transformHashes.push_back( transform->Object::hash() );
 		}
 
-		void writeAttribute( const SceneCache::Name &name, const Object *attribute, double time )
+		void writeAttribute( const SceneCache::Name &name, const Object *attribute, double time, const MurmurHash *hash = nullptr )
 		{
 			writable();
 
@@ -1326,6 +1588,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			IndexedIOPtr io = m_indexedIO->subdirectory( attributesEntry, IndexedIO::CreateIfMissing );
 			io = io->subdirectory( name, IndexedIO::CreateIfMissing );
 			attribute->save( io, sampleEntry(sampleIndex) );
+			m_attributeHashes[name].push_back( hash ? *hash : attribute->hash() );
 		}
 
 		void writeLocalTag( const char *tag )
@@ -1367,7 +1630,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			}
 		}
 
-		void writeObject( const Object *object, double time )
+		void writeObject( const Object *object, double time, const MurmurHash *hash = nullptr )
 		{
 			writable();
 
@@ -1397,6 +1660,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			m_objectSampleTimes.push_back( time );
 			IndexedIOPtr io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
 			object->save( io, sampleEntry(sampleIndex) );
+			m_objectHashes.push_back( hash ? *hash : object->hash() );
 
 			const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object );
 			if ( renderable )
@@ -1474,6 +1738,9 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 			IndexedIOPtr setsIO = m_indexedIO->subdirectory( setsEntry, IndexedIO::CreateIfMissing );
 			setData->Object::save( setsIO, name );
+
+			// Kept for inclusion in the set index at flush time.
+			m_sets[name] = set;
 		}
 
 		WriterImplementationPtr child( const Name &name, MissingBehaviour missingBehaviour )
@@ -1550,6 +1817,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		typedef std::vector< Imath::Box3d > BoxSamples;
 		typedef ConstDataPtr TransformSample;
 		typedef std::vector< TransformSample > TransformSamples;
+		typedef std::vector< MurmurHash > HashSamples;
 
 		IndexedIOPtr globalSampleTimes()
 		{
@@ -1597,6 +1865,20 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			location->createSubdirectory( sampleTimesEntry )->createSubdirectory( samplesEntry );
 		}
 
+		// Stores the content hashes of each sample alongside the samples themselves,
+		// so that readers can provide hashes which are stable across files and processes.
+		static void storeHashes( const HashSamples &hashes, IndexedIO *location )
+		{
+			std::vector<uint64_t> values;
+			values.reserve( hashes.size() * 2 );
+			for ( const auto &h : hashes )
+			{
+				values.push_back( h.h1() );
+				values.push_back( h.h2() );
+			}
+			location->write( hashesEntry, values.data(), values.size() );
+		}
+
 		// Helper function which interpolates the time varying bounding box described by sampleTimes and boxSamples at time t,
 		// then extends newSample by the resulting bounding box. "upper" should an iterator into sample times pointing to the
 		// first element greater than t.
@@ -1711,6 +1993,32 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 		}
 
+		// Set and tag membership for the whole file, accumulated
+		// during flush() and written at the root.
+		struct SetIndex
+		{
+			typedef std::map<Name, PathMatcher> Sets;
+			Sets tags;
+			Sets sets;
+			Sets setLocations;
+		};
+
+		void writeSetIndex( const SetIndex::Sets &sets, const IndexedIO::EntryID &entry )
+		{
+			if( sets.empty() )
+			{
+				return;
+			}
+
+			IndexedIOPtr io = m_indexedIO->subdirectory( setIndexEntry, IndexedIO::CreateIfMissing )->subdirectory( entry, IndexedIO::CreateIfMissing );
+			PathMatcherDataPtr data = new PathMatcherData;
+			for( const auto &set : sets )
+			{
+				data->writable() = set.second;
+				data->Object::save( io, set.first );
+			}
+		}
+
 		// Called from the destructor of the root location.
 		// It triggers flush recursivelly on all the child locations.
 		// It also sets m_sampleTimesMap to NULL which prevents further modification on this and all child scene interface objects through their call to writable().
@@ -1718,7 +2026,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		// times from object,transform,attributes and bounds. And also computes the
 		// animated bounding boxes in case they were not explicitly writen.
 		//
-		void flush()
+		void flush( SetIndex &setIndex )
 		{
 			if ( m_parent )
 			{
@@ -1731,7 +2039,26 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			/// first call flush recursively on children...
 			for ( std::map< SceneCache::Name, WriterImplementationPtr >::const_iterator cit = m_children.begin(); cit != m_children.end(); cit++ )
 			{
-				cit->second->flush();
+				cit->second->flush( setIndex );
+			}
+
+			// add our own tags and sets to the index
+			NameList localTags;
+			readTags( localTags, SceneInterface::LocalTag );
+			if( localTags.size() || m_sets.size() )
+			{
+				SceneCache::Path p;
+				path( p );
+				for( const auto &tag : localTags )
+				{
+					setIndex.tags[tag].addPath( p );
+				}
+				for( const auto &set : m_sets )
+				{
+					setIndex.sets[set.first].addPaths( set.second, p );
+					setIndex.setLocations[set.first].addPath( p );
+				}
+				m_sets.clear();
 			}
 
 			IndexedIOPtr io;
@@ -1740,6 +2067,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				io = m_indexedIO->subdirectory( transformEntry, IndexedIO::CreateIfMissing );
 				storeSampleTimes( m_transformSampleTimes, io );
+				storeHashes( m_transformHashes, io.get() );
 			}
 
 			// detect if topology or prim vars are animated
@@ -1771,7 +2099,9 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 				io = m_indexedIO->subdirectory( attributesEntry, IndexedIO::CreateIfMissing );
 				for ( AttributeSamplesMap::const_iterator it = m_attributeSampleTimes.begin(); it != m_attributeSampleTimes.end(); it++ )
 				{
-					storeSampleTimes( it->second, io->subdirectory( it->first, IndexedIO::CreateIfMissing ) );
+					IndexedIOPtr attributeIO = io->subdirectory( it->first, IndexedIO::CreateIfMissing );
+					storeSampleTimes( it->second, attributeIO );
+					storeHashes( m_attributeHashes[it->first], attributeIO.get() );
 				}
 			}
 			// save the object sample times
@@ -1779,6 +2109,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			{
 				io = m_indexedIO->subdirectory( objectEntry, IndexedIO::CreateIfMissing );
 				storeSampleTimes( m_objectSampleTimes, io );
+				storeHashes( m_objectHashes, io.get() );
 			}
 
 			// We have to compute the bounding box over time for the object and each child.
@@ -1945,10 +2276,14 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 
 				// store computed bounds in file
 				uint64_t sampleIndex = 0;
+				HashSamples boundHashes;
+				boundHashes.reserve( m_boundSamples.size() );
 				for ( BoxSamples::const_iterator bit = m_boundSamples.begin(); bit != m_boundSamples.end(); bit++, sampleIndex++ )
 				{
 					io->write( sampleEntry(sampleIndex), bit->min.getValue(), 6 );
+					boundHashes.push_back( MurmurHash().append( *bit ) );
 				}
+				storeHashes( boundHashes, io.get() );
 			}
 
 			if ( m_parent )
@@ -1972,6 +2307,16 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 			// deallocate children since we now computed everything from them anyways...
 			m_children.clear();
 
+			if ( !m_parent )
+			{
+				writeSetIndex( setIndex.tags, setIndexTagsEntry );
+				writeSetIndex( setIndex.sets, setIndexSetsEntry );
+				writeSetIndex( setIndex.setLocations, setIndexSetLocationsEntry );
+				// the presence of the index tells readers that it is complete,
+				// even when there are no sets at all.
+				m_indexedIO->subdirectory( setIndexEntry, IndexedIO::CreateIfMissing );
+			}
+
 			if ( !m_parent && m_sampleTimesMap )
 			{
 				// we are at the root...
@@ -2148,6 +2493,7 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		
 		WriterImplementation* m_parent;
 		std::map< SceneCache::Name, WriterImplementationPtr > m_children;
+		std::map< SceneCache::Name, PathMatcher > m_sets;
 
 		typedef std::map< SampleTimes, uint64_t > SampleTimesMap;
 		typedef std::map< SceneCache::Name, SampleTimes > AttributeSamplesMap;
@@ -2163,6 +2509,10 @@ class SceneCache::WriterImplementation : public SceneCache::Implementation
 		BoxSamples m_objectSamples;
 		// overwriting bounding boxes (or used during flush to compute the final bounding boxes).
 		BoxSamples m_boundSamples;
+		// content hashes for each sample, stored during flush.
+		HashSamples m_transformHashes;
+		std::map< SceneCache::Name, HashSamples > m_attributeHashes;
+		HashSamples m_objectHashes;
 
 		typedef std::pair< MurmurHash, bool> AnimatedHashTest;
 		typedef std::map< SceneCache::Name, AnimatedHashTest > AnimatedPrimVarMap;
@@ -2384,6 +2734,19 @@ void SceneCache::writeAttribute( const Name &name, const Object *attribute, doub
 	writer->writeAttribute( name, attribute, time );
 }
 
+void SceneCache::writeAttribute( const Name &name, const Object *attribute, double time, const MurmurHash &hash )
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+
+	if ( name == animatedObjectTopologyAttribute || name == animatedObjectPrimVarsAttribute )
+	{
+		// ignore reserved attribute names
+		return;
+	}
+
+	writer->writeAttribute( name, attribute, time, &hash );
+}
+
 bool SceneCache::hasTag( const Name &name, int filter ) const
 {
 	return ReaderImplementation::reader( m_implementation.get() )->hasTag(name, filter);
@@ -2431,16 +2794,7 @@ SceneInterface::NameList SceneCache::setNames( bool includeDescendantSets ) cons
 IECore::PathMatcher SceneCache::readSet( const Name &name, bool includeDescendantSets ) const
 {
 	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
-
-	PathMatcher set;
-
-	// read the old style tags and convert to a set
-	Private::loadSetWalk( this, name, set, SceneInterface::Path() );
-
-	// load the new sets
-	set.addPaths( reader->readSet( name, includeDescendantSets ) );
-
-	return set;
+	return reader->readSet( name, includeDescendantSets );
 }
 
 void SceneCache::writeSet( const Name &name, const IECore::PathMatcher &set )
@@ -2505,12 +2859,29 @@ PrimitiveVariableMap SceneCache::readObjectPrimitiveVariables( const std::vector
 	return reader->readObjectPrimitiveVariables( primVarNames, time );
 }
 
+MurmurHash SceneCache::objectKey( double time ) const
+{
+	ReaderImplementation *reader = ReaderImplementation::reader( m_implementation.get() );
+	MurmurHash h;
+	if( reader->objectKey( time, h ) )
+	{
+		return h;
+	}
+	return SampledSceneInterface::objectKey( time );
+}
+
 void SceneCache::writeObject( const Object *object, double time )
 {
 	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
 	writer->writeObject( object, time );
 }
 
+void SceneCache::writeObject( const Object *object, double time, const MurmurHash &hash )
+{
+	WriterImplementation *writer = WriterImplementation::writer( m_implementation.get() );
+	writer->writeObject( object, time, &hash );
+}
+
 void SceneCache::childNames( NameList &childNames ) const
 {
 	return m_implementation->childNames(childNames);
@@ -2617,3 +2988,25 @@ bool SceneCache::readOnly() const
 {
 	return dynamic_cast< const ReaderImplementation* >( m_implementation.get() ) != nullptr;
 }
+
+SceneCache::CacheStatistics::CacheStatistics()
+	:	hits( 0 ), misses( 0 )
+{
+}
+
+SceneCache::CacheStatistics SceneCache::CacheStatistics::operator - ( const CacheStatistics &other ) const
+{
+	CacheStatistics result;
+	result.hits = hits - other.hits;
+	result.misses = misses - other.misses;
+	return result;
+}
+
+SceneCache::CacheStatistics SceneCache::threadCacheStatistics()
+{
+	const CacheCounts &counts = g_cacheCounts.local();
+	CacheStatistics result;
+	result.misses = counts.misses;
+	result.hits = counts.lookups - counts.misses;
+	return result;
+}
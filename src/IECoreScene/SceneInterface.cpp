@@ -139,6 +139,15 @@ void SceneInterface::hash( HashType hashType, double time, MurmurHash &h ) const
 	h.append( typeId() );
 }
 
+MurmurHash SceneInterface::objectKey( double time ) const
+{
+	if( !hasObject() )
+	{
+		return MurmurHash();
+	}
+	return readObject( time )->hash();
+}
+
 void SceneInterface::pathToString( const SceneInterface::Path &p, std::string &path )
 {
 	if ( !p.size() )
@@ -47,8 +47,14 @@
 #include "boost/regex.hpp"
 #include "boost/algorithm/string/replace.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
-#include <unordered_set>
 
 using namespace std;
 using namespace boost;
@@ -89,29 +95,73 @@ boost::regex attributeRegex()
 	return r;	
 }
 
-bool stringFindSubstitutions( const std::string &target, std::unordered_set< InternedString > &requestedAttributes )
+std::string unescape( const std::string &s )
 {
-	bool found = false;
-	boost::sregex_iterator matches( target.begin(), target.end(), attributeRegex(), boost::match_default );
-	for( boost::sregex_iterator i = matches; i != boost::sregex_iterator(); i++ )
-	{
-		found = true;
+	std::string result = s;
+	boost::replace_all( result, "\\<", "<" );
+	boost::replace_all( result, "\\>", ">" );
+	return result;
+}
 
-		// The one group in the expression gives us the token we're looking for
-		requestedAttributes.insert( InternedString( (*i)[1] ) );
-	}
+// A string parameter value, parsed into literal text and the attributes
+// to be substituted between it, so that substitutions can be applied
+// without parsing the value again.
+struct SubstitutionTemplate
+{
+	// Literal text, with escapes already removed. There is always
+	// one more piece of text than there are attributes, and they
+	// alternate starting with the text.
+	std::vector<std::string> text;
+	std::vector<InternedString> attributes;
+	size_t textSize;
+};
 
-	// Strings with escaped substitutions don't require attributes, but we do need call
-	// stringApplySubstitutions on them so that the escape symbols get removed
-	if( target.find( "\\<" ) != string::npos )
+// Parses `target` in the same way that `attributeRegex()` would match it, returning
+// true if the string needs substitutions applied. This is the case if it contains
+// attributes or escaped angle brackets that must be unescaped.
+bool parseSubstitutions( const std::string &target, SubstitutionTemplate &result )
+{
+	static const std::string prefix( "<attr:" );
+
+	result.text.clear();
+	result.attributes.clear();
+
+	size_t textBegin = 0;
+	size_t pos = 0;
+	while( ( pos = target.find( prefix, pos ) ) != std::string::npos )
 	{
-		found = true;
+		const size_t nameBegin = pos + prefix.size();
+		const size_t nameEnd = target.find( '>', nameBegin );
+		if( nameEnd == std::string::npos )
+		{
+			break;
+		}
+
+		// The opening bracket must not be escaped, the name must be non-empty, and
+		// the name must not end with a backslash, which would escape the closing bracket.
+		if( ( pos > 0 && target[pos-1] == '\\' ) || nameEnd == nameBegin || target[nameEnd-1] == '\\' )
+		{
+			++pos;
+			continue;
+		}
+
+		result.text.push_back( unescape( target.substr( textBegin, pos - textBegin ) ) );
+		result.attributes.push_back( InternedString( target.c_str() + nameBegin, nameEnd - nameBegin ) );
+		textBegin = pos = nameEnd + 1;
 	}
-	if( target.find( "\\>" ) != string::npos )
+	result.text.push_back( unescape( target.substr( textBegin ) ) );
+
+	result.textSize = 0;
+	for( const auto &text : result.text )
 	{
-		found = true;
+		result.textSize += text.size();
 	}
-	return found;
+
+	return
+		result.attributes.size() ||
+		target.find( "\\<" ) != string::npos ||
+		target.find( "\\>" ) != string::npos
+	;
 }
 
 std::string stringApplySubstitutions( const std::string &target, const IECore::CompoundObject *attributes )
@@ -120,8 +170,53 @@ std::string stringApplySubstitutions( const std::string &target, const IECore::C
 	std::string result = boost::regex_replace(
 		target, attributeRegex(), rf, boost::match_default | boost::format_all
 	);
-	boost::replace_all( result, "\\<", "<" );
-	boost::replace_all( result, "\\>", ">" );
+	return unescape( result );
+}
+
+// Fills `result` from the template. Returns false if this isn't possible
+// because an attribute value contains backslashes. The regex based
+// `stringApplySubstitutions()` removes escapes from attribute values as
+// well as from the original string, so we must use it to get an identical
+// result.
+bool fillTemplate( const SubstitutionTemplate &t, const IECore::CompoundObject *attributes, std::string &result )
+{
+	std::vector<const StringData *> values( t.attributes.size() );
+	size_t size = t.textSize;
+	for( size_t i = 0; i < t.attributes.size(); ++i )
+	{
+		values[i] = attributes->member<StringData>( t.attributes[i] );
+		if( values[i] )
+		{
+			if( values[i]->readable().find( '\\' ) != string::npos )
+			{
+				return false;
+			}
+			size += values[i]->readable().size();
+		}
+	}
+
+	result.clear();
+	result.reserve( size );
+	result += t.text[0];
+	for( size_t i = 0; i < t.attributes.size(); ++i )
+	{
+		if( values[i] )
+		{
+			result += values[i]->readable();
+		}
+		result += t.text[i+1];
+	}
+
+	return true;
+}
+
+std::string stringApplySubstitutions( const SubstitutionTemplate &t, const std::string &target, const IECore::CompoundObject *attributes )
+{
+	std::string result;
+	if( !fillTemplate( t, attributes, result ) )
+	{
+		result = stringApplySubstitutions( target, attributes );
+	}
 	return result;
 }
 
@@ -149,6 +244,31 @@ class ShaderNetwork::Implementation
 			return handle;
 		}
 
+		IECore::InternedString addShader( IECore::InternedString handle, const Implementation *sourceNetwork, const IECore::InternedString &sourceHandle )
+		{
+			auto sourceIt = sourceNetwork->m_nodes.find( sourceHandle );
+			if( sourceIt == sourceNetwork->m_nodes.end() )
+			{
+				throw IECore::Exception( boost::str(
+					boost::format(
+						"Source shader \"%1%\" not in network"
+					) % sourceHandle.c_str()
+				) );
+			}
+
+			// Take references before inserting, in case `sourceNetwork` is
+			// this network.
+			ConstShaderPtr shader = sourceIt->shader;
+			ConstNodeDataPtr data = std::atomic_load( &sourceIt->data );
+
+			handle = uniqueHandle( handle );
+			const Node &node = *m_nodes.insert( handle ).first;
+			node.mutableShader() = shader;
+			std::atomic_store( &node.data, data );
+			m_dirty = true;
+			return handle;
+		}
+
 		void setShader( const IECore::InternedString &handle, const IECoreScene::Shader *shader )
 		{
 			setShader( handle, shader->copy() );
@@ -423,10 +543,16 @@ class ShaderNetwork::Implementation
 			h.append( m_hash );
 		}
 
+		bool needsSubstitutions() const
+		{
+			update();
+			return m_substitutions->shaders.size();
+		}
+
 		void hashSubstitutions( const CompoundObject *attributes, MurmurHash &h ) const
 		{
 			update();
-			for( const auto &a : m_neededSubstitutions )
+			for( const auto &a : m_substitutions->attributes )
 			{
 				const StringData *sourceAttribute = attributes->member<StringData>( a );
 				if( sourceAttribute )
@@ -445,35 +571,49 @@ class ShaderNetwork::Implementation
 		{
 			update();
 
-			for( const auto &nodeAndParms : m_parmsNeedingSubstitution )
+			// Hold our own reference, since we're about to dirty ourselves.
+			std::shared_ptr<const Substitutions> substitutions = m_substitutions;
+			for( const auto &shaderSubstitutions : substitutions->shaders )
 			{
-				auto it = m_nodes.find( nodeAndParms.first );
-				ShaderPtr s ( it->shader->copy() );
-				for( const auto &parm : nodeAndParms.second )
+				auto it = m_nodes.find( shaderSubstitutions.first );
+				ShaderPtr s( it->shader->copy() );
+				for( const auto &parameterSubstitutions : shaderSubstitutions.second->substitutions )
 				{
-					StringData *targetParm = runTimeCast< StringData >( s->parameters()[parm].get() );
-					if( targetParm )
+					DataPtr &parm = s->parameters()[parameterSubstitutions.name];
+					const auto &templates = parameterSubstitutions.templates;
+
+					if( !parameterSubstitutions.vector )
 					{
-						targetParm->writable() = stringApplySubstitutions( targetParm->readable(), attributes );
-						continue;
+						const StringData *sourceParm = runTimeCast<const StringData>( parm.get() );
+						if( sourceParm && templates.size() == 1 )
+						{
+							parm = new StringData( stringApplySubstitutions( templates[0], sourceParm->readable(), attributes ) );
+							continue;
+						}
 					}
-
-					StringVectorData *targetParmVector = runTimeCast< StringVectorData >( s->parameters()[parm].get() );
-					if( targetParmVector )
+					else
 					{
-						std::vector<std::string> &stringVector = targetParmVector->writable();
-						for( unsigned int i = 0; i < stringVector.size(); i++ )
+						const StringVectorData *sourceParm = runTimeCast<const StringVectorData>( parm.get() );
+						if( sourceParm && templates.size() == sourceParm->readable().size() )
 						{
-							stringVector[i] = stringApplySubstitutions( stringVector[i], attributes );
+							const std::vector<std::string> &source = sourceParm->readable();
+							StringVectorDataPtr targetParm = new StringVectorData;
+							std::vector<std::string> &target = targetParm->writable();
+							target.reserve( source.size() );
+							for( size_t i = 0; i < source.size(); ++i )
+							{
+								target.push_back( stringApplySubstitutions( templates[i], source[i], attributes ) );
+							}
+							parm = targetParm;
+							continue;
 						}
-						continue;
 					}
 
 					throw Exception( "ShaderNetwork::applySubstitutions : parameter need substitution couldn't be found - was the network somehow modified without being dirtied?" );
 				}
 				it->mutableShader() = s;
+				m_dirty = true;
 			}
-			m_dirty = true;
 		}
 
 		void copyFrom( const Implementation *other, IECore::Object::CopyContext *context )
@@ -483,10 +623,12 @@ class ShaderNetwork::Implementation
 			// all times.
 			m_nodes = other->m_nodes;
 			m_output = other->m_output;
+
+			// `other` may be updating concurrently.
+			std::lock_guard<std::mutex> lock( other->m_updateMutex );
 			m_hash = other->m_hash;
 			m_dirty = other->m_dirty;
-			m_parmsNeedingSubstitution = other->m_parmsNeedingSubstitution;
-			m_neededSubstitutions = other->m_neededSubstitutions;
+			m_substitutions = other->m_substitutions;
 		}
 
 		void save( IECore::Object::SaveContext *context ) const
@@ -582,6 +724,28 @@ class ShaderNetwork::Implementation
 			>
 		>;
 
+		// A string parameter which needs substituting, parsed into templates so
+		// that `applySubstitutions()` doesn't need to parse it again.
+		struct ParameterSubstitutions
+		{
+			IECore::InternedString name;
+			bool vector;
+			// One template per element for StringVectorData.
+			std::vector<SubstitutionTemplate> templates;
+		};
+
+		// Data derived from a single shader by `update()`. It depends only on the
+		// shader, so it is immutable once computed, and is shared along with the
+		// shader between copies of the network. Edits therefore only require the
+		// edited shaders to be visited again.
+		struct NodeData
+		{
+			IECore::MurmurHash shaderHash;
+			std::vector<ParameterSubstitutions> substitutions;
+		};
+
+		using ConstNodeDataPtr = std::shared_ptr<const NodeData>;
+
 		struct Node
 		{
 			Node( IECore::InternedString handle )
@@ -589,12 +753,23 @@ class ShaderNetwork::Implementation
 			{
 			}
 
+			Node( const Node &other )
+				:	handle( other.handle ), shader( other.shader ),
+					inputConnections( other.inputConnections ), outputConnections( other.outputConnections ),
+					data( std::atomic_load( &other.data ) )
+			{
+			}
+
 			IECore::InternedString handle;
 			IECoreScene::ConstShaderPtr shader;
 
 			Connections inputConnections;
 			Connections outputConnections;
 
+			// Computed lazily by `update()`, which may be called concurrently,
+			// so must be accessed via `std::atomic_load()` and `std::atomic_store()`.
+			mutable ConstNodeDataPtr data;
+
 			const std::string &handleKey() const { return handle.string(); }
 			const IECoreScene::Shader *shaderKey() const { return shader.get(); }
 
@@ -602,9 +777,12 @@ class ShaderNetwork::Implementation
 			// to avoid keys changing behind its back. But we know that
 			// `shader` isn't used as a key, so this cast is kosher. Note that
 			// we're only providing mutable access to the pointer, not to the
-			// shader. The shader remains immutable at all times.
+			// shader. The shader remains immutable at all times. Since the
+			// caller is replacing the shader, we discard the data derived
+			// from it.
 			ConstShaderPtr &mutableShader() const
 			{
+				std::atomic_store( &data, ConstNodeDataPtr() );
 				return const_cast<ConstShaderPtr &>( shader );
 			}
 			// As above.
@@ -641,8 +819,15 @@ class ShaderNetwork::Implementation
 		// shaders.
 		mutable IECore::MurmurHash m_hash;
 
-		mutable std::map< InternedString, std::vector< InternedString > > m_parmsNeedingSubstitution;
-		mutable std::unordered_set< InternedString > m_neededSubstitutions;
+		struct Substitutions
+		{
+			// Handles and data for the shaders which need substitutions.
+			std::vector<std::pair<IECore::InternedString, ConstNodeDataPtr>> shaders;
+			// All attributes referenced by the templates, sorted by name.
+			std::vector<IECore::InternedString> attributes;
+		};
+
+		mutable std::shared_ptr<const Substitutions> m_substitutions;
 
 		// Tracks whether or not the hash and substitutions are up to date.
 		mutable bool m_dirty = true;
@@ -696,55 +881,121 @@ class ShaderNetwork::Implementation
 
 		void update() const
 		{
-			std::unique_lock<std::mutex> lock( m_updateMutex );
-			if( m_dirty )
 			{
-				m_hash = MurmurHash();
-				m_neededSubstitutions.clear();
-				m_parmsNeedingSubstitution.clear();
-				for( const auto &node : m_nodes )
+				std::lock_guard<std::mutex> lock( m_updateMutex );
+				if( !m_dirty )
 				{
-					m_hash.append( node.handle );
-					node.shader->hash( m_hash );
-					std::vector< InternedString > parmsNeedingSub;
+					return;
+				}
+			}
 
-					for( const auto &connection : node.inputConnections )
-					{
-						m_hash.append( connection.source.shader );
-						m_hash.append( connection.source.name );
-						m_hash.append( connection.destination.name );
-					}
+			// Compute data for any shaders which don't have it yet. This is
+			// independent per shader, so we do it in parallel. We don't hold
+			// `m_updateMutex` while doing so, because TBB may schedule other
+			// work on this thread while it waits, and that work could call
+			// `update()` itself. In the worst case, two threads compute the
+			// same data and one result is discarded.
+
+			std::vector<const Node *> nodes;
+			for( const auto &node : m_nodes )
+			{
+				if( !std::atomic_load( &node.data ) )
+				{
+					nodes.push_back( &node );
+				}
+			}
 
-					for( const auto &parm : node.shader->parameters() )
+			tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, nodes.size(), 8 ),
+				[&]( const tbb::blocked_range<size_t> &range ) {
+					SubstitutionTemplate t;
+					for( size_t i = range.begin(); i != range.end(); ++i )
 					{
-						bool needed = false;
-						StringData *stringParm = IECore::runTimeCast< StringData >( parm.second.get() );
-						StringVectorData *stringVectorParm = IECore::runTimeCast< StringVectorData >( parm.second.get() );
-						if( stringParm )
-						{
-							needed |= stringFindSubstitutions( stringParm->readable(), m_neededSubstitutions );
-						}
-						if( stringVectorParm )
+						const Node &node = *nodes[i];
+						auto data = std::make_shared<NodeData>();
+						node.shader->hash( data->shaderHash );
+
+						for( const auto &parm : node.shader->parameters() )
 						{
-							for( const std::string &i : stringVectorParm->readable() )
+							if( const StringData *stringParm = IECore::runTimeCast<const StringData>( parm.second.get() ) )
+							{
+								if( parseSubstitutions( stringParm->readable(), t ) )
+								{
+									data->substitutions.push_back( { parm.first, false, { t } } );
+								}
+							}
+							else if( const StringVectorData *stringVectorParm = IECore::runTimeCast<const StringVectorData>( parm.second.get() ) )
 							{
-								needed |= stringFindSubstitutions( i, m_neededSubstitutions );
+								const std::vector<std::string> &strings = stringVectorParm->readable();
+								std::vector<SubstitutionTemplate> templates( strings.size() );
+								bool needed = false;
+								for( size_t j = 0; j < strings.size(); ++j )
+								{
+									needed |= parseSubstitutions( strings[j], templates[j] );
+								}
+								if( needed )
+								{
+									data->substitutions.push_back( { parm.first, true, std::move( templates ) } );
+								}
 							}
 						}
-						if( needed )
+
+						std::atomic_store( &node.data, ConstNodeDataPtr( data ) );
+					}
+				},
+				taskGroupContext
+			);
+
+			// Combine the per-shader data with the network structure. This
+			// is cheap, so we just do it serially.
+
+			std::lock_guard<std::mutex> lock( m_updateMutex );
+			if( !m_dirty )
+			{
+				return;
+			}
+
+			MurmurHash hash;
+			auto substitutions = std::make_shared<Substitutions>();
+			for( const auto &node : m_nodes )
+			{
+				ConstNodeDataPtr data = std::atomic_load( &node.data );
+				hash.append( node.handle );
+				hash.append( data->shaderHash );
+				for( const auto &connection : node.inputConnections )
+				{
+					hash.append( connection.source.shader );
+					hash.append( connection.source.name );
+					hash.append( connection.destination.name );
+				}
+
+				if( data->substitutions.size() )
+				{
+					for( const auto &parameterSubstitutions : data->substitutions )
+					{
+						for( const auto &t : parameterSubstitutions.templates )
 						{
-							parmsNeedingSub.push_back( parm.first );
+							substitutions->attributes.insert( substitutions->attributes.end(), t.attributes.begin(), t.attributes.end() );
 						}
 					}
-
-					m_parmsNeedingSubstitution[ node.handle ] = parmsNeedingSub;	
+					substitutions->shaders.push_back( { node.handle, data } );
 				}
+			}
 
-				m_hash.append( m_output.shader );
-				m_hash.append( m_output.name );
+			hash.append( m_output.shader );
+			hash.append( m_output.name );
 
-				m_dirty = false;
-			}
+			std::vector<InternedString> &attributes = substitutions->attributes;
+			std::sort(
+				attributes.begin(), attributes.end(),
+				[]( const InternedString &a, const InternedString &b ) { return a.string() < b.string(); }
+			);
+			attributes.erase( std::unique( attributes.begin(), attributes.end() ), attributes.end() );
+
+			m_hash = hash;
+			m_substitutions = substitutions;
+			m_dirty = false;
 		}
 
 		static unsigned int g_ioVersion;
@@ -814,6 +1065,11 @@ IECore::InternedString ShaderNetwork::addShader( const IECore::InternedString &h
 	return implementation()->addShader( handle, std::move( shader ) );
 }
 
+IECore::InternedString ShaderNetwork::addShader( const IECore::InternedString &handle, const ShaderNetwork *sourceNetwork, const IECore::InternedString &sourceHandle )
+{
+	return implementation()->addShader( handle, sourceNetwork->implementation(), sourceHandle );
+}
+
 void ShaderNetwork::setShader( const IECore::InternedString &handle, const IECoreScene::Shader *shader )
 {
 	implementation()->setShader( handle, shader );
@@ -874,6 +1130,68 @@ void ShaderNetwork::applySubstitutions( const CompoundObject *attributes )
 	implementation()->applySubstitutions( attributes );
 }
 
+std::vector<ConstShaderNetworkPtr> ShaderNetwork::substitutedNetworks( const std::vector<const IECore::CompoundObject *> &attributeSets ) const
+{
+	std::vector<ConstShaderNetworkPtr> result( attributeSets.size() );
+	if( !implementation()->needsSubstitutions() )
+	{
+		std::fill( result.begin(), result.end(), ConstShaderNetworkPtr( this ) );
+		return result;
+	}
+
+	// Hash the attributes relevant to each set, so that we only need
+	// to build one network for each unique combination of values.
+
+	std::vector<MurmurHash> hashes( attributeSets.size() );
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, attributeSets.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				hashSubstitutions( attributeSets[i], hashes[i] );
+			}
+		},
+		taskGroupContext
+	);
+
+	std::map<MurmurHash, size_t> uniqueIndices;
+	std::vector<size_t> uniqueSources;
+	std::vector<size_t> indices( attributeSets.size() );
+	for( size_t i = 0; i < attributeSets.size(); ++i )
+	{
+		auto inserted = uniqueIndices.insert( { hashes[i], uniqueSources.size() } );
+		if( inserted.second )
+		{
+			uniqueSources.push_back( i );
+		}
+		indices[i] = inserted.first->second;
+	}
+
+	// Build the unique networks.
+
+	std::vector<ConstShaderNetworkPtr> uniqueNetworks( uniqueSources.size() );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, uniqueSources.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for( size_t i = range.begin(); i != range.end(); ++i )
+			{
+				ShaderNetworkPtr network = copy();
+				network->applySubstitutions( attributeSets[uniqueSources[i]] );
+				uniqueNetworks[i] = network;
+			}
+		},
+		taskGroupContext
+	);
+
+	for( size_t i = 0; i < attributeSets.size(); ++i )
+	{
+		result[i] = uniqueNetworks[indices[i]];
+	}
+
+	return result;
+}
+
 void ShaderNetwork::addConnection( const Connection &connection )
 {
 	implementation()->addConnection( connection );
@@ -54,7 +54,7 @@ ShaderNetwork::Parameter ShaderNetworkAlgo::addShaders( ShaderNetwork *network,
 
 	for( const auto &s : sourceNetwork->shaders() )
 	{
-		handleMap[s.first] = network->addShader( s.first, s.second.get() );
+		handleMap[s.first] = network->addShader( s.first, sourceNetwork, s.first );
 	}
 
 	if( connections )
@@ -43,6 +43,9 @@
 #include "IECore/CompoundParameter.h"
 #include "IECore/SimpleTypedData.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include <algorithm>
 #include <cassert>
 
@@ -103,8 +106,9 @@ void TransferSmoothSkinningWeightsOp::modify( Object * object, const CompoundObj
 		throw IECore::Exception( ( boost::format( "TransferSmoothSkinningWeightsOp: \"%s\" is not a valid influence name" ) % target ).str() );
 	}
 	int targetIndex = location - influenceNames.begin();
-	std::vector<int> sourceIndices;
 
+	// flag the source influences so they can be looked up in constant time
+	std::vector<char> isSource( influenceNames.size(), 0 );
 	for ( unsigned i=0; i < sources.size(); i++ )
 	{
 		std::string name = sources[i];
@@ -114,7 +118,7 @@ void TransferSmoothSkinningWeightsOp::modify( Object * object, const CompoundObj
 		{
 			throw IECore::Exception( ( boost::format( "TransferSmoothSkinningWeightsOp: \"%s\" is not a valid influenceName" ) % name ).str() );
 		}
-		sourceIndices.push_back( found - influenceNames.begin() );
+		isSource[ found - influenceNames.begin() ] = 1;
 	}
 
 	// decompress skinning data
@@ -128,34 +132,41 @@ void TransferSmoothSkinningWeightsOp::modify( Object * object, const CompoundObj
 	const std::vector<int> &pointInfluenceIndices = skinningData->pointInfluenceIndices()->readable();
 	std::vector<float> &pointInfluenceWeights = skinningData->pointInfluenceWeights()->writable();
 
-	for ( unsigned i=0; i < pointIndexOffsets.size(); i++ )
-	{
-		float targetWeight = 0.0;
-		int targetCurrentIndex = 0;
-
-		for ( int j=0; j < pointInfluenceCounts[i]; j++ )
-		{
-			int current = pointIndexOffsets[i] + j;
-			int index = pointInfluenceIndices[current];
-			float weight = pointInfluenceWeights[current];
-
-			if( index == targetIndex )
-			{
-				targetWeight += weight;
-				targetCurrentIndex = current;
-			}
-			else
+	// each point only touches its own weights, so the points can be processed in parallel
+	tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, pointIndexOffsets.size() ),
+		[&]( const tbb::blocked_range<size_t> &range ) {
+			for ( size_t i=range.begin(); i != range.end(); i++ )
 			{
-				const std::vector<int>::const_iterator found = find( sourceIndices.begin(), sourceIndices.end(), index );
-				if ( found != sourceIndices.end() )
+				float targetWeight = 0.0;
+				int targetCurrentIndex = -1;
+
+				for ( int j=0; j < pointInfluenceCounts[i]; j++ )
+				{
+					int current = pointIndexOffsets[i] + j;
+					int index = pointInfluenceIndices[current];
+					float weight = pointInfluenceWeights[current];
+
+					if( index == targetIndex )
+					{
+						targetWeight += weight;
+						targetCurrentIndex = current;
+					}
+					else if ( isSource[index] )
+					{
+						targetWeight += weight;
+						pointInfluenceWeights[ current ] = 0.0;
+					}
+				}
+				if ( targetCurrentIndex >= 0 )
 				{
-					targetWeight += weight;
-					pointInfluenceWeights[ current ] = 0.0;
+					pointInfluenceWeights[ targetCurrentIndex ] = targetWeight;
 				}
 			}
-		}
-		pointInfluenceWeights[ targetCurrentIndex ] = targetWeight;
-	}
+		},
+		taskGroupContext
+	);
 
 	// re-compress
 	CompressSmoothSkinningDataOpPtr compressionOp = new CompressSmoothSkinningDataOp;
@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/python.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
 
 #include "CurvesPrimitiveEvaluatorBinding.h"
 
@@ -41,6 +42,7 @@
 
 #include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "OpenEXR/ImathRandom.h"
 
@@ -68,6 +70,37 @@ bool pointAtV( const CurvesPrimitiveEvaluator &e, unsigned curveIndex, float v,
 	return e.pointAtV( curveIndex, v, r );
 }
 
+boost::python::tuple pointsAtV( const CurvesPrimitiveEvaluator &e, const IntVectorData *curveIndices, const FloatVectorData *v )
+{
+	V3fVectorDataPtr points = new V3fVectorData;
+	V3fVectorDataPtr vTangents = new V3fVectorData;
+	{
+		ScopedGILRelease gilRelease;
+		e.pointsAtV( curveIndices->readable(), v->readable(), points->writable(), &vTangents->writable() );
+	}
+	return boost::python::make_tuple( points, vTangents );
+}
+
+boost::python::tuple closestPoints( const CurvesPrimitiveEvaluator &e, const V3fVectorData *points )
+{
+	IntVectorDataPtr curveIndices = new IntVectorData;
+	FloatVectorDataPtr v = new FloatVectorData;
+	{
+		ScopedGILRelease gilRelease;
+		e.closestPoints( points->readable(), curveIndices->writable(), v->writable() );
+	}
+	return boost::python::make_tuple( curveIndices, v );
+}
+
+CompoundDataPtr primitiveVariablesAtV( const CurvesPrimitiveEvaluator &e, const IntVectorData *curveIndices, const FloatVectorData *v, object pythonNames )
+{
+	std::vector<std::string> names;
+	boost::python::container_utils::extend_container( names, pythonNames );
+
+	ScopedGILRelease gilRelease;
+	return e.primitiveVariablesAtV( curveIndices->readable(), v->readable(), names );
+}
+
 IntVectorDataPtr verticesPerCurve( const CurvesPrimitiveEvaluator &e )
 {
 	return new IntVectorData( e.verticesPerCurve() );
@@ -226,6 +259,9 @@ void bindCurvesPrimitiveEvaluator()
 				arg( "vEnd" ) = 1.0f
 			)
 		)
+		.def( "pointsAtV", &pointsAtV )
+		.def( "closestPoints", &closestPoints )
+		.def( "primitiveVariablesAtV", &primitiveVariablesAtV )
 		.def( "verticesPerCurve", &verticesPerCurve )
 		.def( "vertexDataOffsets", &vertexDataOffsets )
 		.def( "varyingDataOffsets", &varyingDataOffsets )
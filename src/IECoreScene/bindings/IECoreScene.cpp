@@ -99,6 +99,7 @@
 #include "RendererBinding.h"
 #include "ReorderSmoothSkinningInfluencesOpBinding.h"
 #include "SampledSceneInterfaceBinding.h"
+#include "SceneBVHBinding.h"
 #include "SceneCacheBinding.h"
 #include "SceneInterfaceBinding.h"
 #include "ShaderBinding.h"
@@ -221,6 +222,7 @@ BOOST_PYTHON_MODULE(_IECoreScene)
 	bindPointsAlgo();
 	bindTypedObjectParameter();
 	bindTypeId();
+	bindSceneBVH();
 	bindSceneAlgo();
 
 }
@@ -41,17 +41,43 @@
 
 #include "IECoreScene/PointSmoothSkinningOp.h"
 
+#include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 #include "IECore/CompoundObject.h"
 #include "IECore/Object.h"
 #include "IECore/Parameter.h"
+#include "IECore/VectorTypedData.h"
 
 using namespace boost;
 using namespace boost::python;
 using namespace IECorePython;
 using namespace IECoreScene;
 
+namespace
+{
+
+const std::vector<int> &indices( const IECore::IntVectorData *data )
+{
+	static const std::vector<int> g_empty;
+	return data ? data->readable() : g_empty;
+}
+
+void deformPoints( const PointSmoothSkinningOp::PreparedSkin &skin, IECore::V3fVectorData *points, const IECore::M44fVectorData *deformationPose, PointSmoothSkinningOp::Blend blend, const IECore::IntVectorData *referenceIndices )
+{
+	ScopedGILRelease gilRelease;
+	skin.deformPoints( points->writable(), deformationPose->readable(), blend, indices( referenceIndices ) );
+}
+
+void deformNormals( const PointSmoothSkinningOp::PreparedSkin &skin, IECore::V3fVectorData *normals, const IECore::M44fVectorData *deformationPose, PointSmoothSkinningOp::Blend blend, const IECore::IntVectorData *referenceIndices, const IECore::IntVectorData *vertexIndices )
+{
+	ScopedGILRelease gilRelease;
+	skin.deformNormals( normals->writable(), deformationPose->readable(), blend, indices( referenceIndices ), indices( vertexIndices ) );
+}
+
+} // namespace
+
 namespace IECoreSceneModule
 {
 
@@ -63,6 +89,30 @@ void bindPointSmoothSkinningOp()
 
 	enum_< PointSmoothSkinningOp::Blend >( "Blend" )
 		.value( "Linear", PointSmoothSkinningOp::Linear )
+		.value( "DualQuaternion", PointSmoothSkinningOp::DualQuaternion )
+	;
+
+	RefCountedClass<PointSmoothSkinningOp::PreparedSkin, IECore::RefCounted>( "PreparedSkin" )
+		.def( init<SmoothSkinningDataPtr>() )
+		.def(
+			"deformPoints", &deformPoints,
+			(
+				arg( "points" ),
+				arg( "deformationPose" ),
+				arg( "blend" ) = PointSmoothSkinningOp::Linear,
+				arg( "referenceIndices" ) = object()
+			)
+		)
+		.def(
+			"deformNormals", &deformNormals,
+			(
+				arg( "normals" ),
+				arg( "deformationPose" ),
+				arg( "blend" ) = PointSmoothSkinningOp::Linear,
+				arg( "referenceIndices" ) = object(),
+				arg( "vertexIndices" ) = object()
+			)
+		)
 	;
 
 
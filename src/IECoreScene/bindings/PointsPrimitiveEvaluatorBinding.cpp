@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/python.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
 
 #include "PointsPrimitiveEvaluatorBinding.h"
 
@@ -40,11 +41,39 @@
 #include "IECoreScene/PointsPrimitiveEvaluator.h"
 
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
+#include "IECore/VectorTypedData.h"
+
+using namespace IECore;
 using namespace IECorePython;
 using namespace IECoreScene;
 using namespace boost::python;
 
+namespace
+{
+
+IntVectorDataPtr closestPoints( const PointsPrimitiveEvaluator &e, const V3fVectorData *points )
+{
+	IntVectorDataPtr pointIndices = new IntVectorData;
+	{
+		ScopedGILRelease gilRelease;
+		e.closestPoints( points->readable(), pointIndices->writable() );
+	}
+	return pointIndices;
+}
+
+CompoundDataPtr primitiveVariables( const PointsPrimitiveEvaluator &e, const IntVectorData *pointIndices, object pythonNames )
+{
+	std::vector<std::string> names;
+	boost::python::container_utils::extend_container( names, pythonNames );
+
+	ScopedGILRelease gilRelease;
+	return e.primitiveVariables( pointIndices->readable(), names );
+}
+
+} // namespace
+
 namespace IECoreSceneModule
 {
 
@@ -52,6 +81,8 @@ void bindPointsPrimitiveEvaluator()
 {
 	scope s = RunTimeTypedClass<PointsPrimitiveEvaluator>()
 		.def( init<PointsPrimitivePtr>() )
+		.def( "closestPoints", &closestPoints )
+		.def( "primitiveVariables", &primitiveVariables )
 	;
 
 	RefCountedClass<PointsPrimitiveEvaluator::Result, PrimitiveEvaluator::Result>( "Result" )
@@ -38,6 +38,7 @@
 
 #include "IECoreScene/SceneAlgo.h"
 
+#include "IECorePython/RefCountedBinding.h"
 #include "IECorePython/ScopedGILRelease.h"
 
 
@@ -48,12 +49,18 @@ using namespace IECoreScene;
 namespace
 {
 
-dict parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, float frameRate, unsigned int flags )
+void copy( const SceneInterface *src, SceneInterface *dst, int startFrame, int endFrame, float frameRate, unsigned int flags )
+{
+	IECorePython::ScopedGILRelease scopedGILRelease;
+	SceneAlgo::copy( src, dst, startFrame, endFrame, frameRate, flags );
+}
+
+dict parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, float frameRate, unsigned int flags, SceneAlgo::ReadProfile *profile, const Canceller *canceller )
 {
 	SceneAlgo::SceneStats stats;
 	{
 		IECorePython::ScopedGILRelease scopedGILRelease;
-		stats = SceneAlgo::parallelReadAll( src, startFrame, endFrame, frameRate, flags );
+		stats = SceneAlgo::parallelReadAll( src, startFrame, endFrame, frameRate, flags, profile, canceller );
 	}
 
 	dict result;
@@ -65,6 +72,60 @@ dict parallelReadAll( const SceneInterface *src, int startFrame, int endFrame, f
 	return result;
 }
 
+list instancedObjects( const SceneInterface *src, double time )
+{
+	SceneAlgo::InstancedObjects instances;
+	{
+		IECorePython::ScopedGILRelease scopedGILRelease;
+		instances = SceneAlgo::instancedObjects( src, time );
+	}
+
+	list result;
+	for( const auto &instance : instances )
+	{
+		result.append( make_tuple( instance.first, instance.second.object->copy(), instance.second.paths ) );
+	}
+
+	return result;
+}
+
+SceneBVHPtr sceneBVH( const SceneInterface *src, double time )
+{
+	ConstSceneBVHPtr result;
+	{
+		IECorePython::ScopedGILRelease scopedGILRelease;
+		result = SceneAlgo::sceneBVH( src, time );
+	}
+	// SceneBVH has only const methods, so this is safe.
+	return const_cast<SceneBVH *>( result.get() );
+}
+
+list readProfileEvents( const SceneAlgo::ReadProfile &profile )
+{
+	list result;
+	for( const auto &event : profile.events() )
+	{
+		result.append( event );
+	}
+	return result;
+}
+
+void writeTrace( const SceneAlgo::ReadProfile &profile, const std::string &fileName )
+{
+	IECorePython::ScopedGILRelease scopedGILRelease;
+	profile.writeTrace( fileName );
+}
+
+list eventPath( const SceneAlgo::ReadProfile::Event &event )
+{
+	list result;
+	for( const auto &name : event.path )
+	{
+		result.append( name.string() );
+	}
+	return result;
+}
+
 } // namespace
 
 namespace IECoreSceneModule
@@ -89,9 +150,44 @@ void bindSceneAlgo()
 		.export_values()
 		;
 
-	def( "copy", &SceneAlgo::copy );
+	def( "copy", &::copy );
+
+	{
+		scope profileScope = IECorePython::RefCountedClass<SceneAlgo::ReadProfile, RefCounted>( "ReadProfile" )
+			.def( init<>() )
+			.def( "events", &readProfileEvents )
+			.def( "writeTrace", &writeTrace )
+		;
+
+		class_<SceneAlgo::ReadProfile::Event>( "Event", no_init )
+			.add_property( "path", &eventPath )
+			.def_readonly( "time", &SceneAlgo::ReadProfile::Event::time )
+			.def_readonly( "phase", &SceneAlgo::ReadProfile::Event::phase )
+			.def_readonly( "thread", &SceneAlgo::ReadProfile::Event::thread )
+			.def_readonly( "start", &SceneAlgo::ReadProfile::Event::start )
+			.def_readonly( "duration", &SceneAlgo::ReadProfile::Event::duration )
+			.def_readonly( "bytesRead", &SceneAlgo::ReadProfile::Event::bytesRead )
+			.def_readonly( "bytesDecompressed", &SceneAlgo::ReadProfile::Event::bytesDecompressed )
+			.def_readonly( "decompressionTime", &SceneAlgo::ReadProfile::Event::decompressionTime )
+			.def_readonly( "cacheHits", &SceneAlgo::ReadProfile::Event::cacheHits )
+			.def_readonly( "cacheMisses", &SceneAlgo::ReadProfile::Event::cacheMisses )
+		;
+	}
+
+	def(
+		"parallelReadAll", &::parallelReadAll,
+		(
+			arg( "src" ), arg( "startFrame" ), arg( "endFrame" ), arg( "frameRate" ), arg( "flags" ),
+			arg( "profile" ) = object(), arg( "canceller" ) = object()
+		)
+	);
+
+	def( "instancedObjects", &::instancedObjects );
 
-	def( "parallelReadAll", &::parallelReadAll);
+	def( "sceneBVH", &::sceneBVH );
+	def( "setSceneBVHCacheMemoryLimit", &SceneAlgo::setSceneBVHCacheMemoryLimit );
+	def( "getSceneBVHCacheMemoryLimit", &SceneAlgo::getSceneBVHCacheMemoryLimit );
+	def( "clearSceneBVHCache", &SceneAlgo::clearSceneBVHCache );
 }
 
 } // namespace IECoreSceneModule
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "boost/python.hpp"
+
+#include "SceneBVHBinding.h"
+
+#include "IECoreScene/SceneBVH.h"
+
+#include "IECorePython/RefCountedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+#include "IECore/Exception.h"
+
+using namespace boost::python;
+using namespace Imath;
+using namespace IECore;
+using namespace IECorePython;
+using namespace IECoreScene;
+
+namespace
+{
+
+template<typename T>
+std::vector<T> listToVector( const list &l )
+{
+	std::vector<T> result;
+	result.reserve( len( l ) );
+	for( size_t i = 0, e = len( l ); i < e; ++i )
+	{
+		result.push_back( extract<T>( l[i] ) );
+	}
+	return result;
+}
+
+list vectorToList( const std::vector<PathMatcher> &v )
+{
+	list result;
+	for( const auto &p : v )
+	{
+		result.append( p );
+	}
+	return result;
+}
+
+PathMatcher boxPaths( const SceneBVH &bvh, const Box3d &box )
+{
+	ScopedGILRelease gilRelease;
+	return bvh.intersectingPaths( box );
+}
+
+PathMatcher frustumPaths( const SceneBVH &bvh, const Frustumd &frustum, const M44d &cameraToWorld )
+{
+	ScopedGILRelease gilRelease;
+	return bvh.intersectingPaths( frustum, cameraToWorld );
+}
+
+PathMatcher rayPaths( const SceneBVH &bvh, const Line3d &ray )
+{
+	ScopedGILRelease gilRelease;
+	return bvh.intersectingPaths( ray );
+}
+
+list bulkPaths( const SceneBVH &bvh, list queries )
+{
+	std::vector<PathMatcher> result;
+	if( !len( queries ) )
+	{
+		return list();
+	}
+	else if( extract<Box3d>( queries[0] ).check() )
+	{
+		const std::vector<Box3d> boxes = listToVector<Box3d>( queries );
+		ScopedGILRelease gilRelease;
+		result = bvh.intersectingPaths( boxes );
+	}
+	else if( extract<Line3d>( queries[0] ).check() )
+	{
+		const std::vector<Line3d> rays = listToVector<Line3d>( queries );
+		ScopedGILRelease gilRelease;
+		result = bvh.intersectingPaths( rays );
+	}
+	else
+	{
+		throw InvalidArgumentException( "SceneBVH.intersectingPaths : Expected a list of Box3d or Line3d" );
+	}
+
+	return vectorToList( result );
+}
+
+list bulkFrustumPaths( const SceneBVH &bvh, list frustums, list cameraToWorld )
+{
+	const std::vector<Frustumd> f = listToVector<Frustumd>( frustums );
+	const std::vector<M44d> m = listToVector<M44d>( cameraToWorld );
+	std::vector<PathMatcher> result;
+	{
+		ScopedGILRelease gilRelease;
+		result = bvh.intersectingPaths( f, m );
+	}
+	return vectorToList( result );
+}
+
+SceneBVHPtr construct( const SceneInterface *scene, double time )
+{
+	ScopedGILRelease gilRelease;
+	return new SceneBVH( scene, time );
+}
+
+Box3d bound( const SceneBVH &bvh )
+{
+	return bvh.bound();
+}
+
+} // namespace
+
+namespace IECoreSceneModule
+{
+
+void bindSceneBVH()
+{
+	RefCountedClass<SceneBVH, RefCounted>( "SceneBVH" )
+		.def( "__init__", make_constructor( &construct, default_call_policies(), ( arg( "scene" ), arg( "time" ) ) ) )
+		.def( "bound", &bound )
+		.def( "numLeaves", &SceneBVH::numLeaves )
+		.def( "memoryUsage", &SceneBVH::memoryUsage )
+		.def( "intersectingPaths", &bulkFrustumPaths )
+		.def( "intersectingPaths", &bulkPaths )
+		.def( "intersectingPaths", &rayPaths )
+		.def( "intersectingPaths", &frustumPaths )
+		.def( "intersectingPaths", &boxPaths )
+	;
+}
+
+} // namespace IECoreSceneModule
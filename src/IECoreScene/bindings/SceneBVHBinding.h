@@ -1,6 +1,6 @@
 //////////////////////////////////////////////////////////////////////////
 //
-//  Copyright (c) 2018, Image Engine Design Inc. All rights reserved.
+//  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
 //
 //  Redistribution and use in source and binary forms, with or without
 //  modification, are permitted provided that the following conditions are
@@ -32,45 +32,15 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#ifndef IECORESCENE_TAGSETALGO_H
-#define IECORESCENE_TAGSETALGO_H
 
-#include "IECoreScene/SceneInterface.h"
+#ifndef IECORESCENEMODULE_SCENEBVHBINDING_H
+#define IECORESCENEMODULE_SCENEBVHBINDING_H
 
-namespace IECoreScene
+namespace IECoreSceneModule
 {
-	namespace Private
-	{
-		void loadSetWalk( const IECoreScene::SceneInterface *scene, const IECore::InternedString &setName, IECore::PathMatcher &set, const SceneInterface::Path &path )
-		{
-			if( scene->hasTag( setName, SceneInterface::LocalTag ) )
-			{
-				set.addPath( path );
-			}
 
-			// Figure out if we need to recurse by querying descendant tags to see if they include
-			// anything we're interested in.
+void bindSceneBVH();
 
-			if( !scene->hasTag( setName, SceneInterface::DescendantTag ) )
-			{
-				return;
-			}
+}
 
-			// Recurse to the children.
-
-			SceneInterface::NameList childNames;
-			scene->childNames( childNames );
-			SceneInterface::Path childPath( path );
-			childPath.push_back( IECore::InternedString() ); // room for the child name
-			for( SceneInterface::NameList::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
-			{
-				ConstSceneInterfacePtr child = scene->child( *it );
-				childPath.back() = *it;
-				loadSetWalk( child.get(), setName, set, childPath );
-			}
-		}
-	} // private
-
-} // IECoreScene
-
-#endif //IECORESCENE_TAGSETALGO_H
+#endif // IECORESCENEMODULE_SCENEBVHBINDING_H
@@ -40,6 +40,7 @@
 #include "IECoreScene/ShaderNetwork.h"
 
 #include "IECorePython/RunTimeTypedBinding.h"
+#include "IECorePython/ScopedGILRelease.h"
 
 using namespace boost::python;
 using namespace IECore;
@@ -128,6 +129,38 @@ ShaderPtr outputShader( const ShaderNetwork &network )
 	return s ? s->copy() : nullptr;
 }
 
+boost::python::list substitutedNetworks( const ShaderNetwork &network, object pythonAttributeSets )
+{
+	std::vector<ConstCompoundObjectPtr> attributeSetOwners;
+	std::vector<const CompoundObject *> attributeSets;
+	for( stl_input_iterator<ConstCompoundObjectPtr> it( pythonAttributeSets ), eIt; it != eIt; ++it )
+	{
+		attributeSetOwners.push_back( *it );
+		attributeSets.push_back( it->get() );
+	}
+
+	std::vector<ConstShaderNetworkPtr> networks;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		networks = network.substitutedNetworks( attributeSets );
+	}
+
+	// Networks are returned as copies, as elsewhere, but we copy each
+	// unique network only once so that sharing is preserved in Python.
+	std::map<const ShaderNetwork *, object> copies;
+	boost::python::list result;
+	for( const auto &n : networks )
+	{
+		auto it = copies.find( n.get() );
+		if( it == copies.end() )
+		{
+			it = copies.insert( { n.get(), object( n->copy() ) } ).first;
+		}
+		result.append( it->second );
+	}
+	return result;
+}
+
 
 const char *parameterShaderGet( const ShaderNetwork::Parameter &p )
 {
@@ -334,12 +367,62 @@ void testShaderNetworkMove()
 
 }
 
+void testShaderNetworkSharing()
+{
+	ShaderNetworkPtr shaderNetwork = new ShaderNetwork;
+	shaderNetwork->addShader( "s1", ShaderPtr( new Shader( "a" ) ) );
+	shaderNetwork->addShader( "s2", ShaderPtr( new Shader( "b" ) ) );
+	shaderNetwork->addConnection( ShaderNetwork::Connection( ShaderNetwork::Parameter( "s2", "out" ), ShaderNetwork::Parameter( "s1", "in" ) ) );
+	shaderNetwork->setOutput( ShaderNetwork::Parameter( "s1" ) );
+	const MurmurHash hash = shaderNetwork->hash();
+
+	// Copies share their shaders.
+
+	ShaderNetworkPtr copy = shaderNetwork->copy();
+	if( copy->getShader( "s1" ) != shaderNetwork->getShader( "s1" ) || copy->getShader( "s2" ) != shaderNetwork->getShader( "s2" ) )
+	{
+		throw Exception( "ShaderNetwork::copy() : Shaders not shared" );
+	}
+
+	// Editing a copy replaces only the edited shader, and doesn't affect
+	// the original.
+
+	copy->setShader( "s1", ShaderPtr( new Shader( "c" ) ) );
+	if( copy->getShader( "s2" ) != shaderNetwork->getShader( "s2" ) )
+	{
+		throw Exception( "ShaderNetwork::setShader() : Unedited shader not shared" );
+	}
+	if( copy->hash() == hash || shaderNetwork->hash() != hash )
+	{
+		throw Exception( "ShaderNetwork::setShader() : Unexpected hash" );
+	}
+
+	// Shaders added from another network are shared.
+
+	ShaderNetworkPtr added = new ShaderNetwork;
+	const InternedString handle = added->addShader( "s1", shaderNetwork.get(), "s1" );
+	if( added->getShader( handle ) != shaderNetwork->getShader( "s1" ) )
+	{
+		throw Exception( "ShaderNetwork::addShader() : Shader not shared" );
+	}
+
+	// And hash the same as copied shaders.
+
+	ShaderNetworkPtr copied = new ShaderNetwork;
+	copied->addShader( "s1", shaderNetwork->getShader( "s1" ) );
+	if( added->hash() != copied->hash() )
+	{
+		throw Exception( "ShaderNetwork::addShader() : Shared shader hashes differently" );
+	}
+}
+
 } // namespace
 
 void IECoreSceneModule::bindShaderNetwork()
 {
 
 	def( "testShaderNetworkMove", &testShaderNetworkMove );
+	def( "testShaderNetworkSharing", &testShaderNetworkSharing );
 
 	scope shaderNetworkScope = RunTimeTypedClass<ShaderNetwork>()
 		.def( init<>() )
@@ -361,6 +444,7 @@ void IECoreSceneModule::bindShaderNetwork()
 		.def( "outputConnections", &outputConnections )
 		.def( "hashSubstitutions", &ShaderNetwork::hashSubstitutions )
 		.def( "applySubstitutions", &ShaderNetwork::applySubstitutions )
+		.def( "substitutedNetworks", &substitutedNetworks )
 	;
 
 	class_<ShaderNetwork::Parameter>( "Parameter" )
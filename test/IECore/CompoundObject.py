@@ -223,6 +223,50 @@ class testCompoundObject( unittest.TestCase ) :
 				self.assertEqual( h, o.hash() )
 			h = o.hash()
 
+	def testTypicalAttributeSets( self ) :
+
+		# Exercises load, copy, hash and lookup for many small
+		# attribute sets, such as are found at scene locations.
+		# Uncomment the prints to get timings.
+
+		attributeNames = [ "attribute%d" % i for i in range( 0, 40 ) ]
+		objects = []
+		for i in range( 0, 1000 ) :
+			o = IECore.CompoundObject()
+			for j, name in enumerate( attributeNames ) :
+				if ( i + j ) % 3 :
+					o[name] = IECore.IntData( i + j )
+				else :
+					o[name] = IECore.CompoundData( { "value" : IECore.FloatData( j ), "name" : name } )
+			objects.append( o )
+
+		t = IECore.Timer()
+		copies = [ o.copy() for o in objects ]
+		#print "COPY", t.stop()
+		self.assertEqual( copies, objects )
+
+		t = IECore.Timer()
+		hashes = [ o.hash() for o in objects ]
+		#print "HASH", t.stop()
+		self.assertEqual( hashes, [ o.hash() for o in copies ] )
+
+		io = IECore.MemoryIndexedIO( IECore.CharVectorData(), [], IECore.IndexedIO.OpenMode.Write )
+		for i, o in enumerate( objects ) :
+			o.save( io, str( i ) )
+
+		io = IECore.MemoryIndexedIO( io.buffer(), [], IECore.IndexedIO.OpenMode.Read )
+		t = IECore.Timer()
+		loaded = [ IECore.Object.load( io, str( i ) ) for i in range( 0, len( objects ) ) ]
+		#print "LOAD", t.stop()
+		self.assertEqual( loaded, objects )
+		self.assertEqual( [ o.hash() for o in loaded ], hashes )
+
+		t = IECore.Timer()
+		for o in loaded :
+			for name in attributeNames :
+				self.assertTrue( name in o )
+		#print "LOOKUP", t.stop()
+
 if __name__ == "__main__":
         unittest.main()
 
@@ -35,6 +35,7 @@
 
 """Unit test for IndexedIO binding"""
 import os
+import shutil
 import unittest
 import math
 import random
@@ -670,6 +671,162 @@ class TestFileIndexedIO(unittest.TestCase):
 		self.assertEqual( f.metadata(),
 			IECore.CompoundData( { "compressor" : "lz4", "compressionLevel" : 0, 'version': IECore.IntData( 7 ), "compressionThreadCount" : 1, "decompressionThreadCount" : 1 } ) )
 
+	def __writeCompressible( self, options, hint = None ) :
+
+		filePath = "./test/FileIndexedIO.fio"
+		f = IECore.IndexedIO.create( filePath, [], IECore.IndexedIO.OpenMode.Write, options = options )
+		if hint is not None :
+			f.setCompressionHint( hint )
+		g = f.subdirectory( "sub1", IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+
+		d = IECore.DoubleVectorData( [ i * 0.001 for i in range( 4096 ) ] )
+		for b in range( 64 ) :
+			g.write( "foo_" + str( b ), IECore.DoubleVectorData( [ x + b for x in d ] ) )
+
+		del g, f
+
+		f = IECore.IndexedIO.create( filePath, [], IECore.IndexedIO.OpenMode.Read )
+		g = f.subdirectory( "sub1" )
+		for b in range( 64 ) :
+			self.assertEqual( g.read( "foo_" + str( b ) ), IECore.DoubleVectorData( [ x + b for x in d ] ) )
+
+		return os.path.getsize( filePath ), f.metadata()
+
+	def testCompressionHintsOption( self ) :
+
+		uncompressedSize = self.__writeCompressible( IECore.CompoundData() )[0]
+		hintedSize = self.__writeCompressible(
+			IECore.CompoundData( {
+				"compressionHints" : IECore.CompoundData( {
+					"sub1" : IECore.CompoundData( { "compressor" : "zlib", "compressionLevel" : 9 } ),
+				} )
+			} )
+		)[0]
+
+		self.assertLess( hintedSize, uncompressedSize / 2 )
+
+	def testSetCompressionHint( self ) :
+
+		hint = IECore.StreamIndexedIO.CompressionHint()
+		self.assertEqual( hint.compressor, "" )
+		self.assertEqual( hint.compressionLevel, -1 )
+		self.assertEqual( hint.shuffle, IECore.StreamIndexedIO.CompressionHint.Shuffle.DefaultShuffle )
+
+		hint.compressor = "lz4"
+		hint.compressionLevel = 9
+
+		f = IECore.IndexedIO.create( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
+		f.setCompressionHint( hint )
+		self.assertEqual( f.getCompressionHint(), hint )
+		self.assertEqual( f.subdirectory( "sub1", IECore.IndexedIO.MissingBehaviour.CreateIfMissing ).getCompressionHint(), hint )
+		self.assertEqual( f.createSubdirectory( "sub2" ).getCompressionHint(), hint )
+		del f
+
+		uncompressedSize = self.__writeCompressible( IECore.CompoundData() )[0]
+		hintedSize = self.__writeCompressible( IECore.CompoundData(), hint )[0]
+
+		self.assertLess( hintedSize, uncompressedSize / 2 )
+
+	def testShuffleUsesElementSize( self ) :
+
+		options = IECore.CompoundData( { "compressor" : "lz4", "compressionLevel" : 9, "shuffle" : "none" } )
+		unshuffledSize = self.__writeCompressible( options )[0]
+
+		options["shuffle"] = IECore.StringData( "byte" )
+		shuffledSize = self.__writeCompressible( options )[0]
+
+		self.assertLess( shuffledSize, unshuffledSize )
+
+		# Shuffling the doubles on a single byte boundary is a no-op, so
+		# the benefit must come from using the 8 byte element size.
+		hint = IECore.StreamIndexedIO.CompressionHint()
+		hint.typeSize = 1
+		byteElementSize = self.__writeCompressible( options, hint )[0]
+
+		self.assertLess( shuffledSize, byteElementSize )
+
+		hint.typeSize = 8
+		self.assertEqual( self.__writeCompressible( options, hint )[0], shuffledSize )
+
+	def testMinCompressedBlockSize( self ) :
+
+		filePath = "./test/FileIndexedIO.fio"
+		sizes = []
+		for minSize in ( 1024, 0 ) :
+			options = IECore.CompoundData( { "compressor" : "lz4", "compressionLevel" : 9, "minCompressedBlockSize" : IECore.UIntData( minSize ) } )
+			f = IECore.IndexedIO.create( filePath, [], IECore.IndexedIO.OpenMode.Write, options = options )
+			for b in range( 256 ) :
+				f.write( "foo_" + str( b ), IECore.IntVectorData( [ b ] * 128 ) )
+			del f
+			sizes.append( os.path.getsize( filePath ) )
+
+		self.assertLess( sizes[1], sizes[0] )
+
+	def testAutoTune( self ) :
+
+		size, metadata = self.__writeCompressible( IECore.CompoundData( { "compressionLevel" : 5, "autoTune" : True } ) )
+		self.assertIn( metadata["compressor"].value, [ "blosclz", "lz4", "lz4hc", "snappy", "zlib" ] )
+
+		uncompressedSize = self.__writeCompressible( IECore.CompoundData() )[0]
+		self.assertLess( size, uncompressedSize / 2 )
+
+	def testBlockStore( self ) :
+
+		storePath = "./test/blockStore"
+		options = IECore.CompoundData( { "blockStore" : storePath } )
+
+		d = IECore.FloatVectorData( [ random.random() for i in range( 16384 ) ] )
+		small = IECore.IntVectorData( range( 10 ) )
+		for fileName in ( "./test/FileIndexedIO.fio", "./test/FileIndexedIO2.fio" ) :
+			f = IECore.IndexedIO.create( fileName, [], IECore.IndexedIO.OpenMode.Write, options = options )
+			f.subdirectory( "sub1", IECore.IndexedIO.MissingBehaviour.CreateIfMissing ).write( "foo", d )
+			f.write( "small", small )
+			del f
+
+			# The large block is held in the store, not the file.
+			self.assertLess( os.path.getsize( fileName ), 4096 )
+
+		# Both files share a single copy of the block.
+		counts = IECore.IndexedIOBlockStore( storePath ).referenceCounts()
+		self.assertEqual( counts.values(), [ 2 ] )
+
+		for fileName in ( "./test/FileIndexedIO.fio", "./test/FileIndexedIO2.fio" ) :
+			f = IECore.IndexedIO.create( fileName, [], IECore.IndexedIO.OpenMode.Read )
+			self.assertEqual( f.metadata()["version"], IECore.IntData( 8 ) )
+			self.assertEqual( f.subdirectory( "sub1" ).read( "foo" ), d )
+			self.assertEqual( f.subdirectory( "sub1" ).entry( "foo" ).arrayLength(), len( d ) )
+			self.assertEqual( f.read( "small" ), small )
+
+		store = IECore.IndexedIOBlockStore( storePath )
+		os.remove( "./test/FileIndexedIO2.fio" )
+		self.assertEqual( store.compact(), 0 )
+		self.assertEqual( store.referenceCounts().values(), [ 1 ] )
+		self.assertEqual( len( store.getReferences( "./test/FileIndexedIO.fio" ) ), 1 )
+
+		os.remove( "./test/FileIndexedIO.fio" )
+		self.assertEqual( IECore.IndexedIOBlockStoreCompactOp()( store = storePath ).value, 16384 * 4 / ( 1024.0 * 1024.0 ) )
+		self.assertEqual( store.referenceCounts(), {} )
+
+	def testRelativeBlockStorePath( self ) :
+
+		options = IECore.CompoundData( { "blockStore" : "./test/blockStore" } )
+		d = IECore.FloatVectorData( [ random.random() for i in range( 16384 ) ] )
+
+		f = IECore.IndexedIO.create( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write, options = options )
+		f.write( "foo", d )
+		del f
+
+		# The store must be found without relying on the working directory
+		# the file was written from.
+		fileName = os.path.abspath( "./test/FileIndexedIO.fio" )
+		cwd = os.getcwd()
+		os.chdir( os.path.dirname( fileName ) )
+		try :
+			f = IECore.IndexedIO.create( fileName, [], IECore.IndexedIO.OpenMode.Read )
+			self.assertEqual( f.read( "foo" ), d )
+		finally :
+			os.chdir( cwd )
+
 	def setUp( self ):
 
 		if os.path.isfile("./test/FileIndexedIO.fio") :
@@ -678,8 +835,12 @@ class TestFileIndexedIO(unittest.TestCase):
 	def tearDown(self):
 
 		# cleanup
-		if os.path.isfile("./test/FileIndexedIO.fio") :
-			os.remove("./test/FileIndexedIO.fio")
+		for f in ( "./test/FileIndexedIO.fio", "./test/FileIndexedIO2.fio" ) :
+			if os.path.isfile( f ) :
+				os.remove( f )
+
+		if os.path.isdir( "./test/blockStore" ) :
+			shutil.rmtree( "./test/blockStore" )
 
 
 if __name__ == "__main__":
@@ -174,6 +174,36 @@ class TestIndexedIOAlgo( unittest.TestCase ) :
 		self.assertEqual( s.read( "stringS" ), IECore.StringData( "foo" ) )
 		self.assertEqual( s.read( "stringA" ), IECore.StringVectorData( ["foo_0", "foo_1", "foo_2"] ) )
 
+	def testCopyPreservesStructureAndOrder( self ) :
+
+		self.makeManyDirectoryTestFile()
+
+		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Append )
+		f.subdirectory( "empty", IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
+		f.subdirectory( "sub_1" ).subdirectory( "nested", IECore.IndexedIO.MissingBehaviour.CreateIfMissing ).write( "s", "nestedString" )
+		del f
+
+		src = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Read )
+
+		def copy( threads ) :
+			dst = IECore.FileIndexedIO( "./test/FileIndexedIO2.fio", [], IECore.IndexedIO.OpenMode.Write )
+			with IECore.tbb_task_scheduler_init( threads ) as taskScheduler :
+				IECore.IndexedIOAlgo.copy( src, dst )
+			del dst
+			with open( "./test/FileIndexedIO2.fio", "rb" ) as f :
+				return f.read()
+
+		# files are written in a fixed order, regardless of the number of threads
+		self.assertEqual( copy( 1 ), copy( 8 ) )
+
+		dst = IECore.FileIndexedIO( "./test/FileIndexedIO2.fio", [], IECore.IndexedIO.OpenMode.Read )
+		self.assertEqual( sorted( dst.entryIds() ), sorted( src.entryIds() ) )
+		self.assertEqual( dst.subdirectory( "empty" ).entryIds(), [] )
+		self.assertEqual( dst.subdirectory( "sub_1" ).subdirectory( "nested" ).read( "s" ), IECore.StringData( "nestedString" ) )
+		for d in range( 512 ) :
+			name = "sub_{0}".format( d )
+			self.assertEqual( dst.subdirectory( name ).read( "myFloatVector" ), src.subdirectory( name ).read( "myFloatVector" ) )
+
 	def testStringFileStats( self ) :
 		f = IECore.FileIndexedIO( "./test/FileIndexedIO.fio", [], IECore.IndexedIO.OpenMode.Write )
 		s = f.subdirectory( "sub", IECore.IndexedIO.MissingBehaviour.CreateIfMissing )
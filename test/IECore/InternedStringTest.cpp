@@ -42,7 +42,9 @@
 
 #include "tbb/tbb.h"
 
+#include <atomic>
 #include <iostream>
+#include <vector>
 
 using namespace boost;
 using namespace boost::unit_test;
@@ -81,6 +83,95 @@ struct InternedStringTest
 		parallel_for( blocked_range<size_t>( 0, numIterations ), Constructor(), taskGroupContext );
 	}
 
+	void testContendedConstruction()
+	{
+		// Many threads interning a mix of new and existing
+		// strings, to exercise the locking in the table.
+		const size_t numThreads = 64;
+		const size_t numIterations = 1000000;
+		const size_t numStrings = 50000;
+
+		std::vector<InternedString> results( numStrings );
+		// Boost.Test assertions aren't thread-safe, so we
+		// count failures and check them afterwards.
+		std::atomic<size_t> failures( 0 );
+		tbb::task_arena arena( numThreads );
+		arena.execute(
+			[&]() {
+				tbb::task_group_context taskGroupContext( tbb::task_group_context::isolated );
+				parallel_for(
+					blocked_range<size_t>( 0, numIterations ),
+					[&]( const blocked_range<size_t> &r ) {
+						for( size_t i=r.begin(); i!=r.end(); ++i )
+						{
+							const size_t index = ( i * 7919 ) % numStrings;
+							const std::string s = "contended" + lexical_cast<std::string>( index );
+							InternedString ss( s );
+							if( ss.string() != s )
+							{
+								failures++;
+							}
+							if( i < numStrings )
+							{
+								results[index] = ss;
+							}
+						}
+					},
+					taskGroupContext
+				);
+			}
+		);
+
+		BOOST_CHECK_EQUAL( failures.load(), 0u );
+		for( size_t i = 0; i < numStrings; ++i )
+		{
+			BOOST_CHECK( results[i] == InternedString( "contended" + lexical_cast<std::string>( i ) ) );
+		}
+	}
+
+	void testBulkInterning()
+	{
+		// The numbered strings are unique to this test, and the
+		// others are interned up front, so that the count of new
+		// strings doesn't depend on which tests have run before.
+		std::vector<std::string> strings;
+		for( size_t i = 0; i < 10000; ++i )
+		{
+			strings.push_back( "testBulkInterning" + lexical_cast<std::string>( i % 5000 ) );
+		}
+		strings.push_back( "" );
+		strings.push_back( "aa" );
+
+		InternedString( "" );
+		InternedString( "aa" );
+		const size_t numUniqueStrings = InternedString::numUniqueStrings();
+
+		std::vector<InternedString> results( strings.size() );
+		InternedString::internStrings( strings.data(), strings.data() + strings.size(), results.data() );
+
+		BOOST_CHECK_EQUAL( InternedString::numUniqueStrings(), numUniqueStrings + 5000 );
+		for( size_t i = 0; i < strings.size(); ++i )
+		{
+			BOOST_CHECK( results[i].string() == strings[i] );
+			BOOST_CHECK( results[i] == InternedString( strings[i] ) );
+		}
+
+		const char *chars = "aabbaa";
+		const InternedString::StringRange ranges[] = {
+			InternedString::StringRange( chars, 2 ),
+			InternedString::StringRange( chars, 4 ),
+			InternedString::StringRange( chars + 4, 2 ),
+			InternedString::StringRange( chars, 0 ),
+		};
+
+		InternedString rangeResults[4];
+		InternedString::internStrings( ranges, ranges + 4, rangeResults );
+		BOOST_CHECK_EQUAL( rangeResults[0], InternedString( "aa" ) );
+		BOOST_CHECK_EQUAL( rangeResults[1], InternedString( "aabb" ) );
+		BOOST_CHECK_EQUAL( rangeResults[2], InternedString( "aa" ) );
+		BOOST_CHECK_EQUAL( rangeResults[3], InternedString() );
+	}
+
 	void testRangeConstruction()
 	{
 
@@ -108,6 +199,8 @@ struct InternedStringTestSuite : public boost::unit_test::test_suite
 
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testConcurrentConstruction, instance ) );
 		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testRangeConstruction, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testContendedConstruction, instance ) );
+		add( BOOST_CLASS_TEST_CASE( &InternedStringTest::testBulkInterning, instance ) );
 
 	}
 };
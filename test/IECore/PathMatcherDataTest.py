@@ -34,6 +34,7 @@
 #
 ##########################################################################
 
+import os
 import unittest
 
 import IECore
@@ -130,5 +131,64 @@ class PathMatcherDataTest( unittest.TestCase ) :
 
 		self.assertEqual( d, d2 )
 
+	def testSaveAndLoadStructure( self ) :
+
+		for paths in [
+			[],
+			[ "/" ],
+			[ "/", "/a/b" ],
+			[ "/a/b/c", "/a/b/*", "/a/.../c", "/x*/y", "/x/y", "/z" ],
+			[ "/a/b/c/d/e/f", "/a/b/c/d/e/g", "/a/h", "/i/j/k", "/i/j" ],
+		] :
+
+			d = IECore.PathMatcherData( IECore.PathMatcher( paths ) )
+
+			saveIO = IECore.MemoryIndexedIO( IECore.CharVectorData(), IECore.IndexedIO.OpenMode.Write )
+			d.save( saveIO, "d" )
+
+			loadIO = IECore.MemoryIndexedIO( saveIO.buffer(), IECore.IndexedIO.OpenMode.Read )
+			d2 = IECore.Object.load( loadIO, "d" )
+
+			self.assertEqual( d, d2 )
+			self.assertEqual( d.hash(), d2.hash() )
+			self.assertEqual( sorted( d2.value.paths() ), sorted( d.value.paths() ) )
+			for path in [ "/", "/a", "/a/b", "/a/b/c", "/a/b/q", "/a/q/c", "/xx/y", "/z/w" ] :
+				self.assertEqual( d2.value.match( path ), d.value.match( path ) )
+
+			# Loaded matchers must remain editable.
+			self.assertTrue( d2.value.addPath( "/new/path" ) )
+			self.assertEqual( d2.value.match( "/new/path" ), IECore.PathMatcher.Result.ExactMatch )
+			self.assertTrue( d2.value.removePath( "/new/path" ) )
+			self.assertEqual( d, d2 )
+
+	@unittest.skipUnless( os.environ.get("CORTEX_PERFORMANCE_TEST", False), "'CORTEX_PERFORMANCE_TEST' env var not set" )
+	def testLoadPerformance( self ) :
+
+		# Build a set of 10 million paths by prefixing a block
+		# of leaves, which is much quicker than adding each path
+		# individually from Python.
+
+		leaves = IECore.PathMatcher( [ "/leaf{}".format( i ) for i in range( 0, 1000 ) ] )
+
+		branches = IECore.PathMatcher()
+		for i in range( 0, 100 ) :
+			branches.addPaths( leaves, IECore.InternedStringVectorData( [ "branch{}".format( i ) ] ) )
+
+		m = IECore.PathMatcher()
+		for i in range( 0, 100 ) :
+			m.addPaths( branches, IECore.InternedStringVectorData( [ "trunk{}".format( i ) ] ) )
+
+		d = IECore.PathMatcherData( m )
+		saveIO = IECore.MemoryIndexedIO( IECore.CharVectorData(), IECore.IndexedIO.OpenMode.Write )
+		d.save( saveIO, "d" )
+
+		loadIO = IECore.MemoryIndexedIO( saveIO.buffer(), IECore.IndexedIO.OpenMode.Read )
+		t = IECore.Timer( True, IECore.Timer.Mode.WallClock )
+		d2 = IECore.Object.load( loadIO, "d" )
+		#print "LOAD", t.stop()
+
+		self.assertEqual( d2.value.size(), 10000000 )
+		self.assertEqual( d, d2 )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -35,6 +35,7 @@
 #
 ##########################################################################
 
+import os
 import unittest
 import random
 
@@ -976,5 +977,119 @@ class PathMatcherTest( unittest.TestCase ) :
 		m.clear()
 		self.assertEqual( m.size(), 0 )
 
+	def testFreeze( self ) :
+
+		m = IECore.PathMatcher( [
+			"/a",
+			"/a/b/c",
+			"/red*",
+			"/somewhere/over/the/*/skies/are/blue",
+			"/.../ellipsis",
+			"/x/...",
+		] )
+
+		f = m.freeze()
+		self.assertTrue( isinstance( f, IECore.FrozenPathMatcher ) )
+		self.assertEqual( f.size(), m.size() )
+		self.assertEqual( f.isEmpty(), m.isEmpty() )
+		self.assertEqual( sorted( f.paths() ), sorted( m.paths() ) )
+		self.assertEqual( f.thaw(), m )
+		self.assertEqual( f, IECore.FrozenPathMatcher( m ) )
+
+		for path in [
+			"/", "/a", "/a/b", "/a/b/c", "/a/b/c/d", "/b", "/redBoots", "/red/in/puddles",
+			"/somewhere/over/the/rainbow/skies/are/blue", "/somewhere/over/the/rainbow/skies",
+			"/ellipsis", "/some/deep/ellipsis", "/x", "/x/y/z",
+		] :
+			self.assertEqual( f.match( path ), m.match( path ), path )
+
+		empty = IECore.PathMatcher().freeze()
+		self.assertTrue( empty.isEmpty() )
+		self.assertEqual( empty.size(), 0 )
+		self.assertEqual( empty.thaw(), IECore.PathMatcher() )
+		self.assertEqual( empty, IECore.FrozenPathMatcher() )
+		self.assertEqual( empty.match( "/" ), IECore.PathMatcher.Result.NoMatch )
+
+	def testFrozenMatchEquivalence( self ) :
+
+		paths = self.generatePaths( seed = 10, depthRange = ( 3, 10 ), numChildrenRange = ( 2, 6 ) )
+		m = IECore.PathMatcher( paths[::2] )
+		f = m.freeze()
+
+		for path in paths :
+			self.assertEqual( f.match( path ), m.match( path ) )
+
+	def testFrozenFind( self ) :
+
+		m = IECore.PathMatcher( [ "/a/b/c", "/a/b/*" ] )
+		f = m.freeze()
+
+		for path, exists, exactMatch in [
+			( "/", True, False ),
+			( "/a", True, False ),
+			( "/a/b", True, False ),
+			( "/a/b/c", True, True ),
+			( "/a/b/*", True, True ),
+			( "/a/b/d", False, False ),
+			( "/z", False, False ),
+		] :
+			path = IECore.InternedStringVectorData( path.split( "/" )[1:] if path != "/" else [] )
+			location = f.find( path )
+			self.assertEqual( location != f.npos, exists )
+			if exists :
+				self.assertEqual( f.exactMatch( location ), exactMatch )
+
+		self.assertEqual( IECore.FrozenPathMatcher().find( IECore.InternedStringVectorData() ), IECore.FrozenPathMatcher.npos )
+
+	def testFrozenSetOperations( self ) :
+
+		paths = self.generatePaths( seed = 3, depthRange = ( 2, 6 ), numChildrenRange = ( 4, 12 ) )
+		random.seed( 5 )
+
+		for i in range( 0, 10 ) :
+
+			m1 = IECore.PathMatcher( random.sample( paths, len( paths ) // 2 ) + [ "/a/*", "/.../b" ] )
+			m2 = IECore.PathMatcher( random.sample( paths, len( paths ) // 2 ) + [ "/a/*" ] )
+			f1 = m1.freeze()
+			f2 = m2.freeze()
+
+			union = IECore.PathMatcher( m1 )
+			union.addPaths( m2 )
+			self.assertEqual( f1.unionWith( f2 ), union.freeze() )
+			self.assertEqual( f1.unionWith( f2 ).thaw(), union )
+			self.assertEqual( f1.unionWith( f2 ).size(), union.size() )
+
+			difference = IECore.PathMatcher( m1 )
+			difference.removePaths( m2 )
+			self.assertEqual( f1.difference( f2 ), difference.freeze() )
+			self.assertEqual( f1.difference( f2 ).thaw(), difference )
+			self.assertEqual( f1.difference( f2 ).size(), difference.size() )
+
+			intersection = m1.intersection( m2 )
+			self.assertEqual( f1.intersection( f2 ), intersection.freeze() )
+			self.assertEqual( f1.intersection( f2 ).thaw(), intersection )
+			self.assertEqual( f1.intersection( f2 ).size(), intersection.size() )
+
+		self.assertTrue( f1.intersection( IECore.FrozenPathMatcher() ).isEmpty() )
+		self.assertTrue( f1.difference( f1 ).isEmpty() )
+		self.assertEqual( f1.unionWith( IECore.FrozenPathMatcher() ), f1 )
+
+	@unittest.skipUnless( os.environ.get("CORTEX_PERFORMANCE_TEST", False), "'CORTEX_PERFORMANCE_TEST' env var not set" )
+	def testFrozenMatchPerformance( self ) :
+
+		paths = self.generatePaths( seed = 10, depthRange = ( 3, 14 ), numChildrenRange = ( 2, 6 ) )
+		m = IECore.PathMatcher( paths )
+		f = m.freeze()
+
+		t = IECore.Timer( True, IECore.Timer.Mode.WallClock )
+		for path in paths :
+			m.match( path )
+		#print "MATCH", t.stop()
+
+		t = IECore.Timer( True, IECore.Timer.Mode.WallClock )
+		for path in paths :
+			f.match( path )
+		#print "FROZEN MATCH", t.stop()
+
 if __name__ == "__main__":
 	unittest.main()
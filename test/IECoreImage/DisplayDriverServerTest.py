@@ -58,6 +58,19 @@ class DisplayDriverServerTest( unittest.TestCase ) :
 		self.assertNotEqual( s4.portNumber(), 0 )
 		self.assertNotEqual( s4.portNumber(), s3.portNumber() )
 
+	def testThreads( self ) :
+
+		s = IECoreImage.DisplayDriverServer()
+		self.assertEqual( s.numThreads(), 1 )
+		self.assertFalse( s.coalesceBuckets() )
+
+		s = IECoreImage.DisplayDriverServer( numThreads = 3, coalesceBuckets = True )
+		self.assertEqual( s.numThreads(), 3 )
+		self.assertTrue( s.coalesceBuckets() )
+
+		s = IECoreImage.DisplayDriverServer( numThreads = 0 )
+		self.assertEqual( s.numThreads(), IECore.hardwareConcurrency() )
+
 if __name__ == "__main__":
 	unittest.main()
 
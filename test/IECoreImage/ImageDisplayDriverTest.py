@@ -39,6 +39,9 @@ import gc
 import glob
 import sys
 import time
+import socket
+import struct
+import threading
 import imath
 import IECore
 import IECoreImage
@@ -138,6 +141,60 @@ class ImageDisplayDriverTest(unittest.TestCase):
 		i = dd.image()
 		self.assertEqual( i["Y"], y )
 
+	def testTileUpdateCounts( self ) :
+
+		dataWindow = imath.Box2i( imath.V2i( 10, 20 ), imath.V2i( 209, 99 ) )
+		dd = IECoreImage.ImageDisplayDriver( dataWindow, dataWindow, [ "R", "G", "B", "A" ], IECore.CompoundData() )
+
+		tileSize = IECoreImage.ImageDisplayDriver.tileSize()
+		numTiles = dd.numTiles()
+		self.assertEqual( numTiles, imath.V2i( ( 200 + tileSize - 1 ) // tileSize, ( 80 + tileSize - 1 ) // tileSize ) )
+
+		bounds = []
+		for y in range( 0, numTiles.y ) :
+			for x in range( 0, numTiles.x ) :
+				self.assertEqual( dd.tileUpdateCount( imath.V2i( x, y ) ), 0 )
+				bound = dd.tileBound( imath.V2i( x, y ) )
+				self.assertTrue( IECore.BoxAlgo.contains( dataWindow, bound ) )
+				bounds.append( bound )
+
+		# Tiles cover the data window exactly
+		self.assertEqual( sum( [ ( b.size().x + 1 ) * ( b.size().y + 1 ) for b in bounds ] ), 200 * 80 )
+
+		self.assertRaises( Exception, dd.tileUpdateCount, numTiles )
+
+		# Send a small bucket, which should only update a single tile
+		bucket = imath.Box2i( imath.V2i( 12, 22 ), imath.V2i( 15, 23 ) )
+		dd.imageData( bucket, IECore.FloatVectorData( [ 1 ] * 4 * 2 * 4 ) )
+		for y in range( 0, numTiles.y ) :
+			for x in range( 0, numTiles.x ) :
+				self.assertEqual( dd.tileUpdateCount( imath.V2i( x, y ) ), 1 if x == 0 and y == 0 else 0 )
+
+		# And a full bucket, which should update all of them
+		dd.imageData( dataWindow, IECore.FloatVectorData( [ 0.5 ] * 200 * 80 * 4 ) )
+		for y in range( 0, numTiles.y ) :
+			for x in range( 0, numTiles.x ) :
+				self.assertEqual( dd.tileUpdateCount( imath.V2i( x, y ) ), 2 if x == 0 and y == 0 else 1 )
+
+		dd.imageClose()
+		for c in [ "R", "G", "B", "A" ] :
+			self.assertEqual( dd.image()[c], IECore.FloatVectorData( [ 0.5 ] * 200 * 80 ) )
+
+	def testManyChannels( self ) :
+
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 299, 199 ) )
+		channelNames = [ "c%d" % i for i in range( 0, 7 ) ]
+		dd = IECoreImage.ImageDisplayDriver( window, window, channelNames, IECore.CompoundData() )
+
+		# Interleaved data, large enough to be deinterleaved in parallel
+		data = IECore.FloatVectorData( [ float( i % 7 ) + i // 7 for i in range( 0, 300 * 200 * 7 ) ] )
+		dd.imageData( window, data )
+		dd.imageClose()
+
+		image = dd.image()
+		for c, name in enumerate( channelNames ) :
+			self.assertEqual( image[name], IECore.FloatVectorData( [ float( c ) + p for p in range( 0, 300 * 200 ) ] ) )
+
 class ClientServerDisplayDriverTest(unittest.TestCase):
 
 	def setUp( self ):
@@ -262,6 +319,268 @@ class ClientServerDisplayDriverTest(unittest.TestCase):
 		i = IECoreImage.ImageDisplayDriver.removeStoredImage( "myHandle" )
 		self.assertEqual( i["Y"], y )
 
+	def __openBuckets( self, window, parameters ) :
+
+		p = IECore.CompoundData( {
+			"displayHost" : "localhost",
+			"displayPort" : "1559",
+			"remoteDisplayType" : "ImageDisplayDriver",
+			"handle" : "myHandle",
+		} )
+		p.update( parameters )
+
+		return IECoreImage.ClientDisplayDriver( window, window, [ "R", "G", "B", "A" ], p )
+
+	def __bucketBoxes( self, window, bucketSize = 64 ) :
+
+		for y in range( window.min().y, window.max().y + 1, bucketSize ) :
+			for x in range( window.min().x, window.max().x + 1, bucketSize ) :
+				yield imath.Box2i(
+					imath.V2i( x, y ),
+					imath.V2i( min( x + bucketSize - 1, window.max().x ), min( y + bucketSize - 1, window.max().y ) )
+				)
+
+	def __sendBucket( self, dd, box ) :
+
+		size = box.size() + imath.V2i( 1 )
+		dd.imageData( box, IECore.FloatVectorData( [ box.min().x / 1000.0, box.min().y / 1000.0, 0.5, 1 ] * ( size.x * size.y ) ) )
+
+	def __transferBuckets( self, window, parameters, bucketSize = 64 ) :
+
+		dd = self.__openBuckets( window, parameters )
+		for box in self.__bucketBoxes( window, bucketSize ) :
+			self.__sendBucket( dd, box )
+
+		usingSharedMemory = dd.usingSharedMemory()
+		dd.imageClose()
+
+		return IECoreImage.ImageDisplayDriver.removeStoredImage( parameters.get( "handle", IECore.StringData( "myHandle" ) ).value ), usingSharedMemory
+
+	def __checkBuckets( self, image, bucketSize = 64 ) :
+
+		window = image.dataWindow
+		width = window.size().x + 1
+		for y in range( window.min().y, window.max().y + 1, 17 ) :
+			for x in range( window.min().x, window.max().x + 1, 13 ) :
+				i = ( y - window.min().y ) * width + x - window.min().x
+				bx = x - ( x - window.min().x ) % bucketSize
+				by = y - ( y - window.min().y ) % bucketSize
+				self.assertAlmostEqual( image["R"][i], bx / 1000.0, 6 )
+				self.assertAlmostEqual( image["G"][i], by / 1000.0, 6 )
+				self.assertEqual( image["B"][i], 0.5 )
+				self.assertEqual( image["A"][i], 1 )
+
+	def testSharedMemory( self ) :
+
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 199, 149 ) )
+
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData() )
+		self.assertTrue( usingSharedMemory )
+		self.__checkBuckets( image )
+
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData( { "sharedMemorySize" : 0 } ) )
+		self.assertFalse( usingSharedMemory )
+		self.__checkBuckets( image )
+
+	def testSharedMemoryFallback( self ) :
+
+		# A segment too small to hold a whole bucket means that every
+		# bucket is sent over the socket instead.
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 99, 99 ) )
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData( { "sharedMemorySize" : 1024 } ) )
+		self.assertTrue( usingSharedMemory )
+		self.__checkBuckets( image )
+
+		# A segment that can only hold a couple of buckets will mix the
+		# two transports whenever the server falls behind.
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData( { "sharedMemorySize" : 64 * 64 * 4 * 4 * 2 } ) )
+		self.assertTrue( usingSharedMemory )
+		self.__checkBuckets( image )
+
+	def testSharedMemoryWithOldServer( self ) :
+
+		# Emulate a server using protocol version 2, which predates shared
+		# memory. It ignores the offer of a segment and never replies to it.
+
+		listener = socket.socket( socket.AF_INET, socket.SOCK_STREAM )
+		listener.bind( ( "localhost", 0 ) )
+		listener.listen( 1 )
+
+		messages = []
+		def receive( connection, size ) :
+			data = ""
+			while len( data ) < size :
+				chunk = connection.recv( size - len( data ) )
+				if not chunk :
+					raise RuntimeError( "Connection closed" )
+				data += chunk
+			return data
+
+		def serve() :
+			connection, address = listener.accept()
+			while True :
+				magic, version, messageType, size = struct.unpack( "<BBBI", receive( connection, 7 ) )
+				receive( connection, size )
+				messages.append( ( version, messageType ) )
+				if messageType == 1 :
+					# scanLineOrderOnly and acceptsRepeatedData
+					for reply in ( "\x00", "\x01" ) :
+						connection.sendall( struct.pack( "<BBBI", 0x82, 2, 1, 1 ) + reply )
+				elif messageType == 3 :
+					connection.sendall( struct.pack( "<BBBI", 0x82, 2, 3, 0 ) )
+					break
+			connection.close()
+
+		thread = threading.Thread( target = serve )
+		thread.daemon = True
+		thread.start()
+
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 99, 99 ) )
+		dd = self.__openBuckets( window, IECore.CompoundData( { "displayPort" : str( listener.getsockname()[1] ) } ) )
+		self.assertFalse( dd.usingSharedMemory() )
+		for box in self.__bucketBoxes( window ) :
+			self.__sendBucket( dd, box )
+		dd.imageClose()
+
+		thread.join()
+		listener.close()
+
+		# Everything was sent over the socket, using a protocol version
+		# the old server understands.
+		self.assertEqual( messages, [ ( 2, 1 ) ] + [ ( 2, 2 ) ] * 4 + [ ( 2, 3 ) ] )
+
+	def __sendSession( self, port, window, boxes, handle ) :
+
+		# Sends a complete session with a single write, so that every bucket
+		# is already waiting when the server processes the first one.
+
+		def message( messageType, payload ) :
+			return struct.pack( "<BBBI", 0x82, 2, messageType, len( payload ) ) + payload
+
+		io = IECore.MemoryIndexedIO( IECore.CharVectorData(), [], IECore.IndexedIO.OpenMode.Write )
+		IECore.Box2iData( window ).save( io, "displayWindow" )
+		IECore.Box2iData( window ).save( io, "dataWindow" )
+		IECore.StringVectorData( [ "R", "G", "B", "A" ] ).save( io, "channelNames" )
+		IECore.CompoundData( { "remoteDisplayType" : "ImageDisplayDriver", "handle" : handle } ).save( io, "parameters" )
+
+		data = message( 1, "".join( io.buffer() ) )
+		for box in boxes :
+			size = box.size() + imath.V2i( 1 )
+			pixels = [ box.min().x / 1000.0, box.min().y / 1000.0, 0.5, 1 ] * ( size.x * size.y )
+			data += message(
+				2,
+				struct.pack( "<4i", box.min().x, box.min().y, box.max().x, box.max().y ) +
+				struct.pack( "<%df" % len( pixels ), *pixels )
+			)
+		data += message( 3, "" )
+
+		connection = socket.create_connection( ( "localhost", port ) )
+		connection.sendall( data )
+
+		# Wait for the two imageOpen replies and the imageClose reply.
+		replies = ""
+		while len( replies ) < 8 + 8 + 7 :
+			chunk = connection.recv( 1024 )
+			self.assertTrue( chunk )
+			replies += chunk
+		connection.close()
+
+		return IECoreImage.ImageDisplayDriver.removeStoredImage( handle )
+
+	def testCoalesceBuckets( self ) :
+
+		server = IECoreImage.DisplayDriverServer( 0, numThreads = 2, coalesceBuckets = True )
+		self.assertEqual( server.numThreads(), 2 )
+		self.assertTrue( server.coalesceBuckets() )
+
+		port = IECore.StringData( str( server.portNumber() ) )
+		window = imath.Box2i( imath.V2i( 10, 20 ), imath.V2i( 209, 169 ) )
+
+		# Buckets which can be merged both horizontally and vertically.
+		for bucketSize in ( 16, 64 ) :
+			image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData( { "displayPort" : port } ), bucketSize )
+			self.__checkBuckets( image, bucketSize )
+
+		# Scanlines, which are merged vertically.
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData( { "displayPort" : port, "sharedMemorySize" : 0 } ), 1 )
+		self.__checkBuckets( image, 1 )
+
+		# When buckets are waiting at once, those in the same row are merged.
+		# Exactly how many are waiting depends on how the socket delivers
+		# them, so we only check that some were merged, and that no merge
+		# crossed a row.
+
+		window = imath.Box2i( imath.V2i( 10, 20 ), imath.V2i( 49, 49 ) )
+		received = server.numBucketsReceived()
+		forwarded = server.numBucketsForwarded()
+
+		image = self.__sendSession( server.portNumber(), window, list( self.__bucketBoxes( window, 8 ) ), "coalesce" )
+		self.__checkBuckets( image, 8 )
+		self.assertEqual( server.numBucketsReceived() - received, 5 * 4 )
+		self.assertLess( server.numBucketsForwarded() - forwarded, 5 * 4 )
+		self.assertGreaterEqual( server.numBucketsForwarded() - forwarded, 4 )
+
+		# And single pixels are merged into rows.
+
+		received = server.numBucketsReceived()
+		forwarded = server.numBucketsForwarded()
+
+		image = self.__sendSession( server.portNumber(), window, list( self.__bucketBoxes( window, 1 ) ), "coalesce" )
+		self.__checkBuckets( image, 1 )
+		self.assertEqual( server.numBucketsReceived() - received, 40 * 30 )
+		self.assertLess( server.numBucketsForwarded() - forwarded, 40 * 30 )
+		self.assertGreaterEqual( server.numBucketsForwarded() - forwarded, 30 )
+
+		# Without coalescing, every bucket is forwarded.
+
+		server = IECoreImage.DisplayDriverServer( 0 )
+		image = self.__sendSession( server.portNumber(), window, list( self.__bucketBoxes( window, 8 ) ), "coalesce" )
+		self.__checkBuckets( image, 8 )
+		self.assertEqual( server.numBucketsReceived(), 5 * 4 )
+		self.assertEqual( server.numBucketsForwarded(), 5 * 4 )
+
+	def testConcurrentSessions( self ) :
+
+		server = IECoreImage.DisplayDriverServer( 0, numThreads = 4 )
+		self.assertEqual( server.numThreads(), 4 )
+
+		port = IECore.StringData( str( server.portNumber() ) )
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 299, 199 ) )
+
+		drivers = [
+			self.__openBuckets( window, IECore.CompoundData( { "displayPort" : port, "handle" : "concurrent%d" % i } ) )
+			for i in range( 0, 4 )
+		]
+
+		for box in self.__bucketBoxes( window, 32 ) :
+			for dd in drivers :
+				self.__sendBucket( dd, box )
+
+		for dd in drivers :
+			dd.imageClose()
+
+		for i in range( 0, 4 ) :
+			image = IECoreImage.ImageDisplayDriver.removeStoredImage( "concurrent%d" % i )
+			self.__checkBuckets( image, 32 )
+
+	def testSharedMemoryThroughput( self ) :
+
+		# Uncomment the prints to compare the bucket throughput of the
+		# socket and shared memory transports.
+
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 1919, 1079 ) )
+
+		t = IECore.Timer()
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData( { "sharedMemorySize" : 0 } ) )
+		#print "SOCKET", t.stop()
+		self.assertFalse( usingSharedMemory )
+
+		t = IECore.Timer()
+		image, usingSharedMemory = self.__transferBuckets( window, IECore.CompoundData() )
+		#print "SHARED MEMORY", t.stop()
+		self.assertTrue( usingSharedMemory )
+		self.__checkBuckets( image )
+
 	def tearDown( self ):
 
 		self.server = None
@@ -192,6 +192,80 @@ class ImageReaderTest( unittest.TestCase ) :
 			cd = r.readChannel( c )
 			self.assertEqual( i[c], cd )
 
+	def testReadRegion( self ) :
+
+		r = IECoreImage.ImageReader( "test/IECoreImage/data/exr/uvMapWithDataWindow.100x100.exr" )
+		i = r.read()
+		dataWindow = r.dataWindow()
+		width = dataWindow.size().x + 1
+
+		region = imath.Box2i( imath.V2i( 30, 27 ), imath.V2i( 40, 45 ) )
+		regionWidth = region.size().x + 1
+		regionHeight = region.size().y + 1
+
+		def expected( channelName, x, y ) :
+			if not dataWindow.intersects( imath.V2i( x, y ) ) :
+				return 0
+			return i[channelName][(y - dataWindow.min().y) * width + (x - dataWindow.min().x)]
+
+		for c in [ "R", "G", "B" ] :
+			cd = r.readChannel( c, region )
+			self.assertEqual( len( cd ), regionWidth * regionHeight )
+			for y in range( region.min().y, region.max().y + 1 ) :
+				for x in range( region.min().x, region.max().x + 1 ) :
+					self.assertEqual( cd[(y - region.min().y) * regionWidth + (x - region.min().x)], expected( c, x, y ) )
+
+		# Regions may extend outside the data window, in which case
+		# the missing pixels are filled with zero.
+		region = imath.Box2i( imath.V2i( 20 ), imath.V2i( 30 ) )
+		regionWidth = region.size().x + 1
+		pixels = r.readRegion( region, IECore.StringVectorData( [ "G", "R" ] ) )
+		self.assertEqual( len( pixels ), 2 * regionWidth * regionWidth )
+		for ci, c in enumerate( [ "G", "R" ] ) :
+			for y in range( region.min().y, region.max().y + 1 ) :
+				for x in range( region.min().x, region.max().x + 1 ) :
+					index = ci * regionWidth * regionWidth + (y - region.min().y) * regionWidth + (x - region.min().x)
+					self.assertEqual( pixels[index], expected( c, x, y ) )
+
+		self.assertRaises( Exception, r.readRegion, region, IECore.StringVectorData( [ "notAChannel" ] ) )
+
+	def testTiles( self ) :
+
+		r = IECoreImage.ImageReader( "test/IECoreImage/data/exr/uvMap.512x256.exr" )
+		self.assertEqual( r.tileSize(), imath.V2i( 0 ) )
+
+		# Scanline images are iterated in bands of full width
+		tiles = r.tiles( r.dataWindow() )
+		self.assertEqual( len( tiles ), 4 )
+		for t in tiles :
+			self.assertEqual( t.min().x, 0 )
+			self.assertEqual( t.max().x, 511 )
+
+		# Tiles cover the requested region exactly once
+		region = imath.Box2i( imath.V2i( 10, 70 ), imath.V2i( 300, 200 ) )
+		tiles = r.tiles( region )
+		self.assertEqual( len( tiles ), 3 )
+		area = 0
+		for t in tiles :
+			self.assertTrue( region.intersects( t ) )
+			self.assertEqual( t.min().x, 10 )
+			self.assertEqual( t.max().x, 300 )
+			area += ( t.size().x + 1 ) * ( t.size().y + 1 )
+		self.assertEqual( area, ( region.size().x + 1 ) * ( region.size().y + 1 ) )
+
+		self.assertEqual( len( r.tiles( imath.Box2i() ) ), 0 )
+
+		# And reading tile by tile gives the same result as reading the whole image
+		i = r.read()
+		dataWindow = r.dataWindow()
+		width = dataWindow.size().x + 1
+		for t in r.tiles( dataWindow ) :
+			pixels = r.readRegion( t, IECore.StringVectorData( [ "R" ] ) )
+			tileWidth = t.size().x + 1
+			for y in range( t.min().y, t.max().y + 1, 17 ) :
+				for x in range( t.min().x, t.max().x + 1, 13 ) :
+					self.assertEqual( pixels[(y - t.min().y) * tileWidth + x - t.min().x], i["R"][y * width + x] )
+
 	def testNonZeroDataWindowOrigin( self ) :
 
 		r = IECoreImage.ImageReader( "test/IECoreImage/data/exr/uvMapWithDataWindow.100x100.exr" )
@@ -198,9 +198,9 @@ class ImageWriterTest( unittest.TestCase ) :
 		image = self.__makeFloatImage( dataWindow, displayWindow, dataType = IECore.FloatVectorData )
 		self.assertTrue( IECoreImage.ImageWriter.canWrite( image, "test/IECoreImage/data/exr/output.exr" ) )
 
-		# we dont support writing images of different channel types
+		# we support writing images of different channel types
 		image["R"] = IECore.DoubleVectorData( [ x for x in image["R"] ] )
-		self.assertFalse( IECoreImage.ImageWriter.canWrite( image, "test/IECoreImage/data/exr/output.exr" ) )
+		self.assertTrue( IECoreImage.ImageWriter.canWrite( image, "test/IECoreImage/data/exr/output.exr" ) )
 
 		# we dont support writing images if OIIO doesn't know how to use the channels
 		image["R"] = IECore.StringVectorData( [ str(x) for x in image["R"] ] )
@@ -241,6 +241,53 @@ class ImageWriterTest( unittest.TestCase ) :
 
 			self.tearDown()
 
+	def testWriteMixedChannelTypes( self ) :
+
+		window = imath.Box2i( imath.V2i( 0 ), imath.V2i( 99, 149 ) )
+
+		imgOrig = self.__makeFloatImage( window, window )
+		imgOrig["G"] = IECore.HalfVectorData( [ x for x in imgOrig["G"] ] )
+		imgOrig["id"] = IECore.UIntVectorData( [ i * 1000 for i in range( 0, 100 * 150 ) ] )
+
+		w = IECore.Writer.create( imgOrig, "test/IECoreImage/data/exr/output.exr" )
+		w["formatSettings"]["openexr"]["dataType"].setValue( "float" )
+		w.write()
+
+		imgNew = IECore.Reader.create( "test/IECoreImage/data/exr/output.exr" ).read()
+		self.__verifyImageRGB( imgNew, imgOrig )
+
+		# Integer channels keep their own type, rather than being
+		# converted to the type specified for the format.
+		self.assertEqual( [ int( x ) for x in imgNew["id"] ], list( imgOrig["id"] ) )
+
+	def testWriteAsync( self ) :
+
+		dataWindow = imath.Box2i( imath.V2i( 10, 20 ), imath.V2i( 209, 319 ) )
+		displayWindow = imath.Box2i( imath.V2i( 0 ), imath.V2i( 255, 511 ) )
+
+		imgOrig = self.__makeFloatImage( dataWindow, displayWindow, withAlpha = True )
+
+		w = IECoreImage.ImageWriter( imgOrig, "test/IECoreImage/data/exr/output.exr" )
+		f = w.writeAsync()
+
+		# Parameters may be changed while the write is in progress
+		# without affecting it.
+		w["fileName"].setTypedValue( "test/IECoreImage/data/exr/notWritten.exr" )
+
+		f.wait()
+		self.assertTrue( f.done() )
+		self.assertFalse( os.path.exists( "test/IECoreImage/data/exr/notWritten.exr" ) )
+
+		imgNew = IECore.Reader.create( "test/IECoreImage/data/exr/output.exr" ).read()
+		self.assertEqual( imgNew.dataWindow, dataWindow )
+		self.__verifyImageRGB( imgNew, imgOrig )
+
+		# Errors are reported when waiting
+		w = IECoreImage.ImageWriter( imgOrig, "test/IECoreImage/data/exr/output.exr" )
+		w["channels"].setValue( IECore.StringVectorData( [ "notAChannel" ] ) )
+		f = w.writeAsync()
+		self.assertRaises( RuntimeError, f.wait )
+
 	def testWriteIncomplete( self ) :
 
 		displayWindow = imath.Box2i(
@@ -107,6 +107,7 @@ from CurvesAlgoTest import *
 from PointsAlgoTest import *
 from ObjectInterpolationTest import ObjectInterpolationTest
 from SceneAlgo import *
+from SceneBVHTest import SceneBVHTest
 from ShaderNetworkTest import ShaderNetworkTest
 from ShaderNetworkAlgoTest import ShaderNetworkAlgoTest
 from SharedSceneInterfacesTest import SharedSceneInterfacesTest
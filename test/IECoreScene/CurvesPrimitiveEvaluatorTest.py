@@ -1246,6 +1246,145 @@ class CurvesPrimitiveEvaluatorTest( unittest.TestCase ) :
 
 		IECoreScene.testCurvesPrimitiveEvaluatorParallelClosestPoint()
 
+	def __batchTestCurves( self, basis, periodic ) :
+
+		rand = imath.Rand32( 10 )
+
+		vertsPerCurve = IECore.IntVectorData()
+		p = IECore.V3fVectorData()
+		for c in range( 0, 100 ) :
+			numVerts = 4 + rand.nexti() % 6 if periodic else 4 + basis.step * ( rand.nexti() % 6 )
+			vertsPerCurve.append( numVerts )
+			for i in range( 0, numVerts ) :
+				p.append( imath.V3f( rand.nextf(), rand.nextf(), rand.nextf() ) + imath.V3f( c * 2 ) )
+
+		curves = IECoreScene.CurvesPrimitive( vertsPerCurve, basis, periodic, p )
+		curves["constantFloat"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.FloatData( 0.5 ) )
+		curves["uniformColor"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Uniform,
+			IECore.Color3fVectorData( [ imath.Color3f( i ) for i in range( 0, curves.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Uniform ) ) ] )
+		)
+		curves["uniformString"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Uniform,
+			IECore.StringVectorData( [ str( i ) for i in range( 0, curves.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Uniform ) ) ] )
+		)
+		curves["vertexFloat"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.FloatVectorData( [ rand.nextf() for i in range( 0, curves.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ) ) ] )
+		)
+		curves["varyingUV"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Varying,
+			IECore.V2fVectorData( [ imath.V2f( rand.nextf() ) for i in range( 0, curves.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Varying ) ) ] )
+		)
+
+		return curves
+
+	def testBatchQueries( self ) :
+
+		for basis, periodic in [
+			( IECore.CubicBasisf.linear(), False ),
+			( IECore.CubicBasisf.linear(), True ),
+			( IECore.CubicBasisf.bSpline(), False ),
+			( IECore.CubicBasisf.bSpline(), True ),
+			( IECore.CubicBasisf.catmullRom(), False ),
+		] :
+
+			curves = self.__batchTestCurves( basis, periodic )
+			e = IECoreScene.CurvesPrimitiveEvaluator( curves )
+			result = e.createResult()
+
+			curveIndices = IECore.IntVectorData()
+			v = IECore.FloatVectorData()
+			for c in range( 0, curves.numCurves() ) :
+				for vi in range( 0, 20 ) :
+					curveIndices.append( c )
+					v.append( vi / 19.0 )
+
+			points, vTangents = e.pointsAtV( curveIndices, v )
+			names = [ "constantFloat", "uniformColor", "uniformString", "vertexFloat", "varyingUV" ]
+			primVars = e.primitiveVariablesAtV( curveIndices, v, names )
+			self.assertEqual( sorted( primVars.keys() ), sorted( names ) )
+
+			for i in range( 0, len( curveIndices ) ) :
+
+				self.failUnless( e.pointAtV( curveIndices[i], v[i], result ) )
+				self.assertEqual( points[i], result.point() )
+				self.assertEqual( vTangents[i], result.vTangent() )
+				self.assertEqual( primVars["constantFloat"][i], result.floatPrimVar( curves["constantFloat"] ) )
+				self.assertEqual( primVars["uniformColor"][i], result.colorPrimVar( curves["uniformColor"] ) )
+				self.assertEqual( primVars["uniformString"][i], result.stringPrimVar( curves["uniformString"] ) )
+				self.assertEqual( primVars["vertexFloat"][i], result.floatPrimVar( curves["vertexFloat"] ) )
+				self.assertEqual( primVars["varyingUV"][i], result.vec2PrimVar( curves["varyingUV"] ) )
+
+			closestCurveIndices, closestV = e.closestPoints( points )
+			for i in range( 0, len( points ) ) :
+				self.failUnless( e.closestPoint( points[i], result ) )
+				self.assertEqual( closestCurveIndices[i], result.curveIndex() )
+				self.assertEqual( closestV[i], result.uv()[1] )
+
+	def testBatchQueryErrors( self ) :
+
+		curves = self.__batchTestCurves( IECore.CubicBasisf.linear(), False )
+		e = IECoreScene.CurvesPrimitiveEvaluator( curves )
+
+		self.assertRaises( Exception, e.pointsAtV, IECore.IntVectorData( [ 0, 1 ] ), IECore.FloatVectorData( [ 0.5 ] ) )
+		self.assertRaises( Exception, e.pointsAtV, IECore.IntVectorData( [ curves.numCurves() ] ), IECore.FloatVectorData( [ 0.5 ] ) )
+		self.assertRaises( Exception, e.pointsAtV, IECore.IntVectorData( [ 0 ] ), IECore.FloatVectorData( [ 1.5 ] ) )
+		self.assertRaises( Exception, e.primitiveVariablesAtV, IECore.IntVectorData( [ 0 ] ), IECore.FloatVectorData( [ 0.5 ] ), [ "notAPrimVar" ] )
+
+		curves["vertexString"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.StringVectorData( [ "" ] * curves.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex ) )
+		)
+		e = IECoreScene.CurvesPrimitiveEvaluator( curves )
+		self.assertRaises( Exception, e.primitiveVariablesAtV, IECore.IntVectorData( [ 0 ] ), IECore.FloatVectorData( [ 0.5 ] ), [ "vertexString" ] )
+
+		empty = IECoreScene.CurvesPrimitive( IECore.IntVectorData(), IECore.CubicBasisf.linear(), False, IECore.V3fVectorData() )
+		e = IECoreScene.CurvesPrimitiveEvaluator( empty )
+		self.assertRaises( Exception, e.closestPoints, IECore.V3fVectorData( [ imath.V3f( 0 ) ] ) )
+
+	def testBatchIndexedPrimitiveVariables( self ) :
+
+		curves = self.__batchTestCurves( IECore.CubicBasisf.linear(), False )
+		numVertices = curves.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Vertex )
+		curves["indexedFloat"] = IECoreScene.PrimitiveVariable(
+			IECoreScene.PrimitiveVariable.Interpolation.Vertex,
+			IECore.FloatVectorData( [ 1, 2, 3 ] ),
+			IECore.IntVectorData( [ i % 3 for i in range( 0, numVertices ) ] )
+		)
+
+		e = IECoreScene.CurvesPrimitiveEvaluator( curves )
+		curveIndices = IECore.IntVectorData( range( 0, curves.numCurves() ) )
+		v = IECore.FloatVectorData( [ 0 ] * curves.numCurves() )
+		primVars = e.primitiveVariablesAtV( curveIndices, v, [ "indexedFloat" ] )
+
+		expanded = curves["indexedFloat"].expandedData()
+		offsets = e.vertexDataOffsets()
+		for i in range( 0, curves.numCurves() ) :
+			self.assertEqual( primVars["indexedFloat"][i], expanded[offsets[i]] )
+
+	def testBatchPerformance( self ) :
+
+		curves = self.__batchTestCurves( IECore.CubicBasisf.bSpline(), False )
+		e = IECoreScene.CurvesPrimitiveEvaluator( curves )
+
+		rand = imath.Rand32( 1 )
+		curveIndices = IECore.IntVectorData( [ rand.nexti() % curves.numCurves() for i in range( 0, 100000 ) ] )
+		v = IECore.FloatVectorData( [ rand.nextf() for i in range( 0, 100000 ) ] )
+
+		t = IECore.Timer()
+		e.primitiveVariablesAtV( curveIndices, v, [ "vertexFloat", "varyingUV", "uniformColor" ] )
+		#print "Batch", t.stop()
+
+		t = IECore.Timer()
+		result = e.createResult()
+		for i in range( 0, len( curveIndices ) ) :
+			e.pointAtV( curveIndices[i], v[i], result )
+			result.floatPrimVar( curves["vertexFloat"] )
+			result.vec2PrimVar( curves["varyingUV"] )
+			result.colorPrimVar( curves["uniformColor"] )
+		#print "Single", t.stop()
+
 if __name__ == "__main__":
 	unittest.main()
 
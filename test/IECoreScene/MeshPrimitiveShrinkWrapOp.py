@@ -78,6 +78,24 @@ class TestMeshPrimitiveShrinkWrapOp( unittest.TestCase ) :
 		for p in pData:
 			self.assert_( math.fabs( p.length() - targetRadius ) < 0.1 )
 
+	def testDenseMesh( self ) :
+
+		m = IECoreScene.MeshPrimitive.createSphere( radius = 1, divisions = imath.V2i( 200, 400 ) )
+		target = IECoreScene.MeshPrimitive.createSphere( radius = 3, divisions = imath.V2i( 100, 200 ) )
+
+		t = IECore.Timer()
+		res = IECoreScene.MeshPrimitiveShrinkWrapOp()(
+			target = target,
+			input = m,
+			method = IECoreScene.MeshPrimitiveShrinkWrapOp.Method.Normal,
+			direction = IECoreScene.MeshPrimitiveShrinkWrapOp.Direction.Outside
+		)
+		#print "ShrinkWrap", t.stop()
+
+		self.assertEqual( len( res["P"].data ), len( m["P"].data ) )
+		for p in res["P"].data :
+			self.assertAlmostEqual( p.length(), 3, delta = 0.01 )
+
 
 
 
@@ -34,6 +34,8 @@
 
 import unittest
 import sys
+import os
+import imath
 import IECore
 import IECoreScene
 
@@ -97,6 +99,56 @@ class TestOBJReader( unittest.TestCase ) :
 		self.failUnless( mesh.isInstanceOf( IECoreScene.MeshPrimitive.staticTypeId() ) )
 		self.failUnless( mesh.arePrimitiveVariablesValid() )
 
+	def testTextureCoordinatesWithoutNormals( self ) :
+
+		with open( "test/IECoreScene/textureOnly.obj", "w" ) as f :
+			f.write( "v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0.5 0.25\nvt 1e-1 -2.5E1\nf 1/1 2/2 -1/-1\n" )
+
+		mesh = IECore.Reader.create( "test/IECoreScene/textureOnly.obj" ).read()
+
+		self.failUnless( mesh.arePrimitiveVariablesValid() )
+		self.assertEqual( mesh.vertexIds, IECore.IntVectorData( [ 0, 1, 2 ] ) )
+		self.assertEqual( mesh["s"].data, IECore.FloatVectorData( [ 0.5, 0.1, 0.1 ] ) )
+		self.assertEqual( mesh["t"].data, IECore.FloatVectorData( [ 0.25, -25, -25 ] ) )
+		self.failIf( "N" in mesh )
+
+	def testInvalidFace( self ) :
+
+		with open( "test/IECoreScene/invalidFace.obj", "w" ) as f :
+			f.write( "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n" )
+
+		self.assertRaises( RuntimeError, IECore.Reader.create( "test/IECoreScene/invalidFace.obj" ).read )
+
+	def testLargeFile( self ) :
+
+		# large enough to be split into many chunks, using both absolute and
+		# relative indices so that the merging of chunks is exercised.
+		numFaces = 50000
+		with open( "test/IECoreScene/large.obj", "w" ) as f :
+			for i in range( 0, numFaces ) :
+				f.write( "v %d 0 0\nv %d 1 0\nv %d 1 1\nvn 0 0 %d\n" % ( i, i, i, i ) )
+				if i % 2 :
+					f.write( "f -3//-1 -2//-1 -1//-1\n" )
+				else :
+					f.write( "f %d//%d %d//%d %d//%d\n" % ( i * 3 + 1, i + 1, i * 3 + 2, i + 1, i * 3 + 3, i + 1 ) )
+
+		t = IECore.Timer()
+		mesh = IECore.Reader.create( "test/IECoreScene/large.obj" ).read()
+		#print "OBJReader", t.stop()
+
+		self.failUnless( mesh.arePrimitiveVariablesValid() )
+		self.assertEqual( mesh.numFaces(), numFaces )
+		self.assertEqual( mesh.vertexIds, IECore.IntVectorData( range( 0, numFaces * 3 ) ) )
+		for i in range( 0, numFaces, 997 ) :
+			self.assertEqual( mesh["P"].data[i*3+2], imath.V3f( i, 1, 1 ) )
+			self.assertEqual( mesh["N"].data[i*3], imath.V3f( 0, 0, i ) )
+
+	def tearDown( self ) :
+
+		for f in [ "textureOnly.obj", "invalidFace.obj", "large.obj" ] :
+			if os.path.exists( "test/IECoreScene/" + f ) :
+				os.remove( "test/IECoreScene/" + f )
+
 if __name__ == "__main__":
 
 	unittest.main()
@@ -38,6 +38,7 @@ import unittest
 import sys
 import os
 
+import imath
 import IECore
 import IECoreScene
 
@@ -212,6 +213,33 @@ class TestPDCReader( unittest.TestCase ) :
 		self.assert_( len( a ) < 15 )
 		self.assert_( len( a ) > 8 )
 
+	def testFilteringSelectsConsistentSubset( self ) :
+
+		r = IECore.Reader.create( "test/IECore/data/pdcFiles/particleShape1.250.pdc" )
+		ids = r.readAttribute( "particleId" )
+		positions = r.readAttribute( "position" )
+		masses = r.readAttribute( "mass" )
+
+		r.parameters()["percentage"].setValue( IECore.FloatData( 50 ) )
+		r.parameters()["realType"].setValue( "float" )
+		filteredIds = r.readAttribute( "particleId" )
+		filteredPositions = r.readAttribute( "position" )
+		filteredMasses = r.readAttribute( "mass" )
+
+		self.assertEqual( type( filteredPositions ), IECore.V3fVectorData )
+		self.assertEqual( len( filteredIds ), len( filteredPositions ) )
+		self.assertEqual( len( filteredIds ), len( filteredMasses ) )
+
+		# every attribute must be filtered by the same selection of particles
+		for i, id in enumerate( filteredIds ) :
+			j = list( ids ).index( id )
+			self.assertEqual( filteredPositions[i], imath.V3f( positions[j] ) )
+			self.assertAlmostEqual( filteredMasses[i], masses[j], 5 )
+
+		# and a different seed must select a different subset
+		r.parameters()["percentageSeed"].setValue( IECore.IntData( 10 ) )
+		self.assertNotEqual( r.readAttribute( "particleId" ), filteredIds )
+
 
 	def testConversion( self ) :
 
@@ -33,6 +33,7 @@
 #
 ##########################################################################
 
+import math
 import unittest
 import imath
 import IECore
@@ -220,6 +221,114 @@ class PointSmoothSkinningOpTest( unittest.TestCase ) :
 		o(input=pts, positionVar="bob", copyInput=False, deformationPose = self.myDP(), smoothSkinningData = self.mySSD( ))
 		self.assertNotEqual(pts["bob"].data , self.myP())
 
+	def testPreparedSkin( self ) :
+
+		pts = self.myPP()
+		o = IECoreScene.PointSmoothSkinningOp()
+		o( input = pts, copyInput = False, deformNormals = True, deformationPose = self.myDP(), smoothSkinningData = self.mySSD() )
+
+		skin = IECoreScene.PointSmoothSkinningOp.PreparedSkin( self.mySSD() )
+		p = self.myP()
+		n = self.myN()
+		skin.deformPoints( p, self.myDP() )
+		skin.deformNormals( n, self.myDP() )
+
+		for i in range( 0, len( p ) ) :
+			self.assertTrue( p[i].equalWithAbsError( pts["P"].data[i], 0.00001 ) )
+			self.assertTrue( n[i].equalWithAbsError( pts["N"].data[i], 0.00001 ) )
+
+		# reuse for a second pose
+		p2 = self.myP()
+		skin.deformPoints( p2, IECore.M44fVectorData( [ imath.M44f() ] * 3 ), referenceIndices = IECore.IntVectorData( range( 0, 8 ) ) )
+
+		self.assertRaises( RuntimeError, skin.deformPoints, self.myP(), IECore.M44fVectorData( [ imath.M44f() ] ) )
+		self.assertRaises( RuntimeError, skin.deformPoints, self.myP(), self.myDP(), referenceIndices = IECore.IntVectorData( [ 8 ] * 8 ) )
+
+	def testSmoothSkinningDataEditedInPlace( self ) :
+
+		ssd = self.mySSD()
+		o = IECoreScene.PointSmoothSkinningOp()
+		first = o( input = self.myPP(), deformationPose = self.myDP(), smoothSkinningData = ssd )
+
+		# Move all of the first point's weight onto the second joint,
+		# editing the same SmoothSkinningData that was used above.
+		weights = ssd.pointInfluenceWeights()
+		weights[0] = 0
+		weights[1] = 1
+		self.assertEqual( ssd.pointInfluenceWeights()[1], 1 )
+
+		second = o( input = self.myPP(), deformationPose = self.myDP(), smoothSkinningData = ssd )
+		expected = IECoreScene.PointSmoothSkinningOp()( input = self.myPP(), deformationPose = self.myDP(), smoothSkinningData = ssd.copy() )
+
+		self.assertFalse( second["P"].data[0].equalWithAbsError( first["P"].data[0], 0.0001 ) )
+		for i in range( 0, len( expected["P"].data ) ) :
+			self.assertTrue( second["P"].data[i].equalWithAbsError( expected["P"].data[i], 0.00001 ) )
+
+	def testDualQuaternion( self ) :
+
+		pts = self.myPP()
+		o = IECoreScene.PointSmoothSkinningOp()
+		linear = o( input = pts, deformNormals = True, deformationPose = self.myDP(), smoothSkinningData = self.mySSD(), blend = IECoreScene.PointSmoothSkinningOp.Blend.Linear )
+		dq = o( input = pts, deformNormals = True, deformationPose = self.myDP(), smoothSkinningData = self.mySSD(), blend = IECoreScene.PointSmoothSkinningOp.Blend.DualQuaternion )
+
+		# points with a single influence are rigidly transformed
+		# by both methods, so should agree.
+		for i in [ 0, 1, 6, 7 ] :
+			self.assertTrue( dq["P"].data[i].equalWithAbsError( linear["P"].data[i], 0.0001 ) )
+			self.assertTrue( dq["N"].data[i].equalWithAbsError( linear["N"].data[i], 0.0001 ) )
+
+	def testDualQuaternionPreservesLength( self ) :
+
+		# two influences, one rotated 90 degrees around the origin.
+		ssd = IECoreScene.SmoothSkinningData(
+			IECore.StringVectorData( [ "a", "b" ] ),
+			IECore.M44fVectorData( [ imath.M44f(), imath.M44f() ] ),
+			IECore.IntVectorData( [ 0 ] ),
+			IECore.IntVectorData( [ 2 ] ),
+			IECore.IntVectorData( [ 0, 1 ] ),
+			IECore.FloatVectorData( [ 0.5, 0.5 ] ),
+		)
+		pose = IECore.M44fVectorData( [ imath.M44f(), imath.M44f().rotate( imath.V3f( 0, 0, math.pi / 2 ) ) ] )
+		skin = IECoreScene.PointSmoothSkinningOp.PreparedSkin( ssd )
+
+		p = IECore.V3fVectorData( [ imath.V3f( 1, 0, 0 ) ] )
+		skin.deformPoints( p, pose, IECoreScene.PointSmoothSkinningOp.Blend.Linear )
+		self.assertAlmostEqual( p[0].length(), math.sqrt( 0.5 ), 5 )
+
+		expected = ( imath.V3f( 1, 0, 0 ) + imath.V3f( 1, 0, 0 ) * pose[1] ).normalized()
+		p = IECore.V3fVectorData( [ imath.V3f( 1, 0, 0 ) ] )
+		skin.deformPoints( p, pose, IECoreScene.PointSmoothSkinningOp.Blend.DualQuaternion )
+		self.assertTrue( p[0].equalWithAbsError( expected, 0.0001 ) )
+
+	def testManyPointsPerformance( self ) :
+
+		numPoints = 100000
+		numInfluences = 50
+		r = imath.Rand32()
+		counts = IECore.IntVectorData( [ 4 ] * numPoints )
+		offsets = IECore.IntVectorData( range( 0, numPoints * 4, 4 ) )
+		indices = IECore.IntVectorData( [ r.nexti() % numInfluences for i in range( 0, numPoints * 4 ) ] )
+		weights = IECore.FloatVectorData( [ 0.25 ] * ( numPoints * 4 ) )
+		ssd = IECoreScene.SmoothSkinningData(
+			IECore.StringVectorData( [ str( i ) for i in range( 0, numInfluences ) ] ),
+			IECore.M44fVectorData( [ imath.M44f() ] * numInfluences ),
+			offsets, counts, indices, weights
+		)
+		pose = IECore.M44fVectorData( [ imath.M44f().translate( imath.V3f( i ) ) for i in range( 0, numInfluences ) ] )
+		p = IECore.V3fVectorData( [ imath.V3f( 0 ) ] * numPoints )
+
+		skin = IECoreScene.PointSmoothSkinningOp.PreparedSkin( ssd )
+
+		t = IECore.Timer()
+		for i in range( 0, 10 ) :
+			skin.deformPoints( p, pose )
+		#print "Linear", t.stop()
+
+		t = IECore.Timer()
+		for i in range( 0, 10 ) :
+			skin.deformPoints( p, pose, IECoreScene.PointSmoothSkinningOp.Blend.DualQuaternion )
+		#print "DualQuaternion", t.stop()
+
 if __name__ == "__main__":
 	unittest.main()
 
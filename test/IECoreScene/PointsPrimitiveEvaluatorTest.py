@@ -77,6 +77,63 @@ class PointsPrimitiveEvaluatorTest( unittest.TestCase ) :
 		self.assertEqual( r.colorPrimVar( p["Cs"] ), imath.Color3f( 5, 0, 0 ) )
 		self.assertEqual( r.stringPrimVar( p["names"] ), "a" )
 
+	def testBatchQueries( self ) :
+
+		rand = imath.Rand32( 10 )
+
+		p = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [ imath.V3f( rand.nextf(), rand.nextf(), rand.nextf() ) for i in range( 0, 1000 ) ] ) )
+		p["Cs"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.Color3fVectorData( [ imath.Color3f( i ) for i in range( 0, 1000 ) ] ) )
+		p["names"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.StringVectorData( [ str( i ) for i in range( 0, 1000 ) ] ) )
+		p["id"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 10, 20 ] ), IECore.IntVectorData( [ i % 2 for i in range( 0, 1000 ) ] ) )
+		p["uniform"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 2.5 ] ) )
+		p["constant"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.StringData( "c" ) )
+
+		e = IECoreScene.PointsPrimitiveEvaluator( p )
+		r = e.createResult()
+
+		queries = IECore.V3fVectorData( [ imath.V3f( rand.nextf(), rand.nextf(), rand.nextf() ) for i in range( 0, 1000 ) ] )
+		pointIndices = e.closestPoints( queries )
+		self.assertEqual( len( pointIndices ), len( queries ) )
+
+		names = [ "P", "Cs", "names", "id", "uniform", "constant" ]
+		primVars = e.primitiveVariables( pointIndices, names )
+		self.assertEqual( sorted( primVars.keys() ), sorted( names ) )
+		self.assertEqual( primVars["constant"], IECore.StringData( "c" ) )
+
+		for i in range( 0, len( queries ) ) :
+
+			self.failUnless( e.closestPoint( queries[i], r ) )
+			self.assertEqual( pointIndices[i], r.pointIndex() )
+			self.assertEqual( primVars["P"][i], r.point() )
+			self.assertEqual( primVars["Cs"][i], r.colorPrimVar( p["Cs"] ) )
+			self.assertEqual( primVars["names"][i], r.stringPrimVar( p["names"] ) )
+			self.assertEqual( primVars["id"][i], 10 if pointIndices[i] % 2 == 0 else 20 )
+			self.assertEqual( primVars["uniform"][i], 2.5 )
+
+	def testBatchQueryConstantIsCopied( self ) :
+
+		p = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [ imath.V3f( x, 0, 0 ) for x in range( 0, 5 ) ] ) )
+		p["constant"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Constant, IECore.StringData( "c" ) )
+		e = IECoreScene.PointsPrimitiveEvaluator( p )
+
+		primVars = e.primitiveVariables( IECore.IntVectorData( [ 0 ] ), [ "constant" ] )
+		primVars["constant"].value = "modified"
+
+		self.assertEqual( p["constant"].data, IECore.StringData( "c" ) )
+		self.assertEqual( e.primitiveVariables( IECore.IntVectorData( [ 1 ] ), [ "constant" ] )["constant"], IECore.StringData( "c" ) )
+
+	def testBatchQueryErrors( self ) :
+
+		p = IECoreScene.PointsPrimitive( IECore.V3fVectorData( [ imath.V3f( x, 0, 0 ) for x in range( 0, 5 ) ] ) )
+		e = IECoreScene.PointsPrimitiveEvaluator( p )
+
+		self.assertRaises( Exception, e.primitiveVariables, IECore.IntVectorData( [ 5 ] ), [ "P" ] )
+		self.assertRaises( Exception, e.primitiveVariables, IECore.IntVectorData( [ -1 ] ), [ "P" ] )
+		self.assertRaises( Exception, e.primitiveVariables, IECore.IntVectorData( [ 0 ] ), [ "notAPrimVar" ] )
+
+		e = IECoreScene.PointsPrimitiveEvaluator( IECoreScene.PointsPrimitive( IECore.V3fVectorData() ) )
+		self.assertRaises( Exception, e.closestPoints, IECore.V3fVectorData( [ imath.V3f( 0 ) ] ) )
+
 if __name__ == "__main__":
 	unittest.main()
 
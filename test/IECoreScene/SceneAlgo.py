@@ -33,6 +33,9 @@
 ##########################################################################
 
 
+import os
+import json
+import filecmp
 import unittest
 import IECore
 import IECoreScene
@@ -44,8 +47,8 @@ class SceneAlgoTest( unittest.TestCase ) :
 	__testFile = "/tmp/test.scc"
 	__testFile2 = "/tmp/test2.scc"
 
-	def writeSCC( self ) :
-		m = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Write )
+	def writeSCC( self, fileName = __testFile ) :
+		m = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
 		m.writeAttribute( "w", IECore.BoolData( True ), 1.0 )
 
 		t = m.createChild( "t" )
@@ -132,6 +135,24 @@ class SceneAlgoTest( unittest.TestCase ) :
 		self.assertTrue( "tagA" in s.readTags() )
 		self.assertTrue( "tagB" in s.readTags() )
 
+	def testCopyPreservesContentHashes( self ) :
+
+		self.writeSCC()
+
+		src = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Read )
+		dst = IECoreScene.SceneCache( SceneAlgoTest.__testFile2, IECore.IndexedIO.OpenMode.Write )
+		IECoreScene.SceneAlgo.copy( src, dst, 1, 1, 1.0, IECoreScene.SceneAlgo.ProcessFlags.All )
+		del dst
+
+		# The hashes computed while reading are stored by the copy, and
+		# must match those stored when the source was written directly.
+		dst = IECoreScene.SceneCache( SceneAlgoTest.__testFile2, IECore.IndexedIO.OpenMode.Read )
+		for path in ( [ "t" ], [ "t", "s" ] ) :
+			srcLocation = src.scene( path )
+			dstLocation = dst.scene( path )
+			for hashType in ( IECoreScene.SceneInterface.HashType.ObjectHash, IECoreScene.SceneInterface.HashType.AttributesHash ) :
+				self.assertEqual( srcLocation.hash( hashType, 1.0 ), dstLocation.hash( hashType, 1.0 ) )
+
 
 	def testMultithreadedCopy( self ):
 		self.writeBigSCC()
@@ -149,6 +170,27 @@ class SceneAlgoTest( unittest.TestCase ) :
 		self.assertEqual( len( t.childNames()), 4096 )
 
 
+	def testCopyIsDeterministic( self ):
+
+		self.writeBigSCC()
+		src = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Read )
+
+		copies = []
+		for threads in ( 1, 8 ) :
+			fileName = "/tmp/testCopy{0}.scc".format( threads )
+			dst = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+			with IECore.tbb_task_scheduler_init( max_threads = threads ) as taskScheduler :
+				IECoreScene.SceneAlgo.copy( src, dst, 1, 1, 1.0, IECoreScene.SceneAlgo.ProcessFlags.All )
+			del dst
+			copies.append( fileName )
+
+		# the single ordered writer means the file layout doesn't depend
+		# on how the reads were scheduled.
+		self.assertTrue( filecmp.cmp( copies[0], copies[1], shallow = False ) )
+
+		for fileName in copies :
+			os.remove( fileName )
+
 	def testMultithreadedRead( self ):
 
 		self.writeBigSCC()
@@ -168,6 +210,165 @@ class SceneAlgoTest( unittest.TestCase ) :
 				self.assertEqual(stats["attributes"], 4096 * 2 )  # default attribute & custom attribute 'foo'
 
 
+	def testReadProfile( self ) :
+
+		# Objects are cached by file name, so we use a file
+		# that no other test has read from.
+		fileName = "/tmp/sceneAlgoProfile.scc"
+		self.writeSCC( fileName )
+		src = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Read )
+
+		profile = IECoreScene.SceneAlgo.ReadProfile()
+		stats = IECoreScene.SceneAlgo.parallelReadAll( src, 1, 1, 1.0, IECoreScene.SceneAlgo.ProcessFlags.All, profile )
+		self.assertEqual( stats["locations"], 3 )
+
+		events = profile.events()
+		locationEvents = [ e for e in events if e.phase == IECoreScene.SceneAlgo.ProcessFlags.None ]
+		self.assertEqual( sorted( [ e.path for e in locationEvents ] ), [ [], [ "t" ], [ "t", "s" ] ] )
+
+		objectEvents = [ e for e in events if e.phase == IECoreScene.SceneAlgo.ProcessFlags.Objects ]
+		self.assertEqual( len( objectEvents ), 1 )
+		self.assertEqual( objectEvents[0].path, [ "t", "s" ] )
+		self.assertEqual( objectEvents[0].time, 1.0 )
+		self.assertGreater( objectEvents[0].bytesRead, 0 )
+		self.assertEqual( objectEvents[0].cacheMisses, 1 )
+
+		# Sets are only read at the root.
+		setEvents = [ e for e in events if e.phase == IECoreScene.SceneAlgo.ProcessFlags.Sets ]
+		self.assertEqual( [ e.path for e in setEvents ], [ [] ] )
+
+		# Phases are nested within their locations.
+		for e in events :
+			if e.phase == IECoreScene.SceneAlgo.ProcessFlags.None :
+				continue
+			location = [ l for l in locationEvents if l.path == e.path ][0]
+			self.assertGreaterEqual( e.start, location.start )
+			self.assertLessEqual( e.start + e.duration, location.start + location.duration )
+			self.assertEqual( e.thread, location.thread )
+
+		self.assertEqual( [ e.start for e in events ], sorted( [ e.start for e in events ] ) )
+
+		# A second read is served from the cache.
+		profile = IECoreScene.SceneAlgo.ReadProfile()
+		IECoreScene.SceneAlgo.parallelReadAll( src, 1, 1, 1.0, IECoreScene.SceneAlgo.ProcessFlags.Objects, profile )
+		objectEvents = [ e for e in profile.events() if e.phase == IECoreScene.SceneAlgo.ProcessFlags.Objects ]
+		self.assertEqual( objectEvents[0].cacheHits, 1 )
+		self.assertEqual( objectEvents[0].cacheMisses, 0 )
+
+		del src
+		os.remove( fileName )
+
+	def testReadProfileCountsPrimitiveVariableReadsAsMisses( self ) :
+
+		box = IECoreScene.MeshPrimitive.createBox( imath.Box3f( imath.V3f( 0 ), imath.V3f( 1 ) ) )
+		numFaces = box.variableSize( IECoreScene.PrimitiveVariable.Interpolation.Uniform )
+		box["Cs"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.Color3fVectorData( [ imath.Color3f( 1, 0, 0 ) ] * numFaces ) )
+		box2 = box.copy()
+		box2["Cs"] = IECoreScene.PrimitiveVariable( IECoreScene.PrimitiveVariable.Interpolation.Uniform, IECore.Color3fVectorData( [ imath.Color3f( 0, 1, 0 ) ] * numFaces ) )
+
+		fileName = "/tmp/sceneAlgoProfilePrimVars.scc"
+		m = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+		b = m.createChild( "b" )
+		b.writeObject( box, 0.0 )
+		b.writeObject( box2, 1.0 )
+		del b, m
+
+		src = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Read )
+
+		def objectEvent( frame ) :
+			profile = IECoreScene.SceneAlgo.ReadProfile()
+			IECoreScene.SceneAlgo.parallelReadAll( src, frame, frame, 1.0, IECoreScene.SceneAlgo.ProcessFlags.Objects, profile )
+			return [ e for e in profile.events() if e.phase == IECoreScene.SceneAlgo.ProcessFlags.Objects ][0]
+
+		self.assertEqual( objectEvent( 0 ).cacheMisses, 1 )
+
+		# The second frame is built from the cached first frame, but
+		# its primitive variables still come from the file.
+		event = objectEvent( 1 )
+		self.assertEqual( event.cacheHits, 0 )
+		self.assertEqual( event.cacheMisses, 1 )
+
+		del src
+		os.remove( fileName )
+
+	def testReadProfileTrace( self ) :
+
+		self.writeSCC()
+		src = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Read )
+
+		profile = IECoreScene.SceneAlgo.ReadProfile()
+		IECoreScene.SceneAlgo.parallelReadAll( src, 1, 2, 1.0, IECoreScene.SceneAlgo.ProcessFlags.All, profile )
+
+		traceFile = "/tmp/sceneAlgoTrace.json"
+		profile.writeTrace( traceFile )
+		with open( traceFile ) as f :
+			trace = json.load( f )
+		os.remove( traceFile )
+
+		traceEvents = trace["traceEvents"]
+		self.assertEqual( len( traceEvents ), len( profile.events() ) )
+		self.assertTrue( all( e["ph"] == "X" for e in traceEvents ) )
+		self.assertEqual(
+			sorted( set( e["name"] for e in traceEvents if e["cat"] == "location" ) ),
+			[ "/", "/t", "/t/s" ]
+		)
+		self.assertEqual(
+			set( e["name"] for e in traceEvents if e["cat"] == "phase" ),
+			{ "bounds", "transforms", "attributes", "tags", "sets", "objects" }
+		)
+		self.assertEqual( set( e["args"]["time"] for e in traceEvents ), { 1.0, 2.0 } )
+
+	def testCancellation( self ) :
+
+		self.writeBigSCC()
+		src = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Read )
+
+		canceller = IECore.Canceller()
+		canceller.cancel()
+
+		profile = IECoreScene.SceneAlgo.ReadProfile()
+		with self.assertRaises( IECore.Cancelled ) :
+			IECoreScene.SceneAlgo.parallelReadAll( src, 1, 1, 1.0, IECoreScene.SceneAlgo.ProcessFlags.All, profile, canceller )
+
+		self.assertEqual( profile.events(), [] )
+
+		# An uncancelled canceller has no effect.
+		stats = IECoreScene.SceneAlgo.parallelReadAll( src, 1, 1, 1.0, IECoreScene.SceneAlgo.ProcessFlags.All, canceller = IECore.Canceller() )
+		self.assertEqual( stats["locations"], 4096 + 2 )
+
+	def testInstancedObjects( self ) :
+
+		m = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Write )
+		t = m.createChild( "t" )
+		for i in range( 100 ) :
+			box = IECoreScene.MeshPrimitive.createBox( imath.Box3f( imath.V3f( -( i % 3 ) - 1 ), imath.V3f( ( i % 3 ) + 1 ) ) )
+			t.createChild( "t{0}".format( i ) ).writeObject( box, 1.0 )
+		del t, m
+
+		src = IECoreScene.SceneCache( SceneAlgoTest.__testFile, IECore.IndexedIO.OpenMode.Read )
+		instances = IECoreScene.SceneAlgo.instancedObjects( src, 1.0 )
+		self.assertEqual( len( instances ), 3 )
+
+		allPaths = IECore.PathMatcher()
+		for key, obj, paths in instances :
+			self.assertEqual( paths.size(), 34 if key == src.scene( [ "t", "t0" ] ).objectKey( 1.0 ) else 33 )
+			for path in paths.paths() :
+				location = src.scene( IECoreScene.SceneInterface.stringToPath( path ) )
+				self.assertEqual( location.objectKey( 1.0 ), key )
+				self.assertEqual( location.readObject( 1.0 ), obj )
+			allPaths.addPaths( paths )
+
+		self.assertEqual( allPaths.size(), 100 )
+
+		# paths are relative to the root of the traversal
+		instances = IECoreScene.SceneAlgo.instancedObjects( src.child( "t" ), 1.0 )
+		self.assertEqual( len( instances ), 3 )
+		self.assertTrue( any( p.match( "/t0" ) & IECore.PathMatcher.Result.ExactMatch for k, o, p in instances ) )
+
+		# keys match the hash of the object when reading a single sample
+		s = src.scene( [ "t", "t1" ] )
+		self.assertEqual( s.objectKey( 1.0 ), s.readObject( 1.0 ).hash() )
+		self.assertEqual( src.objectKey( 1.0 ), IECore.MurmurHash() )
 
 if __name__ == "__main__" :
 	unittest.main()
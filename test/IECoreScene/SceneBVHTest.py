@@ -0,0 +1,188 @@
+##########################################################################
+#
+#  Copyright (c) 2026, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#
+#     * Neither the name of Image Engine Design nor the names of any
+#       other contributors to this software may be used to endorse or
+#       promote products derived from this software without specific prior
+#       written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import os
+import unittest
+
+import imath
+
+import IECore
+import IECoreScene
+
+class SceneBVHTest( unittest.TestCase ) :
+
+	__testFile = "/tmp/sceneBVHTest.scc"
+
+	def setUp( self ) :
+
+		# Ten boxes along the x axis, with another one raised
+		# up in y by its parent's transform.
+		m = IECoreScene.SceneCache( self.__testFile, IECore.IndexedIO.OpenMode.Write )
+		box = IECoreScene.MeshPrimitive.createBox( imath.Box3f( imath.V3f( -1 ), imath.V3f( 1 ) ) )
+		for i in range( 10 ) :
+			b = m.createChild( "b{0}".format( i ) )
+			b.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( i * 3, 0, 0 ) ) ), 0.0 )
+			b.writeObject( box, 0.0 )
+
+		g = m.createChild( "g" )
+		g.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 0, 10, 0 ) ) ), 0.0 )
+		g.createChild( "c" ).writeObject( box, 0.0 )
+
+		del m, g, b
+
+		self.__scene = IECoreScene.SceneCache( self.__testFile, IECore.IndexedIO.OpenMode.Read )
+
+	def tearDown( self ) :
+
+		del self.__scene
+		IECoreScene.SceneAlgo.clearSceneBVHCache()
+		if os.path.exists( self.__testFile ) :
+			os.remove( self.__testFile )
+
+	def testBound( self ) :
+
+		bvh = IECoreScene.SceneBVH( self.__scene, 0.0 )
+		self.assertEqual( bvh.numLeaves(), 11 )
+		self.assertEqual( bvh.bound(), imath.Box3d( imath.V3d( -1 ), imath.V3d( 28, 11, 1 ) ) )
+		self.assertGreater( bvh.memoryUsage(), 0 )
+
+	def testBoxQuery( self ) :
+
+		bvh = IECoreScene.SceneBVH( self.__scene, 0.0 )
+
+		paths = bvh.intersectingPaths( imath.Box3d( imath.V3d( 2.5, -0.5, -0.5 ), imath.V3d( 6.5, 0.5, 0.5 ) ) )
+		self.assertEqual( set( paths.paths() ), { "/b1", "/b2" } )
+
+		paths = bvh.intersectingPaths( imath.Box3d( imath.V3d( 0, 10, 0 ) ) )
+		self.assertEqual( paths.paths(), [ "/g/c" ] )
+
+		paths = bvh.intersectingPaths( imath.Box3d( imath.V3d( 100 ), imath.V3d( 101 ) ) )
+		self.assertTrue( paths.isEmpty() )
+
+	def testRayQuery( self ) :
+
+		bvh = IECoreScene.SceneBVH( self.__scene, 0.0 )
+
+		paths = bvh.intersectingPaths( imath.Line3d( imath.V3d( -5, 0, 0 ), imath.V3d( 1, 0, 0 ) ) )
+		self.assertEqual( paths.size(), 10 )
+		self.assertFalse( paths.match( "/g/c" ) & IECore.PathMatcher.Result.ExactMatch )
+
+		paths = bvh.intersectingPaths( imath.Line3d( imath.V3d( -5, 0, 0 ), imath.V3d( -6, 0, 0 ) ) )
+		self.assertTrue( paths.isEmpty() )
+
+		paths = bvh.intersectingPaths( imath.Line3d( imath.V3d( 0, 20, 0 ), imath.V3d( 0, 19, 0 ) ) )
+		self.assertEqual( set( paths.paths() ), { "/b0", "/g/c" } )
+
+	def testFrustumQuery( self ) :
+
+		bvh = IECoreScene.SceneBVH( self.__scene, 0.0 )
+
+		# An orthographic camera looking down -z at /b2.
+		frustum = imath.Frustumd( 0.1, 100, -1.5, 1.5, 1.5, -1.5, True )
+		cameraToWorld = imath.M44d().translate( imath.V3d( 6, 0, 10 ) )
+
+		paths = bvh.intersectingPaths( frustum, cameraToWorld )
+		self.assertEqual( paths.paths(), [ "/b2" ] )
+
+		# Looking away from the scene.
+		cameraToWorld = imath.M44d().rotate( imath.V3d( 0, 3.14159265, 0 ) ) * cameraToWorld
+		paths = bvh.intersectingPaths( frustum, cameraToWorld )
+		self.assertTrue( paths.isEmpty() )
+
+	def testBulkQueries( self ) :
+
+		bvh = IECoreScene.SceneBVH( self.__scene, 0.0 )
+
+		boxes = [ imath.Box3d( imath.V3d( i * 3, 0, 0 ) ) for i in range( 10 ) ]
+		results = bvh.intersectingPaths( boxes )
+		self.assertEqual( len( results ), 10 )
+		self.assertEqual( results[0].paths(), [ "/b0" ] )
+		for box, paths in zip( boxes, results ) :
+			self.assertEqual( paths.paths(), bvh.intersectingPaths( box ).paths() )
+
+		rays = [ imath.Line3d( imath.V3d( i * 3, 20, 0 ), imath.V3d( i * 3, 19, 0 ) ) for i in range( 10 ) ]
+		results = bvh.intersectingPaths( rays )
+		self.assertEqual( set( results[0].paths() ), { "/b0", "/g/c" } )
+		self.assertEqual( results[5].paths(), [ "/b5" ] )
+
+		frustum = imath.Frustumd( 0.1, 100, -1.5, 1.5, 1.5, -1.5, True )
+		transforms = [ imath.M44d().translate( imath.V3d( i * 3, 0, 10 ) ) for i in range( 10 ) ]
+		results = bvh.intersectingPaths( [ frustum ] * 10, transforms )
+		self.assertEqual( [ r.paths() for r in results ], [ [ "/b{0}".format( i ) ] for i in range( 10 ) ] )
+
+		self.assertEqual( bvh.intersectingPaths( [] ), [] )
+		self.assertRaises( Exception, bvh.intersectingPaths, [ frustum ], [] )
+
+	def testRelativePaths( self ) :
+
+		bvh = IECoreScene.SceneBVH( self.__scene.child( "g" ), 0.0 )
+		self.assertEqual( bvh.numLeaves(), 1 )
+		self.assertEqual( bvh.intersectingPaths( imath.Box3d( imath.V3d( 0 ) ) ).paths(), [ "/c" ] )
+
+	def testEmptyScene( self ) :
+
+		fileName = "/tmp/sceneBVHEmptyTest.scc"
+		m = IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Write )
+		m.createChild( "e" )
+		del m
+
+		bvh = IECoreScene.SceneBVH( IECoreScene.SceneCache( fileName, IECore.IndexedIO.OpenMode.Read ), 0.0 )
+		self.assertEqual( bvh.numLeaves(), 0 )
+		self.assertTrue( bvh.bound().isEmpty() )
+		self.assertTrue( bvh.intersectingPaths( imath.Box3d( imath.V3d( -1 ), imath.V3d( 1 ) ) ).isEmpty() )
+
+		os.remove( fileName )
+
+	def testCache( self ) :
+
+		bvh1 = IECoreScene.SceneAlgo.sceneBVH( self.__scene, 0.0 )
+		bvh2 = IECoreScene.SceneAlgo.sceneBVH( self.__scene, 0.0 )
+		self.assertTrue( bvh1.isSame( bvh2 ) )
+		self.assertEqual( bvh1.numLeaves(), 11 )
+
+		bvh3 = IECoreScene.SceneAlgo.sceneBVH( self.__scene.child( "g" ), 0.0 )
+		self.assertFalse( bvh1.isSame( bvh3 ) )
+
+		IECoreScene.SceneAlgo.clearSceneBVHCache()
+		self.assertFalse( bvh1.isSame( IECoreScene.SceneAlgo.sceneBVH( self.__scene, 0.0 ) ) )
+
+		limit = IECoreScene.SceneAlgo.getSceneBVHCacheMemoryLimit()
+		try :
+			IECoreScene.SceneAlgo.setSceneBVHCacheMemoryLimit( 0 )
+			self.assertFalse( IECoreScene.SceneAlgo.sceneBVH( self.__scene, 0.0 ).isSame( IECoreScene.SceneAlgo.sceneBVH( self.__scene, 0.0 ) ) )
+		finally :
+			IECoreScene.SceneAlgo.setSceneBVHCacheMemoryLimit( limit )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -846,6 +846,58 @@ class SceneCacheTest( unittest.TestCase ) :
 		self.assertEqual( set( B.readSet( "don", includeDescendantSets = False ).paths() ), set( ['/E'] ) )
 		self.assertEqual( set( B.readSet( "john", includeDescendantSets = False ).paths() ), set( ['/F'] ) )
 
+	def testSetIndex( self ) :
+
+		# /
+		#   A { 'don' : ['/B/E'] }
+		#     B { 'don' : ['/F'] }
+		#       E
+		#       F ['john']
+		#     C ['john']
+
+		writeRoot = IECoreScene.SceneCache( "/tmp/testset.scc", IECore.IndexedIO.OpenMode.Write )
+
+		A = writeRoot.createChild( "A" )
+		B = A.createChild( "B" )
+		C = A.createChild( "C" )
+		E = B.createChild( "E" )
+		F = B.createChild( "F" )
+
+		A.writeSet( "don", IECore.PathMatcher( [ "/B/E" ] ) )
+		B.writeSet( "don", IECore.PathMatcher( [ "/F" ] ) )
+		F.writeTags( [ "john" ] )
+		C.writeTags( [ "john" ] )
+
+		del F, E, C, B, A, writeRoot
+
+		def assertSets( readRoot ) :
+
+			A = readRoot.child( "A" )
+			B = A.child( "B" )
+
+			self.assertEqual( set( readRoot.readSet( "don" ).paths() ), { "/A/B/E", "/A/B/F" } )
+			self.assertEqual( set( readRoot.readSet( "john" ).paths() ), { "/A/B/F", "/A/C" } )
+			self.assertEqual( set( readRoot.readSet( "none" ).paths() ), set() )
+			self.assertEqual( set( A.readSet( "don" ).paths() ), { "/B/E", "/B/F" } )
+			self.assertEqual( set( A.readSet( "don", includeDescendantSets = False ).paths() ), { "/B/E" } )
+			self.assertEqual( set( A.readSet( "john", includeDescendantSets = False ).paths() ), { "/B/F", "/C" } )
+			# The set written at A must not be included when reading from B.
+			self.assertEqual( set( B.readSet( "don" ).paths() ), { "/F" } )
+			self.assertEqual( set( B.readSet( "john" ).paths() ), { "/F" } )
+			self.assertEqual( set( B.child( "E" ).readSet( "don" ).paths() ), set() )
+
+		assertSets( IECoreScene.SceneCache( "/tmp/testset.scc", IECore.IndexedIO.OpenMode.Read ) )
+
+		# Remove the index, to check the walk used for files
+		# written before it was introduced.
+
+		io = IECore.FileIndexedIO( "/tmp/testset.scc", [ "root" ], IECore.IndexedIO.OpenMode.Append )
+		self.assertTrue( "setIndex" in io.entryIds() )
+		io.remove( "setIndex" )
+		del io
+
+		assertSets( IECoreScene.SceneCache( "/tmp/testset.scc", IECore.IndexedIO.OpenMode.Read ) )
+
 	def testSetHashes( self ):
 
 		# A
@@ -1117,6 +1169,54 @@ class SceneCacheTest( unittest.TestCase ) :
 
 			self.assertEqual( h1, h2 )
 
+	def testContentHashes( self ) :
+
+		def writeScene( childName, radius ) :
+
+			io = IECore.MemoryIndexedIO( IECore.CharVectorData(), IECore.IndexedIO.OpenMode.Write )
+			scc = IECoreScene.SceneCache( io )
+			c = scc.createChild( childName )
+			c.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 1, 0, 0 ) ) ), 0.0 )
+			c.writeTransform( IECore.M44dData( imath.M44d().translate( imath.V3d( 2, 0, 0 ) ) ), 1.0 )
+			c.writeAttribute( "user:foo", IECore.StringData( "foo" ), 0.0 )
+			c.writeObject( IECoreScene.SpherePrimitive( radius ), 0.0 )
+			del c, scc
+
+			return IECoreScene.SceneCache( IECore.MemoryIndexedIO( io.buffer(), IECore.IndexedIO.OpenMode.Read ) )
+
+		a = writeScene( "a", 1 ).child( "a" )
+		b = writeScene( "b", 1 ).child( "b" )
+		c = writeScene( "c", 2 ).child( "c" )
+
+		for time in ( 0, 0.5, 1 ) :
+			for hashType in (
+				IECoreScene.SceneInterface.HashType.TransformHash,
+				IECoreScene.SceneInterface.HashType.AttributesHash,
+				IECoreScene.SceneInterface.HashType.BoundHash,
+				IECoreScene.SceneInterface.HashType.ObjectHash,
+			) :
+				# identical content in different caches and locations shares hashes
+				self.assertEqual( a.hash( hashType, time ), b.hash( hashType, time ) )
+				if hashType in ( IECoreScene.SceneInterface.HashType.BoundHash, IECoreScene.SceneInterface.HashType.ObjectHash ) :
+					self.assertNotEqual( a.hash( hashType, time ), c.hash( hashType, time ) )
+				else :
+					self.assertEqual( a.hash( hashType, time ), c.hash( hashType, time ) )
+
+			# the location still matters for the child names and hierarchy
+			self.assertNotEqual(
+				a.hash( IECoreScene.SceneInterface.HashType.ChildNamesHash, time ),
+				b.hash( IECoreScene.SceneInterface.HashType.ChildNamesHash, time )
+			)
+
+		self.assertNotEqual(
+			a.hash( IECoreScene.SceneInterface.HashType.TransformHash, 0 ),
+			a.hash( IECoreScene.SceneInterface.HashType.TransformHash, 0.5 )
+		)
+		self.assertNotEqual(
+			a.hash( IECoreScene.SceneInterface.HashType.TransformHash, 0.5 ),
+			a.hash( IECoreScene.SceneInterface.HashType.TransformHash, 1 )
+		)
+
 	def testParallelAttributeRead( self ) :
 
 		IECoreScene.testSceneCacheParallelAttributeRead()
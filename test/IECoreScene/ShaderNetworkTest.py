@@ -502,6 +502,41 @@ class ShaderNetworkTest( unittest.TestCase ) :
 
 		IECoreScene.testShaderNetworkMove()
 
+	def testSharing( self ) :
+
+		IECoreScene.testShaderNetworkSharing()
+
+	def testHashAfterEdits( self ) :
+
+		n = IECoreScene.ShaderNetwork(
+			shaders = {
+				"s1" : IECoreScene.Shader( "a", "surface", IECore.CompoundData( { "p" : IECore.StringData( "<attr:x>" ) } ) ),
+				"s2" : IECoreScene.Shader( "b", "shader" ),
+			},
+			output = IECoreScene.ShaderNetwork.Parameter( "s1" )
+		)
+		h = n.hash()
+
+		n2 = n.copy()
+		n2.setShader( "s2", IECoreScene.Shader( "c", "shader" ) )
+		self.assertNotEqual( n2.hash(), h )
+		self.assertEqual( n.hash(), h )
+
+		n2.addConnection( ( ( "s2", "out" ), ( "s1", "in" ) ) )
+		h2 = n2.hash()
+		n2.removeConnection( ( ( "s2", "out" ), ( "s1", "in" ) ) )
+		self.assertNotEqual( n2.hash(), h2 )
+
+		n2.setShader( "s2", IECoreScene.Shader( "b", "shader" ) )
+		self.assertEqual( n2.hash(), h )
+
+		# Substitutions are still found in shared shaders.
+		n3 = IECoreScene.ShaderNetwork()
+		IECoreScene.ShaderNetworkAlgo.addShaders( n3, n )
+		n3.applySubstitutions( IECore.CompoundObject( { "x" : IECore.StringData( "y" ) } ) )
+		self.assertEqual( n3.getShader( "s1" ).parameters["p"].value, "y" )
+		self.assertEqual( n.getShader( "s1" ).parameters["p"].value, "<attr:x>" )
+
 	def testUniqueHandles( self ) :
 
 		n = IECoreScene.ShaderNetwork()
@@ -595,6 +630,76 @@ class ShaderNetworkTest( unittest.TestCase ) :
 		self.assertEqual( sSubst6.parameters["c"][0], "<attr:bob>" )
 		self.assertEqual( sSubst6.parameters["c"][1], "<attr:carol>" )
 		self.assertEqual( sSubst6.parameters["c"][2], "<attr:fred>" )
+
+	def testSubstitutedNetworks( self ) :
+
+		n = IECoreScene.ShaderNetwork(
+			shaders = {
+				"s1" : IECoreScene.Shader( "test", "surface", IECore.CompoundData( {
+					"a" : IECore.StringData( "pre<attr:fred>post\\<x\\>" ),
+					"b" : IECore.StringVectorData( [ "<attr:bob>", "<attr:fred>" ] ),
+					"c" : IECore.StringData( "\\<attr:fred>" ),
+					"d" : IECore.StringData( "<attr:fred\\>" ),
+				} ) ),
+				"s2" : IECoreScene.Shader( "test", "shader", IECore.CompoundData( {
+					"c" : IECore.StringData( "noSubstitutions" ),
+				} ) ),
+			},
+			connections = [
+				IECoreScene.ShaderNetwork.Connection(
+					IECoreScene.ShaderNetwork.Parameter( "s2", "out" ),
+					IECoreScene.ShaderNetwork.Parameter( "s1", "in" )
+				),
+			],
+			output = IECoreScene.ShaderNetwork.Parameter( "s1" )
+		)
+
+		attributeSets = [
+			IECore.CompoundObject( { "fred" : IECore.StringData( "CAT" ) } ),
+			IECore.CompoundObject( { "bob" : IECore.StringData( "FISH" ) } ),
+			IECore.CompoundObject( { "fred" : IECore.StringData( "CAT" ), "unused" : IECore.IntData( 1 ) } ),
+			IECore.CompoundObject( { "fred" : IECore.StringData( "back\\<slash" ) } ),
+			IECore.CompoundObject( { "fred" : IECore.IntData( 10 ) } ),
+			IECore.CompoundObject(),
+		]
+
+		# Missing attributes, and those which aren't strings, are substituted
+		# with the empty string. Escaped brackets, including the closing bracket
+		# of a name ending in a backslash, are never substituted.
+		expected = [
+			( "preCATpost<x>", [ "", "CAT" ] ),
+			( "prepost<x>", [ "FISH", "" ] ),
+			( "preCATpost<x>", [ "", "CAT" ] ),
+			( "preback<slashpost<x>", [ "", "back<slash" ] ),
+			( "prepost<x>", [ "", "" ] ),
+			( "prepost<x>", [ "", "" ] ),
+		]
+
+		networks = n.substitutedNetworks( attributeSets )
+		self.assertEqual( len( networks ), len( attributeSets ) )
+
+		for network, ( a, b ) in zip( networks, expected ) :
+			s1 = network.getShader( "s1" )
+			self.assertEqual( s1.parameters["a"].value, a )
+			self.assertEqual( list( s1.parameters["b"] ), b )
+			self.assertEqual( s1.parameters["c"].value, "<attr:fred>" )
+			self.assertEqual( s1.parameters["d"].value, "<attr:fred>" )
+			self.assertEqual( network.getShader( "s2" ), n.getShader( "s2" ) )
+			self.assertEqual( network.inputConnections( "s1" ), n.inputConnections( "s1" ) )
+			self.assertEqual( network.getOutput(), n.getOutput() )
+
+		# Attribute sets giving identical substitutions share a result.
+		self.assertTrue( networks[0].isSame( networks[2] ) )
+		self.assertFalse( networks[0].isSame( networks[1] ) )
+
+		n2 = IECoreScene.ShaderNetwork(
+			shaders = { "s" : IECoreScene.Shader( "test", "surface" ) },
+			output = IECoreScene.ShaderNetwork.Parameter( "s" )
+		)
+		networks = n2.substitutedNetworks( attributeSets )
+		for network in networks :
+			self.assertEqual( network, n2 )
+		self.assertTrue( networks[0].isSame( networks[-1] ) )
 		
 if __name__ == "__main__":
 	unittest.main()